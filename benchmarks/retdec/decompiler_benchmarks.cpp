@@ -0,0 +1,160 @@
+///
+/// @file      retdec/decompiler_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for the decompilation service.
+///
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "retdec/decompilation.h"
+#include "retdec/decompilation_arguments.h"
+#include "retdec/decompiler.h"
+#include "retdec/internal/connection.h"
+#include "retdec/internal/connection_manager.h"
+#include "retdec/internal/files/string_file.h"
+#include "retdec/internal/multipart_body.h"
+#include "retdec/internal/stored_response.h"
+#include "retdec/polling_policy.h"
+#include "retdec/settings.h"
+
+using namespace retdec::internal;
+
+namespace retdec {
+namespace benchmarks {
+
+namespace {
+
+/// URL to the API of the fake service.
+const std::string ApiUrl = "https://retdec.com/service/api";
+
+/// Number of status requests after which a decompilation finishes.
+const int StatusPollsUntilFinished = 3;
+
+///
+/// Does @a str end with @a suffix?
+///
+bool endsWith(const std::string &str, const std::string &suffix) {
+	return str.size() >= suffix.size() &&
+		str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+///
+/// Returns a stored response with the given status code and body.
+///
+std::unique_ptr<Connection::Response> response(int statusCode,
+		const std::shared_ptr<const std::string> &body,
+		const std::string &attachedFileName = "") {
+	return std::make_unique<StoredResponse>(statusCode, "OK", body,
+		attachedFileName);
+}
+
+///
+/// Connection to a fake decompilation service running in the same process.
+///
+/// The uploaded files are serialized into the body of a request like by a
+/// real connection. A decompilation finishes after StatusPollsUntilFinished
+/// status requests.
+///
+class FakeConnection: public Connection {
+public:
+	explicit FakeConnection(
+			const std::shared_ptr<const std::string> &outputHll):
+		outputHll(outputHll) {}
+
+	virtual Url getApiUrl() const override {
+		return ApiUrl;
+	}
+
+	virtual std::unique_ptr<Response> sendGetRequest(
+			const Url &url) override {
+		return sendGetRequest(url, RequestArguments());
+	}
+
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url,
+			const RequestArguments &) override {
+		static const auto UnfinishedStatus = std::make_shared<std::string>(
+			R"({"finished": false, "completion": 50})");
+		static const auto FinishedStatus = std::make_shared<std::string>(
+			R"({"finished": true, "succeeded": true, "completion": 100})");
+		static const auto NotFound = std::make_shared<std::string>(
+			R"({"code": 404, "message": "Not Found"})");
+
+		if (endsWith(url, "/status")) {
+			return response(200, ++statusPolls < StatusPollsUntilFinished ?
+				UnfinishedStatus : FinishedStatus);
+		} else if (endsWith(url, "/outputs/hll")) {
+			return response(200, outputHll, "input.c");
+		}
+		return response(404, NotFound);
+	}
+
+	virtual std::unique_ptr<Response> sendPostRequest(const Url &,
+			const RequestArguments &, const RequestFiles &files) override {
+		static const auto Started = std::make_shared<std::string>(
+			R"({"id": "8Mg1GX1a"})");
+
+		MultipartBody body(files, "6eaab101ea8e44848f8d033f5f11088a");
+		std::string chunk;
+		while (body(chunk)) {
+			chunk.clear();
+		}
+		return response(201, Started);
+	}
+
+private:
+	/// Output HLL returned by the service.
+	const std::shared_ptr<const std::string> outputHll;
+
+	/// Number of received status requests.
+	int statusPolls = 0;
+};
+
+///
+/// Manager of connections to a fake decompilation service.
+///
+class FakeConnectionManager: public ConnectionManager {
+public:
+	explicit FakeConnectionManager(std::size_t outputHllSize):
+		outputHll(std::make_shared<std::string>(outputHllSize, 'x')) {}
+
+	virtual std::shared_ptr<Connection> newConnection(
+			const Settings &) override {
+		return std::make_shared<FakeConnection>(outputHll);
+	}
+
+private:
+	/// Output HLL returned by the service.
+	const std::shared_ptr<const std::string> outputHll;
+};
+
+} // anonymous namespace
+
+void BM_DecompilationCycle(benchmark::State &state) {
+	Decompiler decompiler(
+		Settings().pollingPolicy(
+			PollingPolicy::fixed(std::chrono::milliseconds(0))),
+		std::make_shared<FakeConnectionManager>(64 * 1024)
+	);
+	auto args = DecompilationArguments()
+		.mode("bin")
+		.inputFile(std::make_shared<StringFile>(
+			std::string(static_cast<std::size_t>(state.range(0)), 'x'),
+			"input.exe"));
+	while (state.KeepRunning()) {
+		auto decompilation = decompiler.runDecompilation(args);
+		decompilation->waitUntilFinished();
+		benchmark::DoNotOptimize(decompilation->getOutputHll());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+// Inputs of 1 KB and 1 MB.
+BENCHMARK(BM_DecompilationCycle)->Arg(1 << 10)->Arg(1 << 20);
+
+} // namespace benchmarks
+} // namespace retdec
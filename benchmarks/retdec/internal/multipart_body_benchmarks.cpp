@@ -0,0 +1,125 @@
+///
+/// @file      retdec/internal/multipart_body_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for the body of a multipart/form-data request.
+///
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "retdec/file.h"
+#include "retdec/internal/multipart_body.h"
+
+namespace retdec {
+namespace internal {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Stream buffer producing the given number of bytes without storing them.
+///
+class GeneratingStreamBuf: public std::streambuf {
+public:
+	explicit GeneratingStreamBuf(std::uint64_t size):
+		remaining(size), buffer(64 * 1024, 'x') {}
+
+protected:
+	virtual int_type underflow() override {
+		if (remaining == 0) {
+			return traits_type::eof();
+		}
+
+		auto size = std::min<std::uint64_t>(remaining, buffer.size());
+		remaining -= size;
+		setg(&buffer[0], &buffer[0], &buffer[0] + size);
+		return traits_type::to_int_type(buffer[0]);
+	}
+
+private:
+	/// Number of bytes that have not been produced yet.
+	std::uint64_t remaining;
+
+	/// Bytes that are produced over and over again.
+	std::string buffer;
+};
+
+///
+/// Stream over a GeneratingStreamBuf.
+///
+class GeneratingStream: public std::istream {
+public:
+	explicit GeneratingStream(std::uint64_t size):
+			std::istream(nullptr), buf(size) {
+		rdbuf(&buf);
+	}
+
+private:
+	/// Buffer producing the content.
+	GeneratingStreamBuf buf;
+};
+
+///
+/// File of the given size whose content is generated when it is read.
+///
+/// It allows files of any size to be sent without storing them in memory or
+/// on disk, so only the generation of the body is measured.
+///
+class GeneratedFile: public File {
+public:
+	explicit GeneratedFile(std::uint64_t size): size(size) {}
+
+	virtual std::string getName() const override {
+		return "input.exe";
+	}
+
+	virtual std::string getContent() override {
+		return std::string(size, 'x');
+	}
+
+	virtual std::uint64_t getSize() override {
+		return size;
+	}
+
+	virtual std::unique_ptr<std::istream> openContent() override {
+		return std::make_unique<GeneratingStream>(size);
+	}
+
+	virtual void saveCopyTo(const std::string &) override {}
+	virtual void saveCopyTo(const std::string &, const std::string &) override {}
+
+private:
+	/// Size of the file (in bytes).
+	const std::uint64_t size;
+};
+
+} // anonymous namespace
+
+void BM_MultipartBody(benchmark::State &state) {
+	auto size = static_cast<std::uint64_t>(state.range(0));
+	Connection::RequestFiles files{
+		{"input", std::make_shared<GeneratedFile>(size)}
+	};
+	while (state.KeepRunning()) {
+		MultipartBody body(files, "6eaab101ea8e44848f8d033f5f11088a");
+		benchmark::DoNotOptimize(body.size());
+		std::string chunk;
+		while (body(chunk)) {
+			chunk.clear();
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+// From 1 KB to 1 GB.
+BENCHMARK(BM_MultipartBody)->RangeMultiplier(32)->Range(1 << 10, 1 << 30);
+
+} // namespace benchmarks
+} // namespace internal
+} // namespace retdec
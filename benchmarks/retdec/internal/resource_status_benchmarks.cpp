@@ -0,0 +1,56 @@
+///
+/// @file      retdec/internal/resource_status_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for the status of a resource.
+///
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/utilities/json.h"
+
+namespace retdec {
+namespace internal {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Body of a status response of a decompilation that is in progress.
+///
+const std::string StatusBody = R"({
+	"finished": false,
+	"succeeded": false,
+	"failed": false,
+	"error": null,
+	"completion": 45,
+	"phases": [
+		{"part": "Decompilation", "name": "Initialization", "description": "Initializing", "completion": 5, "warnings": []},
+		{"part": "Unpacking", "name": "Unpacking", "description": "Unpacking", "completion": 10, "warnings": []},
+		{"part": "bin2llvmir", "name": "Decoding", "description": "Decoding", "completion": 45, "warnings": []}
+	]
+})";
+
+} // anonymous namespace
+
+void BM_ResourceStatusFromBody(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(ResourceStatus::fromBody(StatusBody.data(),
+			StatusBody.data() + StatusBody.size()));
+	}
+}
+BENCHMARK(BM_ResourceStatusFromBody);
+
+void BM_ResourceStatusFromJson(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(ResourceStatus::fromJson(toJson(StatusBody)));
+	}
+}
+BENCHMARK(BM_ResourceStatusFromJson);
+
+} // namespace benchmarks
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,63 @@
+///
+/// @file      retdec/internal/utilities/connection_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for connection utilities.
+///
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "retdec/internal/utilities/connection.h"
+
+namespace retdec {
+namespace internal {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Arguments of a typical request.
+///
+const Connection::RequestArguments Args{
+	{"mode", "bin"},
+	{"target_language", "c"},
+	{"sel_decomp_ranges", "0x401000-0x401fff,0x402000-0x402fff"},
+	{"sel_decomp_decoding", "only"},
+	{"generate_cfgs", "yes"}
+};
+
+///
+/// Creates the query part of an URL by concatenating temporary strings.
+///
+/// This is how createQuery() used to create queries.
+///
+std::string createQueryFromTemporaries(
+		const Connection::RequestArguments &args) {
+	std::string query;
+	for (auto &arg : args) {
+		query += (query.empty() ? "?" : "&") + arg.first + "=" + arg.second;
+	}
+	return query;
+}
+
+} // anonymous namespace
+
+void BM_CreateQuery(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(createQuery(Args));
+	}
+}
+BENCHMARK(BM_CreateQuery);
+
+void BM_CreateQueryFromTemporaries(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(createQueryFromTemporaries(Args));
+	}
+}
+BENCHMARK(BM_CreateQueryFromTemporaries);
+
+} // namespace benchmarks
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,90 @@
+///
+/// @file      retdec/internal/utilities/json_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for the JSON utility functions.
+///
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <json/json.h>
+
+#include "retdec/internal/utilities/json.h"
+
+namespace retdec {
+namespace internal {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Body of a status response of a decompilation that is in progress.
+///
+const std::string StatusBody = R"({
+	"finished": false,
+	"succeeded": false,
+	"failed": false,
+	"error": null,
+	"completion": 45,
+	"phases": [
+		{"part": "Decompilation", "name": "Initialization", "description": "Initializing", "completion": 5, "warnings": []},
+		{"part": "Unpacking", "name": "Unpacking", "description": "Unpacking", "completion": 10, "warnings": []},
+		{"part": "bin2llvmir", "name": "Decoding", "description": "Decoding", "completion": 45, "warnings": []}
+	]
+})";
+
+///
+/// Body of an error response.
+///
+const std::string ErrorBody = R"({
+	"code": 422,
+	"message": "Missing Parameter",
+	"description": "Parameter 'mode' is missing."
+})";
+
+///
+/// Decodes @a str by using a new Json::Reader.
+///
+/// This is how toJson() used to decode strings.
+///
+Json::Value toJsonByNewReader(const std::string &str) {
+	Json::Value value;
+	Json::Reader reader;
+	reader.parse(str, value);
+	return value;
+}
+
+} // anonymous namespace
+
+void BM_ToJsonStatus(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(toJson(StatusBody));
+	}
+}
+BENCHMARK(BM_ToJsonStatus);
+
+void BM_ToJsonStatusByNewReader(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(toJsonByNewReader(StatusBody));
+	}
+}
+BENCHMARK(BM_ToJsonStatusByNewReader);
+
+void BM_ToJsonError(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(toJson(ErrorBody));
+	}
+}
+BENCHMARK(BM_ToJsonError);
+
+void BM_ToJsonErrorByNewReader(benchmark::State &state) {
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(toJsonByNewReader(ErrorBody));
+	}
+}
+BENCHMARK(BM_ToJsonErrorByNewReader);
+
+} // namespace benchmarks
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,162 @@
+///
+/// @file      retdec/internal/utilities/os_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for operating-system-related utilities.
+///
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "retdec/internal/utilities/os.h"
+
+namespace retdec {
+namespace internal {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Temporary directory that is removed upon destruction.
+///
+class TmpDirectory {
+public:
+	TmpDirectory():
+			path(uniqueFilePath(
+				boost::filesystem::temp_directory_path().string())) {
+		boost::filesystem::create_directory(path);
+	}
+
+	~TmpDirectory() {
+		boost::system::error_code ec;
+		boost::filesystem::remove_all(path, ec);
+	}
+
+	/// Path to the directory.
+	const std::string path;
+};
+
+///
+/// Writes @a content into @a path in place, without a temporary file.
+///
+/// This is how writeFile() used to write files.
+///
+void writeFileInPlace(const std::string &path, const std::string &content) {
+	std::ofstream file(path, std::ios::out | std::ios::binary);
+	file << content;
+}
+
+///
+/// Sizes of the read, written, and copied files: a small output, a large
+/// output, and a huge output.
+///
+void fileSizes(benchmark::internal::Benchmark *b) {
+	b->Arg(1 << 10)->Arg(1 << 20)->Arg(64 << 20);
+}
+
+///
+/// Methods of copying files (see FileCopyMethod) combined with sizes of a
+/// small and a large output.
+///
+void fileCopyMethodsAndSizes(benchmark::internal::Benchmark *b) {
+	b->ArgNames({"method", "size"});
+	for (auto method : {FileCopyMethod::Clone, FileCopyMethod::CopyFileRange,
+			FileCopyMethod::Sendfile, FileCopyMethod::Portable}) {
+		for (auto size : {1 << 10, 64 << 20}) {
+			b->Args({static_cast<int>(method), size});
+		}
+	}
+}
+
+} // anonymous namespace
+
+void BM_ReadFile(benchmark::State &state) {
+	TmpDirectory dir;
+	auto path = joinPaths(dir.path, "file");
+	writeFile(path, std::string(static_cast<std::size_t>(state.range(0)), 'x'));
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(readFile(path));
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadFile)->Apply(fileSizes);
+
+void BM_WriteFile(benchmark::State &state) {
+	TmpDirectory dir;
+	auto path = joinPaths(dir.path, "file");
+	std::string content(static_cast<std::size_t>(state.range(0)), 'x');
+	while (state.KeepRunning()) {
+		writeFile(path, content);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteFile)->Apply(fileSizes);
+
+void BM_WriteFileInPlace(benchmark::State &state) {
+	TmpDirectory dir;
+	auto path = joinPaths(dir.path, "file");
+	std::string content(static_cast<std::size_t>(state.range(0)), 'x');
+	while (state.KeepRunning()) {
+		writeFileInPlace(path, content);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WriteFileInPlace)->Apply(fileSizes);
+
+void BM_CopyFile(benchmark::State &state) {
+	TmpDirectory dir;
+	auto srcPath = joinPaths(dir.path, "src");
+	auto dstPath = joinPaths(dir.path, "dst");
+	writeFile(srcPath, std::string(
+		static_cast<std::size_t>(state.range(0)), 'x'));
+	while (state.KeepRunning()) {
+		copyFile(srcPath, dstPath);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CopyFile)->Apply(fileSizes);
+
+// The copy is not flushed to the disk, so the methods are compared without
+// the flushing, which is measured by BM_SyncFile.
+void BM_CopyFileBy(benchmark::State &state) {
+	auto method = static_cast<FileCopyMethod>(state.range(0));
+	TmpDirectory dir;
+	auto srcPath = joinPaths(dir.path, "src");
+	auto dstPath = joinPaths(dir.path, "dst");
+	writeFile(srcPath, std::string(
+		static_cast<std::size_t>(state.range(1)), 'x'));
+	if (!copyFileBy(method, srcPath, dstPath)) {
+		state.SkipWithError("the method is not supported");
+		return;
+	}
+	while (state.KeepRunning()) {
+		state.PauseTiming();
+		removeFile(dstPath);
+		state.ResumeTiming();
+		copyFileBy(method, srcPath, dstPath);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_CopyFileBy)->Apply(fileCopyMethodsAndSizes);
+
+void BM_SyncFile(benchmark::State &state) {
+	TmpDirectory dir;
+	auto path = joinPaths(dir.path, "file");
+	std::string content(static_cast<std::size_t>(state.range(0)), 'x');
+	while (state.KeepRunning()) {
+		state.PauseTiming();
+		writeFileInPlace(path, content);
+		state.ResumeTiming();
+		syncFile(path);
+	}
+	state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SyncFile)->Apply(fileSizes);
+
+} // namespace benchmarks
+} // namespace internal
+} // namespace retdec
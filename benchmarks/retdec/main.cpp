@@ -0,0 +1,10 @@
+///
+/// @file      retdec/main.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Entry point of the benchmarks.
+///
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+///
+/// @file      retdec/resource_arguments_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks for the base class of arguments for all services.
+///
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "retdec/internal/files/string_file.h"
+#include "retdec/resource_arguments.h"
+
+using namespace retdec::internal;
+
+namespace retdec {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Returns arguments of a typical decompilation.
+///
+ResourceArguments typicalArguments() {
+	ResourceArguments args;
+	args.argument("mode", "bin")
+		.argument("target_language", "c")
+		.argument("sel_decomp_ranges", "0x401000-0x401fff")
+		.argument("sel_decomp_decoding", "only")
+		.file("input", std::make_shared<StringFile>("content", "input.exe"));
+	return args;
+}
+
+} // anonymous namespace
+
+void BM_ResourceArgumentsCopy(benchmark::State &state) {
+	auto args = typicalArguments();
+	while (state.KeepRunning()) {
+		ResourceArguments copy(args);
+		benchmark::DoNotOptimize(copy);
+	}
+}
+BENCHMARK(BM_ResourceArgumentsCopy);
+
+void BM_ResourceArgumentsWithArgument(benchmark::State &state) {
+	auto args = typicalArguments();
+	while (state.KeepRunning()) {
+		benchmark::DoNotOptimize(args.withArgument("generate_cfgs", "yes"));
+	}
+}
+BENCHMARK(BM_ResourceArgumentsWithArgument);
+
+} // namespace benchmarks
+} // namespace retdec
@@ -0,0 +1,159 @@
+///
+/// @file      retdec/simulation_benchmarks.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Benchmarks of services and polling policies against a
+///            simulation of the API.
+///
+
+#include <chrono>
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "retdec/analysis.h"
+#include "retdec/analysis_arguments.h"
+#include "retdec/decompilation.h"
+#include "retdec/decompilation_arguments.h"
+#include "retdec/decompiler.h"
+#include "retdec/file.h"
+#include "retdec/fileinfo.h"
+#include "retdec/internal/clock.h"
+#include "retdec/internal/connection_managers/simulated_connection_manager.h"
+#include "retdec/internal/simulated_service.h"
+#include "retdec/polling_policy.h"
+#include "retdec/settings.h"
+
+using namespace retdec::internal;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace benchmarks {
+
+namespace {
+
+///
+/// Returns a simulation of a busy service.
+///
+/// Decompilations take about a minute, with a long tail, and only 64 of them
+/// are processed at once, so the others wait in a queue.
+///
+std::shared_ptr<SimulatedService> busyService() {
+	SimulatedService::Config config;
+	config.requestLatency = SimulatedService::logNormal(50ms, 0.3);
+	config.processingTime = SimulatedService::logNormal(60s, 0.5);
+	config.workerCount = 64;
+	config.failureRate = 0.01;
+	config.seed = 1;
+	return std::make_shared<SimulatedService>(config);
+}
+
+///
+/// Runs the given number of decompilations on the given simulation at once and
+/// waits until all of them finish, polling as often as the given policy says.
+///
+void runBatchOfDecompilations(const std::shared_ptr<SimulatedService> &service,
+		const std::shared_ptr<const PollingPolicy> &pollingPolicy,
+		std::size_t count) {
+	Decompiler decompiler(
+		Settings().pollingPolicy(pollingPolicy),
+		std::make_shared<SimulatedConnectionManager>(service)
+	);
+	auto args = DecompilationArguments()
+		.mode("bin")
+		.inputFile(File::fromContentWithName("content", "input.exe"));
+
+	std::vector<std::unique_ptr<Decompilation>> decompilations;
+	decompilations.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		decompilations.push_back(decompiler.runDecompilation(args));
+	}
+	for (auto &decompilation : decompilations) {
+		decompilation->waitUntilFinished(Decompilation::OnError::NoThrow);
+	}
+}
+
+///
+/// Benchmarks a batch of decompilations with the given polling policy.
+///
+/// Besides the real time, the label shows the simulated time until the whole
+/// batch finished and the number of status requests per decompilation, so
+/// policies can be compared by both their latency and the load they put on
+/// the service.
+///
+void benchmarkBatchOfDecompilations(benchmark::State &state,
+		const std::shared_ptr<const PollingPolicy> &pollingPolicy) {
+	auto count = static_cast<std::size_t>(state.range(0));
+	std::shared_ptr<SimulatedService> service;
+	while (state.KeepRunning()) {
+		service = busyService();
+		runBatchOfDecompilations(service, pollingPolicy, count);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+
+	auto simulatedTime = std::chrono::duration_cast<std::chrono::seconds>(
+		service->clock()->now().time_since_epoch());
+	auto statusRequestsPerDecompilation =
+		static_cast<double>(service->statistics().statusRequestCount) /
+		static_cast<double>(count);
+	std::ostringstream label;
+	label.precision(2);
+	label << std::fixed << "simulated " << simulatedTime.count() << " s, "
+		<< statusRequestsPerDecompilation
+		<< " status requests per decompilation";
+	state.SetLabel(label.str());
+}
+
+} // anonymous namespace
+
+void BM_SimulatedBatchWithFixedPolling(benchmark::State &state) {
+	benchmarkBatchOfDecompilations(state, PollingPolicy::fixed(1s));
+}
+// Batches of 1K and 100K decompilations.
+BENCHMARK(BM_SimulatedBatchWithFixedPolling)->Arg(1 << 10)->Arg(100000);
+
+void BM_SimulatedBatchWithExponentialPolling(benchmark::State &state) {
+	benchmarkBatchOfDecompilations(state,
+		PollingPolicy::exponential(100ms, 30s));
+}
+BENCHMARK(BM_SimulatedBatchWithExponentialPolling)->Arg(1 << 10)->Arg(100000);
+
+void BM_SimulatedBatchWithDecorrelatedJitterPolling(benchmark::State &state) {
+	benchmarkBatchOfDecompilations(state,
+		PollingPolicy::decorrelatedJitter(100ms, 30s));
+}
+BENCHMARK(BM_SimulatedBatchWithDecorrelatedJitterPolling)->Arg(1 << 10)
+	->Arg(100000);
+
+void BM_SimulatedBatchWithPredictivePolling(benchmark::State &state) {
+	benchmarkBatchOfDecompilations(state,
+		PollingPolicy::predictive(100ms, 30s));
+}
+BENCHMARK(BM_SimulatedBatchWithPredictivePolling)->Arg(1 << 10)->Arg(100000);
+
+void BM_SimulatedAnalysisCycle(benchmark::State &state) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(10s);
+	Fileinfo fileinfo(
+		Settings().pollingPolicy(PollingPolicy::fixed(1s)),
+		std::make_shared<SimulatedConnectionManager>(
+			std::make_shared<SimulatedService>(config))
+	);
+	auto args = AnalysisArguments()
+		.inputFile(File::fromContentWithName("content", "input.exe"));
+	while (state.KeepRunning()) {
+		auto analysis = fileinfo.runAnalysis(args);
+		analysis->waitUntilFinished();
+		benchmark::DoNotOptimize(analysis->getOutput());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimulatedAnalysisCycle);
+
+} // namespace benchmarks
+} // namespace retdec
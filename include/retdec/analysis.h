@@ -12,15 +12,18 @@
 #include <memory>
 #include <string>
 
+#include "retdec/file.h"
 #include "retdec/resource.h"
 
 namespace retdec {
 
 class File;
+class PollingPolicy;
 
 namespace internal {
 
 class Connection;
+struct ResourceContext;
 class AnalysisImpl;
 
 } // namespace internal
@@ -42,18 +45,26 @@ public:
 	/// @cond internal
 	Analysis(const std::string &id,
 		const std::shared_ptr<::retdec::internal::Connection> &conn);
+	Analysis(const std::string &id,
+		const std::shared_ptr<::retdec::internal::Connection> &conn,
+		const ::retdec::internal::ResourceContext &context);
 	/// @endcond
 	virtual ~Analysis() override;
 
 	/// @name Waiting For Analysis To Finish
 	/// @{
 	void waitUntilFinished(OnError onError = OnError::Throw);
+	void waitUntilFinished(const PollingPolicy &pollingPolicy,
+		OnError onError = OnError::Throw);
 	/// @}
 
 	/// @name Obtaining Outputs
 	/// @{
 	std::shared_ptr<File> getOutputAsFile();
 	std::string getOutput();
+	File::ContentView getOutputView();
+	std::shared_ptr<File> downloadOutputAsFile(const std::string &directoryPath);
+	void streamOutput(const OutputHandler &outputHandler);
 	/// @}
 
 private:
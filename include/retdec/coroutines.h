@@ -0,0 +1,284 @@
+///
+/// @file      retdec/coroutines.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Awaitables adapting the asynchronous functions to coroutines.
+///
+/// The awaitables are available only when the header is compiled by a
+/// compiler supporting C++20 coroutines. The library itself does not need to
+/// be compiled in this mode.
+///
+
+#ifndef RETDEC_COROUTINES_H
+#define RETDEC_COROUTINES_H
+
+#if defined(__cpp_impl_coroutine)
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "retdec/analysis.h"
+#include "retdec/analysis_arguments.h"
+#include "retdec/decompilation.h"
+#include "retdec/decompilation_arguments.h"
+#include "retdec/decompiler.h"
+#include "retdec/exceptions.h"
+#include "retdec/fileinfo.h"
+#include "retdec/resource.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// State shared by a completion awaitable and the handler completing it.
+///
+template <typename T>
+struct CompletionState {
+	/// Result of the operation (when it has succeeded).
+	std::optional<T> result;
+
+	/// Error of the operation (when it has failed).
+	std::exception_ptr error;
+
+	/// Coroutine to resume when the operation completes.
+	std::coroutine_handle<> continuation;
+
+	/// Has either the handler or the suspending coroutine arrived?
+	std::atomic<bool> arrived{false};
+
+	///
+	/// Completes the operation with the given result or error.
+	///
+	template <typename... Result>
+	void complete(std::exception_ptr error, Result &&... result) {
+		if (error) {
+			this->error = error;
+		} else {
+			this->result.emplace(std::forward<Result>(result)...);
+		}
+		// The one that arrives second (the handler or the coroutine after
+		// starting the operation) resumes the coroutine.
+		if (arrived.exchange(true, std::memory_order_acq_rel)) {
+			continuation.resume();
+		}
+	}
+};
+
+///
+/// Awaitable suspending a coroutine until a completion handler is called.
+///
+/// @tparam T Type of the result (@c void when there is none).
+/// @tparam Start Function starting the operation. It is passed the shared
+///               state, on which it has to call @c complete() from the handler.
+///
+template <typename T, typename Start>
+class CompletionAwaitable {
+private:
+	using State = CompletionState<
+		std::conditional_t<std::is_void_v<T>, std::monostate, T>>;
+
+public:
+	explicit CompletionAwaitable(Start start): start(std::move(start)) {}
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+
+	bool await_suspend(std::coroutine_handle<> continuation) {
+		state->continuation = continuation;
+		start(state);
+		// When the handler has already been called, do not suspend.
+		return !state->arrived.exchange(true, std::memory_order_acq_rel);
+	}
+
+	T await_resume() {
+		if (state->error) {
+			std::rethrow_exception(state->error);
+		}
+		if constexpr (!std::is_void_v<T>) {
+			return std::move(*state->result);
+		}
+	}
+
+private:
+	/// Function starting the operation.
+	Start start;
+
+	/// State shared with the handler.
+	std::shared_ptr<State> state = std::make_shared<State>();
+};
+
+///
+/// Creates an awaitable of the operation started by the given function.
+///
+template <typename T, typename Start>
+CompletionAwaitable<T, Start> awaitCompletion(Start start) {
+	return CompletionAwaitable<T, Start>(std::move(start));
+}
+
+///
+/// Returns an error of the given resource when it has failed and the error
+/// should be thrown.
+///
+template <typename ErrorType, typename ResourceType>
+std::exception_ptr resourceError(ResourceType &resource,
+		typename ResourceType::OnError onError) noexcept {
+	try {
+		if (onError == ResourceType::OnError::Throw && resource.hasFailed()) {
+			return std::make_exception_ptr(ErrorType(resource.getError()));
+		}
+		return nullptr;
+	} catch (...) {
+		return std::current_exception();
+	}
+}
+
+} // namespace internal
+
+///
+/// Awaitables adapting the asynchronous functions to coroutines.
+///
+/// The awaiting coroutine is resumed by the handler of the adapted function,
+/// i.e. on a thread of the I/O service shared by connections, or right away
+/// when the result is already available. Therefore, after resuming, the
+/// coroutine should not wait on the synchronous functions of the library; it
+/// should either await other operations or transfer itself to a thread of its
+/// own.
+///
+/// The awaited objects have to outlive the awaiting.
+///
+namespace coroutines {
+
+///
+/// Returns an awaitable of a decompilation started with the given arguments.
+///
+/// The result of awaiting is the started decompilation. See
+/// Decompiler::runDecompilationAsync() for the errors that may be thrown.
+///
+inline auto runDecompilation(Decompiler &decompiler,
+		const DecompilationArguments &args) {
+	return internal::awaitCompletion<std::unique_ptr<Decompilation>>(
+		[&decompiler, args](auto state) {
+			decompiler.runDecompilationAsync(args,
+				[state](std::unique_ptr<Decompilation> decompilation,
+						std::exception_ptr error) {
+					state->complete(error, std::move(decompilation));
+				}
+			);
+		}
+	);
+}
+
+///
+/// Returns an awaitable of an analysis started with the given arguments.
+///
+/// The result of awaiting is the started analysis. See
+/// Fileinfo::runAnalysisAsync() for the errors that may be thrown.
+///
+inline auto runAnalysis(Fileinfo &fileinfo, const AnalysisArguments &args) {
+	return internal::awaitCompletion<std::unique_ptr<Analysis>>(
+		[&fileinfo, args](auto state) {
+			fileinfo.runAnalysisAsync(args,
+				[state](std::unique_ptr<Analysis> analysis,
+						std::exception_ptr error) {
+					state->complete(error, std::move(analysis));
+				}
+			);
+		}
+	);
+}
+
+///
+/// Returns an awaitable that finishes when the given resource finishes.
+///
+/// Only errors that occur while waiting (e.g. when the status cannot be
+/// obtained) are thrown. Whether the resource has failed can be checked via
+/// Resource::hasFailed().
+///
+inline auto waitUntilFinished(Resource &resource) {
+	return internal::awaitCompletion<void>(
+		[&resource](auto state) {
+			resource.whenFinished([state](std::exception_ptr error) {
+				state->complete(error);
+			});
+		}
+	);
+}
+
+///
+/// Returns an awaitable that finishes when the given decompilation finishes.
+///
+/// When @a onError is Decompilation::OnError::Throw, DecompilationError is
+/// thrown when the decompilation fails.
+///
+inline auto waitUntilFinished(Decompilation &decompilation,
+		Decompilation::OnError onError = Decompilation::OnError::Throw) {
+	return internal::awaitCompletion<void>(
+		[&decompilation, onError](auto state) {
+			decompilation.whenFinished(
+				[&decompilation, onError, state](std::exception_ptr error) {
+					if (!error) {
+						error = internal::resourceError<DecompilationError>(
+							decompilation, onError);
+					}
+					state->complete(error);
+				}
+			);
+		}
+	);
+}
+
+///
+/// Returns an awaitable that finishes when the given analysis finishes.
+///
+/// When @a onError is Analysis::OnError::Throw, AnalysisError is thrown when
+/// the analysis fails.
+///
+inline auto waitUntilFinished(Analysis &analysis,
+		Analysis::OnError onError = Analysis::OnError::Throw) {
+	return internal::awaitCompletion<void>(
+		[&analysis, onError](auto state) {
+			analysis.whenFinished(
+				[&analysis, onError, state](std::exception_ptr error) {
+					if (!error) {
+						error = internal::resourceError<AnalysisError>(
+							analysis, onError);
+					}
+					state->complete(error);
+				}
+			);
+		}
+	);
+}
+
+///
+/// Returns an awaitable of the content of the output HLL file of the given
+/// decompilation.
+///
+/// See Decompilation::getOutputHllAsync() for details.
+///
+inline auto getOutputHll(Decompilation &decompilation) {
+	return internal::awaitCompletion<std::string>(
+		[&decompilation](auto state) {
+			decompilation.getOutputHllAsync(
+				[state](std::string content, std::exception_ptr error) {
+					state->complete(error, std::move(content));
+				}
+			);
+		}
+	);
+}
+
+} // namespace coroutines
+} // namespace retdec
+
+#endif
+
+#endif
@@ -8,19 +8,23 @@
 #ifndef RETDEC_DECOMPILATION_H
 #define RETDEC_DECOMPILATION_H
 
+#include <exception>
 #include <functional>
 #include <memory>
 #include <string>
 
+#include "retdec/file.h"
 #include "retdec/resource.h"
 
 namespace retdec {
 
 class File;
+class PollingPolicy;
 
 namespace internal {
 
 class Connection;
+struct ResourceContext;
 class DecompilationImpl;
 
 } // namespace internal
@@ -33,6 +37,11 @@ public:
 	/// Type of a callback for waitUntilFinished().
 	using Callback = std::function<void (const Decompilation &decompilation)>;
 
+	/// Type of a function to which the output HLL is passed by
+	/// getOutputHllAsync().
+	using OutputHllHandler = std::function<
+		void (std::string outputHll, std::exception_ptr error)>;
+
 	///
 	/// What should the waiting member functions do when a decompilation
 	/// fails?
@@ -46,6 +55,9 @@ public:
 	/// @cond internal
 	Decompilation(const std::string &id,
 		const std::shared_ptr<::retdec::internal::Connection> &conn);
+	Decompilation(const std::string &id,
+		const std::shared_ptr<::retdec::internal::Connection> &conn,
+		const ::retdec::internal::ResourceContext &context);
 	/// @endcond
 	virtual ~Decompilation() override;
 
@@ -60,12 +72,20 @@ public:
 	void waitUntilFinished(OnError onError = OnError::Throw);
 	void waitUntilFinished(const Callback &callback,
 		OnError onError = OnError::Throw);
+	void waitUntilFinished(const PollingPolicy &pollingPolicy,
+		OnError onError = OnError::Throw);
+	void waitUntilFinished(const Callback &callback,
+		const PollingPolicy &pollingPolicy, OnError onError = OnError::Throw);
 	/// @}
 
 	/// @name Obtaining Outputs
 	/// @{
 	std::shared_ptr<File> getOutputHllFile();
 	std::string getOutputHll();
+	File::ContentView getOutputHllView();
+	std::shared_ptr<File> downloadOutputHllFile(const std::string &directoryPath);
+	void streamOutputHll(const OutputHandler &outputHandler);
+	void getOutputHllAsync(const OutputHllHandler &handler);
 	/// @}
 
 private:
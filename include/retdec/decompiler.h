@@ -8,7 +8,12 @@
 #ifndef RETDEC_DECOMPILER_H
 #define RETDEC_DECOMPILER_H
 
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "retdec/service.h"
 
@@ -29,6 +34,12 @@ class ConnectionManager;
 /// Runner of decompilations.
 ///
 class Decompiler: public Service {
+public:
+	/// Type of a function to which a started decompilation is passed by
+	/// runDecompilationAsync().
+	using DecompilationHandler = std::function<void (
+		std::unique_ptr<Decompilation> decompilation, std::exception_ptr error)>;
+
 public:
 	/// @name Construction and Destruction
 	/// @{
@@ -44,6 +55,12 @@ public:
 	/// @{
 	std::unique_ptr<Decompilation> runDecompilation(
 		const DecompilationArguments &args);
+	std::future<std::unique_ptr<Decompilation>> runDecompilationAsync(
+		const DecompilationArguments &args);
+	void runDecompilationAsync(const DecompilationArguments &args,
+		const DecompilationHandler &handler);
+	std::unique_ptr<Decompilation> reattach(const std::string &id);
+	std::vector<std::string> journaledIds() const;
 	/// @}
 
 private:
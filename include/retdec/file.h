@@ -8,6 +8,9 @@
 #ifndef RETDEC_FILE_H
 #define RETDEC_FILE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <istream>
 #include <memory>
 #include <string>
 
@@ -17,20 +20,58 @@ namespace retdec {
 /// Base class and factory for files.
 ///
 class File {
+public:
+	///
+	/// Read-only view of the content of a file.
+	///
+	/// The view keeps the viewed bytes alive, so it stays valid even after the
+	/// file is destructed. Copying a view does not copy the bytes.
+	///
+	class ContentView {
+	public:
+		/// @cond internal
+		ContentView(std::shared_ptr<const void> owner, const char *data,
+			std::size_t size);
+		/// @endcond
+
+		const char *data() const noexcept;
+		std::size_t size() const noexcept;
+		bool empty() const noexcept;
+		std::string toString() const;
+
+	private:
+		/// Object owning the viewed bytes.
+		std::shared_ptr<const void> owner;
+
+		/// Pointer to the first viewed byte.
+		const char *data_;
+
+		/// Number of viewed bytes.
+		std::size_t size_;
+	};
+
 public:
 	virtual ~File() = 0;
 
 	virtual std::string getName() const = 0;
 	virtual std::string getContent() = 0;
+	virtual ContentView getContentView();
+	virtual std::uint64_t getSize();
+	virtual std::unique_ptr<std::istream> openContent();
 	virtual void saveCopyTo(const std::string &directoryPath) = 0;
 	virtual void saveCopyTo(const std::string &directoryPath,
 		const std::string &name) = 0;
 
 	static std::unique_ptr<File> fromContentWithName(
 		const std::string &content, const std::string &name);
+	static std::unique_ptr<File> fromContentWithName(
+		std::string &&content, const std::string &name);
+	static std::unique_ptr<File> fromSharedContentWithName(
+		std::shared_ptr<const std::string> content, const std::string &name);
 	static std::unique_ptr<File> fromFilesystem(const std::string &path);
 	static std::unique_ptr<File> fromFilesystemWithOtherName(
 		const std::string &path, const std::string &name);
+	static std::unique_ptr<File> fromFilesystemMapped(const std::string &path);
 
 	/// @name Disabled
 	/// @{
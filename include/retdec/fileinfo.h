@@ -8,7 +8,12 @@
 #ifndef RETDEC_FILEINFO_H
 #define RETDEC_FILEINFO_H
 
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "retdec/service.h"
 
@@ -29,6 +34,12 @@ class FileinfoImpl;
 /// Runner of analyses.
 ///
 class Fileinfo: public Service {
+public:
+	/// Type of a function to which a started analysis is passed by
+	/// runAnalysisAsync().
+	using AnalysisHandler = std::function<void (
+		std::unique_ptr<Analysis> analysis, std::exception_ptr error)>;
+
 public:
 	/// @name Construction and Destruction
 	/// @{
@@ -43,6 +54,12 @@ public:
 	/// @name Analyses
 	/// @{
 	std::unique_ptr<Analysis> runAnalysis(const AnalysisArguments &args);
+	std::future<std::unique_ptr<Analysis>> runAnalysisAsync(
+		const AnalysisArguments &args);
+	void runAnalysisAsync(const AnalysisArguments &args,
+		const AnalysisHandler &handler);
+	std::unique_ptr<Analysis> reattach(const std::string &id);
+	std::vector<std::string> journaledIds() const;
 	/// @}
 
 private:
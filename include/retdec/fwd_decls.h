@@ -28,10 +28,15 @@ class File;
 class Fileinfo;
 class FilesystemError;
 class IoError;
+class Metrics;
+class PollingPolicy;
+class RequestObserver;
 class Resource;
 class ResourceArguments;
+class ResourceGroup;
 class Service;
 class Settings;
+class Tracer;
 
 } // namespace retdec
 
@@ -0,0 +1,76 @@
+///
+/// @file      retdec/internal/clock.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Clocks measuring time and waiting while resources are polled.
+///
+
+#ifndef RETDEC_INTERNAL_CLOCK_H
+#define RETDEC_INTERNAL_CLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace retdec {
+namespace internal {
+
+///
+/// Base class of clocks measuring time and waiting while resources are
+/// polled.
+///
+class Clock {
+public:
+	/// Point in time.
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	/// Duration.
+	using Duration = std::chrono::steady_clock::duration;
+
+public:
+	virtual ~Clock() = 0;
+
+	virtual TimePoint now() const = 0;
+	virtual void sleepFor(std::chrono::milliseconds duration) = 0;
+
+	static std::shared_ptr<Clock> system();
+
+	/// @name Disabled
+	/// @{
+	Clock(const Clock &) = delete;
+	Clock(Clock &&) = delete;
+	Clock &operator=(const Clock &) = delete;
+	Clock &operator=(Clock &&) = delete;
+	/// @}
+
+protected:
+	Clock();
+};
+
+///
+/// Clock whose time passes only when it is told so.
+///
+/// Sleeping does not block; it just moves the time forward. This makes it
+/// possible to simulate hours of polling in milliseconds. It can be used from
+/// many threads at once, but the time it shows is deterministic only when a
+/// single thread moves it.
+///
+class VirtualClock: public Clock {
+public:
+	VirtualClock();
+	virtual ~VirtualClock() override;
+
+	virtual TimePoint now() const override;
+	virtual void sleepFor(std::chrono::milliseconds duration) override;
+
+	void advance(Duration duration);
+
+private:
+	/// Time elapsed since the clock was created.
+	std::atomic<Duration::rep> elapsed;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -8,6 +8,9 @@
 #ifndef RETDEC_INTERNAL_CONNECTION_H
 #define RETDEC_INTERNAL_CONNECTION_H
 
+#include <cstddef>
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -26,6 +29,9 @@ class File;
 
 namespace internal {
 
+class Clock;
+struct ResourceStatus;
+
 ///
 /// Base class of connections to the API.
 ///
@@ -41,8 +47,11 @@ public:
 		virtual int statusCode() const = 0;
 		virtual std::string statusMessage() const = 0;
 		virtual std::string body() const = 0;
+		virtual std::shared_ptr<const std::string> sharedBody() const;
 		virtual Json::Value bodyAsJson() const = 0;
+		virtual ResourceStatus bodyAsStatus() const;
 		virtual std::unique_ptr<File> bodyAsFile() const = 0;
+		virtual std::string attachedFileName() const = 0;
 
 	protected:
 		Response();
@@ -69,6 +78,14 @@ public:
 	/// Files passed to a request.
 	using RequestFiles = std::map<FileArgumentName, std::shared_ptr<File>>;
 
+	/// Function receiving parts of a response body as they arrive.
+	using BodyHandler = std::function<void (const char *data, std::size_t size)>;
+
+	/// Function receiving the result of an asynchronous request (either the
+	/// response or the error that occurred).
+	using ResponseHandler = std::function<
+		void (std::unique_ptr<Response> response, std::exception_ptr error)>;
+
 public:
 	virtual ~Connection() = 0;
 
@@ -79,6 +96,21 @@ public:
 		const RequestArguments &args) = 0;
 	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
 		const RequestArguments &args, const RequestFiles &files) = 0;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler);
+
+	/// @name Asynchronous Requests
+	/// @{
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler);
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler);
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler);
+	/// @}
+
+	virtual std::shared_ptr<Clock> clock() const;
 
 protected:
 	Connection();
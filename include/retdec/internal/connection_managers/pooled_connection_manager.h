@@ -0,0 +1,53 @@
+///
+/// @file      retdec/internal/connection_managers/pooled_connection_manager.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Manager of pooled connections to the API.
+///
+
+#ifndef RETDEC_INTERNAL_CONNECTION_MANAGERS_POOLED_CONNECTION_MANAGER_H
+#define RETDEC_INTERNAL_CONNECTION_MANAGERS_POOLED_CONNECTION_MANAGER_H
+
+#include <memory>
+
+#include "retdec/internal/connection_manager.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Manager of pooled connections to the API.
+///
+/// Connections returned from newConnection() are lightweight handles. Every
+/// request sent through them borrows an underlying connection from a bounded
+/// pool, so resources created by the same service share a small number of
+/// connections instead of each creating its own one. The underlying
+/// connections keep their network connections open between requests, so the
+/// handshakes are performed only once per connection. There is a separate pool
+/// for every API URL, credentials, pool size, maximal connection count, and
+/// idle timeout (all taken from Settings). The maximal connection count limits
+/// the number of connections used at once, while the pool size limits the
+/// number of idle connections kept for later requests. A pooled connection is
+/// considered to be stale after it has been idle for the idle timeout. Pools
+/// that are no longer used are removed.
+///
+class PooledConnectionManager: public ConnectionManager {
+public:
+	PooledConnectionManager();
+	explicit PooledConnectionManager(
+		const std::shared_ptr<ConnectionManager> &connectionFactory);
+	virtual ~PooledConnectionManager() override;
+
+	virtual std::shared_ptr<Connection> newConnection(
+		const Settings &settings) override;
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
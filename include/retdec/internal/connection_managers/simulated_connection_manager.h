@@ -0,0 +1,46 @@
+///
+/// @file      retdec/internal/connection_managers/simulated_connection_manager.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Manager of connections to a simulation of the API.
+///
+
+#ifndef RETDEC_INTERNAL_CONNECTION_MANAGERS_SIMULATED_CONNECTION_MANAGER_H
+#define RETDEC_INTERNAL_CONNECTION_MANAGERS_SIMULATED_CONNECTION_MANAGER_H
+
+#include <memory>
+
+#include "retdec/internal/connection_manager.h"
+
+namespace retdec {
+namespace internal {
+
+class SimulatedService;
+
+///
+/// Manager of connections to a simulation of the API running in memory.
+///
+/// All the created connections are connected to the same simulation, so
+/// services using the manager (e.g. Decompiler or Fileinfo) can be run against
+/// the simulation instead of the real API.
+///
+class SimulatedConnectionManager: public ConnectionManager {
+public:
+	explicit SimulatedConnectionManager(
+		const std::shared_ptr<SimulatedService> &service);
+	virtual ~SimulatedConnectionManager() override;
+
+	virtual std::shared_ptr<Connection> newConnection(
+		const Settings &settings) override;
+
+	std::shared_ptr<SimulatedService> service() const;
+
+private:
+	/// Simulation to which connections are connected.
+	const std::shared_ptr<SimulatedService> service_;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,88 @@
+///
+/// @file      retdec/internal/connections/caching_connection.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Connection wrapper caching responses of a resource on disk.
+///
+
+#ifndef RETDEC_INTERNAL_CONNECTIONS_CACHING_CONNECTION_H
+#define RETDEC_INTERNAL_CONNECTIONS_CACHING_CONNECTION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+class ResultCache;
+
+///
+/// Connection wrapper caching responses of a resource on disk.
+///
+/// This class wraps an existing connection used by a single resource. GET
+/// requests to the URLs of the resource are served from an entry of a result
+/// cache when the entry contains their responses. Otherwise, they are sent over
+/// the wrapped connection and successful responses are stored into the entry.
+/// The status of the resource is stored only when the resource has finished
+/// successfully, so an unfinished or failed resource is never served from the
+/// cache. Before the status is stored and passed on, the outputs of the
+/// resource that are not in the entry yet are downloaded into it, so a
+/// resource served from the cache does not need to access the API at all.
+/// Other requests are just passed to the wrapped connection.
+///
+class CachingConnection: public Connection {
+public:
+	CachingConnection(const std::shared_ptr<Connection> &conn,
+		const std::shared_ptr<ResultCache> &cache,
+		const std::string &cacheKey, const Url &resourceUrl,
+		const std::vector<std::string> &outputPaths);
+	virtual ~CachingConnection() override;
+
+	virtual Url getApiUrl() const override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url) override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url,
+		const RequestArguments &args) override;
+	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
+		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) override;
+	virtual std::shared_ptr<Clock> clock() const override;
+
+private:
+	std::string responseName(const Url &url) const;
+	std::unique_ptr<Response> downloadIntoCache(const Url &url,
+		const std::string &name, const BodyHandler &bodyHandler);
+	bool downloadOutputsIntoCache();
+
+private:
+	/// Wrapped connection.
+	const std::shared_ptr<Connection> conn;
+
+	/// Cache of the responses.
+	const std::shared_ptr<ResultCache> cache;
+
+	/// Key of the entry of the resource in the cache.
+	const std::string cacheKey;
+
+	/// URL of the resource.
+	const Url resourceUrl;
+
+	/// Paths to the outputs of the resource (relative to its URL).
+	const std::vector<std::string> outputPaths;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,74 @@
+///
+/// @file      retdec/internal/connections/journaling_connection.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Connection wrapper marking a journaled resource as finished.
+///
+
+#ifndef RETDEC_INTERNAL_CONNECTIONS_JOURNALING_CONNECTION_H
+#define RETDEC_INTERNAL_CONNECTIONS_JOURNALING_CONNECTION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+class SubmissionJournal;
+
+///
+/// Connection wrapper marking a journaled resource as finished.
+///
+/// This class wraps an existing connection used by a single resource. The
+/// resource is marked as finished in a journal of started resources only when
+/// nothing more is to be obtained from it, so a resource whose outputs have
+/// not been downloaded yet can still be reattached to after a crash. That is,
+/// when a response to a GET request to the status of the resource says that
+/// the resource has finished without succeeding (it has no outputs), or when
+/// all outputs of the resource have been successfully downloaded. All requests
+/// are passed to the wrapped connection.
+///
+class JournalingConnection: public Connection {
+public:
+	JournalingConnection(const std::shared_ptr<Connection> &conn,
+		const std::shared_ptr<SubmissionJournal> &journal,
+		const Url &resourcesUrl, const std::string &id,
+		const std::vector<std::string> &outputPaths);
+	virtual ~JournalingConnection() override;
+
+	virtual Url getApiUrl() const override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url) override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url,
+		const RequestArguments &args) override;
+	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
+		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) override;
+	virtual std::shared_ptr<Clock> clock() const override;
+
+private:
+	struct Progress;
+
+	/// Wrapped connection.
+	const std::shared_ptr<Connection> conn;
+
+	/// Progress of obtaining the results of the resource. It is shared with
+	/// handlers of asynchronous requests, which may outlive the wrapper.
+	const std::shared_ptr<Progress> progress;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -21,6 +21,12 @@ namespace internal {
 ///
 /// Connection to the API.
 ///
+/// Requests are sent by an HTTP client that keeps its connections open, so
+/// subsequent requests skip the TCP and TLS handshakes. Synchronous requests
+/// are sent and received on the calling thread. Asynchronous requests are sent
+/// on the I/O service shared by all connections without blocking its threads,
+/// and their handlers are called from these threads.
+///
 class RealConnection: public Connection {
 public:
 	RealConnection(const Settings &settings);
@@ -33,6 +39,16 @@ public:
 		const RequestArguments &args) override;
 	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
 		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) override;
 
 private:
 	struct Impl;
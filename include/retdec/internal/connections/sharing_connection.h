@@ -0,0 +1,78 @@
+///
+/// @file      retdec/internal/connections/sharing_connection.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Connection wrapper sharing responses between handles of a
+///            resource.
+///
+
+#ifndef RETDEC_INTERNAL_CONNECTIONS_SHARING_CONNECTION_H
+#define RETDEC_INTERNAL_CONNECTIONS_SHARING_CONNECTION_H
+
+#include <memory>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+class InFlightResource;
+
+///
+/// Connection wrapper sharing responses between handles of a resource.
+///
+/// This class wraps an existing connection used by a single handle of an
+/// in-flight resource. A GET request to a URL of the resource is sent only when
+/// the same request of another handle is not in progress; otherwise, the
+/// response to that request is used. Successful responses with outputs and the
+/// final status of the resource are kept, so they are obtained only once for
+/// all the handles. Other requests are just passed to the wrapped connection.
+/// Synchronous requests sent from worker threads of the I/O service never wait
+/// for requests of other handles.
+///
+class SharingConnection: public Connection {
+public:
+	SharingConnection(const std::shared_ptr<Connection> &conn,
+		const std::shared_ptr<InFlightResource> &resource,
+		const Url &resourceUrl);
+	virtual ~SharingConnection() override;
+
+	virtual Url getApiUrl() const override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url) override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url,
+		const RequestArguments &args) override;
+	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
+		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) override;
+	virtual std::shared_ptr<Clock> clock() const override;
+
+private:
+	bool isResourceUrl(const Url &url) const;
+
+private:
+	/// Wrapped connection.
+	const std::shared_ptr<Connection> conn;
+
+	/// Resource whose responses are shared.
+	const std::shared_ptr<InFlightResource> resource;
+
+	/// URL of the resource.
+	const Url resourceUrl;
+
+	/// URL of the status of the resource.
+	const Url statusUrl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
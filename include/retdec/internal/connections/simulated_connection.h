@@ -0,0 +1,52 @@
+///
+/// @file      retdec/internal/connections/simulated_connection.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Connection to a simulation of the API running in memory.
+///
+
+#ifndef RETDEC_INTERNAL_CONNECTIONS_SIMULATED_CONNECTION_H
+#define RETDEC_INTERNAL_CONNECTIONS_SIMULATED_CONNECTION_H
+
+#include <memory>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+class SimulatedService;
+
+///
+/// Connection to a simulation of the API running in memory.
+///
+/// Requests are handled by the simulation, without any network traffic, and
+/// waiting for resources is timed by the virtual clock of the simulation.
+/// Asynchronous requests are handled before the functions sending them return.
+///
+class SimulatedConnection: public Connection {
+public:
+	SimulatedConnection(const std::shared_ptr<SimulatedService> &service,
+		const Url &apiUrl);
+	virtual ~SimulatedConnection() override;
+
+	virtual Url getApiUrl() const override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url) override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url,
+		const RequestArguments &args) override;
+	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
+		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::shared_ptr<Clock> clock() const override;
+
+private:
+	/// Simulation handling the requests.
+	const std::shared_ptr<SimulatedService> service;
+
+	/// URL to the API.
+	const Url apiUrl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,37 @@
+///
+/// @file      retdec/internal/files/content_view_stream.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Stream reading a view of the content of a file.
+///
+
+#ifndef RETDEC_INTERNAL_FILES_CONTENT_VIEW_STREAM_H
+#define RETDEC_INTERNAL_FILES_CONTENT_VIEW_STREAM_H
+
+#include <boost/interprocess/streams/bufferstream.hpp>
+
+#include "retdec/file.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Stream reading a view of the content of a file.
+///
+/// The stream reads straight from the viewed bytes, without copying them, and
+/// keeps them alive.
+///
+class ContentViewStream: public boost::interprocess::ibufferstream {
+public:
+	explicit ContentViewStream(const File::ContentView &view);
+	virtual ~ContentViewStream() override;
+
+private:
+	/// View that is read.
+	const File::ContentView view;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
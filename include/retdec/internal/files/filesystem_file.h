@@ -26,6 +26,8 @@ public:
 
 	virtual std::string getName() const override;
 	virtual std::string getContent() override;
+	virtual std::uint64_t getSize() override;
+	virtual std::unique_ptr<std::istream> openContent() override;
 	virtual void saveCopyTo(const std::string &directoryPath) override;
 	virtual void saveCopyTo(const std::string &directoryPath,
 		const std::string &name) override;
@@ -0,0 +1,56 @@
+///
+/// @file      retdec/internal/files/mapped_file.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     File stored in a filesystem and mapped into memory.
+///
+
+#ifndef RETDEC_INTERNAL_FILES_MAPPED_FILE_H
+#define RETDEC_INTERNAL_FILES_MAPPED_FILE_H
+
+#include <memory>
+
+#include "retdec/internal/files/filesystem_file.h"
+
+namespace boost {
+namespace interprocess {
+
+class mapped_region;
+
+} // namespace interprocess
+} // namespace boost
+
+namespace retdec {
+namespace internal {
+
+///
+/// File stored in a filesystem and mapped into memory.
+///
+/// The file is mapped when it is constructed. When it cannot be mapped, it
+/// behaves like FilesystemFile.
+///
+class MappedFile: public FilesystemFile {
+public:
+	explicit MappedFile(const std::string &path);
+	MappedFile(const std::string &path, const std::string &name);
+	virtual ~MappedFile() override;
+
+	bool isMapped() const noexcept;
+
+	virtual std::string getContent() override;
+	virtual ContentView getContentView() override;
+	virtual std::uint64_t getSize() override;
+	virtual std::unique_ptr<std::istream> openContent() override;
+
+private:
+	void map(const std::string &path);
+
+private:
+	/// Region into which the file is mapped (null when it is not mapped).
+	std::shared_ptr<const boost::interprocess::mapped_region> region;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -8,6 +8,7 @@
 #ifndef RETDEC_INTERNAL_FILES_STRING_FILE_H
 #define RETDEC_INTERNAL_FILES_STRING_FILE_H
 
+#include <memory>
 #include <string>
 
 #include "retdec/file.h"
@@ -22,17 +23,21 @@ class StringFile: public File {
 public:
 	explicit StringFile(std::string content);
 	StringFile(std::string content, std::string name);
+	StringFile(std::shared_ptr<const std::string> content, std::string name);
 	virtual ~StringFile() override;
 
 	virtual std::string getName() const override;
 	virtual std::string getContent() override;
+	virtual ContentView getContentView() override;
+	virtual std::uint64_t getSize() override;
+	virtual std::unique_ptr<std::istream> openContent() override;
 	virtual void saveCopyTo(const std::string &directoryPath) override;
 	virtual void saveCopyTo(const std::string &directoryPath,
 		const std::string &name) override;
 
 private:
-	/// Content of the file.
-	std::string content;
+	/// Content of the file (may be shared with the object it came from).
+	std::shared_ptr<const std::string> content;
 
 	/// Name of the file.
 	std::string name;
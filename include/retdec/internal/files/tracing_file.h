@@ -0,0 +1,58 @@
+///
+/// @file      retdec/internal/files/tracing_file.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     File wrapper tracing the saving of copies of the file.
+///
+
+#ifndef RETDEC_INTERNAL_FILES_TRACING_FILE_H
+#define RETDEC_INTERNAL_FILES_TRACING_FILE_H
+
+#include <memory>
+#include <string>
+
+#include "retdec/file.h"
+
+namespace retdec {
+namespace internal {
+
+class TraceBuffer;
+
+///
+/// File wrapper tracing the saving of copies of the file.
+///
+/// This class wraps an existing file (e.g. an output of a resource). Every
+/// saving of a copy of the file is recorded as a @c saveCopyTo span on the
+/// given track. Everything else is just passed to the wrapped file.
+///
+class TracingFile: public File {
+public:
+	TracingFile(const std::shared_ptr<File> &file,
+		const std::shared_ptr<TraceBuffer> &traceBuffer,
+		const std::string &track);
+	virtual ~TracingFile() override;
+
+	virtual std::string getName() const override;
+	virtual std::string getContent() override;
+	virtual ContentView getContentView() override;
+	virtual std::uint64_t getSize() override;
+	virtual std::unique_ptr<std::istream> openContent() override;
+	virtual void saveCopyTo(const std::string &directoryPath) override;
+	virtual void saveCopyTo(const std::string &directoryPath,
+		const std::string &name) override;
+
+private:
+	/// Wrapped file.
+	const std::shared_ptr<File> file;
+
+	/// Buffer into which the spans are recorded.
+	const std::shared_ptr<TraceBuffer> traceBuffer;
+
+	/// Track on which the spans are shown.
+	const std::string track;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
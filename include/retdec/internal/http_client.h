@@ -0,0 +1,151 @@
+///
+/// @file      retdec/internal/http_client.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     HTTP/1.1 client keeping its connections open.
+///
+
+#ifndef RETDEC_INTERNAL_HTTP_CLIENT_H
+#define RETDEC_INTERNAL_HTTP_CLIENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace retdec {
+namespace internal {
+
+class IoService;
+
+///
+/// HTTP/1.1 client keeping its connections open.
+///
+/// A connection is kept open after a response has been received over it, so
+/// further requests to the same host skip name resolution and the TCP and TLS
+/// handshakes. A kept-alive connection that has been closed by the server in
+/// the meantime is detected and closed before it is used. Requests sent at
+/// the same time use separate connections.
+///
+/// Requests can be sent either synchronously, in which case all the I/O is
+/// performed on the calling thread, or asynchronously, in which case it is
+/// performed on threads of the given I/O service without blocking any of them.
+/// Both kinds of requests share the kept-alive connections.
+///
+/// All errors that occur while sending a request or receiving its response
+/// are reported as ConnectionError. Exceptions thrown from the generator of
+/// the body of the request or from the handlers are reported as they are.
+/// After an error, the connection is closed.
+///
+class HttpClient {
+public:
+	/// Headers (names and values, in the order of their appearance).
+	using Headers = std::vector<std::pair<std::string, std::string>>;
+
+	/// Function generating the body of a request in chunks. It stores the
+	/// next chunk into the given string and returns @c false when there are
+	/// no more chunks.
+	using BodyGenerator = std::function<bool (std::string &chunk)>;
+
+	///
+	/// Phase of sending a request.
+	///
+	enum class Phase {
+		Resolved,         ///< The host name has been resolved.
+		Connected,        ///< The TCP connection has been established.
+		TlsHandshakeDone, ///< The TLS handshake has finished.
+		RequestWritten    ///< The whole request has been written.
+	};
+
+	/// Function called when a phase of sending a request finishes.
+	using PhaseHandler = std::function<void (Phase phase)>;
+
+	///
+	/// Request to be sent.
+	///
+	struct Request {
+		/// Method (e.g. @c GET).
+		std::string method;
+
+		/// Absolute URL (including the query), either @c http or @c https.
+		std::string url;
+
+		/// Additional headers (@c Host and @c Content-Length are added by the
+		/// client).
+		Headers headers;
+
+		/// Generator of the body (empty when the request has no body).
+		BodyGenerator body;
+
+		/// Size of the body generated by @c body (in bytes).
+		std::uint64_t bodySize = 0;
+
+		/// Function called when a phase of sending the request finishes
+		/// (may be empty). The phases of establishing a connection are
+		/// reported only when no kept-alive connection is reused, and the TLS
+		/// handshake only for @c https URLs. It is called from the same
+		/// threads as the other handlers and it should not throw.
+		PhaseHandler phaseHandler;
+	};
+
+	///
+	/// Status and headers of a received response.
+	///
+	struct Response {
+		std::string header(const std::string &name) const;
+
+		/// Status code.
+		int statusCode = 0;
+
+		/// Status message (reason phrase).
+		std::string statusMessage;
+
+		/// Headers.
+		Headers headers;
+	};
+
+	/// Function receiving the status and headers of a response, before its
+	/// body.
+	using HeadHandler = std::function<void (const Response &response)>;
+
+	/// Function receiving parts of the body of a response as they arrive.
+	using BodyHandler = std::function<void (const char *data, std::size_t size)>;
+
+	/// Function called when an asynchronous request finishes (with the error
+	/// that occurred, or null when the whole response has been received).
+	using CompletionHandler = std::function<void (std::exception_ptr error)>;
+
+public:
+	explicit HttpClient(std::shared_ptr<IoService> ioService);
+	~HttpClient();
+
+	void send(const Request &request, const HeadHandler &headHandler,
+		const BodyHandler &bodyHandler);
+	void sendAsync(const Request &request, const HeadHandler &headHandler,
+		const BodyHandler &bodyHandler,
+		const CompletionHandler &completionHandler);
+
+	std::size_t idleConnectionCount() const;
+
+	/// @name Disabled
+	/// @{
+	HttpClient(const HttpClient &) = delete;
+	HttpClient(HttpClient &&) = delete;
+	HttpClient &operator=(const HttpClient &) = delete;
+	HttpClient &operator=(HttpClient &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation (shared with pending asynchronous requests).
+	std::shared_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
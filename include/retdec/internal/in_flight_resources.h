@@ -0,0 +1,118 @@
+///
+/// @file      retdec/internal/in_flight_resources.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Resources shared by identical runs that are in progress.
+///
+
+#ifndef RETDEC_INTERNAL_IN_FLIGHT_RESOURCES_H
+#define RETDEC_INTERNAL_IN_FLIGHT_RESOURCES_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Resource shared by identical runs that are in progress.
+///
+/// The first run starts the resource and the others wait until its ID is
+/// known. Then, every run gets its own handle of the resource, but identical
+/// GET requests of the handles are sent only once: a request sent while the
+/// same request of another handle is in progress gets the same response, and
+/// the responses that do not change anymore (e.g. outputs) are kept for all the
+/// handles.
+///
+class InFlightResource {
+public:
+	/// Function called when the resource is started (with the error that
+	/// occurred if it could not be started).
+	using StartedHandler = std::function<void (const std::string &id,
+		std::exception_ptr error)>;
+
+public:
+	InFlightResource();
+	~InFlightResource();
+
+	/// @name Starting
+	/// @{
+	void started(const std::string &id);
+	void failedToStart(std::exception_ptr error);
+	void whenStarted(const StartedHandler &handler);
+	std::string waitUntilStarted();
+	bool hasFailedToStart() const;
+	/// @}
+
+	/// @name Finishing
+	/// @{
+	void finished();
+	bool hasFinished() const;
+	/// @}
+
+	/// @name Sharing Responses
+	/// @{
+	bool joinRequest(const Connection::Url &url,
+		const Connection::ResponseHandler &responseHandler);
+	void completeRequest(const Connection::Url &url,
+		std::unique_ptr<Connection::Response> response,
+		std::exception_ptr error, bool keepResponse);
+	std::unique_ptr<Connection::Response> keptResponse(
+		const Connection::Url &url) const;
+	/// @}
+
+	/// @name Disabled
+	/// @{
+	InFlightResource(const InFlightResource &) = delete;
+	InFlightResource(InFlightResource &&) = delete;
+	InFlightResource &operator=(const InFlightResource &) = delete;
+	InFlightResource &operator=(InFlightResource &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+///
+/// Resources shared by identical runs that are in progress, addressed by keys
+/// of resources (see resourceKey()).
+///
+/// Resources are held only by their handles, so a resource is forgotten when
+/// all its handles are destructed. A resource that has finished or that could
+/// not be started is not shared with new runs.
+///
+class InFlightResources {
+public:
+	InFlightResources();
+	~InFlightResources();
+
+	std::pair<std::shared_ptr<InFlightResource>, bool> join(
+		const std::string &key);
+	std::size_t size() const;
+
+	/// @name Disabled
+	/// @{
+	InFlightResources(const InFlightResources &) = delete;
+	InFlightResources(InFlightResources &&) = delete;
+	InFlightResources &operator=(const InFlightResources &) = delete;
+	InFlightResources &operator=(InFlightResources &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
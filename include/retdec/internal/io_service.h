@@ -0,0 +1,55 @@
+///
+/// @file      retdec/internal/io_service.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     I/O service shared by connections to the API.
+///
+
+#ifndef RETDEC_INTERNAL_IO_SERVICE_H
+#define RETDEC_INTERNAL_IO_SERVICE_H
+
+#include <cstddef>
+#include <memory>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace retdec {
+namespace internal {
+
+///
+/// I/O service with a fixed number of worker threads.
+///
+/// HTTP clients of connections are given the underlying Boost.Asio service
+/// instead of creating their own one, so the number of I/O services and
+/// threads does not grow with the number of connections.
+///
+class IoService {
+public:
+	explicit IoService(std::size_t threadCount);
+	~IoService();
+
+	boost::shared_ptr<boost::asio::io_service> asioService() const;
+	std::size_t threadCount() const;
+
+	static std::shared_ptr<IoService> shared(std::size_t threadCount);
+	static bool isWorkerThread();
+
+	/// @name Disabled
+	/// @{
+	IoService(const IoService &) = delete;
+	IoService(IoService &&) = delete;
+	IoService &operator=(const IoService &) = delete;
+	IoService &operator=(IoService &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,225 @@
+///
+/// @file      retdec/internal/metrics_registry.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Registry of metrics of requests and resources.
+///
+
+#ifndef RETDEC_INTERNAL_METRICS_REGISTRY_H
+#define RETDEC_INTERNAL_METRICS_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace retdec {
+namespace internal {
+
+struct ResourceStatus;
+
+///
+/// Counter that can be incremented from many threads at once.
+///
+/// The value is split into stripes, each in its own cache line. Every thread
+/// increments the stripe assigned to it, so threads do not contend for the
+/// same cache line and no locks are needed.
+///
+class Counter {
+public:
+	Counter();
+
+	void increment(std::uint64_t n = 1) noexcept;
+	std::uint64_t value() const noexcept;
+
+	/// @name Disabled
+	/// @{
+	Counter(const Counter &) = delete;
+	Counter(Counter &&) = delete;
+	Counter &operator=(const Counter &) = delete;
+	Counter &operator=(Counter &&) = delete;
+	/// @}
+
+	/// Number of stripes.
+	static const std::size_t StripeCount = 16;
+
+private:
+	///
+	/// Part of the value occupying a whole cache line.
+	///
+	struct Stripe {
+		/// Part of the value.
+		std::atomic<std::uint64_t> value;
+
+		/// Padding up to the size of a cache line.
+		char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+	};
+
+private:
+	/// Stripes of the value.
+	std::array<Stripe, StripeCount> stripes;
+};
+
+///
+/// Histogram of durations that can be updated from many threads at once.
+///
+/// Durations are recorded in microseconds into log-linear buckets, like in HDR
+/// histograms: every power of two is split into SubBucketCount buckets of the
+/// same width, so the relative error of a recorded duration is at most 25 %
+/// over the whole range, from a microsecond to days.
+///
+class Histogram {
+public:
+	Histogram();
+
+	void record(std::chrono::microseconds duration) noexcept;
+
+	std::uint64_t count() const noexcept;
+	std::uint64_t sumInMicroseconds() const noexcept;
+	std::uint64_t bucketCount(std::size_t index) const noexcept;
+
+	static std::size_t bucketIndex(std::uint64_t microseconds) noexcept;
+	static std::uint64_t bucketLowerBound(std::size_t index) noexcept;
+
+	/// @name Disabled
+	/// @{
+	Histogram(const Histogram &) = delete;
+	Histogram(Histogram &&) = delete;
+	Histogram &operator=(const Histogram &) = delete;
+	Histogram &operator=(Histogram &&) = delete;
+	/// @}
+
+	/// Number of bits distinguishing the buckets of a power of two.
+	static const std::size_t SubBucketBits = 2;
+
+	/// Number of buckets per power of two.
+	static const std::size_t SubBucketCount = 1 << SubBucketBits;
+
+	/// Largest power of two whose buckets are kept. Longer durations are
+	/// recorded into the last bucket.
+	static const std::size_t MaxExponent = 40;
+
+	/// Number of buckets.
+	static const std::size_t BucketCount =
+		SubBucketCount + (MaxExponent - SubBucketBits + 1) * SubBucketCount;
+
+private:
+	/// Numbers of durations in the buckets.
+	std::array<std::atomic<std::uint64_t>, BucketCount> buckets;
+
+	/// Sum of all durations (in microseconds).
+	std::atomic<std::uint64_t> sum;
+};
+
+///
+/// Registry of metrics of requests and resources.
+///
+/// The metrics are split by service and, for requests, by status code. Nothing
+/// is locked when a metric is updated, so the registry can be updated from
+/// many threads at once. Series of metrics are created when they are first
+/// updated, and only created series are exported.
+///
+class MetricsRegistry {
+public:
+	///
+	/// Service to which metrics belong.
+	///
+	enum class Service {
+		Decompiler,
+		Fileinfo,
+		Test,
+		Other
+	};
+
+	/// Number of services.
+	static const std::size_t ServiceCount = 4;
+
+	/// Clock used to measure durations.
+	using Clock = std::chrono::steady_clock;
+
+public:
+	MetricsRegistry();
+	~MetricsRegistry();
+
+	static Service serviceFromName(const std::string &name);
+	static Service serviceFromUrl(const std::string &apiUrl,
+		const std::string &url);
+
+	/// @name Recording
+	/// @{
+	void requestFinished(Service service, int statusCode,
+		Clock::duration duration) noexcept;
+	void requestFailed(Service service) noexcept;
+	void statusPolled(Service service) noexcept;
+	void resourceFinished(Service service, bool succeeded,
+		Clock::duration duration) noexcept;
+	/// @}
+
+	/// @name Exporting
+	/// @{
+	std::string toPrometheusText() const;
+	/// @}
+
+	/// @name Disabled
+	/// @{
+	MetricsRegistry(const MetricsRegistry &) = delete;
+	MetricsRegistry(MetricsRegistry &&) = delete;
+	MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+	MetricsRegistry &operator=(MetricsRegistry &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+///
+/// Metrics of a single resource.
+///
+/// The duration of a resource is measured from the creation of the metrics
+/// until a finished status is received. It is recorded only once and only for
+/// resources that have just been started, so that resources that were started
+/// earlier (e.g. reattached ones or those from the result cache) are not
+/// recorded. It can be used from many threads at once.
+///
+class ResourceMetrics {
+public:
+	ResourceMetrics(const std::shared_ptr<MetricsRegistry> &registry,
+		MetricsRegistry::Service service, bool measureDuration = true);
+
+	void statusPolled() noexcept;
+	void statusReceived(const ResourceStatus &status) noexcept;
+
+	/// @name Disabled
+	/// @{
+	ResourceMetrics(const ResourceMetrics &) = delete;
+	ResourceMetrics(ResourceMetrics &&) = delete;
+	ResourceMetrics &operator=(const ResourceMetrics &) = delete;
+	ResourceMetrics &operator=(ResourceMetrics &&) = delete;
+	/// @}
+
+private:
+	/// Registry into which the metrics are recorded.
+	const std::shared_ptr<MetricsRegistry> registry;
+
+	/// Service of the resource.
+	const MetricsRegistry::Service service;
+
+	/// When the metrics were created.
+	const MetricsRegistry::Clock::time_point created;
+
+	/// Should the duration of the resource be recorded?
+	const bool measureDuration;
+
+	/// Has the duration of the resource been recorded?
+	std::atomic<bool> finishedRecorded;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
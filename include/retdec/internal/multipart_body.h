@@ -0,0 +1,92 @@
+///
+/// @file      retdec/internal/multipart_body.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Body of a multipart/form-data request.
+///
+
+#ifndef RETDEC_INTERNAL_MULTIPART_BODY_H
+#define RETDEC_INTERNAL_MULTIPART_BODY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Body of a @c multipart/form-data request, generated in chunks.
+///
+/// The content of the files is read only when the body is being sent, one
+/// chunk at a time, so the memory needed to send a request does not depend on
+/// the size of the sent files. The size of the body is computed from the sizes
+/// of the files when the body is created, so when a file changes its size in
+/// the meantime, FilesystemError is thrown from the generation.
+///
+class MultipartBody {
+public:
+	MultipartBody(const Connection::RequestFiles &files,
+		const std::string &boundary);
+
+	std::uint64_t size() const;
+	bool operator()(std::string &chunk);
+
+	/// Maximal size of a generated chunk (in bytes).
+	static const std::size_t ChunkSize = 64 * 1024;
+
+private:
+	///
+	/// Part of the body.
+	///
+	struct Part {
+		/// Text preceding the content of the file.
+		std::string header;
+
+		/// File whose content forms the part.
+		std::shared_ptr<File> file;
+
+		/// Size of the file when the body was created (in bytes).
+		std::uint64_t fileSize;
+	};
+
+	///
+	/// State of the generation.
+	///
+	/// It is shared because cpp-netlib copies the generator.
+	///
+	struct State {
+		/// Parts of the body.
+		std::vector<Part> parts;
+
+		/// Text following the last part.
+		std::string trailer;
+
+		/// Index of the part whose content is being generated.
+		std::size_t currentPart = 0;
+
+		/// Content of the current part (when it is being read).
+		std::unique_ptr<std::istream> currentContent;
+
+		/// Number of bytes of the content of the current part generated so
+		/// far.
+		std::uint64_t currentContentSize = 0;
+
+		/// Has the trailer been generated?
+		bool trailerGenerated = false;
+	};
+
+private:
+	/// State of the generation.
+	std::shared_ptr<State> state;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,42 @@
+///
+/// @file      retdec/internal/polling_policies/deadline_aware_polling_policy.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Policy making sure that a status is polled right at a deadline.
+///
+
+#ifndef RETDEC_INTERNAL_POLLING_POLICIES_DEADLINE_AWARE_POLLING_POLICY_H
+#define RETDEC_INTERNAL_POLLING_POLICIES_DEADLINE_AWARE_POLLING_POLICY_H
+
+#include <chrono>
+#include <memory>
+
+#include "retdec/polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Policy that makes sure that a status is polled right at a deadline.
+///
+class DeadlineAwarePollingPolicy: public PollingPolicy {
+public:
+	DeadlineAwarePollingPolicy(std::shared_ptr<const PollingPolicy> policy,
+		std::chrono::milliseconds deadline);
+	virtual ~DeadlineAwarePollingPolicy() override;
+
+	virtual std::chrono::milliseconds nextDelay(
+		const Progress &progress) const override;
+
+private:
+	/// Policy deciding the delays before the deadline.
+	const std::shared_ptr<const PollingPolicy> policy;
+
+	/// Deadline (measured from the start of the waiting).
+	const std::chrono::milliseconds deadline;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
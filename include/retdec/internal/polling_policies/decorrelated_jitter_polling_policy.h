@@ -0,0 +1,41 @@
+///
+/// @file      retdec/internal/polling_policies/decorrelated_jitter_polling_policy.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Policy polling statuses with a randomized, decorrelated delay.
+///
+
+#ifndef RETDEC_INTERNAL_POLLING_POLICIES_DECORRELATED_JITTER_POLLING_POLICY_H
+#define RETDEC_INTERNAL_POLLING_POLICIES_DECORRELATED_JITTER_POLLING_POLICY_H
+
+#include <chrono>
+
+#include "retdec/polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Policy polling statuses with a randomized, decorrelated delay.
+///
+class DecorrelatedJitterPollingPolicy: public PollingPolicy {
+public:
+	DecorrelatedJitterPollingPolicy(std::chrono::milliseconds baseDelay,
+		std::chrono::milliseconds maxDelay);
+	virtual ~DecorrelatedJitterPollingPolicy() override;
+
+	virtual std::chrono::milliseconds nextDelay(
+		const Progress &progress) const override;
+
+private:
+	/// Minimal delay.
+	const std::chrono::milliseconds baseDelay;
+
+	/// Maximal delay.
+	const std::chrono::milliseconds maxDelay;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
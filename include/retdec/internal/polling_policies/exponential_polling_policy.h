@@ -0,0 +1,44 @@
+///
+/// @file      retdec/internal/polling_policies/exponential_polling_policy.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Policy polling statuses with an exponentially growing delay.
+///
+
+#ifndef RETDEC_INTERNAL_POLLING_POLICIES_EXPONENTIAL_POLLING_POLICY_H
+#define RETDEC_INTERNAL_POLLING_POLICIES_EXPONENTIAL_POLLING_POLICY_H
+
+#include <chrono>
+
+#include "retdec/polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Policy polling statuses with an exponentially growing delay.
+///
+class ExponentialPollingPolicy: public PollingPolicy {
+public:
+	ExponentialPollingPolicy(std::chrono::milliseconds initialDelay,
+		std::chrono::milliseconds maxDelay, double factor);
+	virtual ~ExponentialPollingPolicy() override;
+
+	virtual std::chrono::milliseconds nextDelay(
+		const Progress &progress) const override;
+
+private:
+	/// Delay after the first status update.
+	const std::chrono::milliseconds initialDelay;
+
+	/// Maximal delay.
+	const std::chrono::milliseconds maxDelay;
+
+	/// Factor by which the delay grows.
+	const double factor;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,37 @@
+///
+/// @file      retdec/internal/polling_policies/fixed_polling_policy.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Policy polling statuses with a fixed delay.
+///
+
+#ifndef RETDEC_INTERNAL_POLLING_POLICIES_FIXED_POLLING_POLICY_H
+#define RETDEC_INTERNAL_POLLING_POLICIES_FIXED_POLLING_POLICY_H
+
+#include <chrono>
+
+#include "retdec/polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Policy polling statuses with a fixed delay.
+///
+class FixedPollingPolicy: public PollingPolicy {
+public:
+	explicit FixedPollingPolicy(std::chrono::milliseconds delay);
+	virtual ~FixedPollingPolicy() override;
+
+	virtual std::chrono::milliseconds nextDelay(
+		const Progress &progress) const override;
+
+private:
+	/// Delay between two status updates.
+	const std::chrono::milliseconds delay;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,67 @@
+///
+/// @file      retdec/internal/polling_policies/predictive_polling_policy.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Policy polling statuses when resources are predicted to finish.
+///
+
+#ifndef RETDEC_INTERNAL_POLLING_POLICIES_PREDICTIVE_POLLING_POLICY_H
+#define RETDEC_INTERNAL_POLLING_POLICIES_PREDICTIVE_POLLING_POLICY_H
+
+#include <chrono>
+#include <map>
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Policy polling statuses when resources are predicted to finish.
+///
+/// The prediction is based on the rate at which the completion of a resource
+/// grows. The rate is computed from the completion timeline of the resource.
+/// Until the timeline is long enough, the rate observed for other resources
+/// with the same mode is used.
+///
+class PredictivePollingPolicy: public PollingPolicy {
+public:
+	PredictivePollingPolicy(std::chrono::milliseconds minDelay,
+		std::chrono::milliseconds maxDelay);
+	virtual ~PredictivePollingPolicy() override;
+
+	virtual std::chrono::milliseconds nextDelay(
+		const Progress &progress) const override;
+
+	double rateForMode(const std::string &mode) const;
+
+private:
+	double completionRate(const Progress &progress) const;
+	void recordCompletionRate(const Progress &progress) const;
+	std::chrono::milliseconds delayWithoutPrediction(
+		const Progress &progress) const;
+	std::chrono::milliseconds boundedDelay(
+		std::chrono::milliseconds delay) const;
+
+private:
+	/// Minimal delay.
+	const std::chrono::milliseconds minDelay;
+
+	/// Maximal delay.
+	const std::chrono::milliseconds maxDelay;
+
+	/// Rates of completion (in percentages per millisecond) observed for
+	/// resources with the given modes.
+	mutable std::map<std::string, double> modeRates;
+
+	/// Mutex guarding @c modeRates.
+	mutable boost::mutex mutex;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
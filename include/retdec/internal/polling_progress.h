@@ -0,0 +1,68 @@
+///
+/// @file      retdec/internal/polling_progress.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Progress of polling the status of a resource.
+///
+
+#ifndef RETDEC_INTERNAL_POLLING_PROGRESS_H
+#define RETDEC_INTERNAL_POLLING_PROGRESS_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Progress of polling the status of a resource.
+///
+/// It keeps track of the status updates of a single resource (including the
+/// timeline of its completion) and asks a polling policy for the delay before
+/// the next one.
+///
+class PollingProgress {
+public:
+	explicit PollingProgress(const PollingPolicy &policy,
+		const std::string &mode = "",
+		const std::shared_ptr<Clock> &clock = Clock::system());
+
+	std::chrono::milliseconds nextDelay(const ResourceStatus &status);
+
+private:
+	/// Policy deciding the delays.
+	const PollingPolicy &policy;
+
+	/// Mode of the resource.
+	const std::string mode;
+
+	/// Clock measuring the elapsed time.
+	const std::shared_ptr<Clock> clock;
+
+	/// When the polling started.
+	const Clock::TimePoint startTime;
+
+	/// Delay returned last time.
+	std::chrono::milliseconds lastDelay;
+
+	/// Completion from the last status.
+	int lastCompletion = 0;
+
+	/// Number of status updates so far.
+	std::size_t statusUpdateCount = 0;
+
+	/// Timeline of changes in completion.
+	std::vector<PollingPolicy::CompletionChange> completionChanges;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -0,0 +1,61 @@
+///
+/// @file      retdec/internal/resource_context.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Context in which a resource is created.
+///
+
+#ifndef RETDEC_INTERNAL_RESOURCE_CONTEXT_H
+#define RETDEC_INTERNAL_RESOURCE_CONTEXT_H
+
+#include <memory>
+#include <string>
+
+namespace retdec {
+
+class PollingPolicy;
+
+namespace internal {
+
+class IoService;
+class MetricsRegistry;
+class TraceBuffer;
+
+///
+/// Context in which a resource is created.
+///
+/// It holds everything a resource takes from the service that has created it
+/// (apart from its connection). A default-constructed context is used for
+/// resources that are created outside of a service, e.g. in tests.
+///
+struct ResourceContext {
+	/// I/O service on which the status is polled asynchronously. When it is
+	/// null, the I/O service shared by connections with the default settings
+	/// is used.
+	std::shared_ptr<IoService> ioService;
+
+	/// Policy deciding how often the status is polled. When it is null, the
+	/// default policy is used.
+	std::shared_ptr<const PollingPolicy> pollingPolicy;
+
+	/// Mode of the resource (empty when it has no mode).
+	std::string mode;
+
+	/// Registry into which metrics of the resource are recorded (null when
+	/// they are not recorded).
+	std::shared_ptr<MetricsRegistry> metrics;
+
+	/// Buffer into which the lifecycle of the resource is traced (null when
+	/// it is not traced).
+	std::shared_ptr<TraceBuffer> traceBuffer;
+
+	/// Should the duration of the resource be recorded into @c metrics? It
+	/// should be @c false when the resource has not just been started (e.g.
+	/// when it has been reattached or its result is cached).
+	bool measureDuration = true;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
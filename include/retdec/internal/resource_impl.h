@@ -8,28 +8,45 @@
 #ifndef RETDEC_INTERNAL_RESOURCE_IMPL_H
 #define RETDEC_INTERNAL_RESOURCE_IMPL_H
 
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 
-#include <json/json.h>
-
 #include "retdec/internal/connection.h"
+#include "retdec/internal/resource_context.h"
+#include "retdec/internal/resource_status.h"
 
 namespace retdec {
+
+class File;
+class PollingPolicy;
+
 namespace internal {
 
+class IoService;
+class ResourceMetrics;
+class ResourceTrace;
 class ResponseVerifyingConnection;
+class StatusPolling;
 
 ///
 /// Base class of private implementation of resources.
 ///
 class ResourceImpl {
+public:
+	/// Function called when the resource finishes (with the error that
+	/// occurred while waiting, if any).
+	using FinishedHandler = std::function<void (std::exception_ptr error)>;
+
 public:
 	ResourceImpl(
 		const std::string &id,
 		const std::shared_ptr<Connection> &conn,
 		const std::string &serviceName,
-		const std::string &resourcesName
+		const std::string &resourcesName,
+		const ResourceContext &context = ResourceContext()
 	);
 	virtual ~ResourceImpl();
 
@@ -39,7 +56,27 @@ public:
 	void updateStatus();
 	void updateStatusIfNeeded();
 
-	virtual void updateResourceSpecificStatus(const Json::Value &jsonBody);
+	virtual void updateResourceSpecificStatus(const ResourceStatus &status);
+	/// @}
+
+	/// @name Waiting
+	/// @{
+	void waitUntilFinished(const PollingPolicy &pollingPolicy,
+		const std::function<void ()> &statusUpdated);
+	/// @}
+
+	/// @name Asynchronous Waiting
+	/// @{
+	std::shared_future<void> finishedFuture();
+	void whenFinished(const FinishedHandler &handler);
+	/// @}
+
+	/// @name Obtaining Outputs
+	/// @{
+	void streamOutputFile(const Connection::Url &url,
+		const Connection::BodyHandler &bodyHandler);
+	std::shared_ptr<File> downloadOutputFile(const Connection::Url &url,
+		const std::string &directoryPath);
 	/// @}
 
 	/// Identifier.
@@ -65,6 +102,35 @@ public:
 
 	/// Error message.
 	std::string error;
+
+	/// I/O service on which the status is polled asynchronously.
+	const std::shared_ptr<IoService> ioService;
+
+	/// Policy deciding how often the status is polled.
+	const std::shared_ptr<const PollingPolicy> pollingPolicy;
+
+	/// Mode of the resource (empty when the resource has no mode).
+	const std::string mode;
+
+	/// Metrics of the resource (null when they are not recorded).
+	const std::shared_ptr<ResourceMetrics> metrics;
+
+	/// Trace of the resource (null when it is not traced).
+	const std::shared_ptr<ResourceTrace> trace;
+
+protected:
+	std::shared_ptr<File> traced(const std::shared_ptr<File> &file) const;
+	static std::shared_ptr<File> traced(const std::shared_ptr<File> &file,
+		const std::shared_ptr<ResourceTrace> &trace);
+
+private:
+	ResourceStatus currentStatus();
+	void updateStatus(const ResourceStatus &status);
+	void startStatusPollingIfNeeded();
+
+private:
+	/// Asynchronous polling of the status (if started).
+	std::shared_ptr<StatusPolling> statusPolling;
 };
 
 } // namespace internal
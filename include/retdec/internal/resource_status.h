@@ -0,0 +1,52 @@
+///
+/// @file      retdec/internal/resource_status.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Status of a resource.
+///
+
+#ifndef RETDEC_INTERNAL_RESOURCE_STATUS_H
+#define RETDEC_INTERNAL_RESOURCE_STATUS_H
+
+#include <string>
+
+#include <boost/optional.hpp>
+
+namespace Json {
+
+class Value;
+
+} // namespace Json
+
+namespace retdec {
+namespace internal {
+
+///
+/// Status of a resource, as returned by the API.
+///
+/// Only the parts of the status that are used by resources are kept.
+///
+struct ResourceStatus {
+	static ResourceStatus fromJson(const Json::Value &status);
+	static ResourceStatus fromBody(const char *begin, const char *end);
+
+	/// Has the resource finished?
+	bool finished = false;
+
+	/// Has the resource succeeded?
+	bool succeeded = false;
+
+	/// Has the resource failed?
+	bool failed = false;
+
+	/// Error message (empty when there is no error).
+	std::string error;
+
+	/// Completion (in percentages, 0-100), if the resource reports it.
+	boost::optional<int> completion;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
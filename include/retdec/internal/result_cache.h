@@ -0,0 +1,123 @@
+///
+/// @file      retdec/internal/result_cache.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     On-disk cache of results of resources.
+///
+
+#ifndef RETDEC_INTERNAL_RESULT_CACHE_H
+#define RETDEC_INTERNAL_RESULT_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/internal/connection.h"
+#include "retdec/internal/io_service.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// On-disk cache of results of resources.
+///
+/// Entries are addressed by keys of resources (see resourceKey()), which are
+/// computed from their arguments, including the contents of their input files.
+/// An entry contains the ID of the resource, its final status, and the
+/// responses with its outputs.
+///
+/// The cache can be shared between processes. Files are never modified in
+/// place: they are written under temporary names and then renamed. Entries
+/// that cannot be read (e.g. because another process has just evicted them)
+/// are treated as missing.
+///
+/// The size of the cache is scanned only when the cache is first stored into
+/// and when it exceeds its maximal size. Otherwise, sizes of stored files are
+/// added to a running size.
+///
+/// Responses received by handlers of asynchronous requests are stored by a
+/// writer thread of the cache (see storeResponseAsync()), so the flushing of
+/// files and the eviction never block the threads of the I/O service.
+///
+class ResultCache: public std::enable_shared_from_this<ResultCache> {
+public:
+	ResultCache(const std::string &directoryPath, std::uint64_t maxSize);
+	~ResultCache();
+
+	/// @name Resources
+	/// @{
+	boost::optional<std::string> finishedResourceId(const std::string &key,
+		const std::vector<std::string> &outputPaths);
+	void storeResourceId(const std::string &key, const std::string &id);
+	/// @}
+
+	/// @name Responses
+	/// @{
+	bool hasResponse(const std::string &key, const std::string &name) const;
+	std::unique_ptr<Connection::Response> response(const std::string &key,
+		const std::string &name);
+	std::unique_ptr<Connection::Response> streamResponse(
+		const std::string &key, const std::string &name,
+		const Connection::BodyHandler &bodyHandler);
+	void storeResponse(const std::string &key, const std::string &name,
+		const Connection::Response &response);
+	void storeResponseAsync(const std::string &key, const std::string &name,
+		const Connection::Response &response,
+		const std::function<void ()> &storedHandler);
+	std::string newTmpFilePath() const;
+	void storeResponseFile(const std::string &key, const std::string &name,
+		const std::string &tmpFilePath, const std::string &attachedFileName);
+	/// @}
+
+	/// @name Disabled
+	/// @{
+	ResultCache(const ResultCache &) = delete;
+	ResultCache(ResultCache &&) = delete;
+	ResultCache &operator=(const ResultCache &) = delete;
+	ResultCache &operator=(ResultCache &&) = delete;
+	/// @}
+
+	static std::string responseName(const std::string &path);
+
+	/// Name of the response with the status of a resource.
+	static const std::string StatusResponseName;
+
+private:
+	std::string entryPath(const std::string &key) const;
+	void storeBody(const std::string &key, const std::string &name,
+		const std::string &body, const std::string &attachedFileName);
+	void storeEntryFile(const std::string &key, const std::string &name,
+		const std::string &content);
+	void moveIntoEntry(const std::string &key, const std::string &name,
+		const std::string &tmpFilePath);
+	void evictEntriesIfNeeded();
+	std::uint64_t evictEntries();
+
+private:
+	/// Path to the directory with the cache.
+	const std::string directoryPath;
+
+	/// Maximal size of all entries (in bytes).
+	const std::uint64_t maxSize;
+
+	/// Running size of all entries (in bytes, unknown before the first scan).
+	boost::optional<std::uint64_t> size;
+
+	/// Mutex guarding the running size.
+	boost::mutex sizeMutex;
+
+	/// Service whose single thread stores responses passed to
+	/// storeResponseAsync(). It is destructed first, so the stores that are
+	/// still pending are finished before the rest of the cache is destructed.
+	IoService writer;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -8,13 +8,26 @@
 #ifndef RETDEC_INTERNAL_SERVICE_WITH_RESOURCES_IMPL_H
 #define RETDEC_INTERNAL_SERVICE_WITH_RESOURCES_IMPL_H
 
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include <boost/optional.hpp>
 #include <json/json.h>
 
 #include "retdec/internal/connection_manager.h"
+#include "retdec/internal/in_flight_resources.h"
+#include "retdec/internal/resource_context.h"
+#include "retdec/internal/result_cache.h"
 #include "retdec/internal/service_impl.h"
+#include "retdec/internal/submission_journal.h"
+#include "retdec/internal/trace_buffer.h"
+#include "retdec/internal/utilities/connection.h"
+#include "retdec/resource_arguments.h"
 
 namespace retdec {
 namespace internal {
@@ -27,28 +40,258 @@ public:
 	ServiceWithResourcesImpl(const Settings &settings,
 		const std::shared_ptr<ConnectionManager> &connectionManager,
 		const std::string &serviceName,
-		const std::string &resourcesName);
+		const std::string &resourcesName,
+		const std::vector<std::string> &outputPaths);
 	virtual ~ServiceWithResourcesImpl() override;
 
+	///
+	/// Creator of resources of a single run.
+	///
+	/// It holds everything needed to create the resource once its ID is known,
+	/// so it can be copied into handlers of asynchronous requests, which may
+	/// outlive the service.
+	///
+	struct ResourceCreator {
+		boost::optional<std::string> cachedResourceId() const;
+		std::string started(const Connection::Response &response) const;
+		void failedToStart(std::exception_ptr error) const;
+
+		///
+		/// Creates a resource with the given ID.
+		///
+		/// @a measureDuration should be @c false when the resource has not
+		/// been started by this run (e.g. when it has been reattached or its
+		/// result is cached), so its duration is not recorded into metrics.
+		///
+		template <typename ResourceType>
+		std::unique_ptr<ResourceType> create(const std::string &id,
+				bool measureDuration = true) const {
+			auto resourceContext = context;
+			resourceContext.measureDuration = measureDuration;
+			return std::make_unique<ResourceType>(
+				id, connectionFor(id), resourceContext);
+		}
+
+		std::shared_ptr<Connection> connectionFor(const std::string &id) const;
+		void traceRun(const std::string &id,
+			TraceBuffer::Clock::time_point start) const;
+
+		/// Connection to be used by the resource.
+		std::shared_ptr<Connection> conn;
+
+		/// URL to resources.
+		std::string resourcesUrl;
+
+		/// Name of the resources (plural).
+		std::string resourcesName;
+
+		/// Paths to the outputs of the resource (relative to its URL).
+		std::vector<std::string> outputPaths;
+
+		/// Context in which the resource is created.
+		ResourceContext context;
+
+		/// Key of the resource (empty when neither the result cache nor
+		/// deduplication of runs is enabled).
+		std::string key;
+
+		/// Cache of results of resources (null when disabled).
+		std::shared_ptr<ResultCache> resultCache;
+
+		/// Shared resource of identical runs (null when runs are not
+		/// deduplicated).
+		std::shared_ptr<InFlightResource> inFlightResource;
+
+		/// Journal of started resources (null when disabled).
+		std::shared_ptr<SubmissionJournal> journal;
+	};
+
 	///
 	/// Runs a new resource with the given arguments.
 	///
+	/// When the result cache contains a finished resource with the same
+	/// arguments, no request is sent and the cached resource is returned. When
+	/// runs are deduplicated and an identical run is in progress, no request
+	/// is sent and a new handle of the resource of that run is returned.
+	///
 	template <typename ResourceType>
 	std::unique_ptr<ResourceType> runResource(const ResourceArguments &args) {
-		auto conn = connectionManager->newConnection(settings);
-		auto response = conn->sendPostRequest(
-			resourcesUrl,
-			createRequestArguments(args),
-			createRequestFiles(args)
+		auto start = TraceBuffer::Clock::now();
+		auto creator = resourceCreatorFor(args);
+		if (auto id = creator.cachedResourceId()) {
+			creator.traceRun(*id, start);
+			return creator.create<ResourceType>(*id, false);
+		}
+
+		if (!joinInFlightResource(creator)) {
+			auto id = creator.inFlightResource->waitUntilStarted();
+			creator.traceRun(id, start);
+			return creator.create<ResourceType>(id);
+		}
+
+		try {
+			auto response = creator.conn->sendPostRequest(
+				resourcesUrl,
+				createRequestArguments(args),
+				createRequestFiles(args)
+			);
+			auto id = creator.started(*response);
+			creator.traceRun(id, start);
+			return creator.create<ResourceType>(id);
+		} catch (...) {
+			creator.failedToStart(std::current_exception());
+			throw;
+		}
+	}
+
+	///
+	/// Runs a new resource with the given arguments without waiting for the
+	/// request to be sent.
+	///
+	/// The returned future holds either the resource or the error that
+	/// occurred.
+	///
+	template <typename ResourceType>
+	std::future<std::unique_ptr<ResourceType>> runResourceAsync(
+			const ResourceArguments &args) {
+		auto resource = std::make_shared<
+			std::promise<std::unique_ptr<ResourceType>>>();
+		runResourceAsync<ResourceType>(args,
+			[resource](std::unique_ptr<ResourceType> runResource,
+					std::exception_ptr error) {
+				if (error) {
+					resource->set_exception(error);
+				} else {
+					resource->set_value(std::move(runResource));
+				}
+			}
 		);
-		verifyRequestSucceeded(*response);
-		auto jsonBody = response->bodyAsJson();
-		auto id = jsonBody.get("id", "?").asString();
-		return std::make_unique<ResourceType>(id, conn);
+		return resource->get_future();
 	}
 
+	///
+	/// Runs a new resource with the given arguments and passes it to
+	/// @a handler once the request is sent.
+	///
+	/// When the resource cannot be run, the error is passed to @a handler
+	/// instead. @a handler is called from a thread of the I/O service shared
+	/// by connections. When no request has to be sent (see runResource()),
+	/// @a handler is called right away or once the identical run that is in
+	/// progress sends its request.
+	///
+	template <typename ResourceType>
+	void runResourceAsync(const ResourceArguments &args,
+			const std::function<void (std::unique_ptr<ResourceType> resource,
+				std::exception_ptr error)> &handler) {
+		auto start = TraceBuffer::Clock::now();
+		ResourceCreator creator;
+		boost::optional<std::string> cachedId;
+		auto shouldStart = false;
+		Connection::RequestArguments requestArgs;
+		Connection::RequestFiles requestFiles;
+		try {
+			creator = resourceCreatorFor(args);
+			cachedId = creator.cachedResourceId();
+			if (!cachedId) {
+				shouldStart = joinInFlightResource(creator);
+				if (shouldStart) {
+					requestArgs = createRequestArguments(args);
+					requestFiles = createRequestFiles(args);
+				}
+			}
+		} catch (...) {
+			if (shouldStart) {
+				creator.failedToStart(std::current_exception());
+			}
+			return handler(nullptr, std::current_exception());
+		}
+
+		auto createResource = [creator, handler, start, cachedId](
+				const std::string &id, std::exception_ptr error) {
+			std::unique_ptr<ResourceType> resource;
+			if (!error) {
+				try {
+					creator.traceRun(id, start);
+					resource = creator.create<ResourceType>(id, !cachedId);
+				} catch (...) {
+					error = std::current_exception();
+				}
+			}
+			handler(std::move(resource), error);
+		};
+		if (cachedId) {
+			return createResource(*cachedId, nullptr);
+		} else if (!shouldStart) {
+			return creator.inFlightResource->whenStarted(createResource);
+		}
+
+		creator.conn->sendPostRequestAsync(resourcesUrl, requestArgs,
+			requestFiles,
+			[creator, createResource](
+					std::unique_ptr<Connection::Response> response,
+					std::exception_ptr error) {
+				std::string id;
+				if (!error) {
+					try {
+						id = creator.started(*response);
+					} catch (...) {
+						error = std::current_exception();
+					}
+				}
+				if (error) {
+					creator.failedToStart(error);
+				}
+				createResource(id, error);
+			}
+		);
+	}
+
+	///
+	/// Returns the resource with the given ID from the journal of started
+	/// resources.
+	///
+	/// No request is sent. The resource polls its status once it is queried
+	/// or waited for, as if it had been run by this service.
+	///
+	/// @throws Error When the journal is disabled or it contains no resource
+	///               with the given ID started by this service.
+	///
+	template <typename ResourceType>
+	std::unique_ptr<ResourceType> reattachResource(const std::string &id) {
+		auto record = journaledResource(id);
+		return resourceCreator(record.mode, record.key)
+			.create<ResourceType>(id, false);
+	}
+
+	std::vector<std::string> journaledResourceIds() const;
+
+	ResourceCreator resourceCreatorFor(const ResourceArguments &args) const;
+	ResourceCreator resourceCreator(const std::string &mode,
+		const std::string &key) const;
+	bool joinInFlightResource(ResourceCreator &creator) const;
+	SubmissionJournal::Record journaledResource(const std::string &id) const;
+
+	/// Name of the resources (plural).
+	const std::string resourcesName;
+
 	/// URL to resources.
 	const std::string resourcesUrl;
+
+	/// Paths to the outputs of resources (relative to their URLs).
+	const std::vector<std::string> outputPaths;
+
+	/// Context in which resources are created (without a mode).
+	const ResourceContext resourceContext;
+
+	/// Cache of results of resources (null when disabled).
+	const std::shared_ptr<ResultCache> resultCache;
+
+	/// Resources of runs that are in progress (null when runs are not
+	/// deduplicated).
+	const std::shared_ptr<InFlightResources> inFlightResources;
+
+	/// Journal of started resources (null when disabled).
+	const std::shared_ptr<SubmissionJournal> journal;
 };
 
 } // namespace internal
@@ -0,0 +1,146 @@
+///
+/// @file      retdec/internal/simulated_service.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Simulation of the services of the API running in memory.
+///
+
+#ifndef RETDEC_INTERNAL_SIMULATED_SERVICE_H
+#define RETDEC_INTERNAL_SIMULATED_SERVICE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+class VirtualClock;
+
+///
+/// Simulation of the decompiler, fileinfo, and test services of the API
+/// running in memory on a virtual clock.
+///
+/// Resources are processed by a limited number of workers. A resource waits in
+/// a queue until a worker is free, its completion then grows linearly over its
+/// processing time, and when it finishes, it either succeeds or fails. Every
+/// request moves the clock forward by its latency.
+///
+/// Time passes only when the clock is moved forward, e.g. when a connection to
+/// the simulation waits for a resource, so hours of processing take
+/// milliseconds of real time. The simulation can be used from many threads at
+/// once, but it is deterministic only when used from a single thread.
+///
+class SimulatedService {
+public:
+	///
+	/// Distribution of durations, returning a random duration from the given
+	/// generator.
+	///
+	using Distribution =
+		std::function<std::chrono::milliseconds (std::mt19937_64 &random)>;
+
+	///
+	/// Configuration of the simulation.
+	///
+	struct Config {
+		/// Latency of requests.
+		Distribution requestLatency = fixed(std::chrono::milliseconds(0));
+
+		/// Time needed to process a resource.
+		Distribution processingTime = fixed(std::chrono::seconds(10));
+
+		/// Maximal number of resources processed at once (0 means
+		/// unlimited).
+		std::size_t workerCount = 0;
+
+		/// Probability that a resource fails.
+		double failureRate = 0.0;
+
+		/// Probability that a request fails with 500 Internal Server Error.
+		double errorRate = 0.0;
+
+		/// Size of outputs of resources (in bytes).
+		std::size_t outputSize = 1024;
+
+		/// Seed of the random number generator.
+		std::uint64_t seed = 0;
+	};
+
+	///
+	/// Statistics of the simulation.
+	///
+	struct Statistics {
+		/// Number of received requests.
+		std::size_t requestCount = 0;
+
+		/// Number of received requests for statuses of resources.
+		std::size_t statusRequestCount = 0;
+
+		/// Number of requests that failed with an injected error.
+		std::size_t failedRequestCount = 0;
+
+		/// Number of created resources.
+		std::size_t createdResourceCount = 0;
+
+		/// Number of finished resources (both succeeded and failed).
+		std::size_t finishedResourceCount = 0;
+
+		/// Maximal number of resources waiting for a worker at once.
+		std::size_t maxQueueLength = 0;
+	};
+
+public:
+	explicit SimulatedService(const Config &config);
+	~SimulatedService();
+
+	/// @name Requests
+	/// @{
+	std::unique_ptr<Connection::Response> sendGetRequest(
+		const Connection::Url &url,
+		const Connection::RequestArguments &args);
+	std::unique_ptr<Connection::Response> sendPostRequest(
+		const Connection::Url &url,
+		const Connection::RequestArguments &args,
+		const Connection::RequestFiles &files);
+	/// @}
+
+	/// @name Simulation
+	/// @{
+	std::shared_ptr<VirtualClock> clock() const;
+	Statistics statistics() const;
+	/// @}
+
+	/// @name Distributions
+	/// @{
+	static Distribution fixed(std::chrono::milliseconds duration);
+	static Distribution uniform(std::chrono::milliseconds min,
+		std::chrono::milliseconds max);
+	static Distribution exponential(std::chrono::milliseconds mean);
+	static Distribution logNormal(std::chrono::milliseconds median,
+		double sigma);
+	/// @}
+
+	/// @name Disabled
+	/// @{
+	SimulatedService(const SimulatedService &) = delete;
+	SimulatedService(SimulatedService &&) = delete;
+	SimulatedService &operator=(const SimulatedService &) = delete;
+	SimulatedService &operator=(SimulatedService &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
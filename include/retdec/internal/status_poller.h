@@ -0,0 +1,66 @@
+///
+/// @file      retdec/internal/status_poller.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Poller of statuses of resources.
+///
+
+#ifndef RETDEC_INTERNAL_STATUS_POLLER_H
+#define RETDEC_INTERNAL_STATUS_POLLER_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace retdec {
+namespace internal {
+
+class IoService;
+
+///
+/// Poller of statuses of resources.
+///
+/// Instead of every resource waiting on its own, status updates of all the
+/// resources using the same I/O service are scheduled here. The poller keeps
+/// them ordered by the time they are due and runs them from a single timer on
+/// the threads of the I/O service, so the number of waiting resources does not
+/// affect the number of threads or timers.
+///
+class StatusPoller: public std::enable_shared_from_this<StatusPoller> {
+public:
+	/// Status update to be run when it is due.
+	using StatusUpdate = std::function<void ()>;
+
+public:
+	explicit StatusPoller(const std::shared_ptr<IoService> &ioService);
+	~StatusPoller();
+
+	void schedule(std::chrono::milliseconds delay, const StatusUpdate &update);
+	std::size_t scheduledCount() const;
+
+	static std::shared_ptr<StatusPoller> shared(
+		const std::shared_ptr<IoService> &ioService);
+
+	/// @name Disabled
+	/// @{
+	StatusPoller(const StatusPoller &) = delete;
+	StatusPoller(StatusPoller &&) = delete;
+	StatusPoller &operator=(const StatusPoller &) = delete;
+	StatusPoller &operator=(StatusPoller &&) = delete;
+	/// @}
+
+private:
+	void runDueUpdates();
+	void startTimer();
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
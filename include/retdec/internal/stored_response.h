@@ -0,0 +1,60 @@
+///
+/// @file      retdec/internal/stored_response.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Response stored in memory.
+///
+
+#ifndef RETDEC_INTERNAL_STORED_RESPONSE_H
+#define RETDEC_INTERNAL_STORED_RESPONSE_H
+
+#include <memory>
+#include <string>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Response stored in memory.
+///
+/// Stored responses are used when a response is not received from the API but
+/// obtained in another way, e.g. from a cache. Their bodies are shared, so
+/// they can be copied cheaply.
+///
+class StoredResponse: public Connection::Response {
+public:
+	StoredResponse(int statusCode, const std::string &statusMessage,
+		std::shared_ptr<const std::string> body,
+		const std::string &attachedFileName);
+	explicit StoredResponse(const Connection::Response &response);
+	virtual ~StoredResponse() override;
+
+	virtual int statusCode() const override;
+	virtual std::string statusMessage() const override;
+	virtual std::string body() const override;
+	virtual std::shared_ptr<const std::string> sharedBody() const override;
+	virtual Json::Value bodyAsJson() const override;
+	virtual ResourceStatus bodyAsStatus() const override;
+	virtual std::unique_ptr<File> bodyAsFile() const override;
+	virtual std::string attachedFileName() const override;
+
+private:
+	/// Status code.
+	const int code;
+
+	/// Status message.
+	const std::string message;
+
+	/// Body.
+	const std::shared_ptr<const std::string> body_;
+
+	/// Name of the attached file (if any).
+	const std::string fileName;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
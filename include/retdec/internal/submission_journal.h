@@ -0,0 +1,94 @@
+///
+/// @file      retdec/internal/submission_journal.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Persistent journal of started resources.
+///
+
+#ifndef RETDEC_INTERNAL_SUBMISSION_JOURNAL_H
+#define RETDEC_INTERNAL_SUBMISSION_JOURNAL_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+namespace retdec {
+namespace internal {
+
+///
+/// Persistent journal of started resources.
+///
+/// A record is appended to the journal file whenever a resource is started,
+/// so resources that are still in progress or whose outputs have not been
+/// obtained yet can be reattached to after the process is restarted. When
+/// nothing more is to be obtained from a resource, a mark is appended to the
+/// journal. Every record and mark is written as a single line by a single
+/// append and flushed to the disk, so a crash of the process loses none of
+/// them. A line that is incomplete because of a crash in the middle of
+/// writing is skipped when the journal is read.
+///
+/// The file is indexed when it is first read, and the index is used until the
+/// file is changed by another process. When most of the records in the file
+/// are of finished resources, the file is compacted: the records of finished
+/// resources are removed from it.
+///
+/// The file may be shared by several processes. Appending and compaction are
+/// guarded by a lock file next to the journal file (with the @c .lock suffix).
+///
+class SubmissionJournal {
+public:
+	///
+	/// Record of a started resource.
+	///
+	struct Record {
+		/// URL to the resources of the service that started the resource.
+		std::string service;
+
+		/// ID of the resource.
+		std::string id;
+
+		/// Key of the resource (see resourceKey()).
+		std::string key;
+
+		/// Mode of the resource (empty when the resource has no mode).
+		std::string mode;
+
+		/// Has the resource been marked as finished?
+		bool finished = false;
+	};
+
+public:
+	explicit SubmissionJournal(const std::string &path);
+	~SubmissionJournal();
+
+	void append(const Record &record);
+	void markFinished(const std::string &service, const std::string &id);
+	boost::optional<Record> find(const std::string &service,
+		const std::string &id) const;
+	std::vector<Record> records(const std::string &service) const;
+
+	/// @name Disabled
+	/// @{
+	SubmissionJournal(const SubmissionJournal &) = delete;
+	SubmissionJournal(SubmissionJournal &&) = delete;
+	SubmissionJournal &operator=(const SubmissionJournal &) = delete;
+	SubmissionJournal &operator=(SubmissionJournal &&) = delete;
+	/// @}
+
+	/// Minimal number of records of finished resources in the file for the
+	/// file to be compacted.
+	static const std::size_t MinFinishedRecordsToCompact;
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
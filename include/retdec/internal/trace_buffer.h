@@ -0,0 +1,166 @@
+///
+/// @file      retdec/internal/trace_buffer.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Ring buffer of trace events and spans recording them.
+///
+
+#ifndef RETDEC_INTERNAL_TRACE_BUFFER_H
+#define RETDEC_INTERNAL_TRACE_BUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+namespace retdec {
+namespace internal {
+
+struct ResourceStatus;
+
+///
+/// Ring buffer of trace events.
+///
+/// When the buffer is full, the oldest events are overwritten, so only the
+/// most recent events are kept. Events can be recorded from many threads at
+/// once.
+///
+class TraceBuffer {
+public:
+	/// Clock used to time events.
+	using Clock = std::chrono::steady_clock;
+
+	///
+	/// Trace event.
+	///
+	struct Event {
+		/// Name of the event (e.g. @c updateStatus).
+		std::string name;
+
+		/// Track on which the event is shown (e.g. @c "decompilations 123").
+		/// Events with an empty track are shown on the track of the thread
+		/// that recorded them.
+		std::string track;
+
+		/// Number of the thread that recorded the event.
+		std::size_t thread = 0;
+
+		/// When the event started (or happened, for instant events).
+		Clock::time_point start;
+
+		/// Duration of the event (zero for instant events).
+		Clock::duration duration = Clock::duration::zero();
+
+		/// Is this an instant event rather than a span?
+		bool instant = false;
+
+		/// Arguments of the event (a JSON object, or null when there are
+		/// none).
+		Json::Value args;
+	};
+
+public:
+	explicit TraceBuffer(std::size_t capacity);
+	~TraceBuffer();
+
+	void record(Event event);
+	void recordSpan(const std::string &name, const std::string &track,
+		Clock::time_point start, const Json::Value &args = Json::Value());
+	void recordInstant(const std::string &name, const std::string &track,
+		const Json::Value &args = Json::Value());
+	std::vector<Event> events() const;
+	std::string toChromeTraceJson() const;
+
+	static std::size_t currentThread() noexcept;
+	static std::string resourceTrack(const std::string &resourcesName,
+		const std::string &id);
+
+	/// @name Disabled
+	/// @{
+	TraceBuffer(const TraceBuffer &) = delete;
+	TraceBuffer(TraceBuffer &&) = delete;
+	TraceBuffer &operator=(const TraceBuffer &) = delete;
+	TraceBuffer &operator=(TraceBuffer &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+///
+/// Trace of a single resource.
+///
+/// It holds the buffer and the track of the resource, and records changes in
+/// completion of the resource as @c completion events. It can be used from
+/// many threads at once.
+///
+class ResourceTrace {
+public:
+	ResourceTrace(const std::shared_ptr<TraceBuffer> &buffer,
+		const std::string &track);
+
+	void statusReceived(const ResourceStatus &status);
+
+	/// @name Disabled
+	/// @{
+	ResourceTrace(const ResourceTrace &) = delete;
+	ResourceTrace(ResourceTrace &&) = delete;
+	ResourceTrace &operator=(const ResourceTrace &) = delete;
+	ResourceTrace &operator=(ResourceTrace &&) = delete;
+	/// @}
+
+	/// Buffer into which the events are recorded.
+	const std::shared_ptr<TraceBuffer> buffer;
+
+	/// Track of the resource.
+	const std::string track;
+
+private:
+	/// Last recorded completion (-1 when none has been recorded).
+	std::atomic<int> lastCompletion;
+};
+
+///
+/// Span of time recorded into a trace buffer upon destruction.
+///
+/// When there is no buffer, nothing is recorded and all the member functions
+/// return right away.
+///
+class TraceSpan {
+public:
+	TraceSpan(const std::shared_ptr<TraceBuffer> &buffer,
+		const std::string &name, const std::string &track = "");
+	TraceSpan(const std::shared_ptr<ResourceTrace> &trace,
+		const std::string &name);
+	~TraceSpan();
+
+	void setTrack(const std::string &track);
+	void setArg(const std::string &name, const Json::Value &value);
+
+	/// @name Disabled
+	/// @{
+	TraceSpan(const TraceSpan &) = delete;
+	TraceSpan(TraceSpan &&) = delete;
+	TraceSpan &operator=(const TraceSpan &) = delete;
+	TraceSpan &operator=(TraceSpan &&) = delete;
+	/// @}
+
+private:
+	/// Buffer into which the span is recorded (null when nothing is
+	/// recorded).
+	const std::shared_ptr<TraceBuffer> buffer;
+
+	/// Recorded event (valid only when there is a buffer).
+	TraceBuffer::Event event;
+};
+
+} // namespace internal
+} // namespace retdec
+
+#endif
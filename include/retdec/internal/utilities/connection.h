@@ -8,15 +8,21 @@
 #ifndef RETDEC_INTERNAL_UTILITIES_CONNECTION_H
 #define RETDEC_INTERNAL_UTILITIES_CONNECTION_H
 
+#include <functional>
 #include <memory>
+#include <string>
 
 #include "retdec/internal/connection.h"
 
 namespace retdec {
 namespace internal {
 
+std::string createQuery(const Connection::RequestArguments &args);
 bool requestSucceeded(const Connection::Response &response);
 void verifyRequestSucceeded(const Connection::Response &response);
+void passResponseToHandler(
+	const std::function<std::unique_ptr<Connection::Response> ()> &sendRequest,
+	const Connection::ResponseHandler &responseHandler);
 
 ///
 /// Connection wrapper verifying that requests succeed.
@@ -36,6 +42,17 @@ public:
 		const RequestArguments &args) override;
 	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
 		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) override;
+	virtual std::shared_ptr<Clock> clock() const override;
 
 private:
 	/// Wrapped connection.
@@ -0,0 +1,28 @@
+///
+/// @file      retdec/internal/utilities/hash.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Utilities for hashing.
+///
+
+#ifndef RETDEC_INTERNAL_UTILITIES_HASH_H
+#define RETDEC_INTERNAL_UTILITIES_HASH_H
+
+#include <istream>
+#include <string>
+
+namespace retdec {
+namespace internal {
+
+/// @name Hashing
+/// @{
+
+std::string sha256(const std::string &data);
+std::string sha256(std::istream &stream);
+
+/// @}
+
+} // namespace internal
+} // namespace retdec
+
+#endif
@@ -29,6 +29,8 @@ public:
 };
 
 Json::Value toJson(const std::string &str);
+Json::Value toJson(const char *begin, const char *end);
+std::string toJsonString(const Json::Value &value);
 
 /// @}
 
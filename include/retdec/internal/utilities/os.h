@@ -8,6 +8,11 @@
 #ifndef RETDEC_INTERNAL_UTILITIES_OS_H
 #define RETDEC_INTERNAL_UTILITIES_OS_H
 
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
 #include <string>
 
 // Obtain the used operating system.
@@ -35,8 +40,15 @@ namespace internal {
 std::string operatingSystemName();
 std::string fileNameFromPath(const std::string &path);
 std::string readFile(const std::string &path);
+std::unique_ptr<std::istream> openFile(const std::string &path);
+std::uint64_t fileSize(const std::string &path);
 void writeFile(const std::string &path, const std::string &content);
+void appendToFile(const std::string &path, const std::string &content);
+std::unique_ptr<std::ostream> openFileForWriting(const std::string &path);
 void copyFile(const std::string &srcPath, const std::string &dstPath);
+void renameFile(const std::string &srcPath, const std::string &dstPath);
+void removeFile(const std::string &path);
+std::string uniqueFilePath(const std::string &directoryPath);
 std::string joinPaths(const std::string &path1, const std::string &path2);
 
 ///
@@ -49,6 +61,33 @@ inline std::string joinPaths(const std::string &path1, const std::string &path2,
 }
 
 void sleep(int milliseconds);
+std::size_t processorCount();
+
+/// @}
+
+/// @name Copying of Files
+/// @{
+
+///
+/// Method of copying the data of a file.
+///
+enum class FileCopyMethod {
+	/// Cloning (reflinking) the file (Linux only).
+	Clone,
+
+	/// Copying inside the kernel by @c copy_file_range() (Linux only).
+	CopyFileRange,
+
+	/// Copying inside the kernel by @c sendfile() (Linux only).
+	Sendfile,
+
+	/// Reading and writing the file in user space.
+	Portable
+};
+
+bool copyFileBy(FileCopyMethod method, const std::string &srcPath,
+	const std::string &dstPath);
+void syncFile(const std::string &path);
 
 /// @}
 
@@ -0,0 +1,27 @@
+///
+/// @file      retdec/internal/utilities/resource.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Utilities for resources.
+///
+
+#ifndef RETDEC_INTERNAL_UTILITIES_RESOURCE_H
+#define RETDEC_INTERNAL_UTILITIES_RESOURCE_H
+
+#include <string>
+
+#include "retdec/internal/connection.h"
+
+namespace retdec {
+
+class ResourceArguments;
+
+namespace internal {
+
+std::string resourceKey(const Connection::Url &resourcesUrl,
+	const ResourceArguments &args);
+
+} // namespace internal
+} // namespace retdec
+
+#endif
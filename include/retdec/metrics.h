@@ -0,0 +1,71 @@
+///
+/// @file      retdec/metrics.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Metrics of requests sent to the API and of resources.
+///
+
+#ifndef RETDEC_METRICS_H
+#define RETDEC_METRICS_H
+
+#include <memory>
+#include <string>
+
+namespace retdec {
+
+namespace internal {
+
+class MetricsRegistry;
+
+} // namespace internal
+
+///
+/// Metrics of requests sent to the API and of resources.
+///
+/// Metrics are collected by services whose settings contain them (see
+/// Settings::metrics()). A single instance may be shared by any number of
+/// services and used from any number of threads. The following metrics are
+/// collected, split by service (@c decompiler, @c fileinfo, @c test):
+///
+/// - @c retdec_requests_total and @c retdec_request_duration_seconds: the
+///   number and durations of requests to which a response was received, also
+///   split by status code,
+/// - @c retdec_failed_requests_total: the number of requests to which no
+///   response was received,
+/// - @c retdec_status_polls_total: the number of requests for statuses of
+///   resources,
+/// - @c retdec_resource_duration_seconds: durations of resources from their
+///   creation until they finished, also split by result (@c succeeded or
+///   @c failed).
+///
+class Metrics {
+public:
+	Metrics();
+	~Metrics();
+
+	/// @name Exporting
+	/// @{
+	std::string toPrometheusText() const;
+	void writePrometheusText(const std::string &filePath) const;
+	/// @}
+
+	/// @cond internal
+	std::shared_ptr<::retdec::internal::MetricsRegistry> registry() const;
+	/// @endcond
+
+	/// @name Disabled
+	/// @{
+	Metrics(const Metrics &) = delete;
+	Metrics(Metrics &&) = delete;
+	Metrics &operator=(const Metrics &) = delete;
+	Metrics &operator=(Metrics &&) = delete;
+	/// @}
+
+private:
+	/// Registry holding the metrics.
+	const std::shared_ptr<::retdec::internal::MetricsRegistry> registry_;
+};
+
+} // namespace retdec
+
+#endif
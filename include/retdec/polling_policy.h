@@ -0,0 +1,136 @@
+///
+/// @file      retdec/polling_policy.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Policies deciding how often statuses of resources are polled.
+///
+
+#ifndef RETDEC_POLLING_POLICY_H
+#define RETDEC_POLLING_POLICY_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace retdec {
+
+///
+/// Base class and factory for policies deciding how often statuses of
+/// resources are polled.
+///
+/// A policy is consulted after every status update of a resource that has not
+/// finished yet and returns the delay before the next update. Policies do not
+/// keep any per-resource state, so a single policy can be used to wait for
+/// many resources at once, from any number of threads.
+///
+class PollingPolicy {
+public:
+	///
+	/// Change in completion of a resource.
+	///
+	struct CompletionChange {
+		/// Time elapsed since the waiting started.
+		std::chrono::milliseconds elapsedTime;
+
+		/// Completion (in percentages, 0-100) since that time.
+		int completion;
+	};
+
+	///
+	/// View of a timeline of changes in completion.
+	///
+	/// It does not own the changes, so it is valid only during the call of
+	/// nextDelay() to which it has been passed.
+	///
+	class CompletionChanges {
+	public:
+		CompletionChanges();
+		CompletionChanges(const std::vector<CompletionChange> &changes);
+
+		const CompletionChange *begin() const;
+		const CompletionChange *end() const;
+		std::size_t size() const;
+		bool empty() const;
+		const CompletionChange &operator[](std::size_t i) const;
+		const CompletionChange &front() const;
+		const CompletionChange &back() const;
+
+	private:
+		/// First change.
+		const CompletionChange *first = nullptr;
+
+		/// Number of changes.
+		std::size_t count = 0;
+	};
+
+	///
+	/// Progress of the waiting for a resource, based on which the next delay
+	/// is decided.
+	///
+	struct Progress {
+		/// Time elapsed since the waiting started.
+		std::chrono::milliseconds elapsedTime;
+
+		/// Delay before the last status update (zero after the first one).
+		std::chrono::milliseconds lastDelay;
+
+		/// Change in completion (in percentages) between the last two status
+		/// updates. It is always zero for resources that do not report their
+		/// completion.
+		int completionDelta;
+
+		/// Number of status updates done so far (at least one).
+		std::size_t statusUpdateCount;
+
+		/// Current completion (in percentages, 0-100). It is always zero for
+		/// resources that do not report their completion.
+		int completion;
+
+		/// Timeline of changes in completion, starting with the completion
+		/// from the first status update.
+		CompletionChanges completionChanges;
+
+		/// Mode of the resource (e.g. @c bin for decompilations of binary
+		/// files), or the empty string when the resource has no mode.
+		std::string mode;
+	};
+
+public:
+	virtual ~PollingPolicy() = 0;
+
+	virtual std::chrono::milliseconds nextDelay(
+		const Progress &progress) const = 0;
+
+	static std::unique_ptr<PollingPolicy> fixed(
+		std::chrono::milliseconds delay);
+	static std::unique_ptr<PollingPolicy> exponential(
+		std::chrono::milliseconds initialDelay,
+		std::chrono::milliseconds maxDelay,
+		double factor = 2.0);
+	static std::unique_ptr<PollingPolicy> decorrelatedJitter(
+		std::chrono::milliseconds baseDelay,
+		std::chrono::milliseconds maxDelay);
+	static std::unique_ptr<PollingPolicy> predictive(
+		std::chrono::milliseconds minDelay,
+		std::chrono::milliseconds maxDelay);
+	static std::unique_ptr<PollingPolicy> deadlineAware(
+		std::shared_ptr<const PollingPolicy> policy,
+		std::chrono::milliseconds deadline);
+
+	/// @name Disabled
+	/// @{
+	PollingPolicy(const PollingPolicy &) = delete;
+	PollingPolicy(PollingPolicy &&) = delete;
+	PollingPolicy &operator=(const PollingPolicy &) = delete;
+	PollingPolicy &operator=(PollingPolicy &&) = delete;
+	/// @}
+
+protected:
+	PollingPolicy();
+};
+
+} // namespace retdec
+
+#endif
@@ -0,0 +1,101 @@
+///
+/// @file      retdec/request_observer.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Base class of observers of requests sent to the API.
+///
+
+#ifndef RETDEC_REQUEST_OBSERVER_H
+#define RETDEC_REQUEST_OBSERVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace retdec {
+
+///
+/// Base class of observers of requests sent to the API.
+///
+/// An observer is registered via Settings::requestObserver() and it is told
+/// about every request sent by services with these settings once the request
+/// finishes, so it can find out where the time of the request went. When no
+/// observer is registered, requests are not measured at all.
+///
+class RequestObserver {
+public:
+	/// Clock used to measure requests.
+	using Clock = std::chrono::steady_clock;
+
+	/// Point in time of a phase of a request.
+	using TimePoint = Clock::time_point;
+
+	///
+	/// Phases and outcome of a finished request.
+	///
+	/// Phases that have not been reached (e.g. because the request failed)
+	/// have their time set to @c TimePoint() (see hasTime()). Connections are
+	/// kept open between requests, so name resolution, connection
+	/// establishment, and TLS handshake happen only for requests sent over a
+	/// new connection. The TLS handshake happens only for @c https URLs.
+	///
+	struct Request {
+		static bool hasTime(TimePoint time) noexcept;
+
+		/// Method of the request (e.g. @c GET).
+		std::string method;
+
+		/// URL to which the request was sent (without arguments).
+		std::string url;
+
+		/// When the request started being sent.
+		TimePoint started;
+
+		/// When the host name was resolved.
+		TimePoint resolved;
+
+		/// When the connection was established.
+		TimePoint connected;
+
+		/// When the TLS handshake finished.
+		TimePoint tlsHandshakeDone;
+
+		/// When the whole request (including its body) was written.
+		TimePoint requestWritten;
+
+		/// When the first byte of the body of the response was received.
+		TimePoint firstByteReceived;
+
+		/// When the whole response was received (or the request failed).
+		TimePoint finished;
+
+		/// Number of bytes of the body of the request.
+		std::uint64_t bytesSent = 0;
+
+		/// Number of bytes of the body of the response.
+		std::uint64_t bytesReceived = 0;
+
+		/// Status code of the response (zero when no response was received).
+		int statusCode = 0;
+	};
+
+public:
+	virtual ~RequestObserver() = 0;
+
+	virtual void requestFinished(const Request &request) = 0;
+
+	/// @name Disabled
+	/// @{
+	RequestObserver(const RequestObserver &) = delete;
+	RequestObserver(RequestObserver &&) = delete;
+	RequestObserver &operator=(const RequestObserver &) = delete;
+	RequestObserver &operator=(RequestObserver &&) = delete;
+	/// @}
+
+protected:
+	RequestObserver();
+};
+
+} // namespace retdec
+
+#endif
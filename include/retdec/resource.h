@@ -8,7 +8,12 @@
 #ifndef RETDEC_RESOURCE_H
 #define RETDEC_RESOURCE_H
 
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
+#include <string>
 
 namespace retdec {
 
@@ -22,6 +27,24 @@ class ResourceImpl;
 /// Base class of all resources.
 ///
 class Resource {
+public:
+	///
+	/// Type of a function to which outputs are passed when they are streamed.
+	///
+	/// The function is called repeatedly with consecutive parts of the output
+	/// as they are received. Exceptions thrown from it are propagated to the
+	/// caller of the streaming member function.
+	///
+	using OutputHandler = std::function<void (const char *data, std::size_t size)>;
+
+	///
+	/// Type of a function called when a resource finishes.
+	///
+	/// When the status of the resource cannot be obtained, the error is passed
+	/// to the function. Otherwise, @a error is null.
+	///
+	using FinishedHandler = std::function<void (std::exception_ptr error)>;
+
 public:
 	/// @cond internal
 	Resource(std::unique_ptr<internal::ResourceImpl> impl);
@@ -41,6 +64,12 @@ public:
 	std::string getError() const;
 	/// @}
 
+	/// @name Asynchronous Waiting
+	/// @{
+	std::shared_future<void> finished();
+	void whenFinished(const FinishedHandler &handler);
+	/// @}
+
 	/// @name Disabled
 	/// @{
 	Resource(const Resource &) = delete;
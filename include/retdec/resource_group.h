@@ -0,0 +1,66 @@
+///
+/// @file      retdec/resource_group.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Group of resources that can be waited for together.
+///
+
+#ifndef RETDEC_RESOURCE_GROUP_H
+#define RETDEC_RESOURCE_GROUP_H
+
+#include <cstddef>
+#include <memory>
+
+namespace retdec {
+
+class Resource;
+
+///
+/// Group of resources that can be waited for together.
+///
+/// The statuses of all resources in the group are polled asynchronously, on
+/// the threads of the I/O service shared by connections, so waiting for many
+/// resources needs neither a thread per resource nor a status request per
+/// resource and waiting thread.
+///
+/// The resources are not owned by the group. They have to outlive it.
+///
+class ResourceGroup {
+public:
+	ResourceGroup();
+	~ResourceGroup();
+
+	/// @name Adding
+	/// @{
+	void add(Resource &resource);
+	/// @}
+
+	/// @name Querying
+	/// @{
+	std::size_t size() const;
+	bool empty() const;
+	/// @}
+
+	/// @name Waiting
+	/// @{
+	void waitAll();
+	Resource &waitAny();
+	/// @}
+
+	/// @name Disabled
+	/// @{
+	ResourceGroup(const ResourceGroup &) = delete;
+	ResourceGroup(ResourceGroup &&) = delete;
+	ResourceGroup &operator=(const ResourceGroup &) = delete;
+	ResourceGroup &operator=(ResourceGroup &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> pimpl;
+};
+
+} // namespace retdec
+
+#endif
@@ -13,12 +13,18 @@
 
 #include "retdec/analysis.h"
 #include "retdec/analysis_arguments.h"
+#include "retdec/coroutines.h"
 #include "retdec/decompilation.h"
 #include "retdec/decompilation_arguments.h"
 #include "retdec/decompiler.h"
 #include "retdec/exceptions.h"
 #include "retdec/file.h"
 #include "retdec/fileinfo.h"
+#include "retdec/metrics.h"
+#include "retdec/polling_policy.h"
+#include "retdec/request_observer.h"
+#include "retdec/resource_group.h"
 #include "retdec/settings.h"
+#include "retdec/tracer.h"
 
 #endif
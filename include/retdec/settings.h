@@ -8,11 +8,18 @@
 #ifndef RETDEC_SETTINGS_H
 #define RETDEC_SETTINGS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 namespace retdec {
 
+class Metrics;
+class PollingPolicy;
+class RequestObserver;
+class Tracer;
+
 ///
 /// Library settings.
 ///
@@ -49,12 +56,103 @@ public:
 	std::string userAgent() const;
 	/// @}
 
+	/// @name Connection Pool
+	/// @{
+	Settings &connectionPoolSize(std::size_t connectionPoolSize);
+	Settings withConnectionPoolSize(std::size_t connectionPoolSize) const;
+	std::size_t connectionPoolSize() const;
+
+	Settings &maxConnectionCount(std::size_t maxConnectionCount);
+	Settings withMaxConnectionCount(std::size_t maxConnectionCount) const;
+	std::size_t maxConnectionCount() const;
+
+	Settings &connectionIdleTimeout(int connectionIdleTimeout);
+	Settings withConnectionIdleTimeout(int connectionIdleTimeout) const;
+	int connectionIdleTimeout() const;
+	/// @}
+
+	/// @name I/O Threads
+	/// @{
+	Settings &ioThreadCount(std::size_t ioThreadCount);
+	Settings withIoThreadCount(std::size_t ioThreadCount) const;
+	std::size_t ioThreadCount() const;
+	/// @}
+
+	/// @name Polling
+	/// @{
+	Settings &pollingPolicy(std::shared_ptr<const PollingPolicy> pollingPolicy);
+	Settings withPollingPolicy(
+		std::shared_ptr<const PollingPolicy> pollingPolicy) const;
+	std::shared_ptr<const PollingPolicy> pollingPolicy() const;
+	/// @}
+
+	/// @name Result Cache
+	/// @{
+	Settings &resultCacheDirectory(const std::string &resultCacheDirectory);
+	Settings withResultCacheDirectory(
+		const std::string &resultCacheDirectory) const;
+	std::string resultCacheDirectory() const;
+
+	Settings &resultCacheMaxSize(std::uint64_t resultCacheMaxSize);
+	Settings withResultCacheMaxSize(std::uint64_t resultCacheMaxSize) const;
+	std::uint64_t resultCacheMaxSize() const;
+	/// @}
+
+	/// @name Deduplication
+	/// @{
+	Settings &deduplicateRuns(bool deduplicateRuns);
+	Settings withDeduplicateRuns(bool deduplicateRuns) const;
+	bool deduplicateRuns() const;
+	/// @}
+
+	/// @name Journal
+	/// @{
+	Settings &journalPath(const std::string &journalPath);
+	Settings withJournalPath(const std::string &journalPath) const;
+	std::string journalPath() const;
+	/// @}
+
+	/// @name Request Observer
+	/// @{
+	Settings &requestObserver(
+		std::shared_ptr<RequestObserver> requestObserver);
+	Settings withRequestObserver(
+		std::shared_ptr<RequestObserver> requestObserver) const;
+	std::shared_ptr<RequestObserver> requestObserver() const;
+	/// @}
+
+	/// @name Metrics
+	/// @{
+	Settings &metrics(std::shared_ptr<Metrics> metrics);
+	Settings withMetrics(std::shared_ptr<Metrics> metrics) const;
+	std::shared_ptr<Metrics> metrics() const;
+	/// @}
+
+	/// @name Tracer
+	/// @{
+	Settings &tracer(std::shared_ptr<Tracer> tracer);
+	Settings withTracer(std::shared_ptr<Tracer> tracer) const;
+	std::shared_ptr<Tracer> tracer() const;
+	/// @}
+
 public:
 	/// @name Default Values
 	/// @{
 	static const std::string DefaultApiUrl;
 	static const std::string DefaultApiKey;
 	static const std::string DefaultUserAgent;
+	static const std::size_t DefaultConnectionPoolSize;
+	static const std::size_t DefaultMaxConnectionCount;
+	static const int DefaultConnectionIdleTimeout;
+	static const std::size_t DefaultIoThreadCount;
+	static const std::shared_ptr<const PollingPolicy> DefaultPollingPolicy;
+	static const std::string DefaultResultCacheDirectory;
+	static const std::uint64_t DefaultResultCacheMaxSize;
+	static const bool DefaultDeduplicateRuns;
+	static const std::string DefaultJournalPath;
+	static const std::shared_ptr<RequestObserver> DefaultRequestObserver;
+	static const std::shared_ptr<Metrics> DefaultMetrics;
+	static const std::shared_ptr<Tracer> DefaultTracer;
 	/// @}
 
 private:
@@ -66,6 +164,43 @@ private:
 
 	/// User agent.
 	std::string userAgent_;
+
+	/// Maximal number of idle connections kept open per API URL.
+	std::size_t connectionPoolSize_;
+
+	/// Maximal number of connections used at once per API URL.
+	std::size_t maxConnectionCount_;
+
+	/// Time after which an idle pooled connection is dropped (in ms).
+	int connectionIdleTimeout_;
+
+	/// Number of threads processing I/O of connections.
+	std::size_t ioThreadCount_;
+
+	/// Policy deciding how often statuses of resources are polled.
+	std::shared_ptr<const PollingPolicy> pollingPolicy_;
+
+	/// Directory with the cache of results (empty when disabled).
+	std::string resultCacheDirectory_;
+
+	/// Maximal size of the cache of results (in bytes).
+	std::uint64_t resultCacheMaxSize_;
+
+	/// Should identical runs that are in progress share a single resource?
+	bool deduplicateRuns_;
+
+	/// Path to the journal of started resources (empty when disabled).
+	std::string journalPath_;
+
+	/// Observer of sent requests (null when there is none).
+	std::shared_ptr<RequestObserver> requestObserver_;
+
+	/// Metrics into which requests and resources are recorded (null when
+	/// they are not recorded).
+	std::shared_ptr<Metrics> metrics_;
+
+	/// Tracer of lifecycles of resources (null when they are not traced).
+	std::shared_ptr<Tracer> tracer_;
 };
 
 } // namespace retdec
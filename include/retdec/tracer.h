@@ -0,0 +1,71 @@
+///
+/// @file      retdec/tracer.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tracer of lifecycles of resources.
+///
+
+#ifndef RETDEC_TRACER_H
+#define RETDEC_TRACER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace retdec {
+
+namespace internal {
+
+class TraceBuffer;
+
+} // namespace internal
+
+///
+/// Tracer of lifecycles of resources.
+///
+/// Resources are traced by services whose settings contain the tracer (see
+/// Settings::tracer()). Every resource gets its own track, on which the
+/// following spans and events are shown: the request starting the resource
+/// (@c run), status updates (@c updateStatus and @c pollStatus), changes in
+/// completion (@c completion), waiting (@c waitUntilFinished), obtaining of
+/// outputs (@c getOutput, @c downloadOutput, and @c streamOutput), and saving
+/// of copies of output files (@c saveCopyTo).
+///
+/// Only the most recent events are kept, up to the capacity of the tracer. A
+/// single tracer may be shared by any number of services and used from any
+/// number of threads.
+///
+class Tracer {
+public:
+	explicit Tracer(std::size_t capacity = DefaultCapacity);
+	~Tracer();
+
+	/// @name Exporting
+	/// @{
+	std::string toChromeTraceJson() const;
+	void writeChromeTrace(const std::string &filePath) const;
+	/// @}
+
+	/// @cond internal
+	std::shared_ptr<::retdec::internal::TraceBuffer> buffer() const;
+	/// @endcond
+
+	/// @name Disabled
+	/// @{
+	Tracer(const Tracer &) = delete;
+	Tracer(Tracer &&) = delete;
+	Tracer &operator=(const Tracer &) = delete;
+	Tracer &operator=(Tracer &&) = delete;
+	/// @}
+
+	/// Default maximal number of kept events.
+	static const std::size_t DefaultCapacity;
+
+private:
+	/// Buffer holding the events.
+	const std::shared_ptr<::retdec::internal::TraceBuffer> buffer_;
+};
+
+} // namespace retdec
+
+#endif
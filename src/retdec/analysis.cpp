@@ -14,8 +14,9 @@
 #include "retdec/file.h"
 #include "retdec/internal/connections/real_connection.h"
 #include "retdec/internal/resource_impl.h"
+#include "retdec/internal/trace_buffer.h"
 #include "retdec/internal/utilities/connection.h"
-#include "retdec/internal/utilities/os.h"
+#include "retdec/polling_policy.h"
 
 using namespace retdec::internal;
 
@@ -31,7 +32,8 @@ public:
 		const std::string &id,
 		const std::shared_ptr<Connection> &conn,
 		const std::string &serviceName,
-		const std::string &resourcesName
+		const std::string &resourcesName,
+		const ResourceContext &context
 	);
 	virtual ~AnalysisImpl() override;
 
@@ -51,13 +53,15 @@ public:
 /// @param[in] conn Connection to be used to communicate with the API.
 /// @param[in] serviceName Name of the service.
 /// @param[in] resourcesName Name of the resources (plural).
+/// @param[in] context Context in which the resource is created.
 ///
 AnalysisImpl::AnalysisImpl(
 		const std::string &id,
 		const std::shared_ptr<Connection> &conn,
 		const std::string &serviceName,
-		const std::string &resourcesName
-	): ResourceImpl(id, conn, serviceName, resourcesName),
+		const std::string &resourcesName,
+		const ResourceContext &context
+	): ResourceImpl(id, conn, serviceName, resourcesName, context),
 	outputUrl(baseUrl + "/output")
 	{}
 
@@ -68,21 +72,32 @@ AnalysisImpl::~AnalysisImpl() = default;
 /// Gets and stores the results as an output file.
 ///
 void AnalysisImpl::getAndStoreOutputAsFile() {
+	TraceSpan span(trace, "getOutput");
 	auto response = conn->sendGetRequest(outputUrl);
-	outputAsFile = response->bodyAsFile();
+	outputAsFile = traced(response->bodyAsFile());
 }
 
 } // namespace internal
 
 ///
-/// Constructs an analysis.
+/// Constructs an analysis outside of a service.
 ///
-Analysis::Analysis(const std::string &id,const std::shared_ptr<Connection> &conn):
+Analysis::Analysis(const std::string &id,
+		const std::shared_ptr<Connection> &conn):
+	Analysis(id, conn, ResourceContext()) {}
+
+///
+/// Constructs an analysis in the given context.
+///
+Analysis::Analysis(const std::string &id,
+		const std::shared_ptr<Connection> &conn,
+		const ResourceContext &context):
 	Resource(std::make_unique<AnalysisImpl>(
 		id,
 		conn,
 		"fileinfo",
-		"analyses"
+		"analyses",
+		context
 	)) {}
 
 // Override.
@@ -94,16 +109,29 @@ Analysis::~Analysis() = default;
 /// @param[in] onError Should AnalysisError be thrown when the
 ///                    analysis fails?
 ///
+/// The status is polled as often as the polling policy from the settings of
+/// the service says.
+///
 /// May access the API.
 ///
 void Analysis::waitUntilFinished(OnError onError) {
-	// Currently, there is no other choice but polling.
-	while (!impl()->finished) {
-		impl()->updateStatus();
+	waitUntilFinished(*impl()->pollingPolicy, onError);
+}
 
-		// Wait a bit before the next try to update the status.
-		sleep(500);
-	}
+///
+/// Waits until the analysis is finished, polling its status as often as the
+/// given policy says.
+///
+/// @param[in] pollingPolicy Policy deciding how often the status is polled.
+/// @param[in] onError Should AnalysisError be thrown when the
+///                    analysis fails?
+///
+/// May access the API.
+///
+void Analysis::waitUntilFinished(const PollingPolicy &pollingPolicy,
+		OnError onError) {
+	// Currently, there is no other choice but polling.
+	impl()->waitUntilFinished(pollingPolicy, []() {});
 
 	if (impl()->failed && onError == OnError::Throw) {
 		throw AnalysisError(impl()->error);
@@ -137,6 +165,63 @@ std::string Analysis::getOutput() {
 	return getOutputAsFile()->getContent();
 }
 
+///
+/// Returns a read-only view of the content of the results of the analysis.
+///
+/// Unlike getOutput(), which returns a new copy of the content on every call,
+/// the view shares the content with the file returned by getOutputAsFile(), so
+/// no copy is made.
+///
+/// This function should be called only after the analysis has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+File::ContentView Analysis::getOutputView() {
+	return getOutputAsFile()->getContentView();
+}
+
+///
+/// Downloads the results of the analysis as a file into the given directory.
+///
+/// @param[in] directoryPath Path to the directory into which the file is
+///                          downloaded.
+///
+/// @returns The downloaded file.
+///
+/// @throws FilesystemError When the file cannot be written.
+///
+/// Unlike getOutputAsFile(), the results are written to the directory as they
+/// are being received, so they are never stored in memory as a whole. The
+/// returned file is also returned by subsequent calls to getOutputAsFile().
+///
+/// This function should be called only after the analysis has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+std::shared_ptr<File> Analysis::downloadOutputAsFile(
+		const std::string &directoryPath) {
+	impl()->outputAsFile = impl()->downloadOutputFile(
+		impl()->outputUrl, directoryPath);
+	return impl()->outputAsFile;
+}
+
+///
+/// Passes the results of the analysis to the given handler, in parts, as they
+/// are being received.
+///
+/// The results are not stored, so every call accesses the API.
+///
+/// This function should be called only after the analysis has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+void Analysis::streamOutput(const OutputHandler &outputHandler) {
+	impl()->streamOutputFile(impl()->outputUrl, outputHandler);
+}
+
 ///
 /// Returns a properly cast private implementation.
 ///
@@ -5,8 +5,11 @@
 /// @brief     Implementation of the decompilation.
 ///
 
+#include <exception>
 #include <utility>
 
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <json/json.h>
 
 #include "retdec/decompilation.h"
@@ -14,8 +17,9 @@
 #include "retdec/file.h"
 #include "retdec/internal/connections/real_connection.h"
 #include "retdec/internal/resource_impl.h"
+#include "retdec/internal/trace_buffer.h"
 #include "retdec/internal/utilities/connection.h"
-#include "retdec/internal/utilities/os.h"
+#include "retdec/polling_policy.h"
 
 using namespace retdec::internal;
 
@@ -30,25 +34,64 @@ const Decompilation::Callback CallbackDoingNothing = [](const Decompilation &) {
 
 namespace internal {
 
+///
+/// Output file of a decompilation, which may be stored from a thread of the
+/// I/O service.
+///
+class SharedOutputFile {
+public:
+	///
+	/// Returns the stored file (null when no file has been stored).
+	///
+	std::shared_ptr<File> get() const {
+		boost::lock_guard<boost::mutex> lock(mutex);
+		return file;
+	}
+
+	///
+	/// Stores the given file.
+	///
+	void set(const std::shared_ptr<File> &file) {
+		boost::lock_guard<boost::mutex> lock(mutex);
+		this->file = file;
+	}
+
+private:
+	/// Stored file.
+	std::shared_ptr<File> file;
+
+	/// Mutex guarding the file.
+	mutable boost::mutex mutex;
+};
+
 ///
 /// Private implementation of Decompilation.
 ///
 class DecompilationImpl: public ResourceImpl {
+public:
+	/// Function to which an obtained output file is passed (or the error that
+	/// occurred when obtaining it).
+	using OutputFileHandler = std::function<
+		void (std::shared_ptr<File> file, std::exception_ptr error)>;
+
 public:
 	DecompilationImpl(
 		const std::string &id,
 		const std::shared_ptr<Connection> &conn,
 		const std::string &serviceName,
-		const std::string &resourcesName
+		const std::string &resourcesName,
+		const ResourceContext &context
 	);
 	virtual ~DecompilationImpl() override;
 
 	/// @name Status Update
 	/// @{
-	virtual void updateResourceSpecificStatus(const Json::Value &jsonBody) override;
+	virtual void updateResourceSpecificStatus(
+		const ResourceStatus &status) override;
 	/// @}
 
-	void getAndStoreOutputHllFile();
+	std::shared_ptr<File> getAndStoreOutputHllFile();
+	void getAndStoreOutputHllFileAsync(const OutputFileHandler &handler);
 
 	/// URL to obtain the outputs of the resource.
 	const Connection::Url outputsUrl;
@@ -56,8 +99,11 @@ public:
 	/// Completion (in percentages, 0-100).
 	int completion = 0;
 
-	/// Output HLL file.
-	std::shared_ptr<File> outputHllFile;
+	/// Output HLL file (null until it is obtained). It is shared with handlers
+	/// of asynchronous requests, which may finish after the decompilation has
+	/// been destructed.
+	const std::shared_ptr<SharedOutputFile> outputHllFile =
+		std::make_shared<SharedOutputFile>();
 };
 
 ///
@@ -67,13 +113,15 @@ public:
 /// @param[in] conn Connection to be used to communicate with the API.
 /// @param[in] serviceName Name of the service.
 /// @param[in] resourcesName Name of the resources (plural).
+/// @param[in] context Context in which the resource is created.
 ///
 DecompilationImpl::DecompilationImpl(
 		const std::string &id,
 		const std::shared_ptr<Connection> &conn,
 		const std::string &serviceName,
-		const std::string &resourcesName
-	): ResourceImpl(id, conn, serviceName, resourcesName),
+		const std::string &resourcesName,
+		const ResourceContext &context
+	): ResourceImpl(id, conn, serviceName, resourcesName, context),
 	outputsUrl(baseUrl + "/outputs")
 	{}
 
@@ -81,30 +129,75 @@ DecompilationImpl::DecompilationImpl(
 DecompilationImpl::~DecompilationImpl() = default;
 
 // Override.
-void DecompilationImpl::updateResourceSpecificStatus(const Json::Value &jsonBody) {
-	completion = jsonBody.get("completion", false).asInt();
+void DecompilationImpl::updateResourceSpecificStatus(
+		const ResourceStatus &status) {
+	completion = status.completion.value_or(0);
 }
 
 ///
 /// Gets and stores the output HLL file.
 ///
-void DecompilationImpl::getAndStoreOutputHllFile() {
+/// @returns The stored file.
+///
+std::shared_ptr<File> DecompilationImpl::getAndStoreOutputHllFile() {
+	TraceSpan span(trace, "getOutput");
 	auto response = conn->sendGetRequest(outputsUrl + "/hll");
-	outputHllFile = response->bodyAsFile();
+	auto file = traced(response->bodyAsFile());
+	outputHllFile->set(file);
+	return file;
+}
+
+///
+/// Gets and stores the output HLL file without blocking the calling thread,
+/// and passes the stored file to @a handler.
+///
+/// @a handler is called from a thread of the I/O service.
+///
+void DecompilationImpl::getAndStoreOutputHllFileAsync(
+		const OutputFileHandler &handler) {
+	// The decompilation may be destructed before the response is received,
+	// so do not capture it.
+	auto outputHllFile = this->outputHllFile;
+	auto trace = this->trace;
+	auto start = TraceBuffer::Clock::now();
+	conn->sendGetRequestAsync(outputsUrl + "/hll",
+		[handler, outputHllFile, trace, start](
+				std::unique_ptr<Connection::Response> response,
+				std::exception_ptr error) {
+			if (trace) {
+				trace->buffer->recordSpan("getOutput", trace->track, start);
+			}
+			if (error) {
+				return handler(nullptr, error);
+			}
+			auto file = traced(response->bodyAsFile(), trace);
+			outputHllFile->set(file);
+			handler(file, nullptr);
+		}
+	);
 }
 
 } // namespace internal
 
 ///
-/// Constructs a decompilation.
+/// Constructs a decompilation outside of a service.
 ///
 Decompilation::Decompilation(const std::string &id,
 		const std::shared_ptr<Connection> &conn):
+	Decompilation(id, conn, ResourceContext()) {}
+
+///
+/// Constructs a decompilation in the given context.
+///
+Decompilation::Decompilation(const std::string &id,
+		const std::shared_ptr<Connection> &conn,
+		const ResourceContext &context):
 	Resource(std::make_unique<DecompilationImpl>(
 		id,
 		conn,
 		"decompiler",
-		"decompilations"
+		"decompilations",
+		context
 	)) {}
 
 // Override.
@@ -135,10 +228,13 @@ int Decompilation::getCompletion() const noexcept {
 /// @param[in] onError Should DecompilationError be thrown when the
 ///                    decompilation fails?
 ///
+/// The status is polled as often as the polling policy from the settings of
+/// the decompiler says.
+///
 /// May access the API.
 ///
 void Decompilation::waitUntilFinished(OnError onError) {
-	waitUntilFinished(CallbackDoingNothing, onError);
+	waitUntilFinished(CallbackDoingNothing, *impl()->pollingPolicy, onError);
 }
 
 ///
@@ -149,20 +245,53 @@ void Decompilation::waitUntilFinished(OnError onError) {
 /// @param[in] onError Should DecompilationError be thrown when the
 ///                    decompilation fails?
 ///
+/// The status is polled as often as the polling policy from the settings of
+/// the decompiler says.
+///
 /// May access the API.
 ///
 void Decompilation::waitUntilFinished(const Callback &callback,
 		OnError onError) {
+	waitUntilFinished(callback, *impl()->pollingPolicy, onError);
+}
+
+///
+/// Waits until the decompilation is finished, polling its status as often as
+/// the given policy says.
+///
+/// @param[in] pollingPolicy Policy deciding how often the status is polled.
+/// @param[in] onError Should DecompilationError be thrown when the
+///                    decompilation fails?
+///
+/// May access the API.
+///
+void Decompilation::waitUntilFinished(const PollingPolicy &pollingPolicy,
+		OnError onError) {
+	waitUntilFinished(CallbackDoingNothing, pollingPolicy, onError);
+}
+
+///
+/// Waits and reports changes until the decompilation is finished, polling its
+/// status as often as the given policy says.
+///
+/// @param[in] callback Function to be called when the decompilation status
+///                     changes.
+/// @param[in] pollingPolicy Policy deciding how often the status is polled.
+/// @param[in] onError Should DecompilationError be thrown when the
+///                    decompilation fails?
+///
+/// May access the API.
+///
+void Decompilation::waitUntilFinished(const Callback &callback,
+		const PollingPolicy &pollingPolicy, OnError onError) {
 	// Currently, there is no other choice but polling.
-	while (!impl()->finished) {
-		auto lastCompletion = impl()->completion;
-		impl()->updateStatus();
+	auto lastCompletion = impl()->completion;
+	impl()->waitUntilFinished(pollingPolicy, [&]() {
 		if (impl()->completion != lastCompletion) {
+			lastCompletion = impl()->completion;
 			callback(*this);
 		}
-		// Wait a bit before the next try to update the status.
-		sleep(500);
-	}
+	});
 
 	if (impl()->failed && onError == OnError::Throw) {
 		throw DecompilationError(impl()->error);
@@ -178,10 +307,10 @@ void Decompilation::waitUntilFinished(const Callback &callback,
 /// May access the API.
 ///
 std::shared_ptr<File> Decompilation::getOutputHllFile() {
-	if (!impl()->outputHllFile) {
-		impl()->getAndStoreOutputHllFile();
+	if (auto file = impl()->outputHllFile->get()) {
+		return file;
 	}
-	return impl()->outputHllFile;
+	return impl()->getAndStoreOutputHllFile();
 }
 
 ///
@@ -196,6 +325,109 @@ std::string Decompilation::getOutputHll() {
 	return getOutputHllFile()->getContent();
 }
 
+///
+/// Returns a read-only view of the content of the output HLL file (C, Python').
+///
+/// Unlike getOutputHll(), which returns a new copy of the content on every
+/// call, the view shares the content with the file returned by
+/// getOutputHllFile(), so no copy is made.
+///
+/// This function should be called only after the decompilation has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+File::ContentView Decompilation::getOutputHllView() {
+	return getOutputHllFile()->getContentView();
+}
+
+///
+/// Downloads the output HLL file (C, Python') into the given directory.
+///
+/// @param[in] directoryPath Path to the directory into which the file is
+///                          downloaded.
+///
+/// @returns The downloaded file.
+///
+/// @throws FilesystemError When the file cannot be written.
+///
+/// Unlike getOutputHllFile(), the content of the file is written to the
+/// directory as it is being received, so it is never stored in memory as a
+/// whole. The returned file is also returned by subsequent calls to
+/// getOutputHllFile().
+///
+/// This function should be called only after the decompilation has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+std::shared_ptr<File> Decompilation::downloadOutputHllFile(
+		const std::string &directoryPath) {
+	auto file = impl()->downloadOutputFile(impl()->outputsUrl + "/hll",
+		directoryPath);
+	impl()->outputHllFile->set(file);
+	return file;
+}
+
+///
+/// Passes the content of the output HLL file (C, Python') to the given
+/// handler, in parts, as it is being received.
+///
+/// The content is not stored, so every call accesses the API.
+///
+/// This function should be called only after the decompilation has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+void Decompilation::streamOutputHll(const OutputHandler &outputHandler) {
+	impl()->streamOutputFile(impl()->outputsUrl + "/hll", outputHandler);
+}
+
+///
+/// Passes the content of the output HLL file (C, Python') to @a handler
+/// without blocking the calling thread.
+///
+/// This is a callback-based counterpart of getOutputHll(), suitable for
+/// adapting the obtaining to other asynchronous models (e.g. coroutines). When
+/// the output cannot be obtained, the error is passed to @a handler instead.
+/// It should not throw.
+///
+/// Like getOutputHll(), it stores the output file, so it is obtained from the
+/// API only once, no matter which of the two functions obtains it. When the
+/// file has already been obtained, @a handler is called right away, from the
+/// calling thread. Otherwise, it is called from a thread of the I/O service
+/// shared by connections, which also sends and receives requests of all
+/// connections. Hence, @a handler should return quickly and must not wait for
+/// functions that access the API synchronously (e.g. getOutputHllFile() or
+/// waitUntilFinished()).
+///
+/// This function should be called only after the decompilation has finished,
+/// i.e. hasFinished() returns @c true.
+///
+/// May access the API.
+///
+void Decompilation::getOutputHllAsync(const OutputHllHandler &handler) {
+	auto passContent = [handler](std::shared_ptr<File> file,
+			std::exception_ptr error) {
+		if (error) {
+			return handler(std::string(), error);
+		}
+		std::string outputHll;
+		try {
+			outputHll = file->getContent();
+		} catch (...) {
+			return handler(std::string(), std::current_exception());
+		}
+		handler(std::move(outputHll), nullptr);
+	};
+
+	if (auto file = impl()->outputHllFile->get()) {
+		return passContent(file, nullptr);
+	}
+	impl()->getAndStoreOutputHllFileAsync(passContent);
+}
+
 ///
 /// Returns a properly cast private implementation.
 ///
@@ -8,7 +8,7 @@
 #include "retdec/decompilation.h"
 #include "retdec/decompilation_arguments.h"
 #include "retdec/decompiler.h"
-#include "retdec/internal/connection_managers/real_connection_manager.h"
+#include "retdec/internal/connection_managers/pooled_connection_manager.h"
 #include "retdec/internal/service_with_resources_impl.h"
 #include "retdec/settings.h"
 
@@ -39,7 +39,8 @@ DecompilerImpl::DecompilerImpl(const Settings &settings,
 		settings,
 		connectionManager,
 		"decompiler",
-		"decompilations"
+		"decompilations",
+		{"outputs/hll"}
 	) {}
 
 // Override.
@@ -51,7 +52,7 @@ DecompilerImpl::~DecompilerImpl() = default;
 /// Constructs a decompiler with the given settings.
 ///
 Decompiler::Decompiler(const Settings &settings):
-	Decompiler(settings, std::make_shared<RealConnectionManager>()) {}
+	Decompiler(settings, std::make_shared<PooledConnectionManager>()) {}
 
 ///
 /// Constructs a decompiler with the given settings and connection manager.
@@ -73,6 +74,68 @@ std::unique_ptr<Decompilation> Decompiler::runDecompilation(
 	return impl()->runResource<Decompilation>(args);
 }
 
+///
+/// Runs a new decompilation with the given arguments without blocking the
+/// calling thread.
+///
+/// The input file is uploaded from a thread of the I/O service shared by
+/// connections. The returned future holds either the decompilation or the
+/// error that occurred. Use Decompilation::finished() to wait until it
+/// finishes.
+///
+std::future<std::unique_ptr<Decompilation>> Decompiler::runDecompilationAsync(
+		const DecompilationArguments &args) {
+	return impl()->runResourceAsync<Decompilation>(args);
+}
+
+///
+/// Runs a new decompilation with the given arguments and passes it to
+/// @a handler without blocking the calling thread.
+///
+/// This is a callback-based counterpart of the overload returning a future,
+/// suitable for adapting the running to other asynchronous models (e.g.
+/// coroutines). When the decompilation cannot be run, the error is passed to
+/// @a handler instead. @a handler is called from a thread of the I/O service
+/// shared by connections. It should not throw.
+///
+void Decompiler::runDecompilationAsync(const DecompilationArguments &args,
+		const DecompilationHandler &handler) {
+	impl()->runResourceAsync<Decompilation>(args, handler);
+}
+
+///
+/// Returns the decompilation with the given ID from the journal of started
+/// decompilations without running it again.
+///
+/// It can be used to continue waiting for decompilations started before the
+/// process was restarted. The journal has to be enabled by
+/// Settings::journalPath(). No request is sent, so the input file is not
+/// uploaded again. The status of the decompilation is polled once it is queried
+/// or waited for.
+///
+/// @throws Error When the journal is disabled or it contains no
+///               decompilation with the given ID started by a decompiler with
+///               the same API URL.
+///
+std::unique_ptr<Decompilation> Decompiler::reattach(const std::string &id) {
+	return impl()->reattachResource<Decompilation>(id);
+}
+
+///
+/// Returns the IDs of all unfinished decompilations in the journal of started
+/// decompilations, in the order in which they were started.
+///
+/// The journal has to be enabled by Settings::journalPath(). Decompilations
+/// that have failed or whose output has been obtained are marked as finished in
+/// the journal and their IDs are not returned. They can still be reattached to
+/// until they are removed when the journal is compacted.
+///
+/// @throws Error When the journal is disabled.
+///
+std::vector<std::string> Decompiler::journaledIds() const {
+	return impl()->journaledResourceIds();
+}
+
 ///
 /// Returns a properly cast private implementation.
 ///
@@ -6,15 +6,59 @@
 ///
 
 #include <memory>
+#include <sstream>
+#include <utility>
 
 #include "retdec/file.h"
 #include "retdec/internal/files/filesystem_file.h"
+#include "retdec/internal/files/mapped_file.h"
 #include "retdec/internal/files/string_file.h"
 
 using namespace retdec::internal;
 
 namespace retdec {
 
+///
+/// Constructs a view of the given bytes.
+///
+/// @param[in] owner Object owning the bytes. It is kept alive by the view.
+/// @param[in] data Pointer to the first byte.
+/// @param[in] size Number of bytes.
+///
+File::ContentView::ContentView(std::shared_ptr<const void> owner,
+		const char *data, std::size_t size):
+	owner(std::move(owner)), data_(data), size_(size) {}
+
+///
+/// Returns a pointer to the first byte of the content.
+///
+/// The content is not terminated by a null character.
+///
+const char *File::ContentView::data() const noexcept {
+	return data_;
+}
+
+///
+/// Returns the size of the content (in bytes).
+///
+std::size_t File::ContentView::size() const noexcept {
+	return size_;
+}
+
+///
+/// Is the content empty?
+///
+bool File::ContentView::empty() const noexcept {
+	return size_ == 0;
+}
+
+///
+/// Returns a copy of the content.
+///
+std::string File::ContentView::toString() const {
+	return std::string(data_, size_);
+}
+
 ///
 /// Constructs a file.
 ///
@@ -37,6 +81,41 @@ File::~File() = default;
 /// Returns the content of the file.
 ///
 
+///
+/// Returns a read-only view of the content of the file.
+///
+/// The default implementation obtains the content from getContent() and the
+/// view owns it. Subclasses that already hold their content in memory (or can
+/// map it into memory) should override it, so the content is not copied.
+///
+File::ContentView File::getContentView() {
+	auto content = std::make_shared<const std::string>(getContent());
+	return ContentView(content, content->data(), content->size());
+}
+
+///
+/// Returns the size of the content of the file (in bytes).
+///
+/// The default implementation obtains the size from getContent(). Subclasses
+/// that can get the size without reading the whole content should override
+/// it.
+///
+std::uint64_t File::getSize() {
+	return getContent().size();
+}
+
+///
+/// Opens the content of the file for reading.
+///
+/// The returned stream allows reading the content in parts, so large files do
+/// not have to be held in memory at once. The default implementation reads the
+/// stream from getContent(). Subclasses that can read their content
+/// incrementally should override it.
+///
+std::unique_ptr<std::istream> File::openContent() {
+	return std::make_unique<std::istringstream>(getContent());
+}
+
 /// @fn File::saveCopyTo(const std::string &directoryPath)
 ///
 /// Stores a copy of the file into the given directory.
@@ -54,11 +133,42 @@ File::~File() = default;
 /// @param[in] content Content of the file.
 /// @param[in] name Name of the file.
 ///
+/// The content is copied into the file.
+///
 std::unique_ptr<File> File::fromContentWithName(const std::string &content,
 		const std::string &name) {
 	return std::make_unique<StringFile>(content, name);
 }
 
+///
+/// Returns a file containing the given content with the given name.
+///
+/// @param[in] content Content of the file.
+/// @param[in] name Name of the file.
+///
+/// The content is moved into the file, so it is not copied.
+///
+std::unique_ptr<File> File::fromContentWithName(std::string &&content,
+		const std::string &name) {
+	return std::make_unique<StringFile>(std::move(content), name);
+}
+
+///
+/// Returns a file containing the given shared content with the given name.
+///
+/// @param[in] content Content of the file. It must not be null.
+/// @param[in] name Name of the file.
+///
+/// The content is not copied. The file only keeps it alive, so the same
+/// content can be shared by many files (and other objects) at once.
+/// getContentView() and openContent() of the returned file do not copy it
+/// either.
+///
+std::unique_ptr<File> File::fromSharedContentWithName(
+		std::shared_ptr<const std::string> content, const std::string &name) {
+	return std::make_unique<StringFile>(std::move(content), name);
+}
+
 ///
 /// Returns a file from the given path.
 ///
@@ -84,4 +194,21 @@ std::unique_ptr<File> File::fromFilesystemWithOtherName(
 	return std::make_unique<FilesystemFile>(path, name);
 }
 
+///
+/// Returns a file from the given path whose content is mapped into memory.
+///
+/// @param[in] path Path to the file.
+///
+/// The file is mapped when this function is called and stays mapped until
+/// the returned file is destructed, so its content is read from the disk at
+/// most once, no matter how many times it is obtained (e.g. when the file is
+/// uploaded and hashed). getContentView() and openContent() do not copy the
+/// content. When the file cannot be mapped (e.g. because it is empty or it is
+/// not a regular file), the returned file behaves like a file returned by
+/// fromFilesystem(). The file must not be modified while it is mapped.
+///
+std::unique_ptr<File> File::fromFilesystemMapped(const std::string &path) {
+	return std::make_unique<MappedFile>(path);
+}
+
 } // namespace retdec
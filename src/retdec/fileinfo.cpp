@@ -8,7 +8,7 @@
 #include "retdec/analysis.h"
 #include "retdec/analysis_arguments.h"
 #include "retdec/fileinfo.h"
-#include "retdec/internal/connection_managers/real_connection_manager.h"
+#include "retdec/internal/connection_managers/pooled_connection_manager.h"
 #include "retdec/internal/service_with_resources_impl.h"
 #include "retdec/settings.h"
 
@@ -39,7 +39,8 @@ FileinfoImpl::FileinfoImpl(const Settings &settings,
 		settings,
 		connectionManager,
 		"fileinfo",
-		"analyses"
+		"analyses",
+		{"output"}
 	) {}
 
 // Override.
@@ -51,7 +52,7 @@ FileinfoImpl::~FileinfoImpl() = default;
 /// Constructs a fileinfo with the given settings.
 ///
 Fileinfo::Fileinfo(const Settings &settings):
-	Fileinfo(settings, std::make_shared<RealConnectionManager>()) {}
+	Fileinfo(settings, std::make_shared<PooledConnectionManager>()) {}
 
 ///
 /// Constructs a fileinfo with the given settings and connection manager.
@@ -72,6 +73,66 @@ std::unique_ptr<Analysis> Fileinfo::runAnalysis(const AnalysisArguments &args) {
 	return impl()->runResource<Analysis>(args);
 }
 
+///
+/// Runs a new analysis with the given arguments without blocking the calling
+/// thread.
+///
+/// The input file is uploaded from a thread of the I/O service shared by
+/// connections. The returned future holds either the analysis or the error
+/// that occurred. Use Analysis::finished() to wait until it finishes.
+///
+std::future<std::unique_ptr<Analysis>> Fileinfo::runAnalysisAsync(
+		const AnalysisArguments &args) {
+	return impl()->runResourceAsync<Analysis>(args);
+}
+
+///
+/// Runs a new analysis with the given arguments and passes it to
+/// @a handler without blocking the calling thread.
+///
+/// This is a callback-based counterpart of the overload returning a future,
+/// suitable for adapting the running to other asynchronous models (e.g.
+/// coroutines). When the analysis cannot be run, the error is passed to
+/// @a handler instead. @a handler is called from a thread of the I/O service
+/// shared by connections. It should not throw.
+///
+void Fileinfo::runAnalysisAsync(const AnalysisArguments &args,
+		const AnalysisHandler &handler) {
+	impl()->runResourceAsync<Analysis>(args, handler);
+}
+
+///
+/// Returns the analysis with the given ID from the journal of started
+/// analyses without running it again.
+///
+/// It can be used to continue waiting for analyses started before the
+/// process was restarted. The journal has to be enabled by
+/// Settings::journalPath(). No request is sent, so the input file is not
+/// uploaded again. The status of the analysis is polled once it is queried
+/// or waited for.
+///
+/// @throws Error When the journal is disabled or it contains no analysis with
+///               the given ID started by a fileinfo with the same API URL.
+///
+std::unique_ptr<Analysis> Fileinfo::reattach(const std::string &id) {
+	return impl()->reattachResource<Analysis>(id);
+}
+
+///
+/// Returns the IDs of all unfinished analyses in the journal of started
+/// analyses, in the order in which they were started.
+///
+/// The journal has to be enabled by Settings::journalPath(). Analyses that have
+/// failed or whose output has been obtained are marked as finished in the
+/// journal and their IDs are not returned. They can still be reattached to
+/// until they are removed when the journal is compacted.
+///
+/// @throws Error When the journal is disabled.
+///
+std::vector<std::string> Fileinfo::journaledIds() const {
+	return impl()->journaledResourceIds();
+}
+
 ///
 /// Returns a properly cast private implementation.
 ///
@@ -0,0 +1,98 @@
+///
+/// @file      retdec/internal/clock.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the clocks.
+///
+
+#include <algorithm>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/utilities/os.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Clock showing the real time and blocking when sleeping.
+///
+class SystemClock: public Clock {
+public:
+	SystemClock() = default;
+
+	virtual TimePoint now() const override {
+		return std::chrono::steady_clock::now();
+	}
+
+	virtual void sleepFor(std::chrono::milliseconds duration) override {
+		sleep(static_cast<int>(duration.count()));
+	}
+};
+
+} // anonymous namespace
+
+///
+/// Constructs a clock.
+///
+Clock::Clock() = default;
+
+///
+/// Destructs the clock.
+///
+Clock::~Clock() = default;
+
+/// @fn Clock::now()
+///
+/// Returns the current time.
+///
+
+/// @fn Clock::sleepFor()
+///
+/// Waits for the given duration.
+///
+
+///
+/// Returns the clock showing the real time.
+///
+/// Sleeping on it blocks the calling thread.
+///
+std::shared_ptr<Clock> Clock::system() {
+	static const auto clock = std::make_shared<SystemClock>();
+	return clock;
+}
+
+///
+/// Constructs a virtual clock.
+///
+/// Its time starts at the epoch of @c std::chrono::steady_clock.
+///
+VirtualClock::VirtualClock(): elapsed(0) {}
+
+// Override.
+VirtualClock::~VirtualClock() = default;
+
+// Override.
+Clock::TimePoint VirtualClock::now() const {
+	return TimePoint(Duration(elapsed.load()));
+}
+
+///
+/// Moves the time forward by the given duration without blocking.
+///
+void VirtualClock::sleepFor(std::chrono::milliseconds duration) {
+	advance(duration);
+}
+
+///
+/// Moves the time forward by the given duration.
+///
+/// Negative durations are ignored, so the time never goes back.
+///
+void VirtualClock::advance(Duration duration) {
+	elapsed.fetch_add(std::max(duration, Duration::zero()).count());
+}
+
+} // namespace internal
+} // namespace retdec
@@ -5,7 +5,12 @@
 /// @brief     Implementation of the base class of connections to the API.
 ///
 
+#include <json/json.h>
+
+#include "retdec/internal/clock.h"
 #include "retdec/internal/connection.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/utilities/connection.h"
 
 namespace retdec {
 namespace internal {
@@ -35,16 +40,47 @@ Connection::Response::~Response() = default;
 /// Returns the body of the response (raw).
 ///
 
+///
+/// Returns the body of the response (raw) without copying it.
+///
+/// Unlike body(), which returns a new copy of the body on every call, the
+/// returned buffer may be shared with the response and files created from it.
+///
+/// The default implementation returns a copy of body(). Responses holding their
+/// body in a buffer should override it.
+///
+std::shared_ptr<const std::string> Connection::Response::sharedBody() const {
+	return std::make_shared<const std::string>(body());
+}
+
 /// @fn Connection::Response::bodyAsJson()
 ///
 /// Returns the body of the response as JSON.
 ///
 
+///
+/// Returns the body of the response as a status of a resource.
+///
+/// The default implementation obtains the status from bodyAsJson(). Responses
+/// holding their body in a buffer should override it and decode the status by
+/// using ResourceStatus::fromBody(), which is much cheaper.
+///
+ResourceStatus Connection::Response::bodyAsStatus() const {
+	return ResourceStatus::fromJson(bodyAsJson());
+}
+
 /// @fn Connection::Response::bodyAsFile()
 ///
 /// Returns the body of the response as a file.
 ///
 
+/// @fn Connection::Response::attachedFileName()
+///
+/// Returns the name of the file attached to the response.
+///
+/// When there is no attached file, the empty string is returned.
+///
+
 ///
 /// Constructs a connection.
 ///
@@ -85,5 +121,104 @@ Connection::~Connection() = default;
 /// @param[in] files Files passed in the request.
 ///
 
+///
+/// Sends a GET request to the API and passes the body of the response to
+/// @a bodyHandler.
+///
+/// @param[in] url URL to which the request is sent.
+/// @param[in] bodyHandler Function to which the body is passed.
+///
+/// When the request succeeds, the body is passed to @a bodyHandler in parts as
+/// they arrive, so the body does not have to be held in memory, and the body of
+/// the returned response should not be used. When the request fails, the body
+/// is not passed to @a bodyHandler, but it is available in the returned
+/// response so the error can be reported.
+///
+/// The default implementation sends an ordinary GET request and passes the
+/// whole body at once. Connections able to receive the body incrementally
+/// should override it.
+///
+std::unique_ptr<Connection::Response> Connection::sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) {
+	auto response = sendGetRequest(url);
+	if (requestSucceeded(*response)) {
+		auto body = response->sharedBody();
+		bodyHandler(body->data(), body->size());
+	}
+	return response;
+}
+
+///
+/// Sends a GET request to the API and passes the response to
+/// @a responseHandler when it is received.
+///
+/// @param[in] url URL to which the request is sent.
+/// @param[in] responseHandler Function to which the response is passed.
+///
+/// When the request cannot be sent or its response received, the error is
+/// passed to @a responseHandler instead of being thrown. @a responseHandler
+/// may be called from another thread and it should not throw.
+///
+/// The default implementation calls sendGetRequest() and @a responseHandler
+/// before it returns. Connections able to send requests without blocking the
+/// calling thread should override it.
+///
+void Connection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	passResponseToHandler(
+		[&]() { return sendGetRequest(url); },
+		responseHandler
+	);
+}
+
+///
+/// Sends a GET request with arguments to the API and passes the response to
+/// @a responseHandler when it is received.
+///
+/// @param[in] url URL to which the request is sent.
+/// @param[in] args Arguments passed to the request.
+/// @param[in] responseHandler Function to which the response is passed.
+///
+/// See the overload without @a args for more details.
+///
+void Connection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	passResponseToHandler(
+		[&]() { return sendGetRequest(url, args); },
+		responseHandler
+	);
+}
+
+///
+/// Sends a POST request to the API and passes the response to
+/// @a responseHandler when it is received.
+///
+/// @param[in] url URL to which the request is sent.
+/// @param[in] args Arguments passed in the request.
+/// @param[in] files Files passed in the request.
+/// @param[in] responseHandler Function to which the response is passed.
+///
+/// See sendGetRequestAsync() for more details.
+///
+void Connection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	passResponseToHandler(
+		[&]() { return sendPostRequest(url, args, files); },
+		responseHandler
+	);
+}
+
+///
+/// Returns the clock by which waiting for resources of the API is timed.
+///
+/// The default implementation returns the system clock. Connections to
+/// simulated services return the clock of the simulation, so the time spent by
+/// waiting passes in the simulation rather than in reality.
+///
+std::shared_ptr<Clock> Connection::clock() const {
+	return Clock::system();
+}
+
 } // namespace internal
 } // namespace retdec
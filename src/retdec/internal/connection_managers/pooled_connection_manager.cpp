@@ -0,0 +1,700 @@
+///
+/// @file      retdec/internal/connection_managers/pooled_connection_manager.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the manager of pooled connections to the
+///            API.
+///
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/connection.h"
+#include "retdec/internal/connection_managers/pooled_connection_manager.h"
+#include "retdec/internal/connection_managers/real_connection_manager.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/settings.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Bounded pool of connections to a single API URL.
+///
+/// The number of connections that are used at once is limited by the maximal
+/// connection count. Only up to the pool size of the returned connections is
+/// kept for later requests; the other ones are closed.
+///
+class ConnectionPool: public std::enable_shared_from_this<ConnectionPool> {
+public:
+	/// Function receiving a borrowed connection (or the error that occurred
+	/// when creating it). @c reused is @c true when the connection has already
+	/// been used for other requests.
+	using AcquireHandler = std::function<void (std::shared_ptr<Connection> conn,
+		bool reused, std::exception_ptr error)>;
+
+	///
+	/// Connection borrowed from the pool.
+	///
+	struct BorrowedConnection {
+		/// The connection itself.
+		std::shared_ptr<Connection> conn;
+
+		/// Has the connection already been used for other requests?
+		bool reused;
+	};
+
+public:
+	ConnectionPool(const Settings &settings,
+		const std::shared_ptr<ConnectionManager> &connectionFactory);
+
+	BorrowedConnection acquire();
+	void acquireAsync(const AcquireHandler &handler);
+	void release(const std::shared_ptr<Connection> &conn);
+	void discard();
+	bool isUnused();
+
+	/// Settings used to create new connections.
+	const Settings settings;
+
+private:
+	/// Clock used to measure idle times.
+	using Clock = std::chrono::steady_clock;
+
+	///
+	/// Connection that is currently not borrowed.
+	///
+	struct IdleConnection {
+		/// The connection itself.
+		std::shared_ptr<Connection> conn;
+
+		/// When was the connection returned to the pool?
+		Clock::time_point idleSince;
+	};
+
+	///
+	/// Connection handed over to a synchronous waiter.
+	///
+	struct Handover {
+		/// Has the waiter been served?
+		bool served = false;
+
+		/// The handed over connection (null when the waiter should create a
+		/// new one).
+		std::shared_ptr<Connection> conn;
+	};
+
+	///
+	/// Waiter for a connection to be returned to the pool.
+	///
+	struct Waiter {
+		/// Handler of an asynchronous waiter (empty for a synchronous one).
+		AcquireHandler handler;
+
+		/// Handover to a synchronous waiter (null for an asynchronous one).
+		std::shared_ptr<Handover> handover;
+	};
+
+	void dropStaleConnections();
+	std::shared_ptr<Connection> createConnection();
+	void passNewConnection(const AcquireHandler &handler);
+	void passToFirstWaiter(const std::shared_ptr<Connection> &conn,
+		boost::unique_lock<boost::mutex> &lock);
+
+private:
+	/// Factory for new connections.
+	const std::shared_ptr<ConnectionManager> connectionFactory;
+
+	/// I/O service on which connections are passed to asynchronous waiters.
+	const std::shared_ptr<IoService> ioService;
+
+	/// Maximal number of borrowed connections.
+	const std::size_t maxSize;
+
+	/// Maximal number of idle connections.
+	const std::size_t maxIdleSize;
+
+	/// Time after which an idle connection is considered to be stale.
+	const std::chrono::milliseconds idleTimeout;
+
+	/// Idle connections, from the least recently used to the most recently
+	/// used one.
+	std::vector<IdleConnection> idleConnections;
+
+	/// Number of currently borrowed connections.
+	std::size_t borrowedConnections = 0;
+
+	/// Both synchronous and asynchronous waiters, in the order in which they
+	/// started to wait.
+	std::deque<Waiter> waiters;
+
+	/// Mutex guarding the pool.
+	boost::mutex mutex;
+
+	/// Signals that a synchronous waiter has been served.
+	boost::condition_variable waiterServed;
+};
+
+///
+/// Constructs a pool.
+///
+/// @param[in] settings Settings used to create new connections.
+/// @param[in] connectionFactory Factory for new connections.
+///
+ConnectionPool::ConnectionPool(const Settings &settings,
+		const std::shared_ptr<ConnectionManager> &connectionFactory):
+	settings(settings),
+	connectionFactory(connectionFactory),
+	ioService(IoService::shared(settings.ioThreadCount())),
+	maxSize(std::max<std::size_t>(settings.maxConnectionCount(), 1)),
+	maxIdleSize(settings.connectionPoolSize()),
+	idleTimeout(settings.connectionIdleTimeout()) {}
+
+///
+/// Borrows a connection from the pool.
+///
+/// When there is no idle connection and the pool is full, it blocks until a
+/// connection is returned to the pool. Waiters are served in the order in
+/// which they started to wait, no matter whether they wait synchronously or
+/// asynchronously. The borrowed connection has to be either released or
+/// discarded afterwards.
+///
+/// A worker thread of the I/O service never blocks. Connections may be
+/// returned only after handlers that are waiting for that thread run, so a new
+/// connection is created for it even when the pool is full.
+///
+ConnectionPool::BorrowedConnection ConnectionPool::acquire() {
+	boost::unique_lock<boost::mutex> lock(mutex);
+	dropStaleConnections();
+
+	if (waiters.empty() || IoService::isWorkerThread()) {
+		// Prefer the most recently used connection because it is the least
+		// likely one to have been closed by the server.
+		if (!idleConnections.empty()) {
+			auto conn = idleConnections.back().conn;
+			idleConnections.pop_back();
+			++borrowedConnections;
+			return {conn, true};
+		}
+
+		if (borrowedConnections < maxSize || IoService::isWorkerThread()) {
+			++borrowedConnections;
+			// Establishing a connection may take a while, so do not hold the
+			// lock in the meantime.
+			lock.unlock();
+			return {createConnection(), false};
+		}
+	}
+
+	auto handover = std::make_shared<Handover>();
+	waiters.push_back({AcquireHandler(), handover});
+	waiterServed.wait(lock, [&]() { return handover->served; });
+	if (handover->conn) {
+		return {handover->conn, true};
+	}
+	lock.unlock();
+	return {createConnection(), false};
+}
+
+///
+/// Borrows a connection from the pool and passes it to @a handler.
+///
+/// Unlike acquire(), it never blocks. When there is no idle connection and the
+/// pool is full, @a handler is called from a thread of the I/O service after a
+/// connection is returned to the pool. The borrowed connection has to be
+/// either released or discarded afterwards.
+///
+void ConnectionPool::acquireAsync(const AcquireHandler &handler) {
+	boost::unique_lock<boost::mutex> lock(mutex);
+	dropStaleConnections();
+
+	if (waiters.empty()) {
+		if (!idleConnections.empty()) {
+			auto conn = idleConnections.back().conn;
+			idleConnections.pop_back();
+			++borrowedConnections;
+			lock.unlock();
+			return handler(conn, true, nullptr);
+		}
+
+		if (borrowedConnections < maxSize) {
+			++borrowedConnections;
+			lock.unlock();
+			return passNewConnection(handler);
+		}
+	}
+
+	waiters.push_back({handler, nullptr});
+}
+
+///
+/// Returns the given borrowed connection to the pool.
+///
+/// When there are waiters, the connection is passed to the first of them
+/// instead. When the pool already holds the maximal number of idle
+/// connections, the least recently used one is closed.
+///
+void ConnectionPool::release(const std::shared_ptr<Connection> &conn) {
+	boost::unique_lock<boost::mutex> lock(mutex);
+	if (!waiters.empty()) {
+		return passToFirstWaiter(conn, lock);
+	}
+
+	--borrowedConnections;
+	idleConnections.push_back({conn, Clock::now()});
+	if (idleConnections.size() > maxIdleSize) {
+		auto closed = std::move(idleConnections.front().conn);
+		idleConnections.erase(idleConnections.begin());
+		// Closing the connection may take a while, so do not hold the lock in
+		// the meantime.
+		lock.unlock();
+	}
+}
+
+///
+/// Forgets a borrowed connection that should not be reused.
+///
+/// When there are waiters, a new connection is created for the first of them
+/// instead.
+///
+void ConnectionPool::discard() {
+	boost::unique_lock<boost::mutex> lock(mutex);
+	if (!waiters.empty()) {
+		// The place of the discarded connection is taken by the new one.
+		return passToFirstWaiter(nullptr, lock);
+	}
+
+	--borrowedConnections;
+}
+
+///
+/// Is the pool without any connections and waiters?
+///
+/// Idle connections that have been idle for too long are not counted.
+///
+bool ConnectionPool::isUnused() {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	dropStaleConnections();
+	return idleConnections.empty() && borrowedConnections == 0 &&
+		waiters.empty();
+}
+
+///
+/// Drops idle connections that have been idle for too long.
+///
+/// The caller has to hold the lock.
+///
+void ConnectionPool::dropStaleConnections() {
+	auto now = Clock::now();
+	// The connections are ordered by their idle time, so the stale ones are
+	// at the beginning.
+	auto firstFresh = std::find_if(
+		idleConnections.begin(), idleConnections.end(),
+		[&](const IdleConnection &idle) {
+			return now - idle.idleSince < idleTimeout;
+		}
+	);
+	idleConnections.erase(idleConnections.begin(), firstFresh);
+}
+
+///
+/// Creates a new connection.
+///
+/// The connection has to be already counted as borrowed. When it cannot be
+/// created, it is discarded and the error is rethrown.
+///
+std::shared_ptr<Connection> ConnectionPool::createConnection() {
+	try {
+		return connectionFactory->newConnection(settings);
+	} catch (...) {
+		discard();
+		throw;
+	}
+}
+
+///
+/// Creates a new connection and passes it to @a handler.
+///
+/// The connection has to be already counted as borrowed.
+///
+void ConnectionPool::passNewConnection(const AcquireHandler &handler) {
+	std::shared_ptr<Connection> conn;
+	try {
+		conn = createConnection();
+	} catch (...) {
+		return handler(nullptr, false, std::current_exception());
+	}
+	handler(conn, false, nullptr);
+}
+
+///
+/// Passes the given borrowed connection to the first waiter.
+///
+/// The connection stays borrowed. When it is null, the waiter creates a new
+/// connection instead. The caller has to hold the lock, which is released.
+///
+void ConnectionPool::passToFirstWaiter(const std::shared_ptr<Connection> &conn,
+		boost::unique_lock<boost::mutex> &lock) {
+	auto waiter = std::move(waiters.front());
+	waiters.pop_front();
+
+	if (waiter.handover) {
+		waiter.handover->served = true;
+		waiter.handover->conn = conn;
+		lock.unlock();
+		waiterServed.notify_all();
+		return;
+	}
+
+	lock.unlock();
+	// The connection is returned from a thread that is in the middle of
+	// handling a response, so do not make it wait until the request of the
+	// waiter is sent.
+	auto self = shared_from_this();
+	auto handler = waiter.handler;
+	ioService->asioService()->post([self, handler, conn]() {
+		if (conn) {
+			handler(conn, true, nullptr);
+		} else {
+			self->passNewConnection(handler);
+		}
+	});
+}
+
+///
+/// Has the request failed because of a broken connection?
+///
+bool isConnectionError(std::exception_ptr error) {
+	try {
+		std::rethrow_exception(error);
+	} catch (const ConnectionError &) {
+		return true;
+	} catch (...) {
+		return false;
+	}
+}
+
+///
+/// Connection borrowing an underlying connection from a pool for every
+/// request.
+///
+class PooledConnection: public Connection {
+public:
+	PooledConnection(const std::shared_ptr<ConnectionPool> &pool);
+	virtual ~PooledConnection() override;
+
+	virtual Url getApiUrl() const override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url) override;
+	virtual std::unique_ptr<Response> sendGetRequest(const Url &url,
+		const RequestArguments &args) override;
+	virtual std::unique_ptr<Response> sendPostRequest(const Url &url,
+		const RequestArguments &args, const RequestFiles &files) override;
+	virtual std::unique_ptr<Response> sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendGetRequestAsync(const Url &url,
+		const RequestArguments &args,
+		const ResponseHandler &responseHandler) override;
+	virtual void sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) override;
+
+private:
+	template <typename SendRequest>
+	std::unique_ptr<Response> sendBorrowing(SendRequest sendRequest,
+		const std::function<bool ()> &maySendAgain = []() { return true; });
+	template <typename SendRequestAsync>
+	static void sendBorrowingAsync(const std::shared_ptr<ConnectionPool> &pool,
+		SendRequestAsync sendRequestAsync,
+		const ResponseHandler &responseHandler, bool maySendAgain = true);
+
+private:
+	/// Pool from which connections are borrowed.
+	const std::shared_ptr<ConnectionPool> pool;
+};
+
+///
+/// Constructs a connection borrowing from the given pool.
+///
+PooledConnection::PooledConnection(const std::shared_ptr<ConnectionPool> &pool):
+	pool(pool) {}
+
+// Override.
+PooledConnection::~PooledConnection() = default;
+
+// Override.
+Connection::Url PooledConnection::getApiUrl() const {
+	return pool->settings.apiUrl();
+}
+
+// Override.
+std::unique_ptr<Connection::Response> PooledConnection::sendGetRequest(
+		const Url &url) {
+	return sendBorrowing([&](Connection &conn) {
+		return conn.sendGetRequest(url);
+	});
+}
+
+// Override.
+std::unique_ptr<Connection::Response> PooledConnection::sendGetRequest(
+		const Url &url, const RequestArguments &args) {
+	return sendBorrowing([&](Connection &conn) {
+		return conn.sendGetRequest(url, args);
+	});
+}
+
+// Override.
+std::unique_ptr<Connection::Response> PooledConnection::sendPostRequest(
+		const Url &url, const RequestArguments &args, const RequestFiles &files) {
+	return sendBorrowing([&](Connection &conn) {
+		return conn.sendPostRequest(url, args, files);
+	});
+}
+
+// Override.
+std::unique_ptr<Connection::Response> PooledConnection::sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) {
+	// When a part of the body has already been passed to the handler, the
+	// request cannot be sent again.
+	bool bodyReceived = false;
+	return sendBorrowing([&](Connection &conn) {
+		return conn.sendGetRequestStreamingBody(url,
+			[&](const char *data, std::size_t size) {
+				bodyReceived = true;
+				bodyHandler(data, size);
+			});
+	}, [&]() { return !bodyReceived; });
+}
+
+// Override.
+void PooledConnection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	sendBorrowingAsync(pool, [url](Connection &conn,
+			const ResponseHandler &handler) {
+		conn.sendGetRequestAsync(url, handler);
+	}, responseHandler);
+}
+
+// Override.
+void PooledConnection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	sendBorrowingAsync(pool, [url, args](Connection &conn,
+			const ResponseHandler &handler) {
+		conn.sendGetRequestAsync(url, args, handler);
+	}, responseHandler);
+}
+
+// Override.
+void PooledConnection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	sendBorrowingAsync(pool, [url, args, files](Connection &conn,
+			const ResponseHandler &handler) {
+		conn.sendPostRequestAsync(url, args, files, handler);
+	}, responseHandler);
+}
+
+///
+/// Sends a request through a connection borrowed from the pool.
+///
+/// When the request fails, the borrowed connection may be in an inconsistent
+/// state, so it is discarded instead of being returned to the pool. An idle
+/// connection may have been closed by the server in the meantime, so when the
+/// request fails with ConnectionError on a reused connection, it is sent once
+/// more (provided that @a maySendAgain allows it).
+///
+template <typename SendRequest>
+std::unique_ptr<Connection::Response> PooledConnection::sendBorrowing(
+		SendRequest sendRequest, const std::function<bool ()> &maySendAgain) {
+	for (bool firstAttempt = true; ; firstAttempt = false) {
+		auto borrowed = pool->acquire();
+		try {
+			auto response = sendRequest(*borrowed.conn);
+			pool->release(borrowed.conn);
+			return response;
+		} catch (const ConnectionError &) {
+			pool->discard();
+			if (!firstAttempt || !borrowed.reused || !maySendAgain()) {
+				throw;
+			}
+		} catch (...) {
+			pool->discard();
+			throw;
+		}
+	}
+}
+
+///
+/// Sends an asynchronous request through a connection borrowed from the pool.
+///
+/// The connection is borrowed without blocking the calling thread, so the
+/// request may be sent later, from a thread of the I/O service. The connection
+/// is returned to the pool (or discarded when the request fails) once the
+/// response is received, right before it is passed to @a responseHandler. Like
+/// in sendBorrowing(), a request that fails with ConnectionError on a reused
+/// connection is sent once more.
+///
+template <typename SendRequestAsync>
+void PooledConnection::sendBorrowingAsync(
+		const std::shared_ptr<ConnectionPool> &pool,
+		SendRequestAsync sendRequestAsync,
+		const ResponseHandler &responseHandler, bool maySendAgain) {
+	pool->acquireAsync([pool, sendRequestAsync, responseHandler, maySendAgain](
+			std::shared_ptr<Connection> conn, bool reused,
+			std::exception_ptr error) {
+		if (error) {
+			return responseHandler(nullptr, error);
+		}
+
+		sendRequestAsync(*conn, [pool, conn, reused, sendRequestAsync,
+				responseHandler, maySendAgain](
+				std::unique_ptr<Response> response, std::exception_ptr error) {
+			if (!error) {
+				pool->release(conn);
+				return responseHandler(std::move(response), nullptr);
+			}
+
+			pool->discard();
+			if (maySendAgain && reused && isConnectionError(error)) {
+				return sendBorrowingAsync(pool, sendRequestAsync,
+					responseHandler, false);
+			}
+			responseHandler(std::move(response), error);
+		});
+	});
+}
+
+///
+/// Returns a key identifying the pool for the given settings.
+///
+std::string poolKey(const Settings &settings) {
+	// Connections send the API key and user agent in every request and report
+	// requests to the observer and metrics from the settings, so they can be
+	// shared only between services with the same settings.
+	auto observer = reinterpret_cast<std::uintptr_t>(
+		settings.requestObserver().get());
+	auto metrics = reinterpret_cast<std::uintptr_t>(settings.metrics().get());
+	// The sizes and idle timeout are fixed when the pool is created, so
+	// services with different ones cannot share it either.
+	return settings.apiUrl() + '\n' + settings.apiKey() + '\n' +
+		settings.userAgent() + '\n' + std::to_string(observer) + '\n' +
+		std::to_string(metrics) + '\n' +
+		std::to_string(settings.connectionPoolSize()) + '\n' +
+		std::to_string(settings.maxConnectionCount()) + '\n' +
+		std::to_string(settings.connectionIdleTimeout());
+}
+
+} // anonymous namespace
+
+///
+/// Private implementation of PooledConnectionManager.
+///
+struct PooledConnectionManager::Impl {
+	Impl(const std::shared_ptr<ConnectionManager> &connectionFactory):
+		connectionFactory(connectionFactory) {}
+
+	std::shared_ptr<ConnectionPool> poolFor(const Settings &settings);
+	void removeUnusedPools();
+
+	/// Minimal number of pools for which unused pools are removed.
+	static const std::size_t MinPoolCountToRemoveUnused = 16;
+
+	/// Factory for the pooled connections.
+	const std::shared_ptr<ConnectionManager> connectionFactory;
+
+	/// Pools, one for every API URL and credentials.
+	std::map<std::string, std::shared_ptr<ConnectionPool>> pools;
+
+	/// Number of pools from which unused pools are removed next time.
+	std::size_t removeUnusedPoolCount = MinPoolCountToRemoveUnused;
+
+	/// Mutex guarding the pools.
+	boost::mutex mutex;
+};
+
+const std::size_t PooledConnectionManager::Impl::MinPoolCountToRemoveUnused;
+
+///
+/// Returns the pool for the given settings, creating it if needed.
+///
+/// The sizes and idle timeout of a newly created pool are taken from @a
+/// settings.
+///
+std::shared_ptr<ConnectionPool> PooledConnectionManager::Impl::poolFor(
+		const Settings &settings) {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	auto &pool = pools[poolKey(settings)];
+	if (!pool) {
+		pool = std::make_shared<ConnectionPool>(settings, connectionFactory);
+		if (pools.size() >= removeUnusedPoolCount) {
+			removeUnusedPools();
+		}
+	}
+	return pool;
+}
+
+///
+/// Removes pools that are not used by any connection and have no live
+/// connections of their own.
+///
+/// To keep the cost amortized, the next removal happens only after the number
+/// of pools doubles. The caller has to hold the lock.
+///
+void PooledConnectionManager::Impl::removeUnusedPools() {
+	for (auto it = pools.begin(); it != pools.end();) {
+		// When only the map refers to the pool, no new reference can be made
+		// without holding the lock.
+		if (it->second.use_count() == 1 && it->second->isUnused()) {
+			it = pools.erase(it);
+		} else {
+			++it;
+		}
+	}
+	removeUnusedPoolCount = std::max(MinPoolCountToRemoveUnused,
+		2 * pools.size());
+}
+
+///
+/// Constructs a manager pooling real connections.
+///
+PooledConnectionManager::PooledConnectionManager():
+	PooledConnectionManager(std::make_shared<RealConnectionManager>()) {}
+
+///
+/// Constructs a manager pooling connections created by the given factory.
+///
+/// @param[in] connectionFactory Manager used to create the pooled connections.
+///
+PooledConnectionManager::PooledConnectionManager(
+		const std::shared_ptr<ConnectionManager> &connectionFactory):
+	impl(std::make_unique<Impl>(connectionFactory)) {}
+
+// Override.
+PooledConnectionManager::~PooledConnectionManager() = default;
+
+// Override.
+std::shared_ptr<Connection> PooledConnectionManager::newConnection(
+		const Settings &settings) {
+	return std::make_shared<PooledConnection>(impl->poolFor(settings));
+}
+
+} // namespace internal
+} // namespace retdec
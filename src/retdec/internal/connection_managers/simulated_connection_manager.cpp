@@ -0,0 +1,40 @@
+///
+/// @file      retdec/internal/connection_managers/simulated_connection_manager.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the manager of connections to a simulation of
+///            the API.
+///
+
+#include "retdec/internal/connection_managers/simulated_connection_manager.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/settings.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a manager of connections to the given simulation.
+///
+SimulatedConnectionManager::SimulatedConnectionManager(
+		const std::shared_ptr<SimulatedService> &service):
+	service_(service) {}
+
+// Override.
+SimulatedConnectionManager::~SimulatedConnectionManager() = default;
+
+// Override.
+std::shared_ptr<Connection> SimulatedConnectionManager::newConnection(
+		const Settings &settings) {
+	return std::make_shared<SimulatedConnection>(service_, settings.apiUrl());
+}
+
+///
+/// Returns the simulation to which connections are connected.
+///
+std::shared_ptr<SimulatedService> SimulatedConnectionManager::service() const {
+	return service_;
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,370 @@
+///
+/// @file      retdec/internal/connections/caching_connection.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the connection wrapper caching responses of a
+///            resource on disk.
+///
+
+#include <cstddef>
+#include <exception>
+#include <ios>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <json/json.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/connections/caching_connection.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/result_cache.h"
+#include "retdec/internal/utilities/connection.h"
+#include "retdec/internal/utilities/os.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Should the given response be stored into the cache under the given name?
+///
+bool shouldStoreResponse(const std::string &name,
+		const Connection::Response &response) {
+	if (!requestSucceeded(response)) {
+		return false;
+	}
+
+	if (name == ResultCache::StatusResponseName) {
+		try {
+			auto status = response.bodyAsStatus();
+			return status.finished && !status.failed;
+		} catch (...) {
+			return false;
+		}
+	}
+	return true;
+}
+
+///
+/// Downloads the outputs of a resource that are not in its entry of a cache
+/// one by one and then stores its final status into the entry.
+///
+/// The status is passed to the handler only after that, so the outputs can be
+/// obtained from the cache right away. When an output cannot be downloaded,
+/// the status is not stored, so the resource is not served from the cache.
+/// The responses are stored by the writer thread of the cache, which also
+/// continues the download, so the threads of the I/O service never wait for
+/// the disk.
+///
+class OutputsDownload: public std::enable_shared_from_this<OutputsDownload> {
+public:
+	///
+	/// Output of the resource.
+	///
+	struct Output {
+		/// URL of the output.
+		Connection::Url url;
+
+		/// Name of the response with the output in the entry.
+		std::string name;
+	};
+
+public:
+	OutputsDownload(const std::shared_ptr<Connection> &conn,
+			const std::shared_ptr<ResultCache> &cache,
+			const std::string &cacheKey, std::vector<Output> outputs,
+			std::unique_ptr<Connection::Response> status,
+			const Connection::ResponseHandler &statusHandler):
+		conn(conn), cache(cache), cacheKey(cacheKey),
+		outputs(std::move(outputs)), status(std::move(status)),
+		statusHandler(statusHandler) {}
+
+	///
+	/// Starts the download of the output with the given index.
+	///
+	void downloadFrom(std::size_t index) {
+		while (index < outputs.size() &&
+				cache->hasResponse(cacheKey, outputs[index].name)) {
+			++index;
+		}
+		auto self = shared_from_this();
+		if (index == outputs.size()) {
+			return cache->storeResponseAsync(cacheKey,
+				ResultCache::StatusResponseName, *status,
+				[self]() { self->passStatus(); });
+		}
+
+		try {
+			conn->sendGetRequestAsync(outputs[index].url,
+				[self, index](std::unique_ptr<Connection::Response> response,
+						std::exception_ptr error) {
+					if (error || !requestSucceeded(*response)) {
+						return self->passStatus();
+					}
+					self->cache->storeResponseAsync(self->cacheKey,
+						self->outputs[index].name, *response,
+						[self, index]() { self->downloadFrom(index + 1); });
+				}
+			);
+		} catch (...) {
+			passStatus();
+		}
+	}
+
+private:
+	void passStatus() {
+		statusHandler(std::move(status), nullptr);
+	}
+
+private:
+	/// Wrapped connection.
+	const std::shared_ptr<Connection> conn;
+
+	/// Cache of the responses.
+	const std::shared_ptr<ResultCache> cache;
+
+	/// Key of the entry of the resource in the cache.
+	const std::string cacheKey;
+
+	/// Outputs of the resource.
+	const std::vector<Output> outputs;
+
+	/// Final status of the resource.
+	std::unique_ptr<Connection::Response> status;
+
+	/// Handler to which the status is passed.
+	const Connection::ResponseHandler statusHandler;
+};
+
+} // anonymous namespace
+
+///
+/// Constructs a wrapper.
+///
+/// @param[in] conn Connection to be wrapped.
+/// @param[in] cache Cache of the responses.
+/// @param[in] cacheKey Key of the entry of the resource in the cache.
+/// @param[in] resourceUrl URL of the resource. Only responses to GET requests
+///                        to URLs under this URL are cached.
+/// @param[in] outputPaths Paths to the outputs of the resource (relative to
+///                        @a resourceUrl, e.g. @c outputs/hll).
+///
+CachingConnection::CachingConnection(const std::shared_ptr<Connection> &conn,
+		const std::shared_ptr<ResultCache> &cache,
+		const std::string &cacheKey, const Url &resourceUrl,
+		const std::vector<std::string> &outputPaths):
+	conn(conn), cache(cache), cacheKey(cacheKey), resourceUrl(resourceUrl),
+	outputPaths(outputPaths) {}
+
+///
+/// Destructs the wrapper.
+///
+CachingConnection::~CachingConnection() = default;
+
+// Override.
+Connection::Url CachingConnection::getApiUrl() const {
+	return conn->getApiUrl();
+}
+
+// Override.
+std::unique_ptr<Connection::Response> CachingConnection::sendGetRequest(
+		const Url &url) {
+	auto name = responseName(url);
+	if (name.empty()) {
+		return conn->sendGetRequest(url);
+	}
+
+	if (auto response = cache->response(cacheKey, name)) {
+		return response;
+	}
+
+	auto response = conn->sendGetRequest(url);
+	if (!shouldStoreResponse(name, *response)) {
+		return response;
+	}
+
+	if (name != ResultCache::StatusResponseName ||
+			downloadOutputsIntoCache()) {
+		cache->storeResponse(cacheKey, name, *response);
+	}
+	return response;
+}
+
+// Override.
+std::unique_ptr<Connection::Response> CachingConnection::sendGetRequest(
+		const Url &url, const RequestArguments &args) {
+	return conn->sendGetRequest(url, args);
+}
+
+// Override.
+std::unique_ptr<Connection::Response> CachingConnection::sendPostRequest(
+		const Url &url, const RequestArguments &args,
+		const RequestFiles &files) {
+	return conn->sendPostRequest(url, args, files);
+}
+
+///
+/// Sends a GET request to the given URL and passes the body of the response to
+/// @a bodyHandler in parts as it is being received.
+///
+/// When the response is cached, its body is read from the cache in parts.
+/// Otherwise, the body is also written into a temporary file, which is moved
+/// into the cache when the request succeeds, so the body is never stored in
+/// memory as a whole.
+///
+std::unique_ptr<Connection::Response> CachingConnection::sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) {
+	auto name = responseName(url);
+	if (name.empty()) {
+		return conn->sendGetRequestStreamingBody(url, bodyHandler);
+	}
+
+	if (auto response = cache->streamResponse(cacheKey, name, bodyHandler)) {
+		return response;
+	}
+
+	return downloadIntoCache(url, name, bodyHandler);
+}
+
+// Override.
+void CachingConnection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	auto name = responseName(url);
+	if (name.empty()) {
+		return conn->sendGetRequestAsync(url, responseHandler);
+	}
+
+	if (auto response = cache->response(cacheKey, name)) {
+		return responseHandler(std::move(response), nullptr);
+	}
+
+	std::vector<OutputsDownload::Output> outputs;
+	if (name == ResultCache::StatusResponseName) {
+		for (const auto &outputPath : outputPaths) {
+			outputs.push_back({resourceUrl + "/" + outputPath,
+				ResultCache::responseName(outputPath)});
+		}
+	}
+
+	// The wrapper may be destructed before the response is received, so do
+	// not capture it.
+	auto conn = this->conn;
+	auto cache = this->cache;
+	auto cacheKey = this->cacheKey;
+	conn->sendGetRequestAsync(url,
+		[conn, cache, cacheKey, name, outputs, responseHandler](
+				std::unique_ptr<Response> response, std::exception_ptr error) {
+			if (error || !shouldStoreResponse(name, *response)) {
+				return responseHandler(std::move(response), error);
+			}
+
+			if (name != ResultCache::StatusResponseName) {
+				cache->storeResponseAsync(cacheKey, name, *response, nullptr);
+				return responseHandler(std::move(response), error);
+			}
+
+			std::make_shared<OutputsDownload>(conn, cache, cacheKey, outputs,
+				std::move(response), responseHandler)->downloadFrom(0);
+		}
+	);
+}
+
+// Override.
+void CachingConnection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	conn->sendGetRequestAsync(url, args, responseHandler);
+}
+
+// Override.
+void CachingConnection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	conn->sendPostRequestAsync(url, args, files, responseHandler);
+}
+
+// Override.
+std::shared_ptr<Clock> CachingConnection::clock() const {
+	return conn->clock();
+}
+
+///
+/// Returns the name under which the response to a GET request to the given URL
+/// is cached.
+///
+/// When the URL is not a URL of the resource, it returns the empty string.
+///
+std::string CachingConnection::responseName(const Url &url) const {
+	auto prefix = resourceUrl + "/";
+	if (url.compare(0, prefix.size(), prefix) != 0 || url.size() == prefix.size()) {
+		return "";
+	}
+
+	return ResultCache::responseName(url.substr(prefix.size()));
+}
+
+///
+/// Sends a GET request to the given URL and stores the response into the cache
+/// under the given name when the request succeeds.
+///
+/// The body of the response is passed to @a bodyHandler in parts as it is
+/// being received. It is also written into a temporary file, which is moved
+/// into the cache, so the body is never stored in memory as a whole.
+///
+std::unique_ptr<Connection::Response> CachingConnection::downloadIntoCache(
+		const Url &url, const std::string &name,
+		const BodyHandler &bodyHandler) {
+	auto tmpFilePath = cache->newTmpFilePath();
+	std::unique_ptr<Response> response;
+	try {
+		auto file = openFileForWriting(tmpFilePath);
+		response = conn->sendGetRequestStreamingBody(url,
+			[&](const char *data, std::size_t size) {
+				file->write(data, static_cast<std::streamsize>(size));
+				bodyHandler(data, size);
+			}
+		);
+		if (!file->flush() || !requestSucceeded(*response)) {
+			removeFile(tmpFilePath);
+			return response;
+		}
+	} catch (...) {
+		removeFile(tmpFilePath);
+		throw;
+	}
+
+	cache->storeResponseFile(cacheKey, name, tmpFilePath,
+		response->attachedFileName());
+	return response;
+}
+
+///
+/// Downloads the outputs of the resource that are not in the cache yet into
+/// the cache.
+///
+/// @returns @c true when all the outputs are in the cache, @c false otherwise.
+///
+bool CachingConnection::downloadOutputsIntoCache() {
+	for (const auto &outputPath : outputPaths) {
+		auto name = ResultCache::responseName(outputPath);
+		if (cache->hasResponse(cacheKey, name)) {
+			continue;
+		}
+
+		try {
+			auto response = downloadIntoCache(resourceUrl + "/" + outputPath,
+				name, [](const char *, std::size_t) {});
+			if (!requestSucceeded(*response) ||
+					!cache->hasResponse(cacheKey, name)) {
+				return false;
+			}
+		} catch (...) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace internal
+} // namespace retdec
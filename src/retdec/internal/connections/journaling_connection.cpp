@@ -0,0 +1,270 @@
+///
+/// @file      retdec/internal/connections/journaling_connection.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the connection wrapper marking a journaled
+///            resource as finished.
+///
+
+#include <exception>
+#include <set>
+#include <utility>
+
+#include <boost/optional.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+#include <json/json.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/connections/journaling_connection.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/submission_journal.h"
+#include "retdec/internal/utilities/connection.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Returns the status from the given response to a GET request to the status
+/// of a resource.
+///
+/// When the request has failed or the status cannot be decoded, it returns
+/// nothing.
+///
+boost::optional<ResourceStatus> statusFrom(
+		const Connection::Response &response) {
+	if (!requestSucceeded(response)) {
+		return boost::none;
+	}
+
+	try {
+		return response.bodyAsStatus();
+	} catch (const Error &) {
+		return boost::none;
+	}
+}
+
+} // anonymous namespace
+
+///
+/// Progress of obtaining the results of a journaled resource.
+///
+struct JournalingConnection::Progress {
+	Progress(const std::shared_ptr<SubmissionJournal> &journal,
+		const Url &resourcesUrl, const std::string &id,
+		const std::vector<std::string> &outputPaths);
+
+	void responseReceived(const Url &url, const Response &response);
+	void statusReceived(const Response &response);
+	void outputReceived(const Url &url, const Response &response);
+	void markFinished();
+
+	/// Journal in which the resource is marked as finished.
+	const std::shared_ptr<SubmissionJournal> journal;
+
+	/// URL to the resources of the service that started the resource.
+	const Url resourcesUrl;
+
+	/// ID of the resource.
+	const std::string id;
+
+	/// URL of the status of the resource.
+	const Url statusUrl;
+
+	/// Mutex guarding @c pendingOutputUrls and @c markedAsFinished.
+	boost::mutex mutex;
+
+	/// URLs of the outputs of the resource that have not been downloaded yet.
+	std::set<Url> pendingOutputUrls;
+
+	/// Has the resource been marked as finished?
+	bool markedAsFinished = false;
+};
+
+///
+/// Constructs a progress of a resource whose outputs have not been downloaded
+/// yet.
+///
+JournalingConnection::Progress::Progress(
+		const std::shared_ptr<SubmissionJournal> &journal,
+		const Url &resourcesUrl, const std::string &id,
+		const std::vector<std::string> &outputPaths):
+		journal(journal), resourcesUrl(resourcesUrl), id(id),
+		statusUrl(resourcesUrl + "/" + id + "/status") {
+	for (const auto &outputPath : outputPaths) {
+		pendingOutputUrls.insert(resourcesUrl + "/" + id + "/" + outputPath);
+	}
+}
+
+///
+/// Updates the progress by the given response to a GET request to the given
+/// URL.
+///
+void JournalingConnection::Progress::responseReceived(const Url &url,
+		const Response &response) {
+	if (url == statusUrl) {
+		statusReceived(response);
+	} else {
+		outputReceived(url, response);
+	}
+}
+
+///
+/// Marks the resource as finished when the given response to a GET request to
+/// its status says that it has finished and there are no outputs to be
+/// downloaded.
+///
+void JournalingConnection::Progress::statusReceived(
+		const Response &response) {
+	auto status = statusFrom(response);
+	if (!status || !status->finished) {
+		return;
+	}
+
+	bool hasOutputs;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		hasOutputs = status->succeeded && !pendingOutputUrls.empty();
+	}
+	if (!hasOutputs) {
+		markFinished();
+	}
+}
+
+///
+/// Marks the resource as finished when the given response to a GET request to
+/// the given URL has downloaded its last output.
+///
+void JournalingConnection::Progress::outputReceived(const Url &url,
+		const Response &response) {
+	if (!requestSucceeded(response)) {
+		return;
+	}
+
+	bool allOutputsDownloaded;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		if (pendingOutputUrls.erase(url) == 0) {
+			return;
+		}
+		allOutputsDownloaded = pendingOutputUrls.empty();
+	}
+	if (allOutputsDownloaded) {
+		markFinished();
+	}
+}
+
+///
+/// Marks the resource as finished in the journal (only once).
+///
+void JournalingConnection::Progress::markFinished() {
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		if (markedAsFinished) {
+			return;
+		}
+		markedAsFinished = true;
+	}
+	journal->markFinished(resourcesUrl, id);
+}
+
+///
+/// Constructs a wrapper.
+///
+/// @param[in] conn Connection to be wrapped.
+/// @param[in] journal Journal in which the resource is marked as finished.
+/// @param[in] resourcesUrl URL to the resources of the service that started
+///                         the resource.
+/// @param[in] id ID of the resource.
+/// @param[in] outputPaths Paths to the outputs of the resource (relative to
+///                        its URL, e.g. @c outputs/hll). The resource is
+///                        marked as finished after all of them have been
+///                        downloaded.
+///
+JournalingConnection::JournalingConnection(
+		const std::shared_ptr<Connection> &conn,
+		const std::shared_ptr<SubmissionJournal> &journal,
+		const Url &resourcesUrl, const std::string &id,
+		const std::vector<std::string> &outputPaths):
+	conn(conn),
+	progress(std::make_shared<Progress>(journal, resourcesUrl, id,
+		outputPaths)) {}
+
+///
+/// Destructs the wrapper.
+///
+JournalingConnection::~JournalingConnection() = default;
+
+// Override.
+Connection::Url JournalingConnection::getApiUrl() const {
+	return conn->getApiUrl();
+}
+
+// Override.
+std::unique_ptr<Connection::Response> JournalingConnection::sendGetRequest(
+		const Url &url) {
+	auto response = conn->sendGetRequest(url);
+	progress->responseReceived(url, *response);
+	return response;
+}
+
+// Override.
+std::unique_ptr<Connection::Response> JournalingConnection::sendGetRequest(
+		const Url &url, const RequestArguments &args) {
+	return conn->sendGetRequest(url, args);
+}
+
+// Override.
+std::unique_ptr<Connection::Response> JournalingConnection::sendPostRequest(
+		const Url &url, const RequestArguments &args,
+		const RequestFiles &files) {
+	return conn->sendPostRequest(url, args, files);
+}
+
+// Override.
+std::unique_ptr<Connection::Response> JournalingConnection::sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) {
+	auto response = conn->sendGetRequestStreamingBody(url, bodyHandler);
+	progress->responseReceived(url, *response);
+	return response;
+}
+
+// Override.
+void JournalingConnection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	// The wrapper may be destructed before the response is received, so do
+	// not capture it.
+	auto progress = this->progress;
+	conn->sendGetRequestAsync(url,
+		[progress, url, responseHandler](
+				std::unique_ptr<Response> response, std::exception_ptr error) {
+			if (!error) {
+				progress->responseReceived(url, *response);
+			}
+			responseHandler(std::move(response), error);
+		}
+	);
+}
+
+// Override.
+void JournalingConnection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	conn->sendGetRequestAsync(url, args, responseHandler);
+}
+
+// Override.
+void JournalingConnection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	conn->sendPostRequestAsync(url, args, files, responseHandler);
+}
+
+// Override.
+std::shared_ptr<Clock> JournalingConnection::clock() const {
+	return conn->clock();
+}
+
+} // namespace internal
+} // namespace retdec
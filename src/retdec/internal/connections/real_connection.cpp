@@ -5,27 +5,33 @@
 /// @brief     Implementation of the connection to the API.
 ///
 
+#include <exception>
 #include <memory>
+#include <string>
+#include <utility>
 
-#include <boost/network/protocol/http/client.hpp>
 #include <boost/network/utils/base64/encode.hpp>
-#include <boost/system/system_error.hpp>
 #include <json/json.h>
 
+#include "retdec/file.h"
 #include "retdec/internal/connections/real_connection.h"
 #include "retdec/internal/files/string_file.h"
+#include "retdec/internal/http_client.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/multipart_body.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/utilities/connection.h"
 #include "retdec/internal/utilities/json.h"
-#include "retdec/internal/utilities/string.h"
+#include "retdec/metrics.h"
+#include "retdec/request_observer.h"
 #include "retdec/settings.h"
 
 namespace retdec {
 namespace internal {
 
-/// HTTP client to be used.
-// The default client does not use keep-alive connections.
-using HttpClient = boost::network::http::basic_client<
-	boost::network::http::tags::http_keepalive_8bit_tcp_resolve, 1, 1
->;
+/// Function generating the body of a request in chunks.
+using BodyGenerator = HttpClient::BodyGenerator;
 
 ///
 /// Encodes the given string by using the Base64 encoding.
@@ -34,33 +40,224 @@ std::string base64Encode(const std::string &str) {
 	return boost::network::utils::base64::encode<std::string::value_type>(str);
 }
 
+///
+/// Returns the name of the file attached to the given response.
+///
+/// When there is no attached file, the empty string is returned.
+///
+std::string attachedFileName(const HttpClient::Response &response) {
+	// Content-Disposition: attachment; filename=$FILE_NAME
+	auto contentDisposition = response.header("Content-Disposition");
+	const std::string FileNamePrefix("filename=");
+	auto fileNamePos = contentDisposition.find(FileNamePrefix);
+	return fileNamePos != std::string::npos ?
+		contentDisposition.substr(fileNamePos + FileNamePrefix.size()) : "";
+}
+
+///
+/// Measurement of a single request, reported to an observer and recorded into
+/// a registry of metrics upon destruction.
+///
+/// When there is neither an observer nor a registry, nothing is measured and
+/// all the member functions return right away.
+///
+class RequestMeasurement {
+public:
+	RequestMeasurement(RequestObserver *observer, MetricsRegistry *metrics,
+		const Settings &settings, const std::string &method,
+		const Connection::Url &url);
+	~RequestMeasurement();
+
+	bool isEnabled() const noexcept;
+	BodyGenerator measuredBody(BodyGenerator body);
+	HttpClient::PhaseHandler phaseHandler();
+	void responseReceived(int statusCode);
+
+	/// Measured request, shared with the generator of the body (null when
+	/// nothing is measured).
+	const std::shared_ptr<RequestObserver::Request> request;
+
+	/// @name Disabled
+	/// @{
+	RequestMeasurement(const RequestMeasurement &) = delete;
+	RequestMeasurement(RequestMeasurement &&) = delete;
+	RequestMeasurement &operator=(const RequestMeasurement &) = delete;
+	RequestMeasurement &operator=(RequestMeasurement &&) = delete;
+	/// @}
+
+private:
+	/// Observer to which the request is reported (null when there is none).
+	RequestObserver *observer;
+
+	/// Registry into which the request is recorded (null when there is none).
+	MetricsRegistry *metrics;
+
+	/// Service to which the request is sent (known only when it is recorded
+	/// into a registry).
+	MetricsRegistry::Service service = MetricsRegistry::Service::Other;
+};
+
+///
+/// Starts a measurement of a request with the given method to the given URL.
+///
+/// @param[in] observer Observer to which the request is reported (may be
+///                     null).
+/// @param[in] metrics Registry into which the request is recorded (may be
+///                    null).
+/// @param[in] settings Settings of the connection.
+/// @param[in] method Method of the request.
+/// @param[in] url URL to which the request is sent.
+///
+/// When both @a observer and @a metrics are null, nothing is measured.
+///
+RequestMeasurement::RequestMeasurement(RequestObserver *observer,
+		MetricsRegistry *metrics, const Settings &settings,
+		const std::string &method, const Connection::Url &url):
+	request(observer || metrics ?
+		std::make_shared<RequestObserver::Request>() : nullptr),
+	observer(observer),
+	metrics(metrics) {
+	if (!request) {
+		return;
+	}
+
+	if (metrics) {
+		service = MetricsRegistry::serviceFromUrl(settings.apiUrl(), url);
+	}
+	request->method = method;
+	request->url = url;
+	request->started = RequestObserver::Clock::now();
+}
+
+///
+/// Finishes the measurement and reports the request to the observer.
+///
+RequestMeasurement::~RequestMeasurement() {
+	if (!request) {
+		return;
+	}
+
+	request->finished = RequestObserver::Clock::now();
+	if (metrics) {
+		if (request->statusCode != 0) {
+			metrics->requestFinished(service, request->statusCode,
+				request->finished - request->started);
+		} else {
+			metrics->requestFailed(service);
+		}
+	}
+	if (observer) {
+		try {
+			observer->requestFinished(*request);
+		} catch (...) {
+			// Failures of the observer must not affect the request.
+		}
+	}
+}
+
+///
+/// Is the request measured?
+///
+bool RequestMeasurement::isEnabled() const noexcept {
+	return request != nullptr;
+}
+
+///
+/// Returns a generator of @a body that counts the sent bytes.
+///
+BodyGenerator RequestMeasurement::measuredBody(BodyGenerator body) {
+	auto request = this->request;
+	return [request, body](std::string &chunk) {
+		auto generated = body(chunk);
+		request->bytesSent += chunk.size();
+		return generated;
+	};
+}
+
+///
+/// Returns a function recording the times of the phases of the request.
+///
+HttpClient::PhaseHandler RequestMeasurement::phaseHandler() {
+	auto request = this->request;
+	return [request](HttpClient::Phase phase) {
+		auto now = RequestObserver::Clock::now();
+		switch (phase) {
+			case HttpClient::Phase::Resolved:
+				request->resolved = now;
+				break;
+			case HttpClient::Phase::Connected:
+				request->connected = now;
+				break;
+			case HttpClient::Phase::TlsHandshakeDone:
+				request->tlsHandshakeDone = now;
+				break;
+			case HttpClient::Phase::RequestWritten:
+			default:
+				request->requestWritten = now;
+				break;
+		}
+	};
+}
+
+///
+/// Records that a response with the given status code has been received.
+///
+/// The received bytes are counted as the parts of the body arrive.
+///
+void RequestMeasurement::responseReceived(int statusCode) {
+	if (!request) {
+		return;
+	}
+
+	request->statusCode = statusCode;
+}
+
 ///
 /// Real response.
 ///
+/// Everything is extracted from the received response upon construction, so
+/// the body is stored only once and then shared by all the accessors.
+///
 class RealResponse: public Connection::Response {
 public:
-	RealResponse(const HttpClient::response &response);
+	RealResponse(const HttpClient::Response &response,
+		std::shared_ptr<const std::string> body);
 	virtual ~RealResponse();
 
 	virtual int statusCode() const override;
 	virtual std::string statusMessage() const override;
 	virtual std::string body() const override;
+	virtual std::shared_ptr<const std::string> sharedBody() const override;
 	virtual Json::Value bodyAsJson() const override;
+	virtual ResourceStatus bodyAsStatus() const override;
 	virtual std::unique_ptr<File> bodyAsFile() const override;
+	virtual std::string attachedFileName() const override;
 
 private:
-	std::string attachedFileName() const;
+	/// Status code.
+	const int code;
 
-private:
-	/// Underlying response.
-	HttpClient::response response;
+	/// Status message.
+	const std::string message;
+
+	/// Body.
+	const std::shared_ptr<const std::string> body_;
+
+	/// Name of the attached file.
+	const std::string fileName;
 };
 
 ///
-/// Constructs a response.
+/// Constructs a response from the given received response and its body.
+///
+/// The body is passed separately because it may have been streamed elsewhere.
 ///
-RealResponse::RealResponse(const HttpClient::response &response):
-	response(response) {}
+RealResponse::RealResponse(const HttpClient::Response &response,
+		std::shared_ptr<const std::string> body):
+	code(response.statusCode),
+	message(response.statusMessage),
+	body_(std::move(body)),
+	fileName(internal::attachedFileName(response)) {}
 
 ///
 /// Destructs the response.
@@ -69,40 +266,160 @@ RealResponse::~RealResponse() = default;
 
 // Override.
 int RealResponse::statusCode() const {
-	return response.status();
+	return code;
 }
 
 // Override.
 std::string RealResponse::statusMessage() const {
-	// cpp-netlib converts all letters in the status message to UPPER CASE, so
-	// convert the message to Mixed Case.
-	return capitalizeWords(response.status_message());
+	return message;
 }
 
 // Override.
 std::string RealResponse::body() const {
-	return response.body();
+	return *body_;
+}
+
+// Override.
+std::shared_ptr<const std::string> RealResponse::sharedBody() const {
+	return body_;
 }
 
 // Override.
 Json::Value RealResponse::bodyAsJson() const {
-	return toJson(response.body());
+	return toJson(*body_);
+}
+
+// Override.
+ResourceStatus RealResponse::bodyAsStatus() const {
+	return ResourceStatus::fromBody(body_->data(),
+		body_->data() + body_->size());
 }
 
 // Override.
 std::unique_ptr<File> RealResponse::bodyAsFile() const {
-	return std::make_unique<StringFile>(response.body(), attachedFileName());
+	return std::make_unique<StringFile>(body_, fileName);
+}
+
+// Override.
+std::string RealResponse::attachedFileName() const {
+	return fileName;
 }
 
 ///
-/// Returns the file name from the response.
+/// Collector of the response to a request.
 ///
-std::string RealResponse::attachedFileName() const {
-	// TODO Implement this in a more robust way.
-	// Content-Disposition: attachment; filename=$FILE_NAME
-	const auto &headers = boost::network::http::headers(response);
-	const auto &contentDisposition = headers["Content-Disposition"].front();
-	return contentDisposition.second.substr(21);
+/// The body is either collected, or, when it is streamed and the request has
+/// succeeded, passed to a body handler as it arrives. The body of a failed
+/// request is always collected, so that the error can be reported.
+///
+/// The handlers of the client are called one after another, so the collector
+/// needs no locking.
+///
+class ResponseCollector {
+public:
+	ResponseCollector(std::shared_ptr<RequestMeasurement> measurement,
+		const Connection::BodyHandler &bodyHandler);
+
+	HttpClient::HeadHandler headHandler() const;
+	HttpClient::BodyHandler bodyHandler() const;
+	std::unique_ptr<Connection::Response> finish() const;
+	void finishMeasurement() const;
+
+private:
+	///
+	/// State of the collecting.
+	///
+	/// It is shared because the handlers of the client are copied.
+	///
+	struct State {
+		/// Measurement of the request (null once it is finished).
+		std::shared_ptr<RequestMeasurement> measurement;
+
+		/// Function to which the body of a successful response is passed
+		/// (empty when the body is collected).
+		Connection::BodyHandler bodyHandler;
+
+		/// Status and headers of the response.
+		HttpClient::Response head;
+
+		/// Collected body.
+		std::string body;
+
+		/// Is the body passed to the body handler?
+		bool streamed = false;
+	};
+
+private:
+	/// State of the collecting.
+	std::shared_ptr<State> state;
+};
+
+///
+/// Constructs a collector.
+///
+/// @param[in] measurement Measurement of the request.
+/// @param[in] bodyHandler Function to which the body of a successful response
+///                        is passed as it arrives. When it is empty, the body
+///                        is collected and stored in the response.
+///
+ResponseCollector::ResponseCollector(
+		std::shared_ptr<RequestMeasurement> measurement,
+		const Connection::BodyHandler &bodyHandler):
+	state(std::make_shared<State>()) {
+	state->measurement = std::move(measurement);
+	state->bodyHandler = bodyHandler;
+}
+
+///
+/// Returns a handler receiving the status and headers of the response.
+///
+HttpClient::HeadHandler ResponseCollector::headHandler() const {
+	auto state = this->state;
+	return [state](const HttpClient::Response &head) {
+		state->head = head;
+		state->streamed = state->bodyHandler &&
+			head.statusCode >= 200 && head.statusCode <= 299;
+		state->measurement->responseReceived(head.statusCode);
+	};
+}
+
+///
+/// Returns a handler receiving parts of the body of the response.
+///
+HttpClient::BodyHandler ResponseCollector::bodyHandler() const {
+	auto state = this->state;
+	return [state](const char *data, std::size_t size) {
+		if (auto &request = state->measurement->request) {
+			if (request->bytesReceived == 0) {
+				request->firstByteReceived = RequestObserver::Clock::now();
+			}
+			request->bytesReceived += size;
+		}
+
+		if (state->streamed) {
+			state->bodyHandler(data, size);
+		} else {
+			state->body.append(data, size);
+		}
+	};
+}
+
+///
+/// Finishes the measurement and returns the received response.
+///
+/// It has to be called after the whole response has been received.
+///
+std::unique_ptr<Connection::Response> ResponseCollector::finish() const {
+	finishMeasurement();
+	return std::make_unique<RealResponse>(state->head,
+		std::make_shared<const std::string>(std::move(state->body)));
+}
+
+///
+/// Finishes the measurement of the request.
+///
+void ResponseCollector::finishMeasurement() const {
+	state->measurement.reset();
 }
 
 ///
@@ -110,93 +427,129 @@ std::string RealResponse::attachedFileName() const {
 ///
 struct RealConnection::Impl {
 	Impl(const Settings &settings):
-		settings(settings) {}
-
-	std::string createQuery(const RequestArguments &args);
-	void addAuthToRequest(HttpClient::request &request);
-	void addUserAgentToRequest(HttpClient::request &request);
-	std::string addFilesToRequest(const RequestFiles &files,
-		HttpClient::request &request);
-	HttpClient::request createRequest(const Url &url,
-		const RequestArguments &argss);
+		settings(settings),
+		client(IoService::shared(settings.ioThreadCount())),
+		requestObserver(settings.requestObserver()),
+		metrics(settings.metrics() ? settings.metrics()->registry() : nullptr) {}
+
+	HttpClient::Request createRequest(const std::string &method,
+		const Url &url, const RequestArguments &args);
+	void addFilesToRequest(const RequestFiles &files,
+		HttpClient::Request &request);
+	std::shared_ptr<RequestMeasurement> startMeasurement(
+		HttpClient::Request &request, const Url &url);
+
+	std::unique_ptr<Response> send(HttpClient::Request request,
+		const Url &url, const BodyHandler &bodyHandler = BodyHandler());
+	void sendAsync(HttpClient::Request request, const Url &url,
+		const ResponseHandler &responseHandler);
 
 	/// Settings.
 	const Settings settings;
 
-	/// HTTP client.
+	/// HTTP client, keeping connections open between requests.
 	HttpClient client;
-};
 
-///
-/// Creates and returns the query part of an URL (<tt>?key1=value1...</tt>).
-///
-std::string RealConnection::Impl::createQuery(const Connection::RequestArguments &args) {
-	std::string query;
-	for (auto &arg : args) {
-		query += (query.empty() ? "?" : "&") + arg.first + "=" + arg.second;
-	}
-	return query;
-}
+	/// Observer of sent requests (null when there is none).
+	const std::shared_ptr<RequestObserver> requestObserver;
+
+	/// Registry into which sent requests are recorded (null when they are
+	/// not recorded).
+	const std::shared_ptr<MetricsRegistry> metrics;
+};
 
 ///
-/// Adds authorization to the given request.
+/// Creates a request with the given method to the given URL.
 ///
-void RealConnection::Impl::addAuthToRequest(HttpClient::request &request) {
+HttpClient::Request RealConnection::Impl::createRequest(
+		const std::string &method, const Url &url,
+		const RequestArguments &args) {
+	HttpClient::Request request;
+	request.method = method;
+	request.url = url + createQuery(args);
 	// Basic HTTP authorization is used, where the username is the API key, and
 	// the password is empty. According to RFC 2617, the username and password
 	// have to be separated by a colon and base64-encoded. See RFC 2617 (HTTP
 	// Authentication: Basic and Digest Access Authentication) for more
 	// details.
-	auto credentials = settings.apiKey() + ":";
-	auto encodedCredentials = base64Encode(credentials);
-	request << boost::network::header("Authorization", "Basic " + encodedCredentials);
-}
-
-///
-/// Adds a user-agent string to the given request.
-///
-void RealConnection::Impl::addUserAgentToRequest(HttpClient::request &request) {
-	request << boost::network::header("User-Agent", settings.userAgent());
+	request.headers.emplace_back("Authorization",
+		"Basic " + base64Encode(settings.apiKey() + ":"));
+	request.headers.emplace_back("User-Agent", settings.userAgent());
+	return request;
 }
 
 ///
 /// Adds the given files to the given request.
 ///
-/// @returns Body of the request to be used when sending a POST request.
+/// The body is not created here. Instead, it is streamed when the request is
+/// sent, so the files are never held in memory as a whole.
 ///
-std::string RealConnection::Impl::addFilesToRequest(const RequestFiles &files,
-		HttpClient::request &request) {
+void RealConnection::Impl::addFilesToRequest(const RequestFiles &files,
+		HttpClient::Request &request) {
 	// TODO Ensure that the given boundary does not appear in the files.
 	const std::string boundary("6eaab101ea8e44848f8d033f5f11088a");
-	request << boost::network::header("Content-Type",
+	request.headers.emplace_back("Content-Type",
 		"multipart/form-data; boundary=" + boundary);
 
-	std::string body;
-	if (!files.empty()) {
-		bool first = true;
-		for (auto &file : files) {
-			body +=	first ? "" : "\r\n";
-			body +=	"--" + boundary + "\r\n" +
-				"Content-Disposition: form-data; name=\"" + file.first +
-					"\"; filename=\"" + file.second->getName() + "\"\r\n" +
-				"\r\n" +
-				file.second->getContent();
-			first = false;
-		}
-		body += "\r\n--" + boundary + "--\r\n";
+	MultipartBody body(files, boundary);
+	request.bodySize = body.size();
+	request.body = body;
+}
+
+///
+/// Starts a measurement of the given request to the given URL.
+///
+/// When the request has a body, its generator is replaced with one measuring
+/// the sending.
+///
+std::shared_ptr<RequestMeasurement> RealConnection::Impl::startMeasurement(
+		HttpClient::Request &request, const Url &url) {
+	auto measurement = std::make_shared<RequestMeasurement>(
+		requestObserver.get(), metrics.get(), settings, request.method, url);
+	if (!measurement->isEnabled()) {
+		return measurement;
 	}
-	return body;
+
+	if (request.body) {
+		request.body = measurement->measuredBody(std::move(request.body));
+	}
+	request.phaseHandler = measurement->phaseHandler();
+	return measurement;
 }
 
 ///
-/// Creates a request from the given data.
+/// Sends the given request to the given URL (without arguments) and returns
+/// the response.
 ///
-HttpClient::request RealConnection::Impl::createRequest(const Url &url,
-		const RequestArguments &args) {
-	HttpClient::request request(url + createQuery(args));
-	addAuthToRequest(request);
-	addUserAgentToRequest(request);
-	return request;
+/// When @a bodyHandler is not empty, the body of a successful response is
+/// passed to it as it arrives instead of being stored in the response.
+///
+std::unique_ptr<Connection::Response> RealConnection::Impl::send(
+		HttpClient::Request request, const Url &url,
+		const BodyHandler &bodyHandler) {
+	auto measurement = startMeasurement(request, url);
+	ResponseCollector collector(std::move(measurement), bodyHandler);
+	client.send(request, collector.headHandler(), collector.bodyHandler());
+	return collector.finish();
+}
+
+///
+/// Sends the given request to the given URL (without arguments) and passes
+/// the response to @a responseHandler.
+///
+void RealConnection::Impl::sendAsync(HttpClient::Request request,
+		const Url &url, const ResponseHandler &responseHandler) {
+	auto measurement = startMeasurement(request, url);
+	ResponseCollector collector(std::move(measurement), BodyHandler());
+	client.sendAsync(request, collector.headHandler(), collector.bodyHandler(),
+		[collector, responseHandler](std::exception_ptr error) {
+			if (error) {
+				collector.finishMeasurement();
+				return responseHandler(nullptr, error);
+			}
+			responseHandler(collector.finish(), nullptr);
+		}
+	);
 }
 
 ///
@@ -222,13 +575,7 @@ std::unique_ptr<Connection::Response> RealConnection::sendGetRequest(
 // Override.
 std::unique_ptr<Connection::Response> RealConnection::sendGetRequest(
 		const Url &url, const RequestArguments &args) {
-	auto request = impl->createRequest(url, args);
-	try {
-		auto response = impl->client.get(request);
-		return std::make_unique<RealResponse>(response);
-	} catch (const boost::system::system_error &ex) {
-		throw ConnectionError(ex.what());
-	}
+	return impl->send(impl->createRequest("GET", url, args), url);
 }
 
 // Override.
@@ -241,14 +588,38 @@ std::unique_ptr<Connection::Response> RealConnection::sendPostRequest(
 	//
 	// c
 	// --fc4a7d4771a04bdb89d94ab0ec2209f9
-	auto request = impl->createRequest(url, args);
-	auto body = impl->addFilesToRequest(files, request);
-	try {
-		auto response = impl->client.post(request, body);
-		return std::make_unique<RealResponse>(response);
-	} catch (const boost::system::system_error &ex) {
-		throw ConnectionError(ex.what());
-	}
+	auto request = impl->createRequest("POST", url, args);
+	impl->addFilesToRequest(files, request);
+	return impl->send(std::move(request), url);
+}
+
+// Override.
+std::unique_ptr<Connection::Response> RealConnection::sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) {
+	return impl->send(impl->createRequest("GET", url, RequestArguments()), url,
+		bodyHandler);
+}
+
+// Override.
+void RealConnection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	sendGetRequestAsync(url, RequestArguments(), responseHandler);
+}
+
+// Override.
+void RealConnection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	impl->sendAsync(impl->createRequest("GET", url, args), url,
+		responseHandler);
+}
+
+// Override.
+void RealConnection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	auto request = impl->createRequest("POST", url, args);
+	impl->addFilesToRequest(files, request);
+	impl->sendAsync(std::move(request), url, responseHandler);
 }
 
 } // namespace internal
@@ -0,0 +1,212 @@
+///
+/// @file      retdec/internal/connections/sharing_connection.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the connection wrapper sharing responses
+///            between handles of a resource.
+///
+
+#include <exception>
+#include <future>
+#include <utility>
+
+#include <json/json.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/connections/sharing_connection.h"
+#include "retdec/internal/in_flight_resources.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/utilities/connection.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Is the given response a status of a finished resource?
+///
+bool isFinalStatus(const Connection::Response &response) {
+	try {
+		return response.bodyAsStatus().finished;
+	} catch (const Error &) {
+		return false;
+	}
+}
+
+///
+/// Passes the response to a GET request to the given URL to all handles of
+/// the given resource that have joined the request.
+///
+void completeRequest(InFlightResource &resource,
+		const Connection::Url &statusUrl, const Connection::Url &url,
+		std::unique_ptr<Connection::Response> response,
+		std::exception_ptr error) {
+	auto keepResponse = false;
+	if (!error && requestSucceeded(*response)) {
+		if (url != statusUrl) {
+			keepResponse = true;
+		} else if (isFinalStatus(*response)) {
+			keepResponse = true;
+			resource.finished();
+		}
+	}
+	resource.completeRequest(url, std::move(response), error, keepResponse);
+}
+
+} // anonymous namespace
+
+///
+/// Constructs a wrapper.
+///
+/// @param[in] conn Connection to be wrapped.
+/// @param[in] resource Resource whose responses are shared.
+/// @param[in] resourceUrl URL of the resource. Only responses to GET requests
+///                        to URLs under this URL are shared.
+///
+SharingConnection::SharingConnection(const std::shared_ptr<Connection> &conn,
+		const std::shared_ptr<InFlightResource> &resource,
+		const Url &resourceUrl):
+	conn(conn), resource(resource), resourceUrl(resourceUrl),
+	statusUrl(resourceUrl + "/status") {}
+
+///
+/// Destructs the wrapper.
+///
+SharingConnection::~SharingConnection() = default;
+
+// Override.
+Connection::Url SharingConnection::getApiUrl() const {
+	return conn->getApiUrl();
+}
+
+// Override.
+std::unique_ptr<Connection::Response> SharingConnection::sendGetRequest(
+		const Url &url) {
+	if (!isResourceUrl(url)) {
+		return conn->sendGetRequest(url);
+	}
+
+	// A request in progress may be completed only by a handler that waits for
+	// the current thread, so worker threads of the I/O service do not wait for
+	// it and send their own request instead.
+	if (IoService::isWorkerThread()) {
+		if (auto response = resource->keptResponse(url)) {
+			return response;
+		}
+		return conn->sendGetRequest(url);
+	}
+
+	auto response = std::make_shared<
+		std::promise<std::unique_ptr<Response>>>();
+	auto shared = resource->joinRequest(url,
+		[response](std::unique_ptr<Response> sharedResponse,
+				std::exception_ptr error) {
+			if (error) {
+				response->set_exception(error);
+			} else {
+				response->set_value(std::move(sharedResponse));
+			}
+		}
+	);
+	if (!shared) {
+		std::unique_ptr<Response> sentResponse;
+		std::exception_ptr error;
+		try {
+			sentResponse = conn->sendGetRequest(url);
+		} catch (...) {
+			error = std::current_exception();
+		}
+		completeRequest(*resource, statusUrl, url,
+			std::move(sentResponse), error);
+	}
+	return response->get_future().get();
+}
+
+// Override.
+std::unique_ptr<Connection::Response> SharingConnection::sendGetRequest(
+		const Url &url, const RequestArguments &args) {
+	return conn->sendGetRequest(url, args);
+}
+
+// Override.
+std::unique_ptr<Connection::Response> SharingConnection::sendPostRequest(
+		const Url &url, const RequestArguments &args,
+		const RequestFiles &files) {
+	return conn->sendPostRequest(url, args, files);
+}
+
+///
+/// Sends a GET request to the given URL and passes the body of the response to
+/// @a bodyHandler in parts as it is being received.
+///
+/// When the response is kept, its body is passed from memory. Otherwise, the
+/// request is passed to the wrapped connection and the response is not kept
+/// because streamed bodies should never be stored in memory as a whole.
+///
+std::unique_ptr<Connection::Response> SharingConnection::sendGetRequestStreamingBody(
+		const Url &url, const BodyHandler &bodyHandler) {
+	if (isResourceUrl(url)) {
+		if (auto response = resource->keptResponse(url)) {
+			auto body = response->sharedBody();
+			bodyHandler(body->data(), body->size());
+			return response;
+		}
+	}
+	return conn->sendGetRequestStreamingBody(url, bodyHandler);
+}
+
+// Override.
+void SharingConnection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	if (!isResourceUrl(url)) {
+		return conn->sendGetRequestAsync(url, responseHandler);
+	}
+
+	if (resource->joinRequest(url, responseHandler)) {
+		return;
+	}
+
+	// The wrapper may be destructed before the response is received, so do
+	// not capture it.
+	auto resource = this->resource;
+	auto statusUrl = this->statusUrl;
+	conn->sendGetRequestAsync(url,
+		[resource, statusUrl, url](std::unique_ptr<Response> response,
+				std::exception_ptr error) {
+			completeRequest(*resource, statusUrl, url,
+				std::move(response), error);
+		}
+	);
+}
+
+// Override.
+void SharingConnection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	conn->sendGetRequestAsync(url, args, responseHandler);
+}
+
+// Override.
+void SharingConnection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	conn->sendPostRequestAsync(url, args, files, responseHandler);
+}
+
+// Override.
+std::shared_ptr<Clock> SharingConnection::clock() const {
+	return conn->clock();
+}
+
+///
+/// Is the given URL a URL of the resource?
+///
+bool SharingConnection::isResourceUrl(const Url &url) const {
+	auto prefix = resourceUrl + "/";
+	return url.size() > prefix.size() &&
+		url.compare(0, prefix.size(), prefix) == 0;
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,58 @@
+///
+/// @file      retdec/internal/connections/simulated_connection.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the connection to a simulation of the API.
+///
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/internal/simulated_service.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a connection to the given simulation.
+///
+/// @param[in] service Simulation handling the requests.
+/// @param[in] apiUrl URL to the API. The simulation handles requests to any
+///                   URL, so it is used only to form URLs of resources.
+///
+SimulatedConnection::SimulatedConnection(
+		const std::shared_ptr<SimulatedService> &service, const Url &apiUrl):
+	service(service), apiUrl(apiUrl) {}
+
+// Override.
+SimulatedConnection::~SimulatedConnection() = default;
+
+// Override.
+Connection::Url SimulatedConnection::getApiUrl() const {
+	return apiUrl;
+}
+
+// Override.
+std::unique_ptr<Connection::Response> SimulatedConnection::sendGetRequest(
+		const Url &url) {
+	return service->sendGetRequest(url, RequestArguments());
+}
+
+// Override.
+std::unique_ptr<Connection::Response> SimulatedConnection::sendGetRequest(
+		const Url &url, const RequestArguments &args) {
+	return service->sendGetRequest(url, args);
+}
+
+// Override.
+std::unique_ptr<Connection::Response> SimulatedConnection::sendPostRequest(
+		const Url &url, const RequestArguments &args, const RequestFiles &files) {
+	return service->sendPostRequest(url, args, files);
+}
+
+// Override.
+std::shared_ptr<Clock> SimulatedConnection::clock() const {
+	return service->clock();
+}
+
+} // namespace internal
+} // namespace retdec
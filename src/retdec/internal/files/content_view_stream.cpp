@@ -0,0 +1,27 @@
+///
+/// @file      retdec/internal/files/content_view_stream.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the stream reading a view of the content of a
+///            file.
+///
+
+#include "retdec/internal/files/content_view_stream.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a stream reading the given view.
+///
+ContentViewStream::ContentViewStream(const File::ContentView &view):
+	boost::interprocess::ibufferstream(view.data(), view.size()),
+	view(view) {}
+
+///
+/// Destructs the stream.
+///
+ContentViewStream::~ContentViewStream() = default;
+
+} // namespace internal
+} // namespace retdec
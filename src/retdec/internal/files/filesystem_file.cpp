@@ -46,6 +46,16 @@ std::string FilesystemFile::getContent() {
 	return readFile(path);
 }
 
+// Override.
+std::uint64_t FilesystemFile::getSize() {
+	return fileSize(path);
+}
+
+// Override.
+std::unique_ptr<std::istream> FilesystemFile::openContent() {
+	return openFile(path);
+}
+
 // Override.
 void FilesystemFile::saveCopyTo(const std::string &directoryPath) {
 	saveCopyTo(directoryPath, name);
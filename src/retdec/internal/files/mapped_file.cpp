@@ -0,0 +1,105 @@
+///
+/// @file      retdec/internal/files/mapped_file.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the file stored in a filesystem and mapped into
+///            memory.
+///
+
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "retdec/internal/files/content_view_stream.h"
+#include "retdec/internal/files/mapped_file.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a file and maps it into memory.
+///
+/// @param[in] path Path to the file in a filesystem.
+///
+MappedFile::MappedFile(const std::string &path):
+		FilesystemFile(path) {
+	map(path);
+}
+
+///
+/// Constructs a file with a custom name and maps it into memory.
+///
+/// @param[in] path Path to the file in a filesystem.
+/// @param[in] name Name to be used as the file's name.
+///
+MappedFile::MappedFile(const std::string &path, const std::string &name):
+		FilesystemFile(path, name) {
+	map(path);
+}
+
+///
+/// Destructs the file.
+///
+/// The file stays mapped while there are views or streams of its content.
+///
+MappedFile::~MappedFile() = default;
+
+///
+/// Has the file been mapped into memory?
+///
+bool MappedFile::isMapped() const noexcept {
+	return static_cast<bool>(region);
+}
+
+// Override.
+std::string MappedFile::getContent() {
+	if (!region) {
+		return FilesystemFile::getContent();
+	}
+	return getContentView().toString();
+}
+
+// Override.
+File::ContentView MappedFile::getContentView() {
+	if (!region) {
+		return FilesystemFile::getContentView();
+	}
+	return ContentView(region, static_cast<const char *>(region->get_address()),
+		region->get_size());
+}
+
+// Override.
+std::uint64_t MappedFile::getSize() {
+	if (!region) {
+		return FilesystemFile::getSize();
+	}
+	return region->get_size();
+}
+
+// Override.
+std::unique_ptr<std::istream> MappedFile::openContent() {
+	if (!region) {
+		return FilesystemFile::openContent();
+	}
+	return std::make_unique<ContentViewStream>(getContentView());
+}
+
+///
+/// Maps the file from the given path into memory.
+///
+/// When the file cannot be mapped, it is left unmapped.
+///
+void MappedFile::map(const std::string &path) {
+	try {
+		boost::interprocess::file_mapping file(path.c_str(),
+			boost::interprocess::read_only);
+		region = std::make_shared<boost::interprocess::mapped_region>(
+			file, boost::interprocess::read_only);
+	} catch (const boost::interprocess::interprocess_exception &) {
+		// The file does not exist, it is empty, or it is not a regular file.
+		// FilesystemFile reports errors when the file is read.
+	}
+}
+
+} // namespace internal
+} // namespace retdec
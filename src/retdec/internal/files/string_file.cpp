@@ -7,6 +7,7 @@
 
 #include <utility>
 
+#include "retdec/internal/files/content_view_stream.h"
 #include "retdec/internal/files/string_file.h"
 #include "retdec/internal/utilities/os.h"
 
@@ -17,12 +18,22 @@ namespace internal {
 /// Constructs a file with the given content.
 ///
 StringFile::StringFile(std::string content):
-	content(std::move(content)) {}
+	content(std::make_shared<const std::string>(std::move(content))) {}
 
 ///
 /// Constructs a file with the given content and name.
 ///
 StringFile::StringFile(std::string content, std::string name):
+	content(std::make_shared<const std::string>(std::move(content))),
+	name(std::move(name)) {}
+
+///
+/// Constructs a file with the given shared content and name.
+///
+/// The content is not copied.
+///
+StringFile::StringFile(std::shared_ptr<const std::string> content,
+		std::string name):
 	content(std::move(content)), name(std::move(name)) {}
 
 ///
@@ -37,7 +48,22 @@ std::string StringFile::getName() const {
 
 // Override.
 std::string StringFile::getContent() {
-	return content;
+	return *content;
+}
+
+// Override.
+File::ContentView StringFile::getContentView() {
+	return ContentView(content, content->data(), content->size());
+}
+
+// Override.
+std::uint64_t StringFile::getSize() {
+	return content->size();
+}
+
+// Override.
+std::unique_ptr<std::istream> StringFile::openContent() {
+	return std::make_unique<ContentViewStream>(getContentView());
 }
 
 // Override.
@@ -48,7 +74,7 @@ void StringFile::saveCopyTo(const std::string &directoryPath) {
 // Override.
 void StringFile::saveCopyTo(const std::string &directoryPath,
 		const std::string &name) {
-	writeFile(joinPaths(directoryPath, name), content);
+	writeFile(joinPaths(directoryPath, name), *content);
 }
 
 } // namespace internal
@@ -0,0 +1,71 @@
+///
+/// @file      retdec/internal/files/tracing_file.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the file wrapper tracing the saving of copies
+///            of the file.
+///
+
+#include "retdec/internal/files/tracing_file.h"
+#include "retdec/internal/trace_buffer.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Creates a tracing file by wrapping the given file.
+///
+/// @param[in] file File to be wrapped.
+/// @param[in] traceBuffer Buffer into which the spans are recorded.
+/// @param[in] track Track on which the spans are shown.
+///
+TracingFile::TracingFile(const std::shared_ptr<File> &file,
+		const std::shared_ptr<TraceBuffer> &traceBuffer,
+		const std::string &track):
+	file(file), traceBuffer(traceBuffer), track(track) {}
+
+// Override.
+TracingFile::~TracingFile() = default;
+
+// Override.
+std::string TracingFile::getName() const {
+	return file->getName();
+}
+
+// Override.
+std::string TracingFile::getContent() {
+	return file->getContent();
+}
+
+// Override.
+File::ContentView TracingFile::getContentView() {
+	return file->getContentView();
+}
+
+// Override.
+std::uint64_t TracingFile::getSize() {
+	return file->getSize();
+}
+
+// Override.
+std::unique_ptr<std::istream> TracingFile::openContent() {
+	return file->openContent();
+}
+
+// Override.
+void TracingFile::saveCopyTo(const std::string &directoryPath) {
+	TraceSpan span(traceBuffer, "saveCopyTo", track);
+	span.setArg("file", file->getName());
+	file->saveCopyTo(directoryPath);
+}
+
+// Override.
+void TracingFile::saveCopyTo(const std::string &directoryPath,
+		const std::string &name) {
+	TraceSpan span(traceBuffer, "saveCopyTo", track);
+	span.setArg("file", name);
+	file->saveCopyTo(directoryPath, name);
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,1263 @@
+///
+/// @file      retdec/internal/http_client.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the HTTP/1.1 client keeping its connections
+///            open.
+///
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/system/system_error.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/http_client.h"
+#include "retdec/internal/io_service.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+using boost::asio::ip::tcp;
+
+/// Maximal size of the status line and headers of a response (in bytes).
+const std::size_t MaxHeadSize = 64 * 1024;
+
+/// Size of the buffer into which responses are read (in bytes).
+const std::size_t ReadBufferSize = 64 * 1024;
+
+/// Maximal number of idle connections kept open by a single client.
+const std::size_t MaxIdleConnections = 8;
+
+///
+/// Returns @a str with all letters converted to lower case.
+///
+std::string toLower(std::string str) {
+	std::transform(str.begin(), str.end(), str.begin(),
+		[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return str;
+}
+
+///
+/// Returns @a str without leading and trailing spaces and tabs.
+///
+std::string trim(const std::string &str) {
+	auto begin = str.find_first_not_of(" \t");
+	if (begin == std::string::npos) {
+		return "";
+	}
+	auto end = str.find_last_not_of(" \t");
+	return str.substr(begin, end - begin + 1);
+}
+
+///
+/// Does the comma-separated list of tokens in @a value contain @a token
+/// (ignoring case)?
+///
+bool containsToken(const std::string &value, const std::string &token) {
+	std::string::size_type begin = 0;
+	for (;;) {
+		auto end = value.find(',', begin);
+		if (toLower(trim(value.substr(begin, end - begin))) == token) {
+			return true;
+		}
+		if (end == std::string::npos) {
+			return false;
+		}
+		begin = end + 1;
+	}
+}
+
+///
+/// Parts of a URL to which a request is sent.
+///
+struct RequestUrl {
+	/// Is the connection secured by TLS (@c https)?
+	bool secure = false;
+
+	/// Host.
+	std::string host;
+
+	/// Port.
+	std::string port;
+
+	/// Value of the @c Host header (the host and the port as written in the
+	/// URL).
+	std::string authority;
+
+	/// Target of the request (the path and the query).
+	std::string target;
+
+	/// Origin identifying the connections that can be reused for the URL.
+	std::string origin;
+};
+
+///
+/// Splits the given absolute URL into its parts.
+///
+RequestUrl parseUrl(const std::string &url) {
+	RequestUrl parsed;
+	const std::string HttpPrefix("http://");
+	const std::string HttpsPrefix("https://");
+	std::string rest;
+	if (url.compare(0, HttpsPrefix.size(), HttpsPrefix) == 0) {
+		parsed.secure = true;
+		rest = url.substr(HttpsPrefix.size());
+	} else if (url.compare(0, HttpPrefix.size(), HttpPrefix) == 0) {
+		rest = url.substr(HttpPrefix.size());
+	} else {
+		throw ConnectionError("unsupported URL \"" + url + "\"");
+	}
+
+	auto targetPos = rest.find_first_of("/?");
+	parsed.authority = rest.substr(0, targetPos);
+	parsed.target = targetPos != std::string::npos ?
+		rest.substr(targetPos) : "/";
+	if (parsed.target[0] == '?') {
+		parsed.target.insert(0, "/");
+	}
+
+	auto portPos = std::string::npos;
+	if (!parsed.authority.empty() && parsed.authority[0] == '[') {
+		// An IPv6 address (e.g. [::1]:8000).
+		auto addressEnd = parsed.authority.find(']');
+		if (addressEnd != std::string::npos) {
+			parsed.host = parsed.authority.substr(1, addressEnd - 1);
+			portPos = parsed.authority.find(':', addressEnd);
+		}
+	} else {
+		portPos = parsed.authority.rfind(':');
+		parsed.host = parsed.authority.substr(0, portPos);
+	}
+	parsed.port = portPos != std::string::npos ?
+		parsed.authority.substr(portPos + 1) :
+		(parsed.secure ? "443" : "80");
+	if (parsed.host.empty() || parsed.port.empty()) {
+		throw ConnectionError("invalid URL \"" + url + "\"");
+	}
+
+	parsed.origin = (parsed.secure ? HttpsPrefix : HttpPrefix) +
+		parsed.host + ":" + parsed.port;
+	return parsed;
+}
+
+///
+/// Returns the status line and headers of the given request.
+///
+std::string requestHead(const RequestUrl &url,
+		const HttpClient::Request &request) {
+	std::string head = request.method + " " + url.target + " HTTP/1.1\r\n";
+	head += "Host: " + url.authority + "\r\n";
+	for (const auto &header : request.headers) {
+		head += header.first + ": " + header.second + "\r\n";
+	}
+	if (request.body || request.method == "POST") {
+		head += "Content-Length: " + std::to_string(request.bodySize) + "\r\n";
+	}
+	head += "\r\n";
+	return head;
+}
+
+///
+/// Incremental parser of a response.
+///
+/// Data received over a connection are fed to the parser as they arrive. The
+/// status and headers are passed to a head handler once they have been parsed
+/// and parts of the body to a body handler. Both fixed-length and chunked
+/// bodies are supported, as well as bodies ended by closing the connection.
+///
+class ResponseParser {
+public:
+	ResponseParser(const HttpClient::HeadHandler &headHandler,
+		const HttpClient::BodyHandler &bodyHandler);
+
+	void feed(const char *data, std::size_t size);
+	void endOfStream();
+
+	bool isComplete() const noexcept;
+	bool keepsConnectionOpen() const noexcept;
+
+private:
+	/// Part of the response that is being parsed.
+	enum class State {
+		StatusLine,
+		Header,
+		Body,
+		BodyUntilEndOfStream,
+		ChunkSize,
+		ChunkData,
+		ChunkEnd,
+		Trailer,
+		Complete
+	};
+
+	bool readLine(const char *&data, const char *end);
+	void parseStatusLine();
+	void parseHeader();
+	void headParsed();
+	void parseChunkSize();
+
+private:
+	/// Function to which the status and headers are passed.
+	HttpClient::HeadHandler headHandler;
+
+	/// Function to which parts of the body are passed.
+	HttpClient::BodyHandler bodyHandler;
+
+	/// Part of the response that is being parsed.
+	State state = State::StatusLine;
+
+	/// Line that is being read (without the line ending).
+	std::string line;
+
+	/// Size of the status line and headers read so far.
+	std::size_t headSize = 0;
+
+	/// Parsed status and headers.
+	HttpClient::Response response;
+
+	/// Remaining size of the body or of the current chunk.
+	std::uint64_t remainingSize = 0;
+
+	/// Can the connection be used for further requests?
+	bool keepAlive = true;
+};
+
+///
+/// Constructs a parser passing the parsed response to the given handlers.
+///
+ResponseParser::ResponseParser(const HttpClient::HeadHandler &headHandler,
+		const HttpClient::BodyHandler &bodyHandler):
+	headHandler(headHandler), bodyHandler(bodyHandler) {}
+
+///
+/// Parses the given received data.
+///
+/// @throws ConnectionError When the data do not form a valid response.
+///
+void ResponseParser::feed(const char *data, std::size_t size) {
+	const auto end = data + size;
+	while (data != end) {
+		switch (state) {
+			case State::StatusLine:
+				if (readLine(data, end)) {
+					parseStatusLine();
+				}
+				break;
+
+			case State::Header:
+				if (readLine(data, end)) {
+					parseHeader();
+				}
+				break;
+
+			case State::Body:
+			case State::ChunkData: {
+				auto partSize = static_cast<std::size_t>(std::min<std::uint64_t>(
+					remainingSize, static_cast<std::uint64_t>(end - data)));
+				bodyHandler(data, partSize);
+				data += partSize;
+				remainingSize -= partSize;
+				if (remainingSize == 0) {
+					state = state == State::Body ?
+						State::Complete : State::ChunkEnd;
+				}
+				break;
+			}
+
+			case State::BodyUntilEndOfStream:
+				bodyHandler(data, static_cast<std::size_t>(end - data));
+				data = end;
+				break;
+
+			case State::ChunkSize:
+				if (readLine(data, end)) {
+					parseChunkSize();
+				}
+				break;
+
+			case State::ChunkEnd:
+				if (readLine(data, end)) {
+					if (!line.empty()) {
+						throw ConnectionError("invalid chunk in the response");
+					}
+					state = State::ChunkSize;
+				}
+				break;
+
+			case State::Trailer:
+				if (readLine(data, end)) {
+					// Trailing headers are ignored.
+					if (line.empty()) {
+						state = State::Complete;
+					}
+					line.clear();
+				}
+				break;
+
+			case State::Complete:
+			default:
+				// Requests are not pipelined, so nothing may follow the
+				// response. The connection cannot be trusted anymore.
+				keepAlive = false;
+				return;
+		}
+	}
+}
+
+///
+/// Signals that the connection has been closed by the server.
+///
+/// @throws ConnectionError When the response has not been completely received.
+///
+void ResponseParser::endOfStream() {
+	keepAlive = false;
+	if (state == State::BodyUntilEndOfStream) {
+		state = State::Complete;
+	} else if (state != State::Complete) {
+		throw ConnectionError(
+			"connection closed before the whole response was received");
+	}
+}
+
+///
+/// Has the whole response been received?
+///
+bool ResponseParser::isComplete() const noexcept {
+	return state == State::Complete;
+}
+
+///
+/// Can the connection be used for further requests once the response has been
+/// received?
+///
+bool ResponseParser::keepsConnectionOpen() const noexcept {
+	return keepAlive;
+}
+
+///
+/// Reads a line from the given data into @c line.
+///
+/// @returns @c true when the whole line has been read, @c false when more data
+///          are needed.
+///
+bool ResponseParser::readLine(const char *&data, const char *end) {
+	auto lineEnd = std::find(data, end, '\n');
+	auto readSize = static_cast<std::size_t>(lineEnd - data);
+	headSize += readSize;
+	if (headSize > MaxHeadSize) {
+		throw ConnectionError("too long line in the response");
+	}
+	line.append(data, readSize);
+	if (lineEnd == end) {
+		data = end;
+		return false;
+	}
+
+	data = lineEnd + 1;
+	if (!line.empty() && line.back() == '\r') {
+		line.pop_back();
+	}
+	return true;
+}
+
+///
+/// Parses the status line in @c line.
+///
+void ResponseParser::parseStatusLine() {
+	// HTTP/1.1 200 OK
+	auto codePos = line.find(' ');
+	if (line.compare(0, 5, "HTTP/") != 0 || codePos == std::string::npos) {
+		throw ConnectionError("invalid status line in the response");
+	}
+	auto messagePos = line.find(' ', codePos + 1);
+	try {
+		response.statusCode = std::stoi(line.substr(codePos + 1,
+			messagePos - codePos - 1));
+	} catch (const std::exception &) {
+		throw ConnectionError("invalid status code in the response");
+	}
+	response.statusMessage = messagePos != std::string::npos ?
+		line.substr(messagePos + 1) : "";
+	// HTTP/1.0 connections are closed by default.
+	keepAlive = line.compare(0, codePos, "HTTP/1.0") != 0;
+
+	line.clear();
+	state = State::Header;
+}
+
+///
+/// Parses the header in @c line (or finishes the head when it is empty).
+///
+void ResponseParser::parseHeader() {
+	if (line.empty()) {
+		return headParsed();
+	}
+
+	if ((line[0] == ' ' || line[0] == '\t') && !response.headers.empty()) {
+		// A continuation of the previous header.
+		response.headers.back().second += " " + trim(line);
+	} else {
+		auto colonPos = line.find(':');
+		if (colonPos == std::string::npos) {
+			throw ConnectionError("invalid header in the response");
+		}
+		response.headers.emplace_back(trim(line.substr(0, colonPos)),
+			trim(line.substr(colonPos + 1)));
+	}
+	line.clear();
+}
+
+///
+/// Passes the parsed status and headers to the head handler and decides how
+/// the body is delimited.
+///
+void ResponseParser::headParsed() {
+	headSize = 0;
+	if (response.statusCode >= 100 && response.statusCode <= 199) {
+		// An interim response (e.g. 100 Continue) is followed by the final
+		// one.
+		response = HttpClient::Response();
+		state = State::StatusLine;
+		return;
+	}
+
+	auto connection = response.header("Connection");
+	if (containsToken(connection, "close")) {
+		keepAlive = false;
+	} else if (containsToken(connection, "keep-alive")) {
+		keepAlive = true;
+	}
+
+	headHandler(response);
+
+	auto contentLength = response.header("Content-Length");
+	if (response.statusCode == 204 || response.statusCode == 304) {
+		state = State::Complete;
+	} else if (containsToken(response.header("Transfer-Encoding"),
+			"chunked")) {
+		state = State::ChunkSize;
+	} else if (!contentLength.empty()) {
+		try {
+			remainingSize = std::stoull(contentLength);
+		} catch (const std::exception &) {
+			throw ConnectionError("invalid Content-Length in the response");
+		}
+		state = remainingSize > 0 ? State::Body : State::Complete;
+	} else {
+		// The body ends when the server closes the connection.
+		keepAlive = false;
+		state = State::BodyUntilEndOfStream;
+	}
+}
+
+///
+/// Parses the size of a chunk in @c line.
+///
+void ResponseParser::parseChunkSize() {
+	// The size may be followed by extensions (e.g. 1a;name=value).
+	try {
+		remainingSize = std::stoull(line.substr(0, line.find(';')), nullptr,
+			16);
+	} catch (const std::exception &) {
+		throw ConnectionError("invalid chunk size in the response");
+	}
+	line.clear();
+	headSize = 0;
+	state = remainingSize > 0 ? State::ChunkData : State::Trailer;
+}
+
+///
+/// Writes the whole given data into the given stream on the calling thread.
+///
+template <typename Stream>
+void writeAll(Stream &stream, const std::string &data) {
+	std::size_t written = 0;
+	while (written < data.size()) {
+		written += stream.write_some(
+			boost::asio::buffer(data.data() + written, data.size() - written));
+	}
+}
+
+///
+/// Reports the given phase to @a phaseHandler (if any).
+///
+void reportPhase(const HttpClient::PhaseHandler &phaseHandler,
+		HttpClient::Phase phase) {
+	if (phaseHandler) {
+		phaseHandler(phase);
+	}
+}
+
+///
+/// Is @a ec an error signaling that the server has closed the connection?
+///
+bool isEndOfStream(const boost::system::error_code &ec) {
+	// Servers often close TLS connections without a proper shutdown.
+	return ec == boost::asio::error::eof ||
+		ec == boost::asio::ssl::error::stream_truncated;
+}
+
+///
+/// Connection to a single origin, which is kept open between requests.
+///
+/// It is used by a single request at a time.
+///
+class HttpConnection {
+public:
+	HttpConnection(std::shared_ptr<IoService> ioService,
+		const RequestUrl &url,
+		std::shared_ptr<boost::asio::ssl::context> tlsContext);
+	~HttpConnection();
+
+	const std::string &origin() const noexcept;
+	bool isConnected() const noexcept;
+	bool isOpen();
+	void close() noexcept;
+
+	void connect(const HttpClient::PhaseHandler &phaseHandler);
+	template <typename Handler>
+	void connectAsync(const HttpClient::PhaseHandler &phaseHandler,
+		Handler handler);
+	template <typename Handler>
+	void connectAsync(tcp::resolver::iterator endpoint,
+		const HttpClient::PhaseHandler &phaseHandler, Handler handler);
+	void connected();
+
+	/// Calls @a operation with the stream over which data are sent and
+	/// received.
+	template <typename Operation>
+	void withStream(Operation operation) {
+		if (tlsStream) {
+			operation(*tlsStream);
+		} else {
+			operation(*socket);
+		}
+	}
+
+private:
+	tcp::socket &tcpSocket();
+	void setUpTls();
+
+private:
+	/// I/O service with which the connection is associated.
+	const std::shared_ptr<IoService> ioService;
+
+	/// URL of the first request (only its origin is important).
+	const RequestUrl url;
+
+	/// Context of TLS (null for plain connections).
+	const std::shared_ptr<boost::asio::ssl::context> tlsContext;
+
+	/// Resolver of the host (only during an asynchronous connection).
+	std::unique_ptr<tcp::resolver> resolver;
+
+	/// Plain socket (null for connections secured by TLS).
+	std::unique_ptr<tcp::socket> socket;
+
+	/// Stream secured by TLS (null for plain connections).
+	std::unique_ptr<boost::asio::ssl::stream<tcp::socket>> tlsStream;
+
+	/// Has the connection been established?
+	bool connected_ = false;
+};
+
+///
+/// Constructs a connection to the origin of the given URL.
+///
+/// The connection is not established until connect() or connectAsync() is
+/// called. @a tlsContext has to be given for @c https URLs.
+///
+HttpConnection::HttpConnection(std::shared_ptr<IoService> ioService,
+		const RequestUrl &url,
+		std::shared_ptr<boost::asio::ssl::context> tlsContext):
+	ioService(std::move(ioService)), url(url),
+	tlsContext(std::move(tlsContext)) {
+	auto &service = *this->ioService->asioService();
+	if (url.secure) {
+		tlsStream = std::make_unique<boost::asio::ssl::stream<tcp::socket>>(
+			service, *this->tlsContext);
+	} else {
+		socket = std::make_unique<tcp::socket>(service);
+	}
+}
+
+///
+/// Closes the connection.
+///
+HttpConnection::~HttpConnection() {
+	close();
+}
+
+///
+/// Returns the origin to which the connection leads.
+///
+const std::string &HttpConnection::origin() const noexcept {
+	return url.origin;
+}
+
+///
+/// Has the connection been established?
+///
+bool HttpConnection::isConnected() const noexcept {
+	return connected_;
+}
+
+///
+/// Is the idle connection still open?
+///
+/// A server closes idle connections after a while. As nothing may be received
+/// over an idle connection, any received data (including the end of the
+/// stream) mean that the connection cannot be used anymore.
+///
+bool HttpConnection::isOpen() {
+	auto &sock = tcpSocket();
+	if (!sock.is_open()) {
+		return false;
+	}
+
+	boost::system::error_code ec;
+	sock.non_blocking(true, ec);
+	char byte;
+	sock.receive(boost::asio::buffer(&byte, 1), tcp::socket::message_peek, ec);
+	auto open = ec == boost::asio::error::would_block;
+	boost::system::error_code ignored;
+	sock.non_blocking(false, ignored);
+	return open;
+}
+
+///
+/// Closes the connection.
+///
+void HttpConnection::close() noexcept {
+	boost::system::error_code ignored;
+	tcpSocket().close(ignored);
+	connected_ = false;
+}
+
+///
+/// Establishes the connection on the calling thread.
+///
+/// The finished phases are reported to @a phaseHandler.
+///
+void HttpConnection::connect(const HttpClient::PhaseHandler &phaseHandler) {
+	tcp::resolver resolver(*ioService->asioService());
+	tcp::resolver::iterator endpoint = resolver.resolve(
+		tcp::resolver::query(url.host, url.port));
+	reportPhase(phaseHandler, HttpClient::Phase::Resolved);
+	// Try the resolved addresses one after another.
+	boost::system::error_code ec = boost::asio::error::host_not_found;
+	for (tcp::resolver::iterator end; endpoint != end; ++endpoint) {
+		tcpSocket().close(ec);
+		tcpSocket().connect(*endpoint, ec);
+		if (!ec) {
+			break;
+		}
+	}
+	if (ec) {
+		throw boost::system::system_error(ec);
+	}
+	reportPhase(phaseHandler, HttpClient::Phase::Connected);
+	if (tlsStream) {
+		setUpTls();
+		tlsStream->handshake(boost::asio::ssl::stream_base::client);
+		reportPhase(phaseHandler, HttpClient::Phase::TlsHandshakeDone);
+	}
+	connected();
+}
+
+///
+/// Establishes the connection on threads of the I/O service and calls
+/// @a handler with the error code once it is done.
+///
+/// The finished phases are reported to @a phaseHandler. The caller has to keep
+/// the connection alive until @a handler is called.
+///
+template <typename Handler>
+void HttpConnection::connectAsync(const HttpClient::PhaseHandler &phaseHandler,
+		Handler handler) {
+	resolver = std::make_unique<tcp::resolver>(*ioService->asioService());
+	resolver->async_resolve(tcp::resolver::query(url.host, url.port),
+		[this, phaseHandler, handler](const boost::system::error_code &ec,
+				tcp::resolver::iterator endpoint) {
+			if (ec) {
+				return handler(ec);
+			}
+			reportPhase(phaseHandler, HttpClient::Phase::Resolved);
+			connectAsync(endpoint, phaseHandler, handler);
+		}
+	);
+}
+
+///
+/// Connects to the given resolved address (or to one of the following ones
+/// when it fails) on threads of the I/O service and calls @a handler with the
+/// error code once it is done.
+///
+template <typename Handler>
+void HttpConnection::connectAsync(tcp::resolver::iterator endpoint,
+		const HttpClient::PhaseHandler &phaseHandler, Handler handler) {
+	if (endpoint == tcp::resolver::iterator()) {
+		return handler(boost::asio::error::host_not_found);
+	}
+
+	boost::system::error_code ignored;
+	tcpSocket().close(ignored);
+	tcpSocket().async_connect(*endpoint,
+		[this, endpoint, phaseHandler, handler](
+				const boost::system::error_code &ec) {
+			if (ec) {
+				return connectAsync(std::next(endpoint), phaseHandler,
+					handler);
+			}
+			reportPhase(phaseHandler, HttpClient::Phase::Connected);
+			if (!tlsStream) {
+				connected();
+				return handler(ec);
+			}
+
+			setUpTls();
+			tlsStream->async_handshake(boost::asio::ssl::stream_base::client,
+				[this, phaseHandler, handler](
+						const boost::system::error_code &ec) {
+					if (!ec) {
+						reportPhase(phaseHandler,
+							HttpClient::Phase::TlsHandshakeDone);
+						connected();
+					}
+					handler(ec);
+				}
+			);
+		}
+	);
+}
+
+///
+/// Finishes the establishment of the connection.
+///
+void HttpConnection::connected() {
+	resolver.reset();
+	// Requests and their bodies are written in separate parts, which should
+	// not wait for acknowledgements of each other.
+	boost::system::error_code ignored;
+	tcpSocket().set_option(tcp::no_delay(true), ignored);
+	connected_ = true;
+}
+
+///
+/// Returns the underlying TCP socket.
+///
+tcp::socket &HttpConnection::tcpSocket() {
+	return tlsStream ? tlsStream->next_layer() : *socket;
+}
+
+///
+/// Prepares the TLS handshake with the host.
+///
+void HttpConnection::setUpTls() {
+	// Server Name Indication, so that the server presents the certificate of
+	// the host.
+	SSL_ctrl(tlsStream->native_handle(), SSL_CTRL_SET_TLSEXT_HOSTNAME,
+		TLSEXT_NAMETYPE_host_name, const_cast<char *>(url.host.c_str()));
+	tlsStream->set_verify_callback(
+		boost::asio::ssl::rfc2818_verification(url.host));
+}
+
+///
+/// Idle connections kept open for further requests.
+///
+/// It can be used from many threads at once.
+///
+class IdleConnections {
+public:
+	std::unique_ptr<HttpConnection> take(const std::string &origin);
+	void put(std::unique_ptr<HttpConnection> conn);
+	std::size_t size() const;
+
+private:
+	/// Connections, from the least recently used to the most recently used
+	/// one.
+	std::vector<std::unique_ptr<HttpConnection>> connections;
+
+	/// Mutex guarding the connections.
+	mutable boost::mutex mutex;
+};
+
+///
+/// Takes an idle open connection to the given origin.
+///
+/// @returns The connection, or null when there is none.
+///
+/// Connections found to have been closed by the server are dropped.
+///
+std::unique_ptr<HttpConnection> IdleConnections::take(
+		const std::string &origin) {
+	for (;;) {
+		std::unique_ptr<HttpConnection> conn;
+		{
+			boost::lock_guard<boost::mutex> lock(mutex);
+			// Prefer the most recently used connection because it is the least
+			// likely one to have been closed by the server.
+			auto it = std::find_if(connections.rbegin(), connections.rend(),
+				[&](const std::unique_ptr<HttpConnection> &conn) {
+					return conn->origin() == origin;
+				});
+			if (it == connections.rend()) {
+				return nullptr;
+			}
+			conn = std::move(*it);
+			connections.erase(std::next(it).base());
+		}
+
+		if (conn->isOpen()) {
+			return conn;
+		}
+	}
+}
+
+///
+/// Keeps the given connection open for further requests.
+///
+/// When there are too many idle connections, the least recently used one is
+/// closed.
+///
+void IdleConnections::put(std::unique_ptr<HttpConnection> conn) {
+	std::unique_ptr<HttpConnection> closed;
+	boost::lock_guard<boost::mutex> lock(mutex);
+	if (connections.size() >= MaxIdleConnections) {
+		closed = std::move(connections.front());
+		connections.erase(connections.begin());
+	}
+	connections.push_back(std::move(conn));
+}
+
+///
+/// Returns the number of idle connections.
+///
+std::size_t IdleConnections::size() const {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	return connections.size();
+}
+
+///
+/// Sending of a request and receiving of its response on threads of the I/O
+/// service.
+///
+/// Every step keeps the exchange alive until the next step starts, so there
+/// is no need to keep it elsewhere.
+///
+class AsyncExchange: public std::enable_shared_from_this<AsyncExchange> {
+public:
+	AsyncExchange(std::shared_ptr<IdleConnections> idleConnections,
+		std::unique_ptr<HttpConnection> conn, const RequestUrl &url,
+		const HttpClient::Request &request,
+		const HttpClient::HeadHandler &headHandler,
+		const HttpClient::BodyHandler &bodyHandler,
+		const HttpClient::CompletionHandler &completionHandler);
+
+	void start();
+
+private:
+	void writeHead();
+	void writeBody();
+	void write(const std::string &data, std::size_t written,
+		void (AsyncExchange::*next)());
+	void requestWritten();
+	void readResponse();
+	void succeed();
+	void fail(const boost::system::error_code &ec);
+	void fail(std::exception_ptr error);
+
+private:
+	/// Connections to which the connection is returned after the response is
+	/// received.
+	const std::shared_ptr<IdleConnections> idleConnections;
+
+	/// Connection over which the request is sent.
+	std::unique_ptr<HttpConnection> conn;
+
+	/// Request.
+	const HttpClient::Request request;
+
+	/// Status line and headers of the request.
+	const std::string head;
+
+	/// Chunk of the body that is being written.
+	std::string chunk;
+
+	/// Buffer into which the response is read.
+	std::vector<char> buffer;
+
+	/// Parser of the response.
+	ResponseParser parser;
+
+	/// Function called when the exchange finishes.
+	const HttpClient::CompletionHandler completionHandler;
+};
+
+///
+/// Constructs an exchange.
+///
+/// When @a conn is not connected yet, it is connected when the exchange
+/// starts.
+///
+AsyncExchange::AsyncExchange(std::shared_ptr<IdleConnections> idleConnections,
+		std::unique_ptr<HttpConnection> conn, const RequestUrl &url,
+		const HttpClient::Request &request,
+		const HttpClient::HeadHandler &headHandler,
+		const HttpClient::BodyHandler &bodyHandler,
+		const HttpClient::CompletionHandler &completionHandler):
+	idleConnections(std::move(idleConnections)),
+	conn(std::move(conn)),
+	request(request),
+	head(requestHead(url, request)),
+	parser(headHandler, bodyHandler),
+	completionHandler(completionHandler) {}
+
+///
+/// Starts the exchange.
+///
+void AsyncExchange::start() {
+	if (conn->isConnected()) {
+		return writeHead();
+	}
+
+	auto self = shared_from_this();
+	conn->connectAsync(request.phaseHandler,
+		[self](const boost::system::error_code &ec) {
+			if (ec) {
+				return self->fail(ec);
+			}
+			self->writeHead();
+		}
+	);
+}
+
+///
+/// Writes the status line and headers of the request.
+///
+void AsyncExchange::writeHead() {
+	write(head, 0, &AsyncExchange::writeBody);
+}
+
+///
+/// Writes the next chunk of the body of the request (if any).
+///
+void AsyncExchange::writeBody() {
+	bool lastChunk = true;
+	chunk.clear();
+	if (request.body) {
+		try {
+			lastChunk = !request.body(chunk);
+		} catch (...) {
+			return fail(std::current_exception());
+		}
+	}
+	write(chunk, 0, lastChunk ?
+		&AsyncExchange::requestWritten : &AsyncExchange::writeBody);
+}
+
+///
+/// Reports that the whole request has been written and starts reading the
+/// response.
+///
+void AsyncExchange::requestWritten() {
+	reportPhase(request.phaseHandler, HttpClient::Phase::RequestWritten);
+	readResponse();
+}
+
+///
+/// Writes @a data, from which @a written bytes have already been written, and
+/// continues with @a next.
+///
+/// @a data have to be kept alive until they are written.
+///
+void AsyncExchange::write(const std::string &data, std::size_t written,
+		void (AsyncExchange::*next)()) {
+	if (written == data.size()) {
+		return (this->*next)();
+	}
+
+	auto self = shared_from_this();
+	conn->withStream([&](auto &stream) {
+		stream.async_write_some(boost::asio::buffer(data.data() + written,
+				data.size() - written),
+			[self, &data, written, next](const boost::system::error_code &ec,
+					std::size_t size) {
+				if (ec) {
+					return self->fail(ec);
+				}
+				self->write(data, written + size, next);
+			}
+		);
+	});
+}
+
+///
+/// Reads the next part of the response.
+///
+void AsyncExchange::readResponse() {
+	buffer.resize(ReadBufferSize);
+	auto self = shared_from_this();
+	conn->withStream([&](auto &stream) {
+		stream.async_read_some(boost::asio::buffer(buffer),
+			[self](const boost::system::error_code &ec, std::size_t size) {
+				try {
+					if (isEndOfStream(ec)) {
+						self->parser.endOfStream();
+					} else if (ec) {
+						return self->fail(ec);
+					} else {
+						self->parser.feed(self->buffer.data(), size);
+					}
+				} catch (...) {
+					return self->fail(std::current_exception());
+				}
+
+				if (self->parser.isComplete()) {
+					return self->succeed();
+				}
+				self->readResponse();
+			}
+		);
+	});
+}
+
+///
+/// Finishes a successful exchange.
+///
+void AsyncExchange::succeed() {
+	// Return the connection before the completion handler is called, so that
+	// a request sent from the handler can reuse it.
+	if (parser.keepsConnectionOpen()) {
+		idleConnections->put(std::move(conn));
+	} else {
+		conn->close();
+	}
+	completionHandler(nullptr);
+}
+
+///
+/// Finishes an exchange that failed with the given error code.
+///
+void AsyncExchange::fail(const boost::system::error_code &ec) {
+	fail(std::make_exception_ptr(
+		ConnectionError(boost::system::system_error(ec).what())));
+}
+
+///
+/// Finishes an exchange that failed with the given error.
+///
+void AsyncExchange::fail(std::exception_ptr error) {
+	conn->close();
+	completionHandler(error);
+}
+
+} // anonymous namespace
+
+///
+/// Returns the value of the first header with the given name (ignoring case).
+///
+/// When there is no such header, the empty string is returned.
+///
+std::string HttpClient::Response::header(const std::string &name) const {
+	auto lowerName = toLower(name);
+	for (const auto &header : headers) {
+		if (toLower(header.first) == lowerName) {
+			return header.second;
+		}
+	}
+	return "";
+}
+
+///
+/// Private implementation of HttpClient.
+///
+struct HttpClient::Impl {
+	Impl(std::shared_ptr<IoService> ioService):
+		ioService(std::move(ioService)),
+		idleConnections(std::make_shared<IdleConnections>()) {}
+
+	std::unique_ptr<HttpConnection> connectionFor(const RequestUrl &url);
+	std::shared_ptr<boost::asio::ssl::context> sharedTlsContext();
+
+	/// I/O service on which asynchronous requests are sent.
+	const std::shared_ptr<IoService> ioService;
+
+	/// Idle connections kept open for further requests.
+	const std::shared_ptr<IdleConnections> idleConnections;
+
+	/// Context of TLS connections (created upon the first one).
+	std::shared_ptr<boost::asio::ssl::context> tlsContext;
+
+	/// Mutex guarding the context of TLS connections.
+	boost::mutex tlsContextMutex;
+};
+
+///
+/// Returns an idle connection to the origin of the given URL, or a new
+/// connection (not established yet) when there is none.
+///
+std::unique_ptr<HttpConnection> HttpClient::Impl::connectionFor(
+		const RequestUrl &url) {
+	auto conn = idleConnections->take(url.origin);
+	if (conn) {
+		return conn;
+	}
+
+	return std::make_unique<HttpConnection>(ioService, url,
+		url.secure ? sharedTlsContext() : nullptr);
+}
+
+///
+/// Returns the context of TLS connections, creating it if needed.
+///
+std::shared_ptr<boost::asio::ssl::context>
+		HttpClient::Impl::sharedTlsContext() {
+	boost::lock_guard<boost::mutex> lock(tlsContextMutex);
+	if (!tlsContext) {
+		tlsContext = std::make_shared<boost::asio::ssl::context>(
+			boost::asio::ssl::context::sslv23_client);
+		tlsContext->set_options(boost::asio::ssl::context::default_workarounds |
+			boost::asio::ssl::context::no_sslv2 |
+			boost::asio::ssl::context::no_sslv3);
+		tlsContext->set_default_verify_paths();
+		tlsContext->set_verify_mode(boost::asio::ssl::verify_peer);
+	}
+	return tlsContext;
+}
+
+///
+/// Constructs a client sending asynchronous requests on the given I/O
+/// service.
+///
+HttpClient::HttpClient(std::shared_ptr<IoService> ioService):
+	impl(std::make_shared<Impl>(std::move(ioService))) {}
+
+///
+/// Closes the idle connections and destructs the client.
+///
+/// Asynchronous requests that are still in progress are finished.
+///
+HttpClient::~HttpClient() = default;
+
+///
+/// Sends the given request and receives its response on the calling thread.
+///
+/// @param[in] request Request to be sent.
+/// @param[in] headHandler Function to which the status and headers of the
+///                        response are passed.
+/// @param[in] bodyHandler Function to which parts of the body of the response
+///                        are passed as they arrive.
+///
+/// The function returns after the whole response has been received.
+///
+void HttpClient::send(const Request &request, const HeadHandler &headHandler,
+		const BodyHandler &bodyHandler) {
+	auto url = parseUrl(request.url);
+	auto conn = impl->connectionFor(url);
+	ResponseParser parser(headHandler, bodyHandler);
+	try {
+		if (!conn->isConnected()) {
+			conn->connect(request.phaseHandler);
+		}
+
+		conn->withStream([&](auto &stream) {
+			writeAll(stream, requestHead(url, request));
+			if (request.body) {
+				std::string chunk;
+				bool lastChunk;
+				do {
+					chunk.clear();
+					lastChunk = !request.body(chunk);
+					writeAll(stream, chunk);
+				} while (!lastChunk);
+			}
+			reportPhase(request.phaseHandler,
+				HttpClient::Phase::RequestWritten);
+
+			std::vector<char> buffer(ReadBufferSize);
+			while (!parser.isComplete()) {
+				boost::system::error_code ec;
+				auto size = stream.read_some(boost::asio::buffer(buffer), ec);
+				if (isEndOfStream(ec)) {
+					parser.endOfStream();
+				} else if (ec) {
+					throw boost::system::system_error(ec);
+				} else {
+					parser.feed(buffer.data(), size);
+				}
+			}
+		});
+	} catch (const boost::system::system_error &ex) {
+		conn->close();
+		throw ConnectionError(ex.what());
+	} catch (...) {
+		conn->close();
+		throw;
+	}
+
+	if (parser.keepsConnectionOpen()) {
+		impl->idleConnections->put(std::move(conn));
+	}
+}
+
+///
+/// Sends the given request and receives its response on threads of the I/O
+/// service.
+///
+/// @param[in] request Request to be sent.
+/// @param[in] headHandler Function to which the status and headers of the
+///                        response are passed.
+/// @param[in] bodyHandler Function to which parts of the body of the response
+///                        are passed as they arrive.
+/// @param[in] completionHandler Function called after the whole response has
+///                              been received or an error occurred.
+///
+/// All the handlers (and the generator of the body of the request) are called
+/// from threads of the I/O service, never from the calling thread.
+///
+void HttpClient::sendAsync(const Request &request,
+		const HeadHandler &headHandler, const BodyHandler &bodyHandler,
+		const CompletionHandler &completionHandler) {
+	auto impl = this->impl;
+	impl->ioService->asioService()->post(
+		[impl, request, headHandler, bodyHandler, completionHandler]() {
+			std::shared_ptr<AsyncExchange> exchange;
+			try {
+				auto url = parseUrl(request.url);
+				exchange = std::make_shared<AsyncExchange>(
+					impl->idleConnections, impl->connectionFor(url), url,
+					request, headHandler, bodyHandler, completionHandler);
+			} catch (...) {
+				return completionHandler(std::current_exception());
+			}
+			exchange->start();
+		}
+	);
+}
+
+///
+/// Returns the number of idle connections kept open for further requests.
+///
+std::size_t HttpClient::idleConnectionCount() const {
+	return impl->idleConnections->size();
+}
+
+} // namespace internal
+} // namespace retdec
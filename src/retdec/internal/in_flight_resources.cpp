@@ -0,0 +1,360 @@
+///
+/// @file      retdec/internal/in_flight_resources.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of resources shared by identical runs that are in
+///            progress.
+///
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <vector>
+
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/internal/in_flight_resources.h"
+#include "retdec/internal/stored_response.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Private implementation of InFlightResource.
+///
+struct InFlightResource::Impl {
+	///
+	/// GET request that is in progress or whose response is kept.
+	///
+	struct Request {
+		/// Handlers waiting for the response.
+		std::vector<Connection::ResponseHandler> responseHandlers;
+
+		/// Kept response (null when the request is in progress).
+		std::shared_ptr<const StoredResponse> keptResponse;
+	};
+
+	/// Mutex guarding the state.
+	mutable boost::mutex mutex;
+
+	/// Has the resource been started?
+	bool isStarted = false;
+
+	/// ID of the resource (when it has been started).
+	std::string id;
+
+	/// Error that occurred when the resource was started (if any).
+	std::exception_ptr startError;
+
+	/// Handlers waiting for the resource to be started.
+	std::vector<StartedHandler> startedHandlers;
+
+	/// Has the resource finished?
+	bool isFinished = false;
+
+	/// GET requests that are in progress or whose responses are kept, by
+	/// their URLs.
+	std::map<Connection::Url, Request> requests;
+
+	void notifyStarted(const std::string &id, std::exception_ptr error);
+};
+
+///
+/// Stores the result of starting the resource and passes it to the waiting
+/// handlers.
+///
+/// Only the first result is stored; later ones are ignored.
+///
+void InFlightResource::Impl::notifyStarted(const std::string &id,
+		std::exception_ptr error) {
+	std::vector<StartedHandler> handlers;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		if (isStarted || startError) {
+			return;
+		}
+		isStarted = !error;
+		this->id = id;
+		startError = error;
+		handlers.swap(startedHandlers);
+	}
+
+	for (const auto &handler : handlers) {
+		handler(id, error);
+	}
+}
+
+///
+/// Constructs a resource that has not been started yet.
+///
+InFlightResource::InFlightResource(): impl(std::make_unique<Impl>()) {}
+
+///
+/// Destructs the resource.
+///
+InFlightResource::~InFlightResource() = default;
+
+///
+/// Marks the resource as started with the given ID.
+///
+/// The ID is passed to all the handlers waiting for the resource to be
+/// started.
+///
+void InFlightResource::started(const std::string &id) {
+	impl->notifyStarted(id, nullptr);
+}
+
+///
+/// Marks the resource as not started because of the given error.
+///
+/// The error is passed to all the handlers waiting for the resource to be
+/// started. When the resource has already been started, it does nothing.
+///
+void InFlightResource::failedToStart(std::exception_ptr error) {
+	impl->notifyStarted("", error);
+}
+
+///
+/// Calls @a handler once the resource is started (or it fails to start).
+///
+/// When it has already happened, @a handler is called right away. Otherwise,
+/// it is called from the thread that starts the resource. @a handler should
+/// not throw.
+///
+void InFlightResource::whenStarted(const StartedHandler &handler) {
+	{
+		boost::lock_guard<boost::mutex> lock(impl->mutex);
+		if (!impl->isStarted && !impl->startError) {
+			impl->startedHandlers.push_back(handler);
+			return;
+		}
+	}
+
+	handler(impl->id, impl->startError);
+}
+
+///
+/// Blocks until the resource is started and returns its ID.
+///
+/// @throws Any exception that occurred when the resource was started.
+///
+std::string InFlightResource::waitUntilStarted() {
+	auto id = std::make_shared<std::promise<std::string>>();
+	whenStarted([id](const std::string &startedId, std::exception_ptr error) {
+		if (error) {
+			id->set_exception(error);
+		} else {
+			id->set_value(startedId);
+		}
+	});
+	return id->get_future().get();
+}
+
+///
+/// Has the resource failed to start?
+///
+bool InFlightResource::hasFailedToStart() const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	return static_cast<bool>(impl->startError);
+}
+
+///
+/// Marks the resource as finished.
+///
+void InFlightResource::finished() {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	impl->isFinished = true;
+}
+
+///
+/// Has the resource finished?
+///
+bool InFlightResource::hasFinished() const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	return impl->isFinished;
+}
+
+///
+/// Joins a GET request to the given URL.
+///
+/// @param[in] url URL to which the request is sent.
+/// @param[in] responseHandler Function to which the response is passed.
+///
+/// @returns @c true when the request is in progress or its response is kept,
+///          @c false when the caller has to send the request and pass the
+///          response to completeRequest().
+///
+/// In both cases, the response is eventually passed to @a responseHandler.
+/// When the response is kept, @a responseHandler is called right away.
+///
+bool InFlightResource::joinRequest(const Connection::Url &url,
+		const Connection::ResponseHandler &responseHandler) {
+	std::shared_ptr<const StoredResponse> keptResponse;
+	{
+		boost::lock_guard<boost::mutex> lock(impl->mutex);
+		auto it = impl->requests.find(url);
+		if (it == impl->requests.end()) {
+			impl->requests[url].responseHandlers.push_back(responseHandler);
+			return false;
+		}
+		if (!it->second.keptResponse) {
+			it->second.responseHandlers.push_back(responseHandler);
+			return true;
+		}
+		keptResponse = it->second.keptResponse;
+	}
+
+	responseHandler(std::make_unique<StoredResponse>(*keptResponse), nullptr);
+	return true;
+}
+
+///
+/// Passes the response to a GET request to the given URL (or the error that
+/// occurred) to all the handlers that have joined the request.
+///
+/// @param[in] url URL to which the request has been sent.
+/// @param[in] response Received response (null when @a error is set).
+/// @param[in] error Error that occurred when sending the request.
+/// @param[in] keepResponse Should the response be kept for later requests?
+///
+void InFlightResource::completeRequest(const Connection::Url &url,
+		std::unique_ptr<Connection::Response> response,
+		std::exception_ptr error, bool keepResponse) {
+	std::shared_ptr<const StoredResponse> storedResponse;
+	if (!error) {
+		storedResponse = std::make_shared<StoredResponse>(*response);
+	}
+
+	std::vector<Connection::ResponseHandler> handlers;
+	{
+		boost::lock_guard<boost::mutex> lock(impl->mutex);
+		auto &request = impl->requests[url];
+		handlers.swap(request.responseHandlers);
+		if (storedResponse && keepResponse) {
+			request.keptResponse = storedResponse;
+		} else {
+			impl->requests.erase(url);
+		}
+	}
+
+	for (const auto &handler : handlers) {
+		if (error) {
+			handler(nullptr, error);
+		} else {
+			handler(std::make_unique<StoredResponse>(*storedResponse), nullptr);
+		}
+	}
+}
+
+///
+/// Returns the kept response to a GET request to the given URL.
+///
+/// When there is no such response, it returns the null pointer.
+///
+std::unique_ptr<Connection::Response> InFlightResource::keptResponse(
+		const Connection::Url &url) const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	auto it = impl->requests.find(url);
+	if (it == impl->requests.end() || !it->second.keptResponse) {
+		return nullptr;
+	}
+	return std::make_unique<StoredResponse>(*it->second.keptResponse);
+}
+
+///
+/// Private implementation of InFlightResources.
+///
+struct InFlightResources::Impl {
+	void forgetExpiredResources();
+
+	/// Minimal number of resources for which expired resources are
+	/// forgotten.
+	static const std::size_t MinResourceCountToForgetExpired = 16;
+
+	/// Mutex guarding the resources.
+	mutable boost::mutex mutex;
+
+	/// Resources by their keys.
+	std::map<std::string, std::weak_ptr<InFlightResource>> resources;
+
+	/// Number of resources from which expired resources are forgotten next
+	/// time.
+	std::size_t forgetExpiredResourceCount = MinResourceCountToForgetExpired;
+};
+
+const std::size_t InFlightResources::Impl::MinResourceCountToForgetExpired;
+
+///
+/// Forgets resources whose handles have all been destructed.
+///
+/// To keep the cost amortized, the next time it happens only after the number
+/// of resources doubles. The caller has to hold the lock.
+///
+void InFlightResources::Impl::forgetExpiredResources() {
+	for (auto it = resources.begin(); it != resources.end();) {
+		if (it->second.expired()) {
+			it = resources.erase(it);
+		} else {
+			++it;
+		}
+	}
+	forgetExpiredResourceCount = std::max(MinResourceCountToForgetExpired,
+		2 * resources.size());
+}
+
+///
+/// Constructs an empty set of resources.
+///
+InFlightResources::InFlightResources(): impl(std::make_unique<Impl>()) {}
+
+///
+/// Destructs the resources.
+///
+InFlightResources::~InFlightResources() = default;
+
+///
+/// Joins a run of a resource with the given key.
+///
+/// @returns The shared resource and whether the caller has to start it. When
+///          it is @c true, the caller has to call either
+///          InFlightResource::started() or InFlightResource::failedToStart()
+///          on the returned resource.
+///
+std::pair<std::shared_ptr<InFlightResource>, bool> InFlightResources::join(
+		const std::string &key) {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	auto it = impl->resources.find(key);
+	if (it != impl->resources.end()) {
+		auto resource = it->second.lock();
+		if (resource && !resource->hasFinished() &&
+				!resource->hasFailedToStart()) {
+			return std::make_pair(resource, false);
+		}
+	}
+
+	// A resource that is no longer shared is replaced.
+	auto resource = std::make_shared<InFlightResource>();
+	impl->resources[key] = resource;
+	if (impl->resources.size() >= impl->forgetExpiredResourceCount) {
+		impl->forgetExpiredResources();
+	}
+	return std::make_pair(resource, true);
+}
+
+///
+/// Returns the number of resources that are shared.
+///
+std::size_t InFlightResources::size() const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	std::size_t size = 0;
+	for (const auto &resource : impl->resources) {
+		if (!resource.second.expired()) {
+			++size;
+		}
+	}
+	return size;
+}
+
+} // namespace internal
+} // namespace retdec
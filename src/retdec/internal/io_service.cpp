@@ -0,0 +1,142 @@
+///
+/// @file      retdec/internal/io_service.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the I/O service shared by connections.
+///
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "retdec/internal/io_service.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+/// Is the current thread a worker thread of an I/O service?
+thread_local bool currentThreadIsWorker = false;
+
+} // anonymous namespace
+
+///
+/// Private implementation of IoService.
+///
+struct IoService::Impl {
+	Impl(std::size_t threadCount);
+	~Impl();
+
+	/// Underlying service.
+	const boost::shared_ptr<boost::asio::io_service> service;
+
+	/// Keeps the worker threads running even when there is no work.
+	std::unique_ptr<boost::asio::io_service::work> work;
+
+	/// Worker threads running the service.
+	std::vector<boost::thread> threads;
+};
+
+///
+/// Constructs a private implementation and starts the worker threads.
+///
+IoService::Impl::Impl(std::size_t threadCount):
+	service(boost::make_shared<boost::asio::io_service>()),
+	work(std::make_unique<boost::asio::io_service::work>(*service)) {
+	for (std::size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back([service = service]() {
+			currentThreadIsWorker = true;
+			service->run();
+		});
+	}
+}
+
+///
+/// Waits until the worker threads finish the remaining work and destructs the
+/// private implementation.
+///
+/// The service is not stopped, so handlers that have already been posted (and
+/// the operations they start) are run before the worker threads finish.
+///
+IoService::Impl::~Impl() {
+	work.reset();
+	for (auto &thread : threads) {
+		// The service may be destructed from one of its own handlers, in which
+		// case the current thread cannot join itself.
+		if (thread.get_id() == boost::this_thread::get_id()) {
+			thread.detach();
+		} else {
+			thread.join();
+		}
+	}
+}
+
+///
+/// Constructs an I/O service with the given number of worker threads.
+///
+/// @param[in] threadCount Number of worker threads. At least one thread is
+///                        always started.
+///
+IoService::IoService(std::size_t threadCount):
+	impl(std::make_unique<Impl>(std::max<std::size_t>(threadCount, 1))) {}
+
+///
+/// Waits until the worker threads finish the remaining work and destructs the
+/// I/O service.
+///
+IoService::~IoService() = default;
+
+///
+/// Returns the underlying Boost.Asio service.
+///
+boost::shared_ptr<boost::asio::io_service> IoService::asioService() const {
+	return impl->service;
+}
+
+///
+/// Returns the number of worker threads.
+///
+std::size_t IoService::threadCount() const {
+	return impl->threads.size();
+}
+
+///
+/// Returns the process-wide I/O service with the given number of worker
+/// threads.
+///
+/// The service is created upon the first call and destructed when it is no
+/// longer used, so all connections alive at the same time share it.
+///
+std::shared_ptr<IoService> IoService::shared(std::size_t threadCount) {
+	static boost::mutex mutex;
+	static std::map<std::size_t, std::weak_ptr<IoService>> services;
+
+	boost::lock_guard<boost::mutex> lock(mutex);
+	auto &service = services[threadCount];
+	auto sharedService = service.lock();
+	if (!sharedService) {
+		sharedService = std::make_shared<IoService>(threadCount);
+		service = sharedService;
+	}
+	return sharedService;
+}
+
+///
+/// Is the calling thread a worker thread of an I/O service?
+///
+/// Handlers of asynchronous operations run on worker threads, so code that
+/// would block until other handlers run (and thus deadlock when there are not
+/// enough worker threads) uses this function to avoid blocking.
+///
+bool IoService::isWorkerThread() {
+	return currentThreadIsWorker;
+}
+
+} // namespace internal
+} // namespace retdec
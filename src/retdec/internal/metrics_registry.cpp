@@ -0,0 +1,525 @@
+///
+/// @file      retdec/internal/metrics_registry.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the registry of metrics of requests and
+///            resources.
+///
+
+#include <new>
+#include <sstream>
+
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/resource_status.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+/// Number of slots for series of requests with a status code. Status codes
+/// outside of <tt>[100, 599]</tt> share slot 0.
+const std::size_t StatusCodeSlotCount = 600;
+
+/// Names of the services, indexed by MetricsRegistry::Service.
+const char *const ServiceNames[MetricsRegistry::ServiceCount] = {
+	"decompiler",
+	"fileinfo",
+	"test",
+	"other"
+};
+
+///
+/// Returns the index of the stripe of a counter assigned to the calling
+/// thread.
+///
+std::size_t currentStripe() noexcept {
+	// Assign the stripes to threads in a round-robin fashion so that threads
+	// that run at the same time are unlikely to share a stripe.
+	static std::atomic<std::size_t> nextStripe(0);
+	thread_local std::size_t stripe =
+		nextStripe.fetch_add(1, std::memory_order_relaxed) %
+			Counter::StripeCount;
+	return stripe;
+}
+
+///
+/// Formats the given number of microseconds as seconds (e.g. @c 0.0015).
+///
+std::string formatSeconds(std::uint64_t microseconds) {
+	auto str = std::to_string(microseconds / 1000000);
+	auto fraction = microseconds % 1000000;
+	if (fraction == 0) {
+		return str;
+	}
+
+	auto fractionStr = std::to_string(fraction);
+	fractionStr.insert(0, 6 - fractionStr.size(), '0');
+	fractionStr.erase(fractionStr.find_last_not_of('0') + 1);
+	return str + '.' + fractionStr;
+}
+
+///
+/// Converts the given duration to microseconds.
+///
+std::chrono::microseconds toMicroseconds(
+		MetricsRegistry::Clock::duration duration) noexcept {
+	return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+}
+
+///
+/// Writes the header of a metric family into @a out.
+///
+void writeFamilyHeader(std::ostream &out, const std::string &name,
+		const std::string &type, const std::string &help) {
+	out << "# HELP " << name << " " << help << "\n";
+	out << "# TYPE " << name << " " << type << "\n";
+}
+
+///
+/// Writes the samples of the given histogram with the given labels into
+/// @a out.
+///
+/// Only the buckets up to the last non-empty one are written. The count of
+/// all later buckets is the count of the whole histogram, which is written in
+/// the @c +Inf bucket.
+///
+void writeHistogram(std::ostream &out, const std::string &name,
+		const std::string &labels, const Histogram &histogram) {
+	std::array<std::uint64_t, Histogram::BucketCount> counts;
+	std::size_t lastNonEmpty = 0;
+	for (std::size_t i = 0; i < Histogram::BucketCount; ++i) {
+		counts[i] = histogram.bucketCount(i);
+		if (counts[i] != 0) {
+			lastNonEmpty = i;
+		}
+	}
+
+	// Durations are truncated to whole microseconds when they are recorded,
+	// so a duration in a bucket is less than the lower bound of the next
+	// bucket.
+	std::uint64_t cumulativeCount = 0;
+	for (std::size_t i = 0; i <= lastNonEmpty; ++i) {
+		cumulativeCount += counts[i];
+		out << name << "_bucket{" << labels << ",le=\"" <<
+			formatSeconds(Histogram::bucketLowerBound(i + 1)) << "\"} " <<
+			cumulativeCount << "\n";
+	}
+	for (std::size_t i = lastNonEmpty + 1; i < Histogram::BucketCount; ++i) {
+		cumulativeCount += counts[i];
+	}
+	out << name << "_bucket{" << labels << ",le=\"+Inf\"} " <<
+		cumulativeCount << "\n";
+	out << name << "_sum{" << labels << "} " <<
+		formatSeconds(histogram.sumInMicroseconds()) << "\n";
+	out << name << "_count{" << labels << "} " << cumulativeCount << "\n";
+}
+
+///
+/// Series of requests of a service with a status code.
+///
+struct RequestSeries {
+	/// Number of requests.
+	Counter requests;
+
+	/// Durations of the requests.
+	Histogram durations;
+};
+
+///
+/// Series of a service.
+///
+struct ServiceSeries {
+	ServiceSeries();
+	~ServiceSeries();
+
+	RequestSeries *requestSeries(int statusCode) noexcept;
+
+	/// Series of requests, indexed by status codes (created lazily).
+	std::array<std::atomic<RequestSeries *>, StatusCodeSlotCount> requests;
+
+	/// Number of requests to which no response was received.
+	Counter failedRequests;
+
+	/// Number of requests for statuses of resources.
+	Counter statusPolls;
+
+	/// Durations of resources that have succeeded.
+	Histogram succeededResources;
+
+	/// Durations of resources that have failed.
+	Histogram failedResources;
+};
+
+///
+/// Constructs the series with no requests.
+///
+ServiceSeries::ServiceSeries() {
+	for (auto &series : requests) {
+		series.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+///
+/// Destructs the series.
+///
+ServiceSeries::~ServiceSeries() {
+	for (auto &series : requests) {
+		delete series.load(std::memory_order_relaxed);
+	}
+}
+
+///
+/// Returns the series of requests with the given status code, creating it if
+/// needed.
+///
+/// @returns Null when the series cannot be created.
+///
+RequestSeries *ServiceSeries::requestSeries(int statusCode) noexcept {
+	auto slot = statusCode >= 100 &&
+		static_cast<std::size_t>(statusCode) < StatusCodeSlotCount ?
+			static_cast<std::size_t>(statusCode) : 0;
+	auto series = requests[slot].load(std::memory_order_acquire);
+	if (series) {
+		return series;
+	}
+
+	// The first thread to publish its series wins; the others use it and
+	// throw their own series away.
+	auto newSeries = new (std::nothrow) RequestSeries();
+	if (!newSeries) {
+		return nullptr;
+	}
+	if (requests[slot].compare_exchange_strong(series, newSeries,
+			std::memory_order_acq_rel, std::memory_order_acquire)) {
+		return newSeries;
+	}
+	delete newSeries;
+	return series;
+}
+
+} // anonymous namespace
+
+///
+/// Constructs a counter with zero value.
+///
+Counter::Counter() {
+	for (auto &stripe : stripes) {
+		stripe.value.store(0, std::memory_order_relaxed);
+	}
+}
+
+///
+/// Increments the counter by @a n.
+///
+void Counter::increment(std::uint64_t n) noexcept {
+	stripes[currentStripe()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+///
+/// Returns the value of the counter.
+///
+/// Increments that run at the same time may or may not be included.
+///
+std::uint64_t Counter::value() const noexcept {
+	std::uint64_t value = 0;
+	for (auto &stripe : stripes) {
+		value += stripe.value.load(std::memory_order_relaxed);
+	}
+	return value;
+}
+
+///
+/// Constructs an empty histogram.
+///
+Histogram::Histogram(): sum(0) {
+	for (auto &bucket : buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+///
+/// Records the given duration.
+///
+/// Negative durations are recorded as zero.
+///
+void Histogram::record(std::chrono::microseconds duration) noexcept {
+	auto microseconds = duration.count() > 0 ?
+		static_cast<std::uint64_t>(duration.count()) : 0;
+	buckets[bucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+///
+/// Returns the number of recorded durations.
+///
+std::uint64_t Histogram::count() const noexcept {
+	std::uint64_t count = 0;
+	for (auto &bucket : buckets) {
+		count += bucket.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+///
+/// Returns the sum of all recorded durations (in microseconds).
+///
+std::uint64_t Histogram::sumInMicroseconds() const noexcept {
+	return sum.load(std::memory_order_relaxed);
+}
+
+///
+/// Returns the number of durations in the bucket with the given index.
+///
+std::uint64_t Histogram::bucketCount(std::size_t index) const noexcept {
+	return buckets[index].load(std::memory_order_relaxed);
+}
+
+///
+/// Returns the index of the bucket into which the given duration (in
+/// microseconds) belongs.
+///
+std::size_t Histogram::bucketIndex(std::uint64_t microseconds) noexcept {
+	if (microseconds < SubBucketCount) {
+		return microseconds;
+	}
+
+	std::size_t exponent = 0;
+	for (auto v = microseconds; v > 1; v >>= 1) {
+		++exponent;
+	}
+	if (exponent > MaxExponent) {
+		return BucketCount - 1;
+	}
+
+	std::size_t subBucket =
+		(microseconds >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+	return SubBucketCount + (exponent - SubBucketBits) * SubBucketCount +
+		subBucket;
+}
+
+///
+/// Returns the smallest duration (in microseconds) in the bucket with the
+/// given index.
+///
+/// For <tt>index == BucketCount</tt>, it returns the smallest duration that
+/// would follow the last bucket.
+///
+std::uint64_t Histogram::bucketLowerBound(std::size_t index) noexcept {
+	if (index < SubBucketCount) {
+		return index;
+	}
+
+	auto exponent = (index - SubBucketCount) / SubBucketCount + SubBucketBits;
+	std::uint64_t subBucket = (index - SubBucketCount) % SubBucketCount;
+	return (SubBucketCount + subBucket) << (exponent - SubBucketBits);
+}
+
+///
+/// Private implementation of MetricsRegistry.
+///
+struct MetricsRegistry::Impl {
+	/// Series of the services, indexed by Service.
+	std::array<ServiceSeries, ServiceCount> services;
+};
+
+///
+/// Constructs an empty registry.
+///
+MetricsRegistry::MetricsRegistry(): impl(std::make_unique<Impl>()) {}
+
+///
+/// Destructs the registry.
+///
+MetricsRegistry::~MetricsRegistry() = default;
+
+///
+/// Returns the service with the given name (e.g. @c decompiler).
+///
+MetricsRegistry::Service MetricsRegistry::serviceFromName(
+		const std::string &name) {
+	for (std::size_t i = 0; i < ServiceCount - 1; ++i) {
+		if (name == ServiceNames[i]) {
+			return static_cast<Service>(i);
+		}
+	}
+	return Service::Other;
+}
+
+///
+/// Returns the service to which the given URL of the API with the given base
+/// URL belongs.
+///
+/// For example, for @c https://retdec.com/service/api as @a apiUrl and
+/// @c https://retdec.com/service/api/decompiler/decompilations as @a url, it
+/// returns Service::Decompiler.
+///
+MetricsRegistry::Service MetricsRegistry::serviceFromUrl(
+		const std::string &apiUrl, const std::string &url) {
+	if (url.compare(0, apiUrl.size(), apiUrl) != 0 ||
+			url.size() <= apiUrl.size() || url[apiUrl.size()] != '/') {
+		return Service::Other;
+	}
+
+	auto nameBegin = apiUrl.size() + 1;
+	auto nameEnd = url.find_first_of("/?", nameBegin);
+	return serviceFromName(url.substr(nameBegin,
+		nameEnd == std::string::npos ? nameEnd : nameEnd - nameBegin));
+}
+
+///
+/// Records a request of the given service to which a response with the given
+/// status code was received after the given duration.
+///
+void MetricsRegistry::requestFinished(Service service, int statusCode,
+		Clock::duration duration) noexcept {
+	auto series = impl->services[static_cast<std::size_t>(service)]
+		.requestSeries(statusCode);
+	if (series) {
+		series->requests.increment();
+		series->durations.record(toMicroseconds(duration));
+	}
+}
+
+///
+/// Records a request of the given service to which no response was received.
+///
+void MetricsRegistry::requestFailed(Service service) noexcept {
+	impl->services[static_cast<std::size_t>(service)]
+		.failedRequests.increment();
+}
+
+///
+/// Records a request for the status of a resource of the given service.
+///
+void MetricsRegistry::statusPolled(Service service) noexcept {
+	impl->services[static_cast<std::size_t>(service)].statusPolls.increment();
+}
+
+///
+/// Records a resource of the given service that finished after the given
+/// duration.
+///
+void MetricsRegistry::resourceFinished(Service service, bool succeeded,
+		Clock::duration duration) noexcept {
+	auto &series = impl->services[static_cast<std::size_t>(service)];
+	(succeeded ? series.succeededResources : series.failedResources)
+		.record(toMicroseconds(duration));
+}
+
+///
+/// Returns the metrics in the text-based exposition format of Prometheus.
+///
+/// The metrics are updated while they are being exported, so the exported
+/// values of different series may come from slightly different moments.
+///
+std::string MetricsRegistry::toPrometheusText() const {
+	std::ostringstream out;
+
+	writeFamilyHeader(out, "retdec_requests_total", "counter",
+		"Requests sent to the API to which a response was received.");
+	for (std::size_t s = 0; s < ServiceCount; ++s) {
+		auto &requests = impl->services[s].requests;
+		for (std::size_t code = 0; code < StatusCodeSlotCount; ++code) {
+			if (auto series = requests[code].load(std::memory_order_acquire)) {
+				out << "retdec_requests_total{service=\"" << ServiceNames[s] <<
+					"\",code=\"" << (code == 0 ? "other" : std::to_string(code)) <<
+					"\"} " << series->requests.value() << "\n";
+			}
+		}
+	}
+
+	writeFamilyHeader(out, "retdec_request_duration_seconds", "histogram",
+		"Durations of requests sent to the API to which a response was "
+		"received.");
+	for (std::size_t s = 0; s < ServiceCount; ++s) {
+		auto &requests = impl->services[s].requests;
+		for (std::size_t code = 0; code < StatusCodeSlotCount; ++code) {
+			if (auto series = requests[code].load(std::memory_order_acquire)) {
+				writeHistogram(out, "retdec_request_duration_seconds",
+					std::string("service=\"") + ServiceNames[s] +
+						"\",code=\"" +
+						(code == 0 ? "other" : std::to_string(code)) + "\"",
+					series->durations);
+			}
+		}
+	}
+
+	writeFamilyHeader(out, "retdec_failed_requests_total", "counter",
+		"Requests sent to the API to which no response was received.");
+	for (std::size_t s = 0; s < ServiceCount; ++s) {
+		if (auto value = impl->services[s].failedRequests.value()) {
+			out << "retdec_failed_requests_total{service=\"" <<
+				ServiceNames[s] << "\"} " << value << "\n";
+		}
+	}
+
+	writeFamilyHeader(out, "retdec_status_polls_total", "counter",
+		"Requests for statuses of resources.");
+	for (std::size_t s = 0; s < ServiceCount; ++s) {
+		if (auto value = impl->services[s].statusPolls.value()) {
+			out << "retdec_status_polls_total{service=\"" <<
+				ServiceNames[s] << "\"} " << value << "\n";
+		}
+	}
+
+	writeFamilyHeader(out, "retdec_resource_duration_seconds", "histogram",
+		"Durations of resources from their creation until they finished.");
+	for (std::size_t s = 0; s < ServiceCount; ++s) {
+		auto &series = impl->services[s];
+		if (series.succeededResources.count() != 0) {
+			writeHistogram(out, "retdec_resource_duration_seconds",
+				std::string("service=\"") + ServiceNames[s] +
+					"\",result=\"succeeded\"",
+				series.succeededResources);
+		}
+		if (series.failedResources.count() != 0) {
+			writeHistogram(out, "retdec_resource_duration_seconds",
+				std::string("service=\"") + ServiceNames[s] +
+					"\",result=\"failed\"",
+				series.failedResources);
+		}
+	}
+
+	return out.str();
+}
+
+///
+/// Constructs metrics of a resource of the given service, recorded into the
+/// given registry.
+///
+/// The duration of the resource is recorded only when @a measureDuration is
+/// @c true.
+///
+ResourceMetrics::ResourceMetrics(
+		const std::shared_ptr<MetricsRegistry> &registry,
+		MetricsRegistry::Service service, bool measureDuration):
+	registry(registry),
+	service(service),
+	created(MetricsRegistry::Clock::now()),
+	measureDuration(measureDuration),
+	finishedRecorded(false) {}
+
+///
+/// Records a request for the status of the resource.
+///
+void ResourceMetrics::statusPolled() noexcept {
+	registry->statusPolled(service);
+}
+
+///
+/// Records the given received status of the resource.
+///
+void ResourceMetrics::statusReceived(const ResourceStatus &status) noexcept {
+	if (!status.finished || !measureDuration) {
+		return;
+	}
+
+	if (!finishedRecorded.exchange(true, std::memory_order_relaxed)) {
+		registry->resourceFinished(service, status.succeeded,
+			MetricsRegistry::Clock::now() - created);
+	}
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,114 @@
+///
+/// @file      retdec/internal/multipart_body.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the body of a multipart/form-data request.
+///
+
+#include <string>
+
+#include "retdec/exceptions.h"
+#include "retdec/file.h"
+#include "retdec/internal/multipart_body.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Creates a body containing the given files.
+///
+/// @param[in] files Files to be sent.
+/// @param[in] boundary Boundary separating the parts of the body.
+///
+MultipartBody::MultipartBody(const Connection::RequestFiles &files,
+		const std::string &boundary):
+	state(std::make_shared<State>()) {
+	if (files.empty()) {
+		return;
+	}
+
+	bool first = true;
+	for (auto &file : files) {
+		state->parts.push_back({
+			std::string(first ? "" : "\r\n") +
+				"--" + boundary + "\r\n" +
+				"Content-Disposition: form-data; name=\"" + file.first +
+					"\"; filename=\"" + file.second->getName() + "\"\r\n" +
+				"\r\n",
+			file.second,
+			file.second->getSize()
+		});
+		first = false;
+	}
+	state->trailer = "\r\n--" + boundary + "--\r\n";
+}
+
+///
+/// Returns the size of the whole body (in bytes).
+///
+std::uint64_t MultipartBody::size() const {
+	std::uint64_t size = state->trailer.size();
+	for (auto &part : state->parts) {
+		size += part.header.size() + part.fileSize;
+	}
+	return size;
+}
+
+///
+/// Generates the next chunk of the body into @a chunk.
+///
+/// @returns @c true if a chunk was generated, @c false if the whole body has
+///          already been generated.
+///
+/// @throws FilesystemError When the content of a file cannot be read or when
+///                         its size differs from the size of the file when the
+///                         body was created.
+///
+/// This is the interface of body generators in cpp-netlib.
+///
+bool MultipartBody::operator()(std::string &chunk) {
+	while (chunk.empty() && state->currentPart < state->parts.size()) {
+		auto &part = state->parts[state->currentPart];
+		if (!state->currentContent) {
+			state->currentContent = part.file->openContent();
+			chunk = part.header;
+			continue;
+		}
+
+		chunk.resize(ChunkSize);
+		state->currentContent->read(&chunk[0], ChunkSize);
+		if (state->currentContent->bad()) {
+			throw FilesystemError("cannot read file \"" +
+				part.file->getName() + "\"");
+		}
+		chunk.resize(state->currentContent->gcount());
+		// The size of the body has already been announced, so sending more or
+		// less of the content would break the request.
+		state->currentContentSize += chunk.size();
+		bool contentRead = chunk.size() < ChunkSize;
+		if (state->currentContentSize > part.fileSize ||
+				(contentRead && state->currentContentSize < part.fileSize)) {
+			throw FilesystemError("size of file \"" + part.file->getName() +
+				"\" has changed from " + std::to_string(part.fileSize) +
+				" bytes while it was being sent");
+		}
+		if (contentRead) {
+			// The content of the current part has been completely read.
+			state->currentContent.reset();
+			state->currentContentSize = 0;
+			++state->currentPart;
+		}
+	}
+
+	if (chunk.empty() && !state->trailerGenerated) {
+		chunk = state->trailer;
+		state->trailerGenerated = true;
+	}
+	return !chunk.empty();
+}
+
+// Definition of the constant (it is declared and initialized in the header).
+const std::size_t MultipartBody::ChunkSize;
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,50 @@
+///
+/// @file      retdec/internal/polling_policies/deadline_aware_polling_policy.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the policy making sure that a status is polled
+///            right at a deadline.
+///
+
+#include <utility>
+
+#include "retdec/internal/polling_policies/deadline_aware_polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a policy.
+///
+/// @param[in] policy Policy deciding the delays.
+/// @param[in] deadline Deadline (measured from the start of the waiting).
+///
+DeadlineAwarePollingPolicy::DeadlineAwarePollingPolicy(
+		std::shared_ptr<const PollingPolicy> policy,
+		std::chrono::milliseconds deadline):
+	policy(std::move(policy)), deadline(deadline) {}
+
+///
+/// Destructs the policy.
+///
+DeadlineAwarePollingPolicy::~DeadlineAwarePollingPolicy() = default;
+
+///
+/// Returns the delay before the next status update.
+///
+/// The delay is the one returned by the underlying policy, shortened so that
+/// it does not span over the deadline. After the deadline, the delay is not
+/// changed.
+///
+std::chrono::milliseconds DeadlineAwarePollingPolicy::nextDelay(
+		const Progress &progress) const {
+	auto delay = policy->nextDelay(progress);
+	auto remainingTime = deadline - progress.elapsedTime;
+	if (remainingTime.count() > 0 && remainingTime < delay) {
+		return remainingTime;
+	}
+	return delay;
+}
+
+} // namespace internal
+} // namespace retdec
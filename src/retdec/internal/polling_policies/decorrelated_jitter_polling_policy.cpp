@@ -0,0 +1,64 @@
+///
+/// @file      retdec/internal/polling_policies/decorrelated_jitter_polling_policy.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the policy polling statuses with a randomized,
+///            decorrelated delay.
+///
+
+#include <algorithm>
+#include <random>
+
+#include "retdec/internal/polling_policies/decorrelated_jitter_polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Returns a random-number generator for the current thread.
+///
+std::mt19937 &randomEngine() {
+	thread_local std::mt19937 engine{std::random_device()()};
+	return engine;
+}
+
+} // anonymous namespace
+
+///
+/// Constructs a policy.
+///
+/// @param[in] baseDelay Minimal delay.
+/// @param[in] maxDelay Maximal delay.
+///
+DecorrelatedJitterPollingPolicy::DecorrelatedJitterPollingPolicy(
+		std::chrono::milliseconds baseDelay,
+		std::chrono::milliseconds maxDelay):
+	baseDelay(baseDelay), maxDelay(maxDelay) {}
+
+///
+/// Destructs the policy.
+///
+DecorrelatedJitterPollingPolicy::~DecorrelatedJitterPollingPolicy() = default;
+
+///
+/// Returns the delay before the next status update.
+///
+/// The delay is chosen randomly between the base delay and three times the
+/// last delay (up to the maximal delay), so resources that started together
+/// do not keep polling their statuses at the same moments. While the
+/// completion keeps changing, the delay is at most the last delay.
+///
+std::chrono::milliseconds DecorrelatedJitterPollingPolicy::nextDelay(
+		const Progress &progress) const {
+	auto lastDelay = std::max(progress.lastDelay, baseDelay);
+	auto upperBound = progress.completionDelta > 0 ? lastDelay : 3 * lastDelay;
+	std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution(
+		baseDelay.count(), upperBound.count());
+	auto delay = std::chrono::milliseconds(distribution(randomEngine()));
+	return std::min(delay, maxDelay);
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,66 @@
+///
+/// @file      retdec/internal/polling_policies/exponential_polling_policy.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the policy polling statuses with an
+///            exponentially growing delay.
+///
+
+#include <algorithm>
+#include <cmath>
+
+#include "retdec/internal/polling_policies/exponential_polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a policy.
+///
+/// @param[in] initialDelay Delay after the first status update.
+/// @param[in] maxDelay Maximal delay.
+/// @param[in] factor Factor by which the delay grows after each status update
+///                   that does not report any progress.
+///
+ExponentialPollingPolicy::ExponentialPollingPolicy(
+		std::chrono::milliseconds initialDelay,
+		std::chrono::milliseconds maxDelay,
+		double factor):
+	initialDelay(initialDelay), maxDelay(maxDelay), factor(factor) {}
+
+///
+/// Destructs the policy.
+///
+ExponentialPollingPolicy::~ExponentialPollingPolicy() = default;
+
+///
+/// Returns the delay before the next status update.
+///
+/// The delay grows by the factor after each status update, up to the maximal
+/// delay. The grown delay is rounded up and it is always at least one
+/// millisecond longer than the last delay, so short delays do not get stuck
+/// because of the rounding. While the completion keeps changing, the delay
+/// stays the same so that the progress is reported in time.
+///
+std::chrono::milliseconds ExponentialPollingPolicy::nextDelay(
+		const Progress &progress) const {
+	if (progress.lastDelay < initialDelay) {
+		return std::min(initialDelay, maxDelay);
+	}
+
+	if (progress.completionDelta > 0) {
+		return std::min(progress.lastDelay, maxDelay);
+	}
+
+	auto grownDelay = std::chrono::milliseconds(
+		static_cast<std::chrono::milliseconds::rep>(
+			std::ceil(static_cast<double>(progress.lastDelay.count()) * factor)
+		)
+	);
+	grownDelay = std::max(grownDelay,
+		progress.lastDelay + std::chrono::milliseconds(1));
+	return std::min(grownDelay, maxDelay);
+}
+
+} // namespace internal
+} // namespace retdec
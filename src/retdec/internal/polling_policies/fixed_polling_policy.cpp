@@ -0,0 +1,32 @@
+///
+/// @file      retdec/internal/polling_policies/fixed_polling_policy.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the policy polling statuses with a fixed
+///            delay.
+///
+
+#include "retdec/internal/polling_policies/fixed_polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a policy with the given delay between two status updates.
+///
+FixedPollingPolicy::FixedPollingPolicy(std::chrono::milliseconds delay):
+	delay(delay) {}
+
+///
+/// Destructs the policy.
+///
+FixedPollingPolicy::~FixedPollingPolicy() = default;
+
+// Override.
+std::chrono::milliseconds FixedPollingPolicy::nextDelay(
+		const Progress &) const {
+	return delay;
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,172 @@
+///
+/// @file      retdec/internal/polling_policies/predictive_polling_policy.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the policy polling statuses when resources are
+///            predicted to finish.
+///
+
+#include <algorithm>
+
+#include <boost/thread/locks.hpp>
+
+#include "retdec/internal/polling_policies/predictive_polling_policy.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+/// Weight of a newly observed rate in the rate for a mode.
+const double NewRateWeight = 0.3;
+
+/// Number of changes in completion of a resource from which its own rate is
+/// trusted enough to aim only at the predicted finish.
+const std::size_t TrustedCompletionChangeCount = 3;
+
+///
+/// Returns the number of milliseconds needed to increase the completion by
+/// @a completionIncrease at the given rate.
+///
+std::chrono::milliseconds timeToComplete(double completionIncrease,
+		double rate) {
+	return std::chrono::milliseconds(
+		static_cast<std::chrono::milliseconds::rep>(completionIncrease / rate));
+}
+
+} // anonymous namespace
+
+///
+/// Constructs a policy.
+///
+/// @param[in] minDelay Minimal delay.
+/// @param[in] maxDelay Maximal delay.
+///
+PredictivePollingPolicy::PredictivePollingPolicy(
+		std::chrono::milliseconds minDelay,
+		std::chrono::milliseconds maxDelay):
+	minDelay(minDelay), maxDelay(maxDelay) {}
+
+///
+/// Destructs the policy.
+///
+PredictivePollingPolicy::~PredictivePollingPolicy() = default;
+
+///
+/// Returns the delay before the next status update.
+///
+/// The next update is aimed at the moment the resource is predicted to finish.
+/// While the completion timeline of the resource is short, it is aimed at the
+/// next expected change in completion instead (when that comes sooner), so
+/// that the prediction improves. When there is nothing to base the prediction
+/// on, or when the resource is overdue, the delay grows with the elapsed time.
+///
+std::chrono::milliseconds PredictivePollingPolicy::nextDelay(
+		const Progress &progress) const {
+	recordCompletionRate(progress);
+
+	auto rate = completionRate(progress);
+	if (rate <= 0) {
+		return delayWithoutPrediction(progress);
+	}
+
+	const auto &changes = progress.completionChanges;
+	auto lastChangeTime = changes.empty() ?
+		progress.elapsedTime : changes.back().elapsedTime;
+	auto targetTime = lastChangeTime +
+		timeToComplete(100 - progress.completion, rate);
+	if (changes.size() >= 2 && changes.size() < TrustedCompletionChangeCount) {
+		auto averageChange =
+			static_cast<double>(changes.back().completion -
+				changes.front().completion) /
+			static_cast<double>(changes.size() - 1);
+		targetTime = std::min(targetTime,
+			lastChangeTime + timeToComplete(averageChange, rate));
+	}
+
+	if (targetTime <= progress.elapsedTime) {
+		return delayWithoutPrediction(progress);
+	}
+	return boundedDelay(targetTime - progress.elapsedTime);
+}
+
+///
+/// Returns the rate of completion (in percentages per millisecond) observed for
+/// resources with the given mode.
+///
+/// When no rate has been observed, it returns zero.
+///
+double PredictivePollingPolicy::rateForMode(const std::string &mode) const {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	auto it = modeRates.find(mode);
+	return it != modeRates.end() ? it->second : 0.0;
+}
+
+///
+/// Returns the rate of completion (in percentages per millisecond) of the
+/// resource.
+///
+/// When the resource has not changed its completion yet, the rate for its mode
+/// is returned.
+///
+double PredictivePollingPolicy::completionRate(const Progress &progress) const {
+	const auto &changes = progress.completionChanges;
+	if (changes.size() >= 2) {
+		auto time = changes.back().elapsedTime - changes.front().elapsedTime;
+		if (time.count() > 0) {
+			return static_cast<double>(changes.back().completion -
+				changes.front().completion) / static_cast<double>(time.count());
+		}
+	}
+	return rateForMode(progress.mode);
+}
+
+///
+/// Updates the rate for the mode of the resource when its completion has just
+/// changed.
+///
+void PredictivePollingPolicy::recordCompletionRate(
+		const Progress &progress) const {
+	const auto &changes = progress.completionChanges;
+	if (progress.completionDelta <= 0 || changes.size() < 2) {
+		return;
+	}
+
+	const auto &lastChange = changes[changes.size() - 1];
+	const auto &previousChange = changes[changes.size() - 2];
+	auto time = lastChange.elapsedTime - previousChange.elapsedTime;
+	if (time.count() <= 0) {
+		return;
+	}
+	auto rate = static_cast<double>(
+		lastChange.completion - previousChange.completion) /
+		static_cast<double>(time.count());
+
+	boost::lock_guard<boost::mutex> lock(mutex);
+	auto it = modeRates.find(progress.mode);
+	if (it == modeRates.end()) {
+		modeRates.emplace(progress.mode, rate);
+	} else {
+		it->second = NewRateWeight * rate + (1 - NewRateWeight) * it->second;
+	}
+}
+
+///
+/// Returns the delay to be used when the finish of the resource cannot be
+/// predicted.
+///
+std::chrono::milliseconds PredictivePollingPolicy::delayWithoutPrediction(
+		const Progress &progress) const {
+	return boundedDelay(progress.elapsedTime / 10);
+}
+
+///
+/// Returns the given delay bounded by the minimal and maximal delays.
+///
+std::chrono::milliseconds PredictivePollingPolicy::boundedDelay(
+		std::chrono::milliseconds delay) const {
+	return std::min(std::max(delay, minDelay), maxDelay);
+}
+
+} // namespace internal
+} // namespace retdec
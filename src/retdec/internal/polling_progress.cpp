@@ -0,0 +1,62 @@
+///
+/// @file      retdec/internal/polling_progress.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the progress of polling the status of a
+///            resource.
+///
+
+#include <algorithm>
+
+#include "retdec/internal/polling_progress.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Starts tracking a polling of a resource with the given mode whose delays are
+/// decided by the given policy.
+///
+/// The policy has to outlive the progress. The elapsed time passed to the
+/// policy is measured by @a clock.
+///
+PollingProgress::PollingProgress(const PollingPolicy &policy,
+		const std::string &mode, const std::shared_ptr<Clock> &clock):
+	policy(policy),
+	mode(mode),
+	clock(clock),
+	startTime(clock->now()),
+	lastDelay(0) {}
+
+///
+/// Records the given status and returns the delay before the next status
+/// update.
+///
+std::chrono::milliseconds PollingProgress::nextDelay(
+		const ResourceStatus &status) {
+	++statusUpdateCount;
+	auto completion = status.completion.value_or(lastCompletion);
+	auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+		clock->now() - startTime);
+	if (completionChanges.empty() || completion != lastCompletion) {
+		completionChanges.push_back({elapsedTime, completion});
+	}
+
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = elapsedTime;
+	progress.lastDelay = lastDelay;
+	progress.completionDelta = statusUpdateCount > 1 ?
+		completion - lastCompletion : 0;
+	progress.statusUpdateCount = statusUpdateCount;
+	progress.completion = completion;
+	progress.completionChanges = completionChanges;
+	progress.mode = mode;
+
+	lastCompletion = completion;
+	lastDelay = std::max(policy.nextDelay(progress),
+		std::chrono::milliseconds::zero());
+	return lastDelay;
+}
+
+} // namespace internal
+} // namespace retdec
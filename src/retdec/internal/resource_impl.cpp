@@ -6,12 +6,323 @@
 ///            implementations.
 ///
 
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <ios>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/clock.h"
+#include "retdec/internal/files/filesystem_file.h"
+#include "retdec/internal/files/tracing_file.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/polling_progress.h"
 #include "retdec/internal/resource_impl.h"
+#include "retdec/internal/status_poller.h"
+#include "retdec/internal/trace_buffer.h"
 #include "retdec/internal/utilities/connection.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/polling_policy.h"
+#include "retdec/settings.h"
 
 namespace retdec {
 namespace internal {
 
+namespace {
+
+/// Maximal number of consecutive status updates that may fail with a transient
+/// error before the polling fails.
+const std::size_t MaxTransientStatusErrorCount = 5;
+
+///
+/// Is the given error transient, i.e. may the status be obtained when it is
+/// requested again?
+///
+/// Connection errors and server errors (5xx) are transient.
+///
+bool isTransientError(std::exception_ptr error) {
+	try {
+		std::rethrow_exception(error);
+	} catch (const ConnectionError &) {
+		return true;
+	} catch (const ApiError &ex) {
+		return ex.getCode() >= 500 && ex.getCode() <= 599;
+	} catch (...) {
+		return false;
+	}
+}
+
+} // anonymous namespace
+
+///
+/// Asynchronous polling of the status of a resource until it finishes.
+///
+/// The status updates are scheduled by a poller shared by all resources and
+/// run on threads of an I/O service, so the polling does not access the
+/// resource, which may be used from another thread in the meantime. Instead,
+/// it keeps the last received status until the resource picks it up.
+///
+/// When a status update fails with a transient error, the status is requested
+/// again after the delay decided by the polling policy. The polling fails only
+/// when the error is not transient or when too many consecutive status updates
+/// fail.
+///
+class StatusPolling: public std::enable_shared_from_this<StatusPolling> {
+public:
+	StatusPolling(const std::shared_ptr<Connection> &conn,
+		const Connection::Url &statusUrl,
+		const std::shared_ptr<StatusPoller> &poller,
+		const std::shared_ptr<const PollingPolicy> &pollingPolicy,
+		const std::string &mode,
+		const std::shared_ptr<ResourceMetrics> &metrics,
+		const std::shared_ptr<ResourceTrace> &trace);
+
+	void start();
+	void stop();
+
+	std::shared_future<void> finished() const;
+	void whenFinished(const ResourceImpl::FinishedHandler &handler);
+	boost::optional<ResourceStatus> finalStatus();
+
+private:
+	void scheduleStatusUpdate(const ResourceStatus &status);
+	void updateStatus();
+	void handleStatusResponse(std::unique_ptr<Connection::Response> response,
+		std::exception_ptr error);
+
+private:
+	/// Connection used to obtain the status.
+	const std::shared_ptr<Connection> conn;
+
+	/// URL to obtain the status.
+	const Connection::Url statusUrl;
+
+	/// Poller scheduling the status updates.
+	const std::shared_ptr<StatusPoller> poller;
+
+	/// Policy deciding the delays between the status updates.
+	const std::shared_ptr<const PollingPolicy> pollingPolicy;
+
+	/// Metrics of the resource (null when they are not recorded).
+	const std::shared_ptr<ResourceMetrics> metrics;
+
+	/// Trace of the resource (null when it is not traced).
+	const std::shared_ptr<ResourceTrace> trace;
+
+	/// Progress of the polling.
+	PollingProgress progress;
+
+	/// Becomes ready when the resource finishes.
+	std::promise<void> finishedPromise;
+
+	/// Future of @c finishedPromise.
+	const std::shared_future<void> finishedFuture;
+
+	/// Handlers to be called when the resource finishes.
+	std::vector<ResourceImpl::FinishedHandler> finishedHandlers;
+
+	/// Has the polling finished (either because the resource finished or
+	/// because of an error)?
+	bool done = false;
+
+	/// Error that stopped the polling (if any).
+	std::exception_ptr error;
+
+	/// Status received when the resource finished.
+	boost::optional<ResourceStatus> finalStatus_;
+
+	/// Last received status.
+	ResourceStatus lastStatus;
+
+	/// Number of consecutive status updates that failed with a transient
+	/// error.
+	std::size_t transientErrorCount = 0;
+
+	/// Has the polling been stopped?
+	bool stopped = false;
+
+	/// Mutex guarding the polling.
+	boost::mutex mutex;
+};
+
+///
+/// Constructs a polling of a resource with the given mode using the given
+/// connection, poller, and policy, recording the given metrics and trace (if
+/// any).
+///
+StatusPolling::StatusPolling(const std::shared_ptr<Connection> &conn,
+		const Connection::Url &statusUrl,
+		const std::shared_ptr<StatusPoller> &poller,
+		const std::shared_ptr<const PollingPolicy> &pollingPolicy,
+		const std::string &mode,
+		const std::shared_ptr<ResourceMetrics> &metrics,
+		const std::shared_ptr<ResourceTrace> &trace):
+	conn(conn),
+	statusUrl(statusUrl),
+	poller(poller),
+	pollingPolicy(pollingPolicy),
+	metrics(metrics),
+	trace(trace),
+	progress(*pollingPolicy, mode),
+	finishedFuture(finishedPromise.get_future().share()) {}
+
+///
+/// Starts the polling by requesting the status right away.
+///
+void StatusPolling::start() {
+	updateStatus();
+}
+
+///
+/// Stops the polling.
+///
+/// The status is no longer requested. When the resource has not finished yet,
+/// the future returned by finished() never becomes ready.
+///
+void StatusPolling::stop() {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	stopped = true;
+}
+
+///
+/// Returns a future that becomes ready when the resource finishes.
+///
+std::shared_future<void> StatusPolling::finished() const {
+	return finishedFuture;
+}
+
+///
+/// Calls @a handler when the resource finishes.
+///
+/// When the status cannot be obtained, the error is passed to @a handler. It is
+/// called from a thread of the I/O service, or right away when the resource
+/// has already finished.
+///
+void StatusPolling::whenFinished(const ResourceImpl::FinishedHandler &handler) {
+	boost::unique_lock<boost::mutex> lock(mutex);
+	if (!done) {
+		finishedHandlers.push_back(handler);
+		return;
+	}
+
+	auto error = this->error;
+	lock.unlock();
+	handler(error);
+}
+
+///
+/// Returns the status received when the resource finished (if it has
+/// finished).
+///
+boost::optional<ResourceStatus> StatusPolling::finalStatus() {
+	boost::lock_guard<boost::mutex> lock(mutex);
+	return finalStatus_;
+}
+
+///
+/// Schedules the next status update after the given status.
+///
+/// The caller has to hold the lock.
+///
+void StatusPolling::scheduleStatusUpdate(const ResourceStatus &status) {
+	auto self = shared_from_this();
+	poller->schedule(progress.nextDelay(status),
+		[self]() { self->updateStatus(); });
+}
+
+///
+/// Requests the status (unless the polling has been stopped).
+///
+void StatusPolling::updateStatus() {
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		if (stopped) {
+			return;
+		}
+	}
+
+	if (metrics) {
+		metrics->statusPolled();
+	}
+	auto self = shared_from_this();
+	auto start = TraceBuffer::Clock::now();
+	conn->sendGetRequestAsync(statusUrl,
+		[self, start](std::unique_ptr<Connection::Response> response,
+				std::exception_ptr error) {
+			if (self->trace) {
+				self->trace->buffer->recordSpan("pollStatus",
+					self->trace->track, start);
+			}
+			self->handleStatusResponse(std::move(response), error);
+		}
+	);
+}
+
+///
+/// Handles a response to a status request.
+///
+void StatusPolling::handleStatusResponse(
+		std::unique_ptr<Connection::Response> response,
+		std::exception_ptr error) {
+	ResourceStatus status;
+	if (!error) {
+		try {
+			status = response->bodyAsStatus();
+		} catch (...) {
+			error = std::current_exception();
+		}
+	}
+	if (metrics && !error) {
+		metrics->statusReceived(status);
+	}
+	if (trace && !error) {
+		trace->statusReceived(status);
+	}
+
+	std::vector<ResourceImpl::FinishedHandler> handlers;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		if (stopped) {
+			return;
+		}
+
+		if (!error && !status.finished) {
+			lastStatus = status;
+			transientErrorCount = 0;
+			return scheduleStatusUpdate(status);
+		}
+
+		if (error && isTransientError(error) &&
+				++transientErrorCount < MaxTransientStatusErrorCount) {
+			// The delays grow with the number of status updates, so the
+			// failed ones are counted as updates without a change.
+			return scheduleStatusUpdate(lastStatus);
+		}
+
+		done = true;
+		this->error = error;
+		if (error) {
+			finishedPromise.set_exception(error);
+		} else {
+			finalStatus_ = status;
+			finishedPromise.set_value();
+		}
+		handlers.swap(finishedHandlers);
+	}
+
+	// Call the handlers without holding the lock because they may use the
+	// polling.
+	for (auto &handler : handlers) {
+		handler(error);
+	}
+}
+
 ///
 /// Constructs a private implementation.
 ///
@@ -19,23 +330,40 @@ namespace internal {
 /// @param[in] conn Connection to be used to communicate with the API.
 /// @param[in] serviceName Name of the service.
 /// @param[in] resourcesName Name of the resources (plural).
+/// @param[in] context Context in which the resource is created.
 ///
 ResourceImpl::ResourceImpl(
 		const std::string &id,
 		const std::shared_ptr<Connection> &conn,
 		const std::string &serviceName,
-		const std::string &resourcesName
+		const std::string &resourcesName,
+		const ResourceContext &context
 	):
 	id(id),
 	conn(std::make_shared<ResponseVerifyingConnection>(conn)),
 	baseUrl(conn->getApiUrl() + "/" + serviceName + "/" + resourcesName + "/" + id),
-	statusUrl(baseUrl + "/status")
+	statusUrl(baseUrl + "/status"),
+	ioService(context.ioService ? context.ioService :
+		IoService::shared(Settings::DefaultIoThreadCount)),
+	pollingPolicy(context.pollingPolicy ? context.pollingPolicy :
+		Settings::DefaultPollingPolicy),
+	mode(context.mode),
+	metrics(context.metrics ? std::make_shared<ResourceMetrics>(
+		context.metrics, MetricsRegistry::serviceFromName(serviceName),
+		context.measureDuration) : nullptr),
+	trace(context.traceBuffer ? std::make_shared<ResourceTrace>(
+		context.traceBuffer, TraceBuffer::resourceTrack(resourcesName, id)) :
+		nullptr)
 	{}
 
 ///
 /// Destructs the private implementation.
 ///
-ResourceImpl::~ResourceImpl() = default;
+ResourceImpl::~ResourceImpl() {
+	if (statusPolling) {
+		statusPolling->stop();
+	}
+}
 
 ///
 /// Should the status be updated?
@@ -47,14 +375,75 @@ bool ResourceImpl::shouldUpdateStatus() {
 ///
 /// Updates the status of the resource.
 ///
+/// When the asynchronous polling has already received the final status, the
+/// API is not accessed.
+///
 void ResourceImpl::updateStatus() {
+	TraceSpan span(trace, "updateStatus");
+	updateStatus(currentStatus());
+}
+
+///
+/// Waits until the resource finishes, updating its status as often as the
+/// given policy says.
+///
+/// @a statusUpdated is called after each status update. The waiting between
+/// status updates is timed by the clock of the connection.
+///
+void ResourceImpl::waitUntilFinished(const PollingPolicy &pollingPolicy,
+		const std::function<void ()> &statusUpdated) {
+	TraceSpan span(trace, "waitUntilFinished");
+	auto clock = conn->clock();
+	PollingProgress progress(pollingPolicy, mode, clock);
+	while (!finished) {
+		ResourceStatus status;
+		{
+			TraceSpan updateSpan(trace, "updateStatus");
+			status = currentStatus();
+			updateStatus(status);
+		}
+		statusUpdated();
+		if (!finished) {
+			clock->sleepFor(progress.nextDelay(status));
+		}
+	}
+}
+
+///
+/// Returns the current status of the resource.
+///
+/// When the asynchronous polling has already received the final status, the
+/// API is not accessed.
+///
+ResourceStatus ResourceImpl::currentStatus() {
+	if (statusPolling) {
+		if (auto finalStatus = statusPolling->finalStatus()) {
+			return *finalStatus;
+		}
+	}
+
+	if (metrics) {
+		metrics->statusPolled();
+	}
 	auto response = conn->sendGetRequest(statusUrl);
-	auto jsonBody = response->bodyAsJson();
-	finished = jsonBody.get("finished", false).asBool();
-	succeeded = jsonBody.get("succeeded", false).asBool();
-	failed = jsonBody.get("failed", false).asBool();
-	error = jsonBody.get("error", "").asString();
-	updateResourceSpecificStatus(jsonBody);
+	return response->bodyAsStatus();
+}
+
+///
+/// Updates the status of the resource from the given status.
+///
+void ResourceImpl::updateStatus(const ResourceStatus &status) {
+	if (metrics) {
+		metrics->statusReceived(status);
+	}
+	if (trace) {
+		trace->statusReceived(status);
+	}
+	finished = status.finished;
+	succeeded = status.succeeded;
+	failed = status.failed;
+	error = status.error;
+	updateResourceSpecificStatus(status);
 }
 
 ///
@@ -71,7 +460,130 @@ void ResourceImpl::updateStatusIfNeeded() {
 ///
 /// If not overridden, it does nothing.
 ///
-void ResourceImpl::updateResourceSpecificStatus(const Json::Value &) {}
+void ResourceImpl::updateResourceSpecificStatus(const ResourceStatus &) {}
+
+///
+/// Returns a future that becomes ready when the resource finishes.
+///
+/// Upon the first call, it starts polling the status asynchronously, on the
+/// threads of the I/O service.
+///
+std::shared_future<void> ResourceImpl::finishedFuture() {
+	if (finished) {
+		std::promise<void> finishedPromise;
+		finishedPromise.set_value();
+		return finishedPromise.get_future().share();
+	}
+
+	startStatusPollingIfNeeded();
+	return statusPolling->finished();
+}
+
+///
+/// Calls @a handler when the resource finishes.
+///
+/// Upon the first call, it starts polling the status asynchronously, on the
+/// threads of the I/O service. @a handler is called from one of these threads,
+/// or right away when the resource has already finished.
+///
+void ResourceImpl::whenFinished(const FinishedHandler &handler) {
+	if (finished) {
+		return handler(nullptr);
+	}
+
+	startStatusPollingIfNeeded();
+	statusPolling->whenFinished(handler);
+}
+
+///
+/// Starts polling the status asynchronously (if not already started).
+///
+void ResourceImpl::startStatusPollingIfNeeded() {
+	if (!statusPolling) {
+		statusPolling = std::make_shared<StatusPolling>(conn, statusUrl,
+			StatusPoller::shared(ioService), pollingPolicy, mode, metrics,
+			trace);
+		statusPolling->start();
+	}
+}
+
+///
+/// Passes the content of the output file from the given URL to the given
+/// handler, in parts, as it is being received.
+///
+void ResourceImpl::streamOutputFile(const Connection::Url &url,
+		const Connection::BodyHandler &bodyHandler) {
+	TraceSpan span(trace, "streamOutput");
+	conn->sendGetRequestStreamingBody(url, bodyHandler);
+}
+
+///
+/// Downloads the output file from the given URL into the given directory.
+///
+/// @returns The downloaded file.
+///
+/// @throws FilesystemError When the file cannot be written.
+///
+/// The content of the file is written as it is being received, so it is never
+/// stored in memory as a whole. Until the download finishes, the file is stored
+/// under a temporary name, so an incomplete file is never left in the
+/// directory.
+///
+std::shared_ptr<File> ResourceImpl::downloadOutputFile(
+		const Connection::Url &url, const std::string &directoryPath) {
+	TraceSpan span(trace, "downloadOutput");
+	auto tmpFilePath = uniqueFilePath(directoryPath);
+	std::string fileName;
+	try {
+		auto file = openFileForWriting(tmpFilePath);
+		auto response = conn->sendGetRequestStreamingBody(url,
+			[&](const char *data, std::size_t size) {
+				if (!file->write(data, static_cast<std::streamsize>(size))) {
+					throw FilesystemError(
+						"cannot write file \"" + tmpFilePath + "\"");
+				}
+			}
+		);
+		if (!file->flush()) {
+			throw FilesystemError("cannot write file \"" + tmpFilePath + "\"");
+		}
+		fileName = response->attachedFileName();
+	} catch (...) {
+		removeFile(tmpFilePath);
+		throw;
+	}
+
+	if (fileName.empty()) {
+		fileName = fileNameFromPath(url);
+	}
+	auto filePath = joinPaths(directoryPath, fileName);
+	renameFile(tmpFilePath, filePath);
+	return traced(std::make_shared<FilesystemFile>(filePath));
+}
+
+///
+/// Returns the given output file, wrapped so that saving of its copies is
+/// traced (when the resource is traced).
+///
+std::shared_ptr<File> ResourceImpl::traced(
+		const std::shared_ptr<File> &file) const {
+	return traced(file, trace);
+}
+
+///
+/// Returns the given output file, wrapped so that saving of its copies is
+/// recorded into the given trace (when it is not null).
+///
+/// Unlike the other overload, it can be used after the resource has been
+/// destructed (e.g. from handlers of asynchronous requests).
+///
+std::shared_ptr<File> ResourceImpl::traced(const std::shared_ptr<File> &file,
+		const std::shared_ptr<ResourceTrace> &trace) {
+	if (!trace) {
+		return file;
+	}
+	return std::make_shared<TracingFile>(file, trace->buffer, trace->track);
+}
 
 } // namespace internal
 } // namespace retdec
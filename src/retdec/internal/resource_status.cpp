@@ -0,0 +1,383 @@
+///
+/// @file      retdec/internal/resource_status.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the status of a resource.
+///
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <json/json.h>
+
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/utilities/json.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Decoder of the body of a status response that extracts the parts of the
+/// status in a single pass, without building a JSON value.
+///
+/// It understands only the usual shape of statuses: an object whose @c
+/// finished, @c succeeded, and @c failed members are booleans, whose @c error
+/// member is @c null or a string without escape sequences, and whose @c
+/// completion member is a non-negative integer. Other members are skipped. The
+/// decoding fails on anything else, including invalid JSON, so the body can be
+/// decoded by a full JSON parser instead.
+///
+class StatusDecoder {
+public:
+	StatusDecoder(const char *begin, const char *end):
+		pos(begin), end(end) {}
+
+	bool decode(ResourceStatus &status);
+
+private:
+	/// Maximal nesting of skipped arrays and objects.
+	static constexpr int MaxDepth = 32;
+
+	bool decodeMember(ResourceStatus &status);
+	bool decodeBool(bool &value);
+	bool decodeError(std::string &error);
+	bool decodeCompletion(boost::optional<int> &completion);
+	bool decodeString(const char *&strBegin, const char *&strEnd);
+	bool skipValue(int depth);
+	bool skipObject(int depth);
+	bool skipArray(int depth);
+	bool skipNumber();
+	bool skipLiteral(const char *literal);
+	bool skipWhitespace();
+	bool consume(char c);
+
+private:
+	/// Current position.
+	const char *pos;
+
+	/// End of the body.
+	const char *const end;
+};
+
+///
+/// Decodes the body into @a status.
+///
+/// @returns @c false when the body does not have the usual shape.
+///
+bool StatusDecoder::decode(ResourceStatus &status) {
+	if (!consume('{')) {
+		return false;
+	}
+	if (!consume('}')) {
+		do {
+			if (!decodeMember(status)) {
+				return false;
+			}
+		} while (consume(','));
+		if (!consume('}')) {
+			return false;
+		}
+	}
+	return !skipWhitespace();
+}
+
+///
+/// Decodes a member of the status object.
+///
+bool StatusDecoder::decodeMember(ResourceStatus &status) {
+	const char *nameBegin;
+	const char *nameEnd;
+	if (!decodeString(nameBegin, nameEnd) || !consume(':')) {
+		return false;
+	}
+
+	auto isName = [&](const char *name) {
+		auto length = static_cast<std::size_t>(nameEnd - nameBegin);
+		return length == std::strlen(name) &&
+			std::memcmp(nameBegin, name, length) == 0;
+	};
+	if (isName("finished")) {
+		return decodeBool(status.finished);
+	} else if (isName("succeeded")) {
+		return decodeBool(status.succeeded);
+	} else if (isName("failed")) {
+		return decodeBool(status.failed);
+	} else if (isName("error")) {
+		return decodeError(status.error);
+	} else if (isName("completion")) {
+		return decodeCompletion(status.completion);
+	}
+	return skipValue(0);
+}
+
+///
+/// Decodes a boolean.
+///
+bool StatusDecoder::decodeBool(bool &value) {
+	if (skipLiteral("true")) {
+		value = true;
+		return true;
+	} else if (skipLiteral("false")) {
+		value = false;
+		return true;
+	}
+	return false;
+}
+
+///
+/// Decodes an error message, which is either @c null or a string.
+///
+bool StatusDecoder::decodeError(std::string &error) {
+	if (skipLiteral("null")) {
+		error.clear();
+		return true;
+	}
+
+	const char *strBegin;
+	const char *strEnd;
+	if (!decodeString(strBegin, strEnd) ||
+			std::find(strBegin, strEnd, '\\') != strEnd) {
+		return false;
+	}
+	error.assign(strBegin, strEnd);
+	return true;
+}
+
+///
+/// Decodes a completion, which is a non-negative integer.
+///
+bool StatusDecoder::decodeCompletion(boost::optional<int> &completion) {
+	skipWhitespace();
+	auto value = 0;
+	auto digitsBegin = pos;
+	while (pos != end && *pos >= '0' && *pos <= '9') {
+		if (value > (std::numeric_limits<int>::max() - 9) / 10) {
+			return false;
+		}
+		value = value * 10 + (*pos - '0');
+		++pos;
+	}
+	// A fraction, an exponent, or a leading zero are unusual, so let the full
+	// parser decide.
+	if (pos == digitsBegin || (pos - digitsBegin > 1 && *digitsBegin == '0') ||
+			(pos != end && (*pos == '.' || *pos == 'e' || *pos == 'E'))) {
+		return false;
+	}
+	completion = value;
+	return true;
+}
+
+///
+/// Decodes a string, setting [@a strBegin, @a strEnd) to its raw characters
+/// (without the quotes, escape sequences are kept as they are).
+///
+bool StatusDecoder::decodeString(const char *&strBegin,
+		const char *&strEnd) {
+	if (!consume('"')) {
+		return false;
+	}
+
+	strBegin = pos;
+	while (pos != end && *pos != '"') {
+		if (*pos == '\\') {
+			++pos;
+			if (pos == end) {
+				return false;
+			}
+		} else if (static_cast<unsigned char>(*pos) < 0x20) {
+			return false;
+		}
+		++pos;
+	}
+	if (pos == end) {
+		return false;
+	}
+	strEnd = pos;
+	++pos;
+	return true;
+}
+
+///
+/// Skips a value of any type.
+///
+bool StatusDecoder::skipValue(int depth) {
+	if (depth > MaxDepth || !skipWhitespace()) {
+		return false;
+	}
+
+	const char *strBegin;
+	const char *strEnd;
+	switch (*pos) {
+		case '{':
+			return skipObject(depth + 1);
+		case '[':
+			return skipArray(depth + 1);
+		case '"':
+			return decodeString(strBegin, strEnd);
+		case 't':
+			return skipLiteral("true");
+		case 'f':
+			return skipLiteral("false");
+		case 'n':
+			return skipLiteral("null");
+		default:
+			return skipNumber();
+	}
+}
+
+///
+/// Skips an object.
+///
+bool StatusDecoder::skipObject(int depth) {
+	consume('{');
+	if (consume('}')) {
+		return true;
+	}
+
+	const char *nameBegin;
+	const char *nameEnd;
+	do {
+		if (!decodeString(nameBegin, nameEnd) || !consume(':') ||
+				!skipValue(depth)) {
+			return false;
+		}
+	} while (consume(','));
+	return consume('}');
+}
+
+///
+/// Skips an array.
+///
+bool StatusDecoder::skipArray(int depth) {
+	consume('[');
+	if (consume(']')) {
+		return true;
+	}
+
+	do {
+		if (!skipValue(depth)) {
+			return false;
+		}
+	} while (consume(','));
+	return consume(']');
+}
+
+///
+/// Skips a number.
+///
+bool StatusDecoder::skipNumber() {
+	auto skipDigits = [this]() {
+		auto digitsBegin = pos;
+		while (pos != end && *pos >= '0' && *pos <= '9') {
+			++pos;
+		}
+		return pos != digitsBegin;
+	};
+
+	if (pos != end && *pos == '-') {
+		++pos;
+	}
+	if (pos != end && *pos == '0') {
+		++pos;
+	} else if (!skipDigits()) {
+		return false;
+	}
+	if (pos != end && *pos == '.') {
+		++pos;
+		if (!skipDigits()) {
+			return false;
+		}
+	}
+	if (pos != end && (*pos == 'e' || *pos == 'E')) {
+		++pos;
+		if (pos != end && (*pos == '+' || *pos == '-')) {
+			++pos;
+		}
+		if (!skipDigits()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+///
+/// Skips the given literal (e.g. @c null).
+///
+bool StatusDecoder::skipLiteral(const char *literal) {
+	skipWhitespace();
+	auto length = std::strlen(literal);
+	if (static_cast<std::size_t>(end - pos) < length ||
+			std::memcmp(pos, literal, length) != 0) {
+		return false;
+	}
+	pos += length;
+	return true;
+}
+
+///
+/// Skips whitespace.
+///
+/// @returns @c false when there is nothing after the whitespace.
+///
+bool StatusDecoder::skipWhitespace() {
+	while (pos != end &&
+			(*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r')) {
+		++pos;
+	}
+	return pos != end;
+}
+
+///
+/// Skips whitespace and the given character, if it follows.
+///
+/// @returns @c true when the character has been skipped.
+///
+bool StatusDecoder::consume(char c) {
+	if (!skipWhitespace() || *pos != c) {
+		return false;
+	}
+	++pos;
+	return true;
+}
+
+} // anonymous namespace
+
+///
+/// Returns the status from the given JSON value.
+///
+ResourceStatus ResourceStatus::fromJson(const Json::Value &status) {
+	ResourceStatus resourceStatus;
+	resourceStatus.finished = status.get("finished", false).asBool();
+	resourceStatus.succeeded = status.get("succeeded", false).asBool();
+	resourceStatus.failed = status.get("failed", false).asBool();
+	resourceStatus.error = status.get("error", "").asString();
+	if (status.isMember("completion")) {
+		resourceStatus.completion = status["completion"].asInt();
+	}
+	return resourceStatus;
+}
+
+///
+/// Returns the status from the body of a status response in
+/// [@a begin, @a end).
+///
+/// @throws JsonDecodingError When the body is not valid JSON.
+///
+/// Bodies of the usual shape are decoded in a single pass without building a
+/// JSON value, so no memory is allocated (unless there is an error message
+/// that does not fit into a string without an allocation). Other bodies are
+/// decoded by the full JSON parser.
+///
+ResourceStatus ResourceStatus::fromBody(const char *begin, const char *end) {
+	ResourceStatus status;
+	if (StatusDecoder(begin, end).decode(status)) {
+		return status;
+	}
+	return fromJson(toJson(begin, end));
+}
+
+} // namespace internal
+} // namespace retdec
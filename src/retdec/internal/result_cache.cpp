@@ -0,0 +1,432 @@
+///
+/// @file      retdec/internal/result_cache.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the on-disk cache of results of resources.
+///
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <ios>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+#include <boost/thread/locks.hpp>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/result_cache.h"
+#include "retdec/internal/stored_response.h"
+#include "retdec/internal/utilities/os.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+/// Name of the file with the ID of the resource in an entry.
+const std::string ResourceIdFileName = "id";
+
+/// Suffix of the file with the attached file name of a response in an entry.
+const std::string AttachedFileNameSuffix = ".filename";
+
+/// Name of the lock file guarding the eviction.
+const std::string LockFileName = "lock";
+
+/// Size of chunks in which responses are streamed from the cache (in bytes).
+const std::size_t StreamedChunkSize = 64 * 1024;
+
+/// Eviction leaves 1/EvictionFreeFractionReciprocal of the maximal size free,
+/// so the cache is not scanned again on the very next store.
+const std::uint64_t EvictionFreeFractionReciprocal = 10;
+
+///
+/// Returns the total size of files in the given directory (in bytes).
+///
+std::uint64_t directorySize(const boost::filesystem::path &path) {
+	std::uint64_t size = 0;
+	for (boost::filesystem::directory_iterator it(path), end; it != end; ++it) {
+		boost::system::error_code ec;
+		auto fileSize = boost::filesystem::file_size(it->path(), ec);
+		if (!ec) {
+			size += fileSize;
+		}
+	}
+	return size;
+}
+
+} // anonymous namespace
+
+///
+/// Constructs a cache stored in the given directory.
+///
+/// @param[in] directoryPath Path to the directory with the cache. It is created
+///                          when needed.
+/// @param[in] maxSize Maximal size of all entries (in bytes). When it is
+///                    exceeded, the least recently used entries are evicted.
+///
+ResultCache::ResultCache(const std::string &directoryPath,
+		std::uint64_t maxSize):
+	directoryPath(directoryPath), maxSize(maxSize), writer(1) {}
+
+///
+/// Destructs the cache.
+///
+ResultCache::~ResultCache() = default;
+
+///
+/// Returns the ID of the resource from the entry with the given key when the
+/// resource has finished successfully and the entry contains its outputs.
+///
+/// @param[in] key Key of the entry.
+/// @param[in] outputPaths Paths to the outputs of the resource (relative to its
+///                        URL, e.g. @c outputs/hll).
+///
+/// When there is no such entry, it returns nothing.
+///
+boost::optional<std::string> ResultCache::finishedResourceId(
+		const std::string &key, const std::vector<std::string> &outputPaths) {
+	auto path = entryPath(key);
+	try {
+		if (!boost::filesystem::exists(joinPaths(path, StatusResponseName))) {
+			return boost::none;
+		}
+		for (const auto &outputPath : outputPaths) {
+			if (!hasResponse(key, responseName(outputPath))) {
+				return boost::none;
+			}
+		}
+		auto id = readFile(joinPaths(path, ResourceIdFileName));
+		// Mark the entry as recently used.
+		boost::filesystem::last_write_time(path, std::time(nullptr));
+		return id;
+	} catch (...) {
+		return boost::none;
+	}
+}
+
+///
+/// Stores the ID of a resource into the entry with the given key.
+///
+/// Errors are ignored because the cache is only an optimization.
+///
+void ResultCache::storeResourceId(const std::string &key,
+		const std::string &id) {
+	try {
+		storeEntryFile(key, ResourceIdFileName, id);
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+///
+/// Does the entry with the given key contain a response with the given name?
+///
+bool ResultCache::hasResponse(const std::string &key,
+		const std::string &name) const {
+	boost::system::error_code ec;
+	return boost::filesystem::exists(joinPaths(entryPath(key), name), ec);
+}
+
+///
+/// Returns the response with the given name from the entry with the given
+/// key.
+///
+/// When there is no such response, it returns the null pointer.
+///
+std::unique_ptr<Connection::Response> ResultCache::response(
+		const std::string &key, const std::string &name) {
+	auto path = joinPaths(entryPath(key), name);
+	try {
+		if (!boost::filesystem::exists(path)) {
+			return nullptr;
+		}
+		auto body = std::make_shared<const std::string>(readFile(path));
+		std::string fileName;
+		if (boost::filesystem::exists(path + AttachedFileNameSuffix)) {
+			fileName = readFile(path + AttachedFileNameSuffix);
+		}
+		// Only successful responses are stored.
+		return std::make_unique<StoredResponse>(200, "OK", body, fileName);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+///
+/// Passes the body of the response with the given name from the entry with the
+/// given key to @a bodyHandler in parts and returns the response without the
+/// body.
+///
+/// The body is read from the disk in chunks, so it is never stored in memory
+/// as a whole. When there is no such response, it returns the null pointer
+/// without calling @a bodyHandler.
+///
+/// @throws FilesystemError When the body cannot be read after a part of it
+///                         has been passed to @a bodyHandler.
+///
+std::unique_ptr<Connection::Response> ResultCache::streamResponse(
+		const std::string &key, const std::string &name,
+		const Connection::BodyHandler &bodyHandler) {
+	auto path = joinPaths(entryPath(key), name);
+	std::unique_ptr<std::istream> file;
+	std::string fileName;
+	try {
+		file = openFile(path);
+		if (boost::filesystem::exists(path + AttachedFileNameSuffix)) {
+			fileName = readFile(path + AttachedFileNameSuffix);
+		}
+	} catch (...) {
+		return nullptr;
+	}
+
+	// The opened file can be read even when the entry is evicted by another
+	// process in the meantime.
+	std::vector<char> chunk(StreamedChunkSize);
+	try {
+		while (file->read(chunk.data(),
+					static_cast<std::streamsize>(chunk.size())) ||
+				file->gcount() > 0) {
+			bodyHandler(chunk.data(), static_cast<std::size_t>(file->gcount()));
+		}
+	} catch (const std::ios_base::failure &) {
+		throw FilesystemError("cannot read file \"" + path + "\"");
+	}
+	// Only successful responses are stored.
+	return std::make_unique<StoredResponse>(200, "OK",
+		std::make_shared<const std::string>(), fileName);
+}
+
+///
+/// Stores the given response under the given name into the entry with the
+/// given key.
+///
+/// Errors are ignored because the cache is only an optimization.
+///
+void ResultCache::storeResponse(const std::string &key, const std::string &name,
+		const Connection::Response &response) {
+	storeBody(key, name, *response.sharedBody(), response.attachedFileName());
+}
+
+///
+/// Stores the given response under the given name into the entry with the
+/// given key on the writer thread of the cache and then calls
+/// @a storedHandler (if any) on that thread.
+///
+/// It returns right away, so it can be called from handlers run by the I/O
+/// service. The body of the response is shared, not copied. The cache has to
+/// be owned by @c std::shared_ptr, which is kept until the response is stored.
+/// Errors are ignored because the cache is only an optimization, so
+/// @a storedHandler is called even when the response has not been stored.
+///
+void ResultCache::storeResponseAsync(const std::string &key,
+		const std::string &name, const Connection::Response &response,
+		const std::function<void ()> &storedHandler) {
+	auto self = shared_from_this();
+	auto body = response.sharedBody();
+	auto fileName = response.attachedFileName();
+	writer.asioService()->post([self, key, name, body, fileName, storedHandler]() {
+		self->storeBody(key, name, *body, fileName);
+		if (storedHandler) {
+			storedHandler();
+		}
+	});
+}
+
+///
+/// Returns a path to a new temporary file in the cache, into which a response
+/// may be written and then stored by calling storeResponseFile().
+///
+std::string ResultCache::newTmpFilePath() const {
+	boost::system::error_code ec;
+	boost::filesystem::create_directories(directoryPath, ec);
+	return uniqueFilePath(directoryPath);
+}
+
+///
+/// Stores the response whose body has been written into the given temporary
+/// file under the given name into the entry with the given key.
+///
+/// The temporary file is moved into the entry. Errors are ignored because the
+/// cache is only an optimization.
+///
+void ResultCache::storeResponseFile(const std::string &key,
+		const std::string &name, const std::string &tmpFilePath,
+		const std::string &attachedFileName) {
+	try {
+		if (!attachedFileName.empty()) {
+			storeEntryFile(key, name + AttachedFileNameSuffix, attachedFileName);
+		}
+		moveIntoEntry(key, name, tmpFilePath);
+		evictEntriesIfNeeded();
+	} catch (...) {
+		removeFile(tmpFilePath);
+	}
+}
+
+///
+/// Returns a path to the directory with the entry with the given key.
+///
+std::string ResultCache::entryPath(const std::string &key) const {
+	return joinPaths(directoryPath, key);
+}
+
+///
+/// Stores a response with the given body and attached file name under the
+/// given name into the entry with the given key.
+///
+/// Errors are ignored because the cache is only an optimization.
+///
+void ResultCache::storeBody(const std::string &key, const std::string &name,
+		const std::string &body, const std::string &attachedFileName) {
+	try {
+		if (!attachedFileName.empty()) {
+			storeEntryFile(key, name + AttachedFileNameSuffix, attachedFileName);
+		}
+		storeEntryFile(key, name, body);
+		evictEntriesIfNeeded();
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+///
+/// Stores a file with the given name and content into the entry with the
+/// given key.
+///
+void ResultCache::storeEntryFile(const std::string &key,
+		const std::string &name, const std::string &content) {
+	auto tmpFilePath = newTmpFilePath();
+	try {
+		writeFile(tmpFilePath, content);
+	} catch (...) {
+		removeFile(tmpFilePath);
+		throw;
+	}
+	moveIntoEntry(key, name, tmpFilePath);
+}
+
+///
+/// Moves the given temporary file under the given name into the entry with the
+/// given key.
+///
+/// The temporary file is renamed, so other processes either see the whole file
+/// or no file at all.
+///
+void ResultCache::moveIntoEntry(const std::string &key,
+		const std::string &name, const std::string &tmpFilePath) {
+	auto path = entryPath(key);
+	boost::filesystem::create_directories(path);
+	std::uint64_t fileSize = 0;
+	try {
+		fileSize = boost::filesystem::file_size(tmpFilePath);
+		renameFile(tmpFilePath, joinPaths(path, name));
+	} catch (...) {
+		removeFile(tmpFilePath);
+		throw;
+	}
+
+	boost::lock_guard<boost::mutex> lock(sizeMutex);
+	if (size) {
+		*size += fileSize;
+	}
+}
+
+///
+/// Evicts the least recently used entries when the running size of the cache
+/// is unknown or larger than its maximal size.
+///
+/// Files that have been replaced are counted twice and files stored by other
+/// processes are not counted in the running size, so it is corrected by the
+/// scan of the cache that precedes the eviction.
+///
+void ResultCache::evictEntriesIfNeeded() {
+	boost::lock_guard<boost::mutex> lock(sizeMutex);
+	if (size && *size <= maxSize) {
+		return;
+	}
+	size = evictEntries();
+}
+
+///
+/// Scans the cache and evicts the least recently used entries when the cache
+/// is larger than its maximal size.
+///
+/// @returns Size of the cache after the eviction.
+///
+/// The eviction is guarded by a lock file, so only a single process evicts
+/// entries at a time.
+///
+std::uint64_t ResultCache::evictEntries() {
+	auto lockFilePath = joinPaths(directoryPath, LockFileName);
+	std::ofstream(lockFilePath, std::ios::app);
+	boost::interprocess::file_lock lockFile(lockFilePath.c_str());
+	boost::interprocess::scoped_lock<boost::interprocess::file_lock> lock(lockFile);
+
+	///
+	/// Entry of the cache.
+	///
+	struct Entry {
+		/// Path to the entry.
+		boost::filesystem::path path;
+
+		/// Time of the last use.
+		std::time_t lastUseTime;
+
+		/// Size of the entry (in bytes).
+		std::uint64_t size;
+	};
+
+	std::vector<Entry> entries;
+	std::uint64_t totalSize = 0;
+	for (boost::filesystem::directory_iterator it(directoryPath), end;
+			it != end; ++it) {
+		if (!boost::filesystem::is_directory(it->path())) {
+			continue;
+		}
+		Entry entry{it->path(), boost::filesystem::last_write_time(it->path()),
+			directorySize(it->path())};
+		totalSize += entry.size;
+		entries.push_back(entry);
+	}
+	if (totalSize <= maxSize) {
+		return totalSize;
+	}
+
+	std::sort(entries.begin(), entries.end(),
+		[](const Entry &e1, const Entry &e2) {
+			return e1.lastUseTime < e2.lastUseTime;
+		}
+	);
+	auto targetSize = maxSize - maxSize / EvictionFreeFractionReciprocal;
+	for (const auto &entry : entries) {
+		if (totalSize <= targetSize) {
+			break;
+		}
+		boost::system::error_code ec;
+		boost::filesystem::remove_all(entry.path, ec);
+		totalSize -= entry.size;
+	}
+	return totalSize;
+}
+
+///
+/// Returns the name of the response to a GET request to the given path
+/// (relative to the URL of a resource, e.g. @c outputs/hll) in an entry.
+///
+/// Outputs are under nested paths, so slashes are replaced because the name
+/// cannot contain them.
+///
+std::string ResultCache::responseName(const std::string &path) {
+	auto name = path;
+	std::replace(name.begin(), name.end(), '/', '-');
+	return name;
+}
+
+/// Name of the response with the status of a resource.
+const std::string ResultCache::StatusResponseName = "status";
+
+} // namespace internal
+} // namespace retdec
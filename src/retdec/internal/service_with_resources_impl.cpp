@@ -6,11 +6,40 @@
 ///            services with resources.
 ///
 
+#include "retdec/exceptions.h"
+#include "retdec/internal/connections/caching_connection.h"
+#include "retdec/internal/connections/journaling_connection.h"
+#include "retdec/internal/connections/sharing_connection.h"
+#include "retdec/internal/io_service.h"
 #include "retdec/internal/service_with_resources_impl.h"
+#include "retdec/internal/utilities/resource.h"
+#include "retdec/metrics.h"
+#include "retdec/tracer.h"
 
 namespace retdec {
 namespace internal {
 
+namespace {
+
+///
+/// Returns the context in which resources of a service with the given
+/// settings are created (without a mode).
+///
+ResourceContext resourceContextFor(const Settings &settings) {
+	ResourceContext context;
+	context.ioService = IoService::shared(settings.ioThreadCount());
+	context.pollingPolicy = settings.pollingPolicy();
+	if (settings.metrics()) {
+		context.metrics = settings.metrics()->registry();
+	}
+	if (settings.tracer()) {
+		context.traceBuffer = settings.tracer()->buffer();
+	}
+	return context;
+}
+
+} // anonymous namespace
+
 ///
 /// Constructs a private implementation.
 ///
@@ -18,18 +47,223 @@ namespace internal {
 /// @param[in] connectionManager Manager of connections.
 /// @param[in] serviceName Name of the service.
 /// @param[in] resourcesName Name of the resources (plural).
+/// @param[in] outputPaths Paths to the outputs of the resources (relative to
+///                        their URLs). They are stored into the result cache
+///                        together with the resources.
 ///
 ServiceWithResourcesImpl::ServiceWithResourcesImpl(const Settings &settings,
 		const std::shared_ptr<ConnectionManager> &connectionManager,
 		const std::string &serviceName,
-		const std::string &resourcesName):
+		const std::string &resourcesName,
+		const std::vector<std::string> &outputPaths):
 	ServiceImpl(settings, connectionManager, serviceName),
-	resourcesUrl(baseUrl + "/" + resourcesName) {}
+	resourcesName(resourcesName),
+	resourcesUrl(baseUrl + "/" + resourcesName),
+	outputPaths(outputPaths),
+	resourceContext(resourceContextFor(settings)),
+	resultCache(settings.resultCacheDirectory().empty() ? nullptr :
+		std::make_shared<ResultCache>(settings.resultCacheDirectory(),
+			settings.resultCacheMaxSize())),
+	inFlightResources(settings.deduplicateRuns() ?
+		std::make_shared<InFlightResources>() : nullptr),
+	journal(settings.journalPath().empty() ? nullptr :
+		std::make_shared<SubmissionJournal>(settings.journalPath())) {}
 
 ///
 /// Destructs the private implementation.
 ///
 ServiceWithResourcesImpl::~ServiceWithResourcesImpl() = default;
 
+///
+/// Returns the ID of the finished resource with the same key from the result
+/// cache.
+///
+/// When the result cache is disabled or it does not contain such a resource
+/// together with its outputs, it returns nothing.
+///
+boost::optional<std::string>
+ServiceWithResourcesImpl::ResourceCreator::cachedResourceId() const {
+	if (!resultCache || key.empty()) {
+		return boost::none;
+	}
+	return resultCache->finishedResourceId(key, outputPaths);
+}
+
+///
+/// Returns the ID of the resource from the response to the request that has
+/// started it.
+///
+/// The ID is stored into the result cache and the journal, and passed to the
+/// identical runs that wait for the resource to be started.
+///
+/// @throws ApiError When the request has failed.
+///
+std::string ServiceWithResourcesImpl::ResourceCreator::started(
+		const Connection::Response &response) const {
+	verifyRequestSucceeded(response);
+	auto jsonBody = response.bodyAsJson();
+	auto id = jsonBody.get("id", "?").asString();
+	if (resultCache) {
+		resultCache->storeResourceId(key, id);
+	}
+	if (journal) {
+		journal->append({resourcesUrl, id, key, context.mode});
+	}
+	if (inFlightResource) {
+		inFlightResource->started(id);
+	}
+	return id;
+}
+
+///
+/// Passes the error that occurred when the resource was started to the
+/// identical runs that wait for the resource to be started.
+///
+void ServiceWithResourcesImpl::ResourceCreator::failedToStart(
+		std::exception_ptr error) const {
+	if (inFlightResource) {
+		inFlightResource->failedToStart(error);
+	}
+}
+
+///
+/// Returns the connection to be used by the resource with the given ID.
+///
+/// The connection marks the resource as finished in the journal when it is
+/// enabled (once its outputs have been downloaded), caches the responses of the resource when the result cache is
+/// enabled, and shares them with other handles of the resource when runs are
+/// deduplicated.
+///
+std::shared_ptr<Connection>
+ServiceWithResourcesImpl::ResourceCreator::connectionFor(
+		const std::string &id) const {
+	auto resourceUrl = resourcesUrl + "/" + id;
+	auto resourceConn = conn;
+	if (journal) {
+		resourceConn = std::make_shared<JournalingConnection>(
+			resourceConn, journal, resourcesUrl, id, outputPaths);
+	}
+	if (resultCache && !key.empty()) {
+		resourceConn = std::make_shared<CachingConnection>(
+			resourceConn, resultCache, key, resourceUrl, outputPaths);
+	}
+	if (inFlightResource) {
+		resourceConn = std::make_shared<SharingConnection>(
+			resourceConn, inFlightResource, resourceUrl);
+	}
+	return resourceConn;
+}
+
+///
+/// Records the run of the resource with the given ID, which started at
+/// @a start, as a @c run span on the track of the resource (when it is
+/// traced).
+///
+void ServiceWithResourcesImpl::ResourceCreator::traceRun(
+		const std::string &id, TraceBuffer::Clock::time_point start) const {
+	if (context.traceBuffer) {
+		context.traceBuffer->recordSpan("run",
+			TraceBuffer::resourceTrack(resourcesName, id), start);
+	}
+}
+
+///
+/// Returns the IDs of all resources started by this service that are in the
+/// journal of started resources and have not been marked as finished, in the
+/// order in which they were started.
+///
+/// @throws Error When the journal is disabled.
+///
+std::vector<std::string> ServiceWithResourcesImpl::journaledResourceIds() const {
+	if (!journal) {
+		throw Error("the journal is disabled");
+	}
+
+	std::vector<std::string> ids;
+	for (const auto &record : journal->records(resourcesUrl)) {
+		if (!record.finished) {
+			ids.push_back(record.id);
+		}
+	}
+	return ids;
+}
+
+///
+/// Returns a creator of a resource with the given arguments.
+///
+/// It computes the key of the resource when it is needed.
+///
+ServiceWithResourcesImpl::ResourceCreator
+ServiceWithResourcesImpl::resourceCreatorFor(
+		const ResourceArguments &args) const {
+	std::string key;
+	if (resultCache || inFlightResources || journal) {
+		key = resourceKey(resourcesUrl, args);
+	}
+	return resourceCreator(args.argument("mode"), key);
+}
+
+///
+/// Returns a creator of a resource with the given mode and key.
+///
+/// It obtains a new connection to be used by the resource.
+///
+ServiceWithResourcesImpl::ResourceCreator
+ServiceWithResourcesImpl::resourceCreator(const std::string &mode,
+		const std::string &key) const {
+	ResourceCreator creator;
+	creator.conn = connectionManager->newConnection(settings);
+	creator.resourcesUrl = resourcesUrl;
+	creator.resourcesName = resourcesName;
+	creator.outputPaths = outputPaths;
+	creator.context = resourceContext;
+	creator.context.mode = mode;
+	creator.key = key;
+	creator.resultCache = resultCache;
+	creator.journal = journal;
+	return creator;
+}
+
+///
+/// Joins an identical run that is in progress.
+///
+/// @returns @c true when the resource has to be started by the caller,
+///          @c false when it is started by an identical run. In the latter
+///          case, the caller has to wait for
+///          @c creator.inFlightResource to be started.
+///
+/// When runs are not deduplicated, it always returns @c true.
+///
+bool ServiceWithResourcesImpl::joinInFlightResource(
+		ResourceCreator &creator) const {
+	if (!inFlightResources) {
+		return true;
+	}
+
+	auto joined = inFlightResources->join(creator.key);
+	creator.inFlightResource = joined.first;
+	return joined.second;
+}
+
+///
+/// Returns the record of the resource with the given ID started by this
+/// service from the journal of started resources.
+///
+/// @throws Error When the journal is disabled or it contains no such
+///               resource.
+///
+SubmissionJournal::Record ServiceWithResourcesImpl::journaledResource(
+		const std::string &id) const {
+	if (!journal) {
+		throw Error("the journal is disabled");
+	}
+
+	auto record = journal->find(resourcesUrl, id);
+	if (!record) {
+		throw Error("there is no resource with ID " + id + " in the journal");
+	}
+	return *record;
+}
+
 } // namespace internal
 } // namespace retdec
@@ -0,0 +1,504 @@
+///
+/// @file      retdec/internal/simulated_service.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the simulation of the services of the API.
+///
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <json/json.h>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/simulated_service.h"
+#include "retdec/internal/stored_response.h"
+#include "retdec/internal/utilities/json.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+/// Path to decompilations, relative to the API URL.
+const std::string DecompilationsPath = "/decompiler/decompilations";
+
+/// Path to analyses, relative to the API URL.
+const std::string AnalysesPath = "/fileinfo/analyses";
+
+/// Path to the echo sub-service, relative to the API URL.
+const std::string EchoPath = "/test/echo";
+
+///
+/// Does @a str end with @a suffix?
+///
+bool endsWith(const std::string &str, const std::string &suffix) {
+	return str.size() >= suffix.size() &&
+		str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+///
+/// Returns a response with the given status code and JSON body.
+///
+std::unique_ptr<Connection::Response> jsonResponse(int statusCode,
+		const std::string &statusMessage, const Json::Value &body) {
+	return std::make_unique<StoredResponse>(statusCode, statusMessage,
+		std::make_shared<const std::string>(toJsonString(body)), "");
+}
+
+///
+/// Returns a response with the given status code and an error in the format
+/// of the API.
+///
+std::unique_ptr<Connection::Response> errorResponse(int statusCode,
+		const std::string &statusMessage, const std::string &description) {
+	Json::Value body;
+	body["code"] = statusCode;
+	body["message"] = statusMessage;
+	body["description"] = description;
+	return jsonResponse(statusCode, statusMessage, body);
+}
+
+///
+/// Returns a response saying that the requested URL does not exist.
+///
+std::unique_ptr<Connection::Response> notFoundResponse() {
+	return errorResponse(404, "Not Found",
+		"The requested URL was not found on the server.");
+}
+
+} // anonymous namespace
+
+///
+/// Private implementation of SimulatedService.
+///
+struct SimulatedService::Impl {
+	///
+	/// Simulated resource.
+	///
+	struct Resource {
+		/// Time needed to process the resource.
+		Clock::Duration processingTime;
+
+		/// Does the resource fail?
+		bool fails = false;
+
+		/// Has a worker started processing the resource?
+		bool started = false;
+
+		/// When a worker started processing the resource (valid only when
+		/// @c started is @c true).
+		Clock::TimePoint startedAt;
+	};
+
+	/// Resource being processed, ordered by the time it finishes.
+	using RunningResource = std::pair<Clock::TimePoint, std::string>;
+
+public:
+	explicit Impl(const Config &config);
+
+	Clock::TimePoint receiveRequest();
+	bool chance(double probability);
+	Clock::Duration sample(const Distribution &distribution);
+
+	void runUntil(Clock::TimePoint now);
+	void startWaitingResources(Clock::TimePoint at);
+
+	std::unique_ptr<Connection::Response> createResource(
+		const std::string &resourcesPath);
+	std::unique_ptr<Connection::Response> resourceStatus(
+		const std::string &key, Clock::TimePoint now);
+	std::unique_ptr<Connection::Response> resourceOutput(
+		const std::string &key, const std::string &fileName,
+		Clock::TimePoint now);
+
+	bool isFinished(const Resource &resource, Clock::TimePoint now) const;
+	int completion(const Resource &resource, Clock::TimePoint now) const;
+
+	/// Configuration of the simulation.
+	const Config config;
+
+	/// Clock of the simulation.
+	const std::shared_ptr<VirtualClock> clock;
+
+	/// Output of resources.
+	const std::shared_ptr<const std::string> output;
+
+	/// Random number generator.
+	std::mt19937_64 random;
+
+	/// Resources by their keys (paths relative to the API URL).
+	std::unordered_map<std::string, Resource> resources;
+
+	/// Keys of resources waiting for a worker, in the order of their
+	/// creation.
+	std::deque<std::string> waitingResources;
+
+	/// Resources being processed, the one that finishes first on the top.
+	std::priority_queue<RunningResource, std::vector<RunningResource>,
+		std::greater<RunningResource>> runningResources;
+
+	/// Time up to which the processing of resources has been simulated.
+	Clock::TimePoint simulatedUntil;
+
+	/// Number of created resources.
+	std::size_t lastId = 0;
+
+	/// Statistics of the simulation.
+	Statistics statistics;
+
+	/// Mutex guarding the simulation.
+	boost::mutex mutex;
+};
+
+///
+/// Constructs a private implementation.
+///
+SimulatedService::Impl::Impl(const Config &config):
+	config(config),
+	clock(std::make_shared<VirtualClock>()),
+	output(std::make_shared<const std::string>(config.outputSize, 'x')),
+	random(config.seed),
+	simulatedUntil(clock->now()) {}
+
+///
+/// Counts a received request, moves the clock forward by its latency, and
+/// returns the time at which the request is handled.
+///
+Clock::TimePoint SimulatedService::Impl::receiveRequest() {
+	++statistics.requestCount;
+	clock->advance(sample(config.requestLatency));
+	auto now = clock->now();
+	runUntil(now);
+	return now;
+}
+
+///
+/// Returns @c true with the given probability.
+///
+bool SimulatedService::Impl::chance(double probability) {
+	// Do not draw a number when it is not needed so that the sequence of
+	// random numbers does not depend on disabled features.
+	if (probability <= 0.0) {
+		return false;
+	}
+	return std::uniform_real_distribution<double>(0.0, 1.0)(random) <
+		probability;
+}
+
+///
+/// Returns a random non-negative duration from the given distribution.
+///
+Clock::Duration SimulatedService::Impl::sample(
+		const Distribution &distribution) {
+	return std::max<Clock::Duration>(distribution(random),
+		Clock::Duration::zero());
+}
+
+///
+/// Simulates the processing of resources up to the given time.
+///
+/// When a resource finishes, the first waiting resource starts at the time of
+/// its finish.
+///
+void SimulatedService::Impl::runUntil(Clock::TimePoint now) {
+	startWaitingResources(simulatedUntil);
+	while (!runningResources.empty() && runningResources.top().first <= now) {
+		auto finishedAt = runningResources.top().first;
+		runningResources.pop();
+		++statistics.finishedResourceCount;
+		startWaitingResources(finishedAt);
+	}
+	simulatedUntil = std::max(simulatedUntil, now);
+}
+
+///
+/// Starts processing waiting resources at the given time while there are free
+/// workers.
+///
+void SimulatedService::Impl::startWaitingResources(Clock::TimePoint at) {
+	while (!waitingResources.empty() && (config.workerCount == 0 ||
+			runningResources.size() < config.workerCount)) {
+		auto key = std::move(waitingResources.front());
+		waitingResources.pop_front();
+		auto &resource = resources.at(key);
+		resource.started = true;
+		resource.startedAt = at;
+		runningResources.emplace(at + resource.processingTime, std::move(key));
+	}
+}
+
+///
+/// Creates a resource under the given path and returns its ID.
+///
+std::unique_ptr<Connection::Response> SimulatedService::Impl::createResource(
+		const std::string &resourcesPath) {
+	auto id = std::to_string(++lastId);
+	auto key = resourcesPath + "/" + id;
+
+	Resource resource;
+	resource.processingTime = sample(config.processingTime);
+	resource.fails = chance(config.failureRate);
+	resources.emplace(key, resource);
+	++statistics.createdResourceCount;
+
+	waitingResources.push_back(key);
+	statistics.maxQueueLength = std::max(statistics.maxQueueLength,
+		waitingResources.size());
+	runUntil(clock->now());
+
+	Json::Value body;
+	body["id"] = id;
+	return jsonResponse(201, "Created", body);
+}
+
+///
+/// Returns the status of the resource with the given key at the given time.
+///
+std::unique_ptr<Connection::Response> SimulatedService::Impl::resourceStatus(
+		const std::string &key, Clock::TimePoint now) {
+	auto it = resources.find(key);
+	if (it == resources.end()) {
+		return notFoundResponse();
+	}
+
+	const auto &resource = it->second;
+	auto finished = isFinished(resource, now);
+	Json::Value body;
+	body["finished"] = finished;
+	body["succeeded"] = finished && !resource.fails;
+	body["failed"] = finished && resource.fails;
+	body["error"] = finished && resource.fails ?
+		Json::Value("The failure has been simulated.") : Json::Value();
+	body["completion"] = completion(resource, now);
+	return jsonResponse(200, "OK", body);
+}
+
+///
+/// Returns the output of the resource with the given key at the given time.
+///
+/// The output is available only when the resource has succeeded.
+///
+std::unique_ptr<Connection::Response> SimulatedService::Impl::resourceOutput(
+		const std::string &key, const std::string &fileName,
+		Clock::TimePoint now) {
+	auto it = resources.find(key);
+	if (it == resources.end()) {
+		return notFoundResponse();
+	}
+
+	const auto &resource = it->second;
+	if (!isFinished(resource, now) || resource.fails) {
+		return errorResponse(404, "Not Found",
+			"The output is not available.");
+	}
+	return std::make_unique<StoredResponse>(200, "OK", output, fileName);
+}
+
+///
+/// Has the given resource finished at the given time?
+///
+bool SimulatedService::Impl::isFinished(const Resource &resource,
+		Clock::TimePoint now) const {
+	return resource.started &&
+		resource.startedAt + resource.processingTime <= now;
+}
+
+///
+/// Returns the completion (0-100) of the given resource at the given time.
+///
+/// It grows linearly over the processing time, but unfinished resources never
+/// report a completion of 100.
+///
+int SimulatedService::Impl::completion(const Resource &resource,
+		Clock::TimePoint now) const {
+	if (isFinished(resource, now)) {
+		return 100;
+	} else if (!resource.started) {
+		return 0;
+	}
+
+	auto elapsed = now - resource.startedAt;
+	return std::min(99, static_cast<int>(
+		elapsed * 100 / resource.processingTime));
+}
+
+///
+/// Constructs a simulation with the given configuration.
+///
+SimulatedService::SimulatedService(const Config &config):
+	impl(std::make_unique<Impl>(config)) {}
+
+///
+/// Destructs the simulation.
+///
+SimulatedService::~SimulatedService() = default;
+
+///
+/// Handles a GET request and returns the response.
+///
+/// URLs are matched by their ends, so the simulation can be used with any API
+/// URL.
+///
+std::unique_ptr<Connection::Response> SimulatedService::sendGetRequest(
+		const Connection::Url &url,
+		const Connection::RequestArguments &args) {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	auto now = impl->receiveRequest();
+	if (endsWith(url, "/status")) {
+		++impl->statistics.statusRequestCount;
+	}
+	if (impl->chance(impl->config.errorRate)) {
+		++impl->statistics.failedRequestCount;
+		return errorResponse(500, "Internal Server Error",
+			"The error has been simulated.");
+	}
+
+	if (endsWith(url, EchoPath)) {
+		Json::Value body(Json::objectValue);
+		for (const auto &arg : args) {
+			body[arg.first] = arg.second;
+		}
+		return jsonResponse(200, "OK", body);
+	}
+
+	auto decompilationsPos = url.find(DecompilationsPath + "/");
+	auto analysesPos = url.find(AnalysesPath + "/");
+	if (decompilationsPos != std::string::npos) {
+		auto path = url.substr(decompilationsPos);
+		if (endsWith(path, "/status")) {
+			return impl->resourceStatus(
+				path.substr(0, path.size() - 7), now);
+		} else if (endsWith(path, "/outputs/hll")) {
+			auto key = path.substr(0, path.size() - 12);
+			auto id = key.substr(DecompilationsPath.size() + 1);
+			return impl->resourceOutput(key, id + ".c", now);
+		}
+	} else if (analysesPos != std::string::npos) {
+		auto path = url.substr(analysesPos);
+		if (endsWith(path, "/status")) {
+			return impl->resourceStatus(
+				path.substr(0, path.size() - 7), now);
+		} else if (endsWith(path, "/output")) {
+			auto key = path.substr(0, path.size() - 7);
+			auto id = key.substr(AnalysesPath.size() + 1);
+			return impl->resourceOutput(key, id + ".txt", now);
+		}
+	}
+	return notFoundResponse();
+}
+
+///
+/// Handles a POST request and returns the response.
+///
+/// The uploaded files are not read; only the creation of a resource is
+/// simulated.
+///
+std::unique_ptr<Connection::Response> SimulatedService::sendPostRequest(
+		const Connection::Url &url,
+		const Connection::RequestArguments &,
+		const Connection::RequestFiles &) {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	impl->receiveRequest();
+	if (impl->chance(impl->config.errorRate)) {
+		++impl->statistics.failedRequestCount;
+		return errorResponse(500, "Internal Server Error",
+			"The error has been simulated.");
+	}
+
+	if (endsWith(url, DecompilationsPath)) {
+		return impl->createResource(DecompilationsPath);
+	} else if (endsWith(url, AnalysesPath)) {
+		return impl->createResource(AnalysesPath);
+	}
+	return notFoundResponse();
+}
+
+///
+/// Returns the clock of the simulation.
+///
+std::shared_ptr<VirtualClock> SimulatedService::clock() const {
+	return impl->clock;
+}
+
+///
+/// Returns the statistics of the simulation so far.
+///
+SimulatedService::Statistics SimulatedService::statistics() const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	// Count also the resources that have finished since the last request.
+	impl->runUntil(impl->clock->now());
+	return impl->statistics;
+}
+
+///
+/// Returns a distribution always returning the given duration.
+///
+SimulatedService::Distribution SimulatedService::fixed(
+		std::chrono::milliseconds duration) {
+	return [duration](std::mt19937_64 &) { return duration; };
+}
+
+///
+/// Returns a distribution returning durations uniformly distributed between
+/// @a min and @a max (inclusive).
+///
+SimulatedService::Distribution SimulatedService::uniform(
+		std::chrono::milliseconds min, std::chrono::milliseconds max) {
+	return [min, max](std::mt19937_64 &random) {
+		return std::chrono::milliseconds(
+			std::uniform_int_distribution<std::chrono::milliseconds::rep>(
+				min.count(), std::max(min, max).count())(random));
+	};
+}
+
+///
+/// Returns a distribution returning exponentially distributed durations with
+/// the given mean.
+///
+/// It models, e.g., times between independent events.
+///
+SimulatedService::Distribution SimulatedService::exponential(
+		std::chrono::milliseconds mean) {
+	if (mean <= std::chrono::milliseconds::zero()) {
+		return fixed(std::chrono::milliseconds::zero());
+	}
+
+	std::exponential_distribution<double> distribution(
+		1.0 / static_cast<double>(mean.count()));
+	return [distribution](std::mt19937_64 &random) mutable {
+		return std::chrono::milliseconds(std::llround(distribution(random)));
+	};
+}
+
+///
+/// Returns a distribution returning log-normally distributed durations with
+/// the given median.
+///
+/// It models, e.g., latencies and processing times, which are mostly close to
+/// the median but sometimes much longer. The larger @a sigma is, the longer
+/// the tail.
+///
+SimulatedService::Distribution SimulatedService::logNormal(
+		std::chrono::milliseconds median, double sigma) {
+	if (median <= std::chrono::milliseconds::zero()) {
+		return fixed(std::chrono::milliseconds::zero());
+	}
+
+	std::lognormal_distribution<double> distribution(
+		std::log(static_cast<double>(median.count())), sigma);
+	return [distribution](std::mt19937_64 &random) mutable {
+		return std::chrono::milliseconds(std::llround(distribution(random)));
+	};
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,147 @@
+///
+/// @file      retdec/internal/status_poller.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the poller of statuses of resources.
+///
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/status_poller.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Private implementation of StatusPoller.
+///
+struct StatusPoller::Impl {
+	/// Clock used to schedule the updates.
+	using Clock = std::chrono::steady_clock;
+
+	Impl(const std::shared_ptr<IoService> &ioService):
+		ioService(ioService),
+		timer(*ioService->asioService()) {}
+
+	/// I/O service running the updates. It has to outlive the timer.
+	const std::shared_ptr<IoService> ioService;
+
+	/// Timer expiring when the earliest update is due.
+	boost::asio::steady_timer timer;
+
+	/// Scheduled updates, ordered by the time they are due.
+	std::multimap<Clock::time_point, StatusUpdate> updates;
+
+	/// Mutex guarding the updates and the timer.
+	mutable boost::mutex mutex;
+};
+
+///
+/// Constructs a poller running the updates on the given I/O service.
+///
+StatusPoller::StatusPoller(const std::shared_ptr<IoService> &ioService):
+	impl(std::make_unique<Impl>(ioService)) {}
+
+///
+/// Destructs the poller.
+///
+/// Updates that have not been run yet are dropped.
+///
+StatusPoller::~StatusPoller() = default;
+
+///
+/// Schedules the given update to be run after the given delay.
+///
+/// The update is run from a thread of the I/O service. It should not throw.
+///
+void StatusPoller::schedule(std::chrono::milliseconds delay,
+		const StatusUpdate &update) {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	auto due = Impl::Clock::now() + delay;
+	auto inserted = impl->updates.emplace(due, update);
+	// Only an update that is due before all the other ones changes the time
+	// at which the timer has to expire.
+	if (inserted == impl->updates.begin()) {
+		startTimer();
+	}
+}
+
+///
+/// Returns the number of updates that have been scheduled but not run yet.
+///
+std::size_t StatusPoller::scheduledCount() const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	return impl->updates.size();
+}
+
+///
+/// Returns the poller shared by all resources using the given I/O service.
+///
+/// The poller is created upon the first call and destructed when it is no
+/// longer used.
+///
+std::shared_ptr<StatusPoller> StatusPoller::shared(
+		const std::shared_ptr<IoService> &ioService) {
+	static boost::mutex mutex;
+	static std::map<IoService *, std::weak_ptr<StatusPoller>> pollers;
+
+	boost::lock_guard<boost::mutex> lock(mutex);
+	auto &poller = pollers[ioService.get()];
+	auto sharedPoller = poller.lock();
+	if (!sharedPoller) {
+		sharedPoller = std::make_shared<StatusPoller>(ioService);
+		poller = sharedPoller;
+	}
+	return sharedPoller;
+}
+
+///
+/// Runs all the updates that are due and restarts the timer.
+///
+void StatusPoller::runDueUpdates() {
+	std::vector<StatusUpdate> dueUpdates;
+	{
+		boost::lock_guard<boost::mutex> lock(impl->mutex);
+		auto firstNotDue = impl->updates.upper_bound(Impl::Clock::now());
+		for (auto it = impl->updates.begin(); it != firstNotDue; ++it) {
+			dueUpdates.push_back(std::move(it->second));
+		}
+		impl->updates.erase(impl->updates.begin(), firstNotDue);
+		if (!impl->updates.empty()) {
+			startTimer();
+		}
+	}
+
+	// Run the updates without holding the lock because they usually schedule
+	// further updates.
+	for (auto &update : dueUpdates) {
+		update();
+	}
+}
+
+///
+/// (Re)starts the timer so it expires when the earliest update is due.
+///
+/// The caller has to hold the lock and there has to be at least one update.
+///
+void StatusPoller::startTimer() {
+	// Setting the expiry time cancels the pending wait (if any).
+	impl->timer.expires_at(impl->updates.begin()->first);
+	// The poller is kept alive until the timer expires.
+	auto self = shared_from_this();
+	impl->timer.async_wait([self](const boost::system::error_code &ec) {
+		if (!ec) {
+			self->runDueUpdates();
+		}
+	});
+}
+
+} // namespace internal
+} // namespace retdec
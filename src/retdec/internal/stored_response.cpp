@@ -0,0 +1,89 @@
+///
+/// @file      retdec/internal/stored_response.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the response stored in memory.
+///
+
+#include <utility>
+
+#include "retdec/internal/files/string_file.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/stored_response.h"
+#include "retdec/internal/utilities/json.h"
+
+namespace retdec {
+namespace internal {
+
+///
+/// Constructs a response.
+///
+/// @param[in] statusCode Status code.
+/// @param[in] statusMessage Status message.
+/// @param[in] body Body.
+/// @param[in] attachedFileName Name of the attached file (empty when there is
+///                             no attached file).
+///
+StoredResponse::StoredResponse(int statusCode,
+		const std::string &statusMessage,
+		std::shared_ptr<const std::string> body,
+		const std::string &attachedFileName):
+	code(statusCode), message(statusMessage), body_(std::move(body)),
+	fileName(attachedFileName) {}
+
+///
+/// Constructs a copy of the given response.
+///
+/// The body is obtained by calling @c sharedBody(), so it is not copied when
+/// the response shares it.
+///
+StoredResponse::StoredResponse(const Connection::Response &response):
+	StoredResponse(response.statusCode(), response.statusMessage(),
+		response.sharedBody(), response.attachedFileName()) {}
+
+// Override.
+StoredResponse::~StoredResponse() = default;
+
+// Override.
+int StoredResponse::statusCode() const {
+	return code;
+}
+
+// Override.
+std::string StoredResponse::statusMessage() const {
+	return message;
+}
+
+// Override.
+std::string StoredResponse::body() const {
+	return *body_;
+}
+
+// Override.
+std::shared_ptr<const std::string> StoredResponse::sharedBody() const {
+	return body_;
+}
+
+// Override.
+Json::Value StoredResponse::bodyAsJson() const {
+	return toJson(*body_);
+}
+
+// Override.
+ResourceStatus StoredResponse::bodyAsStatus() const {
+	return ResourceStatus::fromBody(body_->data(),
+		body_->data() + body_->size());
+}
+
+// Override.
+std::unique_ptr<File> StoredResponse::bodyAsFile() const {
+	return std::make_unique<StringFile>(body_, fileName);
+}
+
+// Override.
+std::string StoredResponse::attachedFileName() const {
+	return fileName;
+}
+
+} // namespace internal
+} // namespace retdec
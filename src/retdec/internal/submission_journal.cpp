@@ -0,0 +1,451 @@
+///
+/// @file      retdec/internal/submission_journal.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the persistent journal of started resources.
+///
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/optional.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+#include <json/json.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/submission_journal.h"
+#include "retdec/internal/utilities/json.h"
+#include "retdec/internal/utilities/os.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Lock of the lock file of a journal, which guards the journal file against
+/// other processes. It is released upon destruction.
+///
+class JournalFileLock {
+public:
+	///
+	/// Locks the given lock file, which is created when it does not exist.
+	///
+	/// @throws FilesystemError When the file cannot be locked.
+	///
+	explicit JournalFileLock(const std::string &lockFilePath) {
+		std::ofstream(lockFilePath, std::ios::out | std::ios::app);
+		try {
+			lockFile = boost::interprocess::file_lock(lockFilePath.c_str());
+			lockFile.lock();
+		} catch (const boost::interprocess::interprocess_exception &) {
+			throw FilesystemError(
+				"cannot lock journal file \"" + lockFilePath + "\"");
+		}
+	}
+
+	///
+	/// Unlocks the lock file.
+	///
+	/// Errors are ignored because destructors must not throw. The lock is
+	/// released anyway when the file is closed.
+	///
+	~JournalFileLock() {
+		try {
+			lockFile.unlock();
+		} catch (...) {
+			// Ignore.
+		}
+	}
+
+	JournalFileLock(const JournalFileLock &) = delete;
+	JournalFileLock &operator=(const JournalFileLock &) = delete;
+
+private:
+	/// Locked file.
+	boost::interprocess::file_lock lockFile;
+};
+
+///
+/// Returns the given JSON value as a line to be appended to the journal.
+///
+/// The line also starts with a new line, which terminates an incomplete line
+/// written during a crash, so it does not corrupt the appended one.
+///
+std::string journalLine(const Json::Value &value) {
+	return "\n" + toJsonString(value) + "\n";
+}
+
+///
+/// Returns the key under which the record of the resource with the given ID
+/// started by the given service is indexed.
+///
+std::string recordKey(const std::string &service, const std::string &id) {
+	return service + '\n' + id;
+}
+
+///
+/// Version of the journal file.
+///
+/// When the version of the file is the same as when it was indexed, the file
+/// has not been changed since then.
+///
+struct FileVersion {
+	/// Size of the file (in bytes).
+	std::uint64_t size;
+
+	/// Time of the last modification of the file.
+	std::time_t lastWriteTime;
+
+	bool operator==(const FileVersion &other) const {
+		return size == other.size && lastWriteTime == other.lastWriteTime;
+	}
+};
+
+///
+/// Returns the current version of the given file.
+///
+/// @throws FilesystemError When the file does not exist.
+///
+FileVersion fileVersion(const std::string &path) {
+	boost::system::error_code sizeError;
+	auto size = boost::filesystem::file_size(path, sizeError);
+	boost::system::error_code timeError;
+	auto lastWriteTime = boost::filesystem::last_write_time(path, timeError);
+	if (sizeError || timeError) {
+		throw FilesystemError("cannot read journal file \"" + path + "\"");
+	}
+	return FileVersion{size, lastWriteTime};
+}
+
+} // anonymous namespace
+
+///
+/// Private implementation of SubmissionJournal.
+///
+/// The caller of the member functions has to hold both @c mutex and
+/// JournalFileLock of the lock file.
+///
+struct SubmissionJournal::Impl {
+	Impl(const std::string &path);
+
+	void indexIfNeeded();
+	void indexLine(const std::string &line);
+	void indexRecord(const Record &record);
+	void indexFinishedMark(const std::string &service, const std::string &id);
+	void append(const std::string &line, const std::function<void ()> &index);
+	void compactIfNeeded();
+	void clearIndex();
+
+	/// Path to the journal file.
+	const std::string path;
+
+	/// Path to the lock file guarding the journal file against other
+	/// processes.
+	const std::string lockFilePath;
+
+	/// Mutex guarding the journal against other threads.
+	boost::mutex mutex;
+
+	/// Indexed records, in the order in which they were appended.
+	std::vector<Record> records;
+
+	/// Positions of the indexed records in @c records by their keys (see
+	/// recordKey()).
+	std::unordered_map<std::string, std::size_t> recordPositions;
+
+	/// Number of indexed records of finished resources.
+	std::size_t finishedRecordCount = 0;
+
+	/// Version of the file when it was indexed (nothing when it has not been
+	/// indexed).
+	boost::optional<FileVersion> indexedVersion;
+};
+
+///
+/// Constructs a private implementation.
+///
+SubmissionJournal::Impl::Impl(const std::string &path):
+	path(path), lockFilePath(path + ".lock") {}
+
+///
+/// Indexes the journal file when it has not been indexed yet or it has been
+/// changed by another process since then.
+///
+/// @throws FilesystemError When the journal file cannot be read.
+///
+void SubmissionJournal::Impl::indexIfNeeded() {
+	auto version = fileVersion(path);
+	if (indexedVersion && *indexedVersion == version) {
+		return;
+	}
+
+	clearIndex();
+	auto content = readFile(path);
+	std::size_t lineStart = 0;
+	for (auto lineEnd = content.find('\n'); lineEnd != std::string::npos;
+			lineEnd = content.find('\n', lineStart)) {
+		indexLine(content.substr(lineStart, lineEnd - lineStart));
+		lineStart = lineEnd + 1;
+	}
+	// The last line is not terminated only when it is incomplete, and it gets
+	// terminated when the next line is appended.
+	indexedVersion = version;
+}
+
+///
+/// Indexes the given line of the journal file.
+///
+void SubmissionJournal::Impl::indexLine(const std::string &line) {
+	if (line.empty()) {
+		return;
+	}
+
+	try {
+		auto jsonLine = toJson(line);
+		if (!jsonLine.isObject() || !jsonLine.isMember("id")) {
+			return;
+		}
+
+		auto service = jsonLine.get("service", "").asString();
+		auto id = jsonLine.get("id", "").asString();
+		if (jsonLine.get("finished", false).asBool()) {
+			indexFinishedMark(service, id);
+		} else {
+			indexRecord(Record{
+				service,
+				id,
+				jsonLine.get("key", "").asString(),
+				jsonLine.get("mode", "").asString()
+			});
+		}
+	} catch (const JsonDecodingError &) {
+		// An incomplete line written during a crash.
+	}
+}
+
+///
+/// Indexes the given record.
+///
+/// When there already is a record of the same resource, it is kept.
+///
+void SubmissionJournal::Impl::indexRecord(const Record &record) {
+	auto inserted = recordPositions.emplace(
+		recordKey(record.service, record.id), records.size());
+	if (inserted.second) {
+		records.push_back(record);
+	}
+}
+
+///
+/// Marks the indexed record of the resource with the given ID started by the
+/// given service as finished.
+///
+void SubmissionJournal::Impl::indexFinishedMark(const std::string &service,
+		const std::string &id) {
+	auto it = recordPositions.find(recordKey(service, id));
+	if (it == recordPositions.end() || records[it->second].finished) {
+		return;
+	}
+
+	records[it->second].finished = true;
+	++finishedRecordCount;
+}
+
+///
+/// Appends the given line to the journal file and calls @a index to index it
+/// when the index is up to date.
+///
+/// @throws FilesystemError When the journal file cannot be written.
+///
+void SubmissionJournal::Impl::append(const std::string &line,
+		const std::function<void ()> &index) {
+	auto versionBeforeAppend = fileVersion(path);
+	appendToFile(path, line);
+	// Other processes do not change the file while the lock file is locked,
+	// so the index stays up to date when it was up to date before appending.
+	if (indexedVersion && *indexedVersion == versionBeforeAppend) {
+		index();
+		indexedVersion = fileVersion(path);
+	}
+}
+
+///
+/// Compacts the journal file when most of its records are of finished
+/// resources.
+///
+/// The records of finished resources are removed. The file is written
+/// atomically, so a crash during the compaction loses no records.
+///
+/// @throws FilesystemError When the journal file cannot be written.
+///
+void SubmissionJournal::Impl::compactIfNeeded() {
+	if (finishedRecordCount < MinFinishedRecordsToCompact ||
+			finishedRecordCount * 2 < records.size()) {
+		return;
+	}
+
+	std::vector<Record> unfinishedRecords;
+	std::string content;
+	for (const auto &record : records) {
+		if (record.finished) {
+			continue;
+		}
+
+		Json::Value jsonRecord;
+		jsonRecord["service"] = record.service;
+		jsonRecord["id"] = record.id;
+		jsonRecord["key"] = record.key;
+		jsonRecord["mode"] = record.mode;
+		content += toJsonString(jsonRecord) + "\n";
+		unfinishedRecords.push_back(record);
+	}
+	writeFile(path, content);
+
+	clearIndex();
+	for (const auto &record : unfinishedRecords) {
+		indexRecord(record);
+	}
+	indexedVersion = fileVersion(path);
+}
+
+///
+/// Clears the index.
+///
+void SubmissionJournal::Impl::clearIndex() {
+	records.clear();
+	recordPositions.clear();
+	finishedRecordCount = 0;
+	indexedVersion = boost::none;
+}
+
+///
+/// Constructs a journal stored in the given file.
+///
+/// @param[in] path Path to the journal file. It is created when it does not
+///                 exist.
+///
+/// @throws FilesystemError When the file cannot be opened for appending.
+///
+SubmissionJournal::SubmissionJournal(const std::string &path):
+		impl(std::make_unique<Impl>(path)) {
+	std::ofstream file(path, std::ios::out | std::ios::app | std::ios::binary);
+	if (!file) {
+		throw FilesystemError("cannot open journal file \"" + path + "\"");
+	}
+}
+
+///
+/// Destructs the journal.
+///
+SubmissionJournal::~SubmissionJournal() = default;
+
+///
+/// Appends the given record to the journal.
+///
+/// The whole record is written by a single append and flushed to the disk
+/// right away. Errors are ignored because the resource has already been
+/// started, and it should not get lost because it cannot be journaled.
+///
+void SubmissionJournal::append(const Record &record) {
+	Json::Value jsonRecord;
+	jsonRecord["service"] = record.service;
+	jsonRecord["id"] = record.id;
+	jsonRecord["key"] = record.key;
+	jsonRecord["mode"] = record.mode;
+	auto line = journalLine(jsonRecord);
+
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	try {
+		JournalFileLock fileLock(impl->lockFilePath);
+		impl->append(line, [&]() { impl->indexRecord(record); });
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+///
+/// Marks the resource with the given ID started by the given service as
+/// finished.
+///
+/// The journal is compacted when most of its records are of finished
+/// resources. Errors are ignored because the resource has already finished.
+///
+void SubmissionJournal::markFinished(const std::string &service,
+		const std::string &id) {
+	Json::Value jsonMark;
+	jsonMark["service"] = service;
+	jsonMark["id"] = id;
+	jsonMark["finished"] = true;
+	auto line = journalLine(jsonMark);
+
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	try {
+		JournalFileLock fileLock(impl->lockFilePath);
+		impl->indexIfNeeded();
+		auto it = impl->recordPositions.find(recordKey(service, id));
+		if (it == impl->recordPositions.end() ||
+				impl->records[it->second].finished) {
+			return;
+		}
+
+		impl->append(line, [&]() { impl->indexFinishedMark(service, id); });
+		impl->compactIfNeeded();
+	} catch (...) {
+		// Ignore.
+	}
+}
+
+///
+/// Returns the record of the resource with the given ID that has been started
+/// by the given service.
+///
+/// When there is no such record, it returns nothing.
+///
+/// @throws FilesystemError When the journal file cannot be read.
+///
+boost::optional<SubmissionJournal::Record> SubmissionJournal::find(
+		const std::string &service, const std::string &id) const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	JournalFileLock fileLock(impl->lockFilePath);
+	impl->indexIfNeeded();
+	auto it = impl->recordPositions.find(recordKey(service, id));
+	if (it == impl->recordPositions.end()) {
+		return boost::none;
+	}
+	return impl->records[it->second];
+}
+
+///
+/// Returns the records of all resources started by the given service, in the
+/// order in which they were started.
+///
+/// @throws FilesystemError When the journal file cannot be read.
+///
+std::vector<SubmissionJournal::Record> SubmissionJournal::records(
+		const std::string &service) const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	JournalFileLock fileLock(impl->lockFilePath);
+	impl->indexIfNeeded();
+	std::vector<Record> records;
+	for (const auto &record : impl->records) {
+		if (record.service == service) {
+			records.push_back(record);
+		}
+	}
+	return records;
+}
+
+/// Minimal number of records of finished resources in the file for the file
+/// to be compacted.
+const std::size_t SubmissionJournal::MinFinishedRecordsToCompact = 64;
+
+} // namespace internal
+} // namespace retdec
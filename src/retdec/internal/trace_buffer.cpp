@@ -0,0 +1,322 @@
+///
+/// @file      retdec/internal/trace_buffer.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the ring buffer of trace events and spans
+///            recording them.
+///
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <utility>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/trace_buffer.h"
+#include "retdec/internal/utilities/json.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Returns the number of microseconds from @a origin to @a time.
+///
+Json::Int64 microsecondsSince(TraceBuffer::Clock::time_point origin,
+		TraceBuffer::Clock::time_point time) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		time - origin).count();
+}
+
+///
+/// Returns the number of microseconds of @a duration.
+///
+Json::Int64 microseconds(TraceBuffer::Clock::duration duration) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		duration).count();
+}
+
+} // anonymous namespace
+
+///
+/// Private implementation of TraceBuffer.
+///
+struct TraceBuffer::Impl {
+	explicit Impl(std::size_t capacity):
+		capacity(std::max<std::size_t>(capacity, 1)),
+		origin(Clock::now()) {}
+
+	/// Maximal number of kept events.
+	const std::size_t capacity;
+
+	/// Time from which timestamps of events are computed.
+	const Clock::time_point origin;
+
+	/// Kept events. Once there are @c capacity events, @c next points to the
+	/// oldest one.
+	std::vector<Event> events;
+
+	/// Index into @c events at which the next event is stored once the
+	/// buffer is full.
+	std::size_t next = 0;
+
+	/// Mutex guarding the events.
+	mutable boost::mutex mutex;
+};
+
+///
+/// Constructs an empty buffer keeping at most @a capacity events.
+///
+TraceBuffer::TraceBuffer(std::size_t capacity):
+	impl(std::make_unique<Impl>(capacity)) {}
+
+///
+/// Destructs the buffer.
+///
+TraceBuffer::~TraceBuffer() = default;
+
+///
+/// Records the given event.
+///
+/// When the buffer is full, the oldest event is overwritten.
+///
+void TraceBuffer::record(Event event) {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	if (impl->events.size() < impl->capacity) {
+		impl->events.push_back(std::move(event));
+		return;
+	}
+
+	impl->events[impl->next] = std::move(event);
+	impl->next = (impl->next + 1) % impl->capacity;
+}
+
+///
+/// Records a span with the given name and arguments on the given track that
+/// started at @a start and has just ended.
+///
+void TraceBuffer::recordSpan(const std::string &name,
+		const std::string &track, Clock::time_point start,
+		const Json::Value &args) {
+	Event event;
+	event.name = name;
+	event.track = track;
+	event.thread = currentThread();
+	event.start = start;
+	event.duration = Clock::now() - start;
+	event.args = args;
+	record(std::move(event));
+}
+
+///
+/// Records an instant event with the given name and arguments that has just
+/// happened on the given track.
+///
+void TraceBuffer::recordInstant(const std::string &name,
+		const std::string &track, const Json::Value &args) {
+	Event event;
+	event.name = name;
+	event.track = track;
+	event.thread = currentThread();
+	event.start = Clock::now();
+	event.instant = true;
+	event.args = args;
+	record(std::move(event));
+}
+
+///
+/// Returns the kept events, from the oldest one to the most recent one.
+///
+std::vector<TraceBuffer::Event> TraceBuffer::events() const {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	std::vector<Event> events;
+	events.reserve(impl->events.size());
+	auto oldest = impl->events.begin() + static_cast<std::ptrdiff_t>(impl->next);
+	events.insert(events.end(), oldest, impl->events.end());
+	events.insert(events.end(), impl->events.begin(), oldest);
+	return events;
+}
+
+///
+/// Returns the kept events in the JSON format of Chrome trace events.
+///
+/// The result can be opened in @c chrome://tracing or Perfetto. Every track
+/// is shown as a separately named thread of a single process.
+///
+std::string TraceBuffer::toChromeTraceJson() const {
+	auto events = this->events();
+
+	Json::Value traceEvents(Json::arrayValue);
+	std::map<std::string, Json::Int64> trackIds;
+	auto trackId = [&](const Event &event) {
+		auto trackName = event.track.empty() ?
+			"thread " + std::to_string(event.thread) : event.track;
+		auto it = trackIds.find(trackName);
+		if (it != trackIds.end()) {
+			return it->second;
+		}
+
+		auto id = static_cast<Json::Int64>(trackIds.size()) + 1;
+		trackIds.emplace(trackName, id);
+		Json::Value metadata;
+		metadata["name"] = "thread_name";
+		metadata["ph"] = "M";
+		metadata["pid"] = 1;
+		metadata["tid"] = id;
+		metadata["args"]["name"] = trackName;
+		traceEvents.append(metadata);
+		return id;
+	};
+
+	for (const auto &event : events) {
+		auto tid = trackId(event);
+		Json::Value traceEvent;
+		traceEvent["name"] = event.name;
+		traceEvent["cat"] = "retdec";
+		traceEvent["pid"] = 1;
+		traceEvent["tid"] = tid;
+		traceEvent["ts"] = microsecondsSince(impl->origin, event.start);
+		if (event.instant) {
+			traceEvent["ph"] = "i";
+			traceEvent["s"] = "t";
+		} else {
+			traceEvent["ph"] = "X";
+			traceEvent["dur"] = microseconds(event.duration);
+		}
+		if (!event.args.isNull()) {
+			traceEvent["args"] = event.args;
+		}
+		traceEvents.append(traceEvent);
+	}
+
+	Json::Value trace;
+	trace["traceEvents"] = traceEvents;
+	trace["displayTimeUnit"] = "ms";
+	return toJsonString(trace);
+}
+
+///
+/// Returns the number of the calling thread.
+///
+/// Threads are numbered from one in the order in which they first call this
+/// function.
+///
+std::size_t TraceBuffer::currentThread() noexcept {
+	static std::atomic<std::size_t> nextThread(1);
+	thread_local std::size_t thread =
+		nextThread.fetch_add(1, std::memory_order_relaxed);
+	return thread;
+}
+
+///
+/// Returns the track of the resource with the given ID.
+///
+/// @param[in] resourcesName Name of the resources (plural, e.g.
+///                          @c decompilations).
+/// @param[in] id ID of the resource.
+///
+std::string TraceBuffer::resourceTrack(const std::string &resourcesName,
+		const std::string &id) {
+	return resourcesName + " " + id;
+}
+
+///
+/// Constructs a trace of a resource shown on the given track of the given
+/// buffer.
+///
+ResourceTrace::ResourceTrace(const std::shared_ptr<TraceBuffer> &buffer,
+		const std::string &track):
+	buffer(buffer), track(track), lastCompletion(-1) {}
+
+///
+/// Records the change in completion of the resource from the given status (if
+/// any).
+///
+void ResourceTrace::statusReceived(const ResourceStatus &status) {
+	if (!status.completion) {
+		return;
+	}
+
+	auto completion = *status.completion;
+	if (lastCompletion.exchange(completion) != completion) {
+		Json::Value args;
+		args["completion"] = completion;
+		buffer->recordInstant("completion", track, args);
+	}
+}
+
+///
+/// Starts a span with the given name on the given track.
+///
+/// @param[in] buffer Buffer into which the span is recorded. When it is null,
+///                   nothing is recorded.
+/// @param[in] name Name of the span.
+/// @param[in] track Track of the span (when empty, the track of the calling
+///                  thread is used).
+///
+TraceSpan::TraceSpan(const std::shared_ptr<TraceBuffer> &buffer,
+		const std::string &name, const std::string &track):
+	buffer(buffer) {
+	if (!buffer) {
+		return;
+	}
+
+	event.name = name;
+	event.track = track;
+	event.thread = TraceBuffer::currentThread();
+	event.start = TraceBuffer::Clock::now();
+}
+
+///
+/// Starts a span with the given name on the track of the given resource.
+///
+/// When @a trace is null, nothing is recorded.
+///
+TraceSpan::TraceSpan(const std::shared_ptr<ResourceTrace> &trace,
+		const std::string &name):
+	TraceSpan(trace ? trace->buffer : nullptr, name,
+		trace ? trace->track : std::string()) {}
+
+///
+/// Ends the span and records it.
+///
+TraceSpan::~TraceSpan() {
+	if (!buffer) {
+		return;
+	}
+
+	event.duration = TraceBuffer::Clock::now() - event.start;
+	try {
+		buffer->record(std::move(event));
+	} catch (...) {
+		// Failures of tracing must not affect the traced code.
+	}
+}
+
+///
+/// Sets the track of the span.
+///
+/// It is useful when the track is not known when the span starts (e.g. when
+/// the span starts a resource whose ID is not known yet).
+///
+void TraceSpan::setTrack(const std::string &track) {
+	if (buffer) {
+		event.track = track;
+	}
+}
+
+///
+/// Sets an argument of the span, shown with the span in trace viewers.
+///
+void TraceSpan::setArg(const std::string &name, const Json::Value &value) {
+	if (buffer) {
+		event.args[name] = value;
+	}
+}
+
+} // namespace internal
+} // namespace retdec
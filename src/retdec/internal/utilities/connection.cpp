@@ -5,6 +5,9 @@
 /// @brief     Implementation of the connection utilities.
 ///
 
+#include <exception>
+#include <utility>
+
 #include <json/json.h>
 
 #include "retdec/exceptions.h"
@@ -27,8 +30,49 @@ void throwApiError(int code, const std::string &message,
 	throw ApiError(code, message, description);
 }
 
+///
+/// Returns a response handler verifying the response before passing it to
+/// @a responseHandler.
+///
+Connection::ResponseHandler verifyingResponseHandler(
+		const Connection::ResponseHandler &responseHandler) {
+	return [responseHandler](std::unique_ptr<Connection::Response> response,
+			std::exception_ptr error) {
+		if (!error) {
+			try {
+				verifyRequestSucceeded(*response);
+			} catch (...) {
+				return responseHandler(nullptr, std::current_exception());
+			}
+		}
+		responseHandler(std::move(response), error);
+	};
+}
+
 } // anonymous namespace
 
+///
+/// Creates and returns the query part of an URL (<tt>?key1=value1...</tt>).
+///
+/// When there are no arguments, the empty string is returned.
+///
+std::string createQuery(const Connection::RequestArguments &args) {
+	std::size_t size = 0;
+	for (const auto &arg : args) {
+		size += arg.first.size() + arg.second.size() + 2;
+	}
+
+	std::string query;
+	query.reserve(size);
+	for (const auto &arg : args) {
+		query += query.empty() ? '?' : '&';
+		query += arg.first;
+		query += '=';
+		query += arg.second;
+	}
+	return query;
+}
+
 ///
 /// Checks if a request resulted in the given @a response succeeded.
 ///
@@ -61,6 +105,27 @@ void verifyRequestSucceeded(const Connection::Response &response) {
 	}
 }
 
+///
+/// Sends a request by calling @a sendRequest and passes its result to
+/// @a responseHandler.
+///
+/// When @a sendRequest throws an exception, it is passed to @a responseHandler
+/// instead of the response.
+///
+void passResponseToHandler(
+		const std::function<std::unique_ptr<Connection::Response> ()> &sendRequest,
+		const Connection::ResponseHandler &responseHandler) {
+	std::unique_ptr<Connection::Response> response;
+	try {
+		response = sendRequest();
+	} catch (...) {
+		return responseHandler(nullptr, std::current_exception());
+	}
+	// Call the handler outside of the try block so that exceptions thrown
+	// from it are not passed back to it.
+	responseHandler(std::move(response), nullptr);
+}
+
 ///
 /// Creates a verifying connection by wrapping a connection.
 ///
@@ -103,5 +168,40 @@ std::unique_ptr<Connection::Response> ResponseVerifyingConnection::sendPostReque
 	return response;
 }
 
+// Override.
+std::unique_ptr<Connection::Response>
+		ResponseVerifyingConnection::sendGetRequestStreamingBody(
+			const Url &url, const BodyHandler &bodyHandler) {
+	auto response = conn->sendGetRequestStreamingBody(url, bodyHandler);
+	verifyRequestSucceeded(*response);
+	return response;
+}
+
+// Override.
+void ResponseVerifyingConnection::sendGetRequestAsync(const Url &url,
+		const ResponseHandler &responseHandler) {
+	conn->sendGetRequestAsync(url, verifyingResponseHandler(responseHandler));
+}
+
+// Override.
+void ResponseVerifyingConnection::sendGetRequestAsync(const Url &url,
+		const RequestArguments &args, const ResponseHandler &responseHandler) {
+	conn->sendGetRequestAsync(url, args,
+		verifyingResponseHandler(responseHandler));
+}
+
+// Override.
+void ResponseVerifyingConnection::sendPostRequestAsync(const Url &url,
+		const RequestArguments &args, const RequestFiles &files,
+		const ResponseHandler &responseHandler) {
+	conn->sendPostRequestAsync(url, args, files,
+		verifyingResponseHandler(responseHandler));
+}
+
+// Override.
+std::shared_ptr<Clock> ResponseVerifyingConnection::clock() const {
+	return conn->clock();
+}
+
 } // namespace internal
 } // namespace retdec
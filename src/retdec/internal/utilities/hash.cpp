@@ -0,0 +1,102 @@
+///
+/// @file      retdec/internal/utilities/hash.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the hashing utilities.
+///
+
+#include <cstddef>
+#include <memory>
+
+#include <openssl/evp.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/utilities/hash.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+/// Size of chunks in which streams are hashed (in bytes).
+const std::size_t HashedChunkSize = 64 * 1024;
+
+///
+/// Incremental computation of a SHA-256 hash.
+///
+class Sha256 {
+public:
+	Sha256();
+
+	void update(const void *data, std::size_t size);
+	std::string hexDigest();
+
+private:
+	/// Context of the computation.
+	const std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX *)> ctx;
+};
+
+///
+/// Starts a computation.
+///
+Sha256::Sha256():
+		ctx(EVP_MD_CTX_create(), [](EVP_MD_CTX *ctx) { EVP_MD_CTX_destroy(ctx); }) {
+	if (!ctx || EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr) != 1) {
+		throw Error("cannot initialize SHA-256 computation");
+	}
+}
+
+///
+/// Adds the given data to the hash.
+///
+void Sha256::update(const void *data, std::size_t size) {
+	EVP_DigestUpdate(ctx.get(), data, size);
+}
+
+///
+/// Finishes the computation and returns the hash as a hexadecimal string.
+///
+std::string Sha256::hexDigest() {
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int digestSize = 0;
+	EVP_DigestFinal_ex(ctx.get(), digest, &digestSize);
+
+	static const char HexDigits[] = "0123456789abcdef";
+	std::string hexDigest;
+	hexDigest.reserve(2 * digestSize);
+	for (unsigned int i = 0; i < digestSize; ++i) {
+		hexDigest += HexDigits[digest[i] >> 4];
+		hexDigest += HexDigits[digest[i] & 0xf];
+	}
+	return hexDigest;
+}
+
+} // anonymous namespace
+
+///
+/// Returns the SHA-256 hash of the given data as a hexadecimal string.
+///
+std::string sha256(const std::string &data) {
+	Sha256 hash;
+	hash.update(data.data(), data.size());
+	return hash.hexDigest();
+}
+
+///
+/// Returns the SHA-256 hash of the content of the given stream as a
+/// hexadecimal string.
+///
+/// The stream is read until its end in chunks, so its content is never stored
+/// in memory as a whole.
+///
+std::string sha256(std::istream &stream) {
+	Sha256 hash;
+	char chunk[HashedChunkSize];
+	while (stream.read(chunk, sizeof(chunk)) || stream.gcount() > 0) {
+		hash.update(chunk, static_cast<std::size_t>(stream.gcount()));
+	}
+	return hash.hexDigest();
+}
+
+} // namespace internal
+} // namespace retdec
@@ -5,12 +5,37 @@
 /// @brief     Implementation of the JSON utility functions.
 ///
 
+#include <memory>
+
 #include "retdec/exceptions.h"
 #include "retdec/internal/utilities/json.h"
 
 namespace retdec {
 namespace internal {
 
+namespace {
+
+///
+/// Returns a JSON parser of the calling thread.
+///
+/// Setting up a parser allocates memory, and statuses of resources are decoded
+/// every time they are polled. Therefore, every thread sets up its parser once
+/// and then reuses it for all the values it decodes.
+///
+Json::CharReader &threadJsonParser() {
+	thread_local const std::unique_ptr<Json::CharReader> parser = [] {
+		Json::CharReaderBuilder builder;
+		builder["collectComments"] = false;
+		// Newer versions of JsonCpp accept trailing commas by default, unlike
+		// the previously used Json::Reader.
+		builder["allowTrailingCommas"] = false;
+		return std::unique_ptr<Json::CharReader>(builder.newCharReader());
+	}();
+	return *parser;
+}
+
+} // anonymous namespace
+
 ///
 /// Creates an exception.
 ///
@@ -26,13 +51,34 @@ JsonDecodingError::JsonDecodingError(const std::string &formattedErrors):
 ///                           JSON.
 ///
 Json::Value toJson(const std::string &str) {
-	Json::Value strAsJson;
-	Json::Reader reader;
-	bool parsingSuccessful = reader.parse(str, strAsJson);
-	if (!parsingSuccessful) {
-		throw JsonDecodingError(reader.getFormattedErrorMessages());
+	return toJson(str.data(), str.data() + str.size());
+}
+
+///
+/// Decodes the characters in [@a begin, @a end) into a JSON value.
+///
+/// @throws JsonDecodingError When the decoding fails, i.e. the characters are
+///                           not valid JSON.
+///
+/// The characters are decoded in place, so they do not have to be copied into
+/// a string first.
+///
+Json::Value toJson(const char *begin, const char *end) {
+	Json::Value value;
+	std::string errors;
+	if (!threadJsonParser().parse(begin, end, &value, &errors)) {
+		throw JsonDecodingError(errors);
 	}
-	return strAsJson;
+	return value;
+}
+
+///
+/// Encodes the given JSON value into a string on a single line.
+///
+std::string toJsonString(const Json::Value &value) {
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+	return Json::writeString(builder, value);
 }
 
 } // namespace internal
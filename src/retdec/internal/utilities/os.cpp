@@ -5,6 +5,7 @@
 /// @brief     Implementation of the operating-system-related utilities.
 ///
 
+#include <algorithm>
 #include <fstream>
 
 #include <boost/date_time/posix_time/posix_time_types.hpp>
@@ -14,11 +15,343 @@
 #include "retdec/exceptions.h"
 #include "retdec/internal/utilities/os.h"
 
+#if !defined(RETDEC_OS_WINDOWS)
+	#include <cerrno>
+
+	#include <fcntl.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#if defined(RETDEC_OS_LINUX)
+	#include <linux/fs.h>
+	#include <sys/ioctl.h>
+	#include <sys/sendfile.h>
+#endif
+
 using namespace std::string_literals;
 
 namespace retdec {
 namespace internal {
 
+namespace {
+
+///
+/// Returns a path to a not-yet-existing temporary file in the directory of the
+/// given file.
+///
+/// A file written under the returned path can be renamed to @a path
+/// atomically because both paths are on the same filesystem.
+///
+std::string tmpFilePathFor(const std::string &path) {
+	return uniqueFilePath(boost::filesystem::path(path).parent_path().string());
+}
+
+#if !defined(RETDEC_OS_WINDOWS)
+
+///
+/// Owner of a file descriptor, which closes it upon destruction.
+///
+class FileDescriptor {
+public:
+	explicit FileDescriptor(int fd): fd(fd) {}
+
+	~FileDescriptor() {
+		if (fd >= 0) {
+			::close(fd);
+		}
+	}
+
+	int get() const noexcept {
+		return fd;
+	}
+
+	bool close() noexcept {
+		auto rc = ::close(fd);
+		fd = -1;
+		return rc == 0;
+	}
+
+	FileDescriptor(const FileDescriptor &) = delete;
+	FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+private:
+	/// Owned file descriptor (negative when there is none).
+	int fd;
+};
+
+#endif
+
+///
+/// Flushes the directory containing the given file to the disk, so that a
+/// file renamed to @a path is found there after a crash.
+///
+/// @throws FilesystemError When the directory cannot be opened or flushed.
+///
+/// Does nothing on Windows.
+///
+void syncParentDirectory(const std::string &path) {
+#if !defined(RETDEC_OS_WINDOWS)
+	auto dirPath = boost::filesystem::path(path).parent_path().string();
+	if (dirPath.empty()) {
+		dirPath = ".";
+	}
+	FileDescriptor dir(::open(dirPath.c_str(),
+		O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+	if (dir.get() < 0) {
+		throw FilesystemError("cannot open directory \"" + dirPath + "\"");
+	}
+	// Some filesystems do not support flushing of directories (EINVAL), and
+	// there is nothing more to be done on them.
+	if (::fsync(dir.get()) != 0 && errno != EINVAL) {
+		throw FilesystemError("cannot write directory \"" + dirPath + "\"");
+	}
+#else
+	static_cast<void>(path);
+#endif
+}
+
+///
+/// Gives the file in @a tmpPath the permissions of the existing file in
+/// @a path, so they are kept when @a tmpPath replaces it.
+///
+/// Does nothing when @a path does not exist.
+///
+/// @throws FilesystemError When the permissions cannot be changed.
+///
+void copyPermissionsOfExistingFile(const std::string &path,
+		const std::string &tmpPath) {
+	boost::system::error_code ec;
+	auto status = boost::filesystem::status(path, ec);
+	if (ec || !boost::filesystem::exists(status)) {
+		return;
+	}
+
+	boost::filesystem::permissions(tmpPath, status.permissions(), ec);
+	if (ec) {
+		throw FilesystemError("cannot write file \"" + path + "\"");
+	}
+}
+
+///
+/// Returns the path of the file that is to be replaced when writing into
+/// @a path.
+///
+/// When @a path is a symbolic link to an existing file, it is the path to the
+/// file, so the link is kept. Otherwise, it is @a path.
+///
+std::string pathOfReplacedFile(const std::string &path) {
+	boost::system::error_code ec;
+	if (!boost::filesystem::is_symlink(path, ec)) {
+		return path;
+	}
+
+	auto target = boost::filesystem::canonical(path, ec);
+	return ec ? path : target.string();
+}
+
+#if defined(RETDEC_OS_LINUX)
+
+///
+/// Function copying @a size bytes from file descriptor @a src into the empty
+/// file descriptor @a dst. It returns @c false when the data cannot be copied.
+///
+using CopyFileContent = bool (*)(int src, int dst, std::uint64_t size);
+
+///
+/// Returns the number of bytes to be copied by a single system call when
+/// @a offset bytes out of @a size have already been copied.
+///
+std::size_t copiedChunkSize(std::uint64_t size, loff_t offset) {
+	return static_cast<std::size_t>(std::min<std::uint64_t>(
+		size - static_cast<std::uint64_t>(offset), 0x7ffff000));
+}
+
+///
+/// Clones (reflinks) @a src into the empty file @a dst.
+///
+/// The files then share their data on copy-on-write filesystems (e.g. Btrfs
+/// or XFS), so nothing is copied. Returns @c false when the filesystem does not
+/// support cloning.
+///
+bool cloneFileContent(int src, int dst) {
+#if defined(FICLONE)
+	return ::ioctl(dst, FICLONE, src) == 0;
+#else
+	static_cast<void>(src);
+	static_cast<void>(dst);
+	return false;
+#endif
+}
+
+///
+/// Copies the data of @a src from @a offset up to @a size into the same
+/// offset in @a dst by @c copy_file_range().
+///
+/// The data is copied inside the kernel (and server-side copies may be used
+/// on network filesystems). @a offset is advanced by the number of copied
+/// bytes. Returns @c false when not all the data has been copied.
+///
+bool copyFileContentByCopyFileRange(int src, int dst, std::uint64_t size,
+		loff_t &offset) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 27)
+	auto dstOffset = offset;
+	while (static_cast<std::uint64_t>(offset) < size) {
+		// A zero return value means that the filesystem cannot copy the
+		// file (e.g. procfs) or that it has been truncated in the meantime.
+		if (::copy_file_range(src, &offset, dst, &dstOffset,
+				copiedChunkSize(size, offset), 0) <= 0) {
+			return false;
+		}
+	}
+	return true;
+#else
+	static_cast<void>(src);
+	static_cast<void>(dst);
+	return static_cast<std::uint64_t>(offset) >= size;
+#endif
+}
+
+///
+/// Copies the data of @a src from @a offset up to @a size into the same
+/// offset in @a dst by @c sendfile().
+///
+/// The data is copied inside the kernel, also on older kernels and between
+/// filesystems of different types. @a offset is advanced by the number of
+/// copied bytes. Returns @c false when not all the data has been copied.
+///
+bool copyFileContentBySendfile(int src, int dst, std::uint64_t size,
+		loff_t &offset) {
+	// sendfile() writes at the current offset of the destination file.
+	if (::lseek(dst, offset, SEEK_SET) != offset) {
+		return false;
+	}
+	while (static_cast<std::uint64_t>(offset) < size) {
+		if (::sendfile(dst, src, &offset, copiedChunkSize(size, offset)) <= 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+///
+/// Copies @a size bytes from @a src into the empty file @a dst without passing
+/// them through user space.
+///
+/// The file is cloned when possible. Otherwise, it is copied by
+/// @c copy_file_range(), and the rest of the data that it cannot copy is
+/// copied by @c sendfile(). Returns @c false when none of the methods
+/// succeeds. In such a case, @a dst may contain a part of the data.
+///
+bool copyFileContentInKernel(int src, int dst, std::uint64_t size) {
+	if (cloneFileContent(src, dst)) {
+		return true;
+	}
+
+	loff_t offset = 0;
+	return copyFileContentByCopyFileRange(src, dst, size, offset) ||
+		copyFileContentBySendfile(src, dst, size, offset);
+}
+
+///
+/// Copies file in @a srcPath to a new file in @a dstPath by @a copyContent.
+///
+/// @param[in] srcPath Path to the copied file.
+/// @param[in] dstPath Path to the new file.
+/// @param[in] copyContent Function copying the data between the files.
+/// @param[in] sync Should the new file be flushed to the disk?
+///
+/// @returns @c false when the copied file is not a regular file or
+///          @a copyContent fails.
+///
+/// @throws FilesystemError When a file cannot be opened or closed.
+///
+bool copyFileWith(const std::string &srcPath, const std::string &dstPath,
+		CopyFileContent copyContent, bool sync) {
+	FileDescriptor src(::open(srcPath.c_str(), O_RDONLY | O_CLOEXEC));
+	struct stat srcStat;
+	if (src.get() < 0 || ::fstat(src.get(), &srcStat) != 0) {
+		throw FilesystemError("cannot open file \"" + srcPath + "\"");
+	}
+	if (!S_ISREG(srcStat.st_mode)) {
+		return false;
+	}
+
+	FileDescriptor dst(::open(dstPath.c_str(),
+		O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, srcStat.st_mode & 0777));
+	if (dst.get() < 0) {
+		throw FilesystemError("cannot open file \"" + dstPath + "\"");
+	}
+	if (!copyContent(src.get(), dst.get(),
+			static_cast<std::uint64_t>(srcStat.st_size))) {
+		return false;
+	}
+	if ((sync && ::fsync(dst.get()) != 0) || !dst.close()) {
+		throw FilesystemError("cannot write file \"" + dstPath + "\"");
+	}
+	return true;
+}
+
+#endif
+
+///
+/// Copies file in @a srcPath to @a dstPath by reading and writing it in user
+/// space.
+///
+/// @throws FilesystemError When a file cannot be opened, read, or written.
+///
+void copyFilePortably(const std::string &srcPath,
+		const std::string &dstPath) {
+	try {
+		boost::filesystem::copy_file(srcPath, dstPath,
+			boost::filesystem::copy_option::overwrite_if_exists);
+	} catch (const boost::filesystem::filesystem_error &) {
+		throw FilesystemError("cannot copy file \"" + srcPath +
+			"\" to \"" + dstPath + "\"");
+	}
+}
+
+///
+/// Copies file in @a srcPath to a new file in @a dstPath and flushes the new
+/// file to the disk.
+///
+/// @throws FilesystemError When a file cannot be opened, read, or written.
+///
+void copyFileToNewFile(const std::string &srcPath,
+		const std::string &dstPath) {
+#if defined(RETDEC_OS_LINUX)
+	if (copyFileWith(srcPath, dstPath, copyFileContentInKernel, true)) {
+		return;
+	}
+#endif
+
+	copyFilePortably(srcPath, dstPath);
+	syncFile(dstPath);
+}
+
+} // anonymous namespace
+
+///
+/// Flushes the content of the given file to the disk.
+///
+/// @throws FilesystemError When the file cannot be opened or flushed.
+///
+/// Does nothing on Windows.
+///
+void syncFile(const std::string &path) {
+#if !defined(RETDEC_OS_WINDOWS)
+	FileDescriptor file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+	if (file.get() < 0) {
+		throw FilesystemError("cannot open file \"" + path + "\"");
+	}
+	if (::fsync(file.get()) != 0) {
+		throw FilesystemError("cannot write file \"" + path + "\"");
+	}
+#else
+	static_cast<void>(path);
+#endif
+}
+
 ///
 /// Returns a name of the operating system.
 ///
@@ -98,24 +431,149 @@ std::string readFile(const std::string &path) {
 	return content;
 }
 
+///
+/// Opens the given file for reading.
+///
+/// @param[in] path Path to the file.
+///
+/// @throws FilesystemError When the file cannot be opened.
+///
+/// The file is opened in the binary mode, so no conversions are performed
+/// during the reading. The returned stream throws an exception when a read
+/// error occurs.
+///
+std::unique_ptr<std::istream> openFile(const std::string &path) {
+	std::unique_ptr<std::istream> file = std::make_unique<std::ifstream>(
+		path, std::ios::in | std::ios::binary);
+	if (!*file) {
+		throw FilesystemError("cannot open file \"" + path + "\"");
+	}
+
+	file->exceptions(std::ios::badbit);
+	return file;
+}
+
+///
+/// Returns the size of the given file (in bytes).
+///
+/// @param[in] path Path to the file.
+///
+/// @throws FilesystemError When the size cannot be obtained.
+///
+std::uint64_t fileSize(const std::string &path) {
+	boost::system::error_code ec;
+	auto size = boost::filesystem::file_size(path, ec);
+	if (ec) {
+		throw FilesystemError("cannot get the size of file \"" + path + "\"");
+	}
+	return size;
+}
+
 ///
 /// Stores a file with the given @a content into the given @a path.
 ///
 /// @throws FilesystemError When the file cannot be opened or written.
 ///
 /// The file is opened in the binary mode, so no conversions are performed
-/// during writing.
+/// during writing. The content is written into a temporary file in the same
+/// directory, which then atomically replaces the file in @a path. Hence, the
+/// file in @a path is never seen partially written, and when writing fails,
+/// the original file (if any) is left intact. Both the file and the directory
+/// containing it are flushed to the disk, so the file survives a crash once
+/// this function returns.
+///
+/// The replaced file keeps its permissions, but its owner and group become
+/// those of the process. When @a path is a symbolic link to an existing file,
+/// the file is replaced and the link is kept.
 ///
 void writeFile(const std::string &path, const std::string &content) {
-	std::ofstream file(path, std::ios::out | std::ios::binary);
+	auto replacedPath = pathOfReplacedFile(path);
+	auto tmpPath = tmpFilePathFor(replacedPath);
+	try {
+		std::ofstream file(tmpPath, std::ios::out | std::ios::binary);
+		if (!file) {
+			throw FilesystemError("cannot open file \"" + path + "\"");
+		}
+
+		file.write(content.data(), content.size());
+		file.close();
+		if (!file) {
+			throw FilesystemError("cannot write file \"" + path + "\"");
+		}
+		copyPermissionsOfExistingFile(replacedPath, tmpPath);
+		syncFile(tmpPath);
+		renameFile(tmpPath, replacedPath);
+		syncParentDirectory(replacedPath);
+	} catch (const FilesystemError &) {
+		removeFile(tmpPath);
+		throw;
+	}
+}
+
+///
+/// Appends the given content to the end of the given file.
+///
+/// @throws FilesystemError When the file cannot be opened or written.
+///
+/// The file is created when it does not exist. On POSIX systems, the file is
+/// opened with @c O_APPEND and the content is written by a single @c write()
+/// (unless the system writes only a part of it), so contents appended by
+/// several processes at the same time are not interleaved. The file is
+/// flushed to the disk before this function returns.
+///
+void appendToFile(const std::string &path, const std::string &content) {
+#if !defined(RETDEC_OS_WINDOWS)
+	FileDescriptor file(::open(path.c_str(),
+		O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0666));
+	if (file.get() < 0) {
+		throw FilesystemError("cannot open file \"" + path + "\"");
+	}
+	auto data = content.data();
+	auto remainingSize = content.size();
+	while (remainingSize > 0) {
+		auto writtenSize = ::write(file.get(), data, remainingSize);
+		if (writtenSize < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw FilesystemError("cannot write file \"" + path + "\"");
+		}
+		data += writtenSize;
+		remainingSize -= static_cast<std::size_t>(writtenSize);
+	}
+	if (::fsync(file.get()) != 0 || !file.close()) {
+		throw FilesystemError("cannot write file \"" + path + "\"");
+	}
+#else
+	std::ofstream file(path, std::ios::out | std::ios::app | std::ios::binary);
 	if (!file) {
 		throw FilesystemError("cannot open file \"" + path + "\"");
 	}
-
-	file << content;
+	file.write(content.data(), static_cast<std::streamsize>(content.size()));
+	file.close();
 	if (!file) {
 		throw FilesystemError("cannot write file \"" + path + "\"");
 	}
+#endif
+}
+
+///
+/// Opens the given file for writing.
+///
+/// @param[in] path Path to the file.
+///
+/// @throws FilesystemError When the file cannot be opened.
+///
+/// The file is opened in the binary mode, so no conversions are performed
+/// during writing. If the file exists, it is truncated.
+///
+std::unique_ptr<std::ostream> openFileForWriting(const std::string &path) {
+	std::unique_ptr<std::ostream> file = std::make_unique<std::ofstream>(
+		path, std::ios::out | std::ios::binary);
+	if (!*file) {
+		throw FilesystemError("cannot open file \"" + path + "\"");
+	}
+	return file;
 }
 
 ///
@@ -123,16 +581,116 @@ void writeFile(const std::string &path, const std::string &content) {
 ///
 /// @throws FilesystemError When a file cannot be opened, read, or written.
 ///
+/// On Linux, the file is cloned (reflinked) when the filesystem supports it.
+/// Otherwise, it is copied inside the kernel by using @c copy_file_range() or
+/// @c sendfile(). When none of these is possible, it is copied in the usual
+/// way. The copy is made in a temporary file in the same directory, which then
+/// atomically replaces the file in @a dstPath. Hence, the file in @a dstPath
+/// is never seen partially written, and when copying fails, the original file
+/// (if any) is left intact. Both the copy and the directory containing it are
+/// flushed to the disk, so the copy survives a crash once this function
+/// returns.
+///
 void copyFile(const std::string &srcPath, const std::string &dstPath) {
+	auto tmpPath = tmpFilePathFor(dstPath);
 	try {
-		boost::filesystem::copy_file(srcPath, dstPath,
-			boost::filesystem::copy_option::overwrite_if_exists);
-	} catch (const boost::filesystem::filesystem_error &) {
+		copyFileToNewFile(srcPath, tmpPath);
+		renameFile(tmpPath, dstPath);
+		syncParentDirectory(dstPath);
+	} catch (const FilesystemError &) {
+		removeFile(tmpPath);
 		throw FilesystemError("cannot copy file \"" + srcPath +
 			"\" to \"" + dstPath + "\"");
 	}
 }
 
+///
+/// Copies file in @a srcPath to a new file in @a dstPath by the given method
+/// without flushing it to the disk.
+///
+/// @returns @c false when the method is not supported on the system, by the
+///          filesystems, or for the file. In such a case, @a dstPath may
+///          contain a part of the data.
+///
+/// @throws FilesystemError When a file cannot be opened, read, or written.
+///
+/// copyFile() uses the fastest of the methods that succeeds and flushes the
+/// copy. The methods are exposed so that they can be compared separately.
+/// Except for FileCopyMethod::Portable, @a dstPath must not exist.
+///
+bool copyFileBy(FileCopyMethod method, const std::string &srcPath,
+		const std::string &dstPath) {
+	switch (method) {
+		case FileCopyMethod::Portable:
+			copyFilePortably(srcPath, dstPath);
+			return true;
+#if defined(RETDEC_OS_LINUX)
+		case FileCopyMethod::Clone:
+			return copyFileWith(srcPath, dstPath,
+				[](int src, int dst, std::uint64_t) {
+					return cloneFileContent(src, dst);
+				},
+				false
+			);
+		case FileCopyMethod::CopyFileRange:
+			return copyFileWith(srcPath, dstPath,
+				[](int src, int dst, std::uint64_t size) {
+					loff_t offset = 0;
+					return copyFileContentByCopyFileRange(src, dst, size, offset);
+				},
+				false
+			);
+		case FileCopyMethod::Sendfile:
+			return copyFileWith(srcPath, dstPath,
+				[](int src, int dst, std::uint64_t size) {
+					loff_t offset = 0;
+					return copyFileContentBySendfile(src, dst, size, offset);
+				},
+				false
+			);
+#endif
+		default:
+			return false;
+	}
+}
+
+///
+/// Renames (moves) file in @a srcPath to @a dstPath.
+///
+/// @throws FilesystemError When the file cannot be renamed.
+///
+/// If @a dstPath exists, it is replaced.
+///
+void renameFile(const std::string &srcPath, const std::string &dstPath) {
+	boost::system::error_code ec;
+	boost::filesystem::rename(srcPath, dstPath, ec);
+	if (ec) {
+		throw FilesystemError("cannot rename file \"" + srcPath +
+			"\" to \"" + dstPath + "\"");
+	}
+}
+
+///
+/// Removes the given file.
+///
+/// Does nothing when the file does not exist or cannot be removed.
+///
+void removeFile(const std::string &path) {
+	boost::system::error_code ec;
+	boost::filesystem::remove(path, ec);
+}
+
+///
+/// Returns a path to a not-yet-existing file in the given directory.
+///
+/// The name of the file is randomly generated, so the path can be used for
+/// temporary files.
+///
+std::string uniqueFilePath(const std::string &directoryPath) {
+	return joinPaths(directoryPath, boost::filesystem::unique_path(
+		"retdec-%%%%-%%%%-%%%%-%%%%.tmp").string());
+}
+
 ///
 /// Sleeps for the given number of milliseconds.
 ///
@@ -142,5 +700,14 @@ void sleep(int milliseconds) {
 	boost::this_thread::sleep(boost::posix_time::milliseconds(milliseconds));
 }
 
+///
+/// Returns the number of processors (cores) available on the system.
+///
+/// When the number cannot be determined, it returns 1.
+///
+std::size_t processorCount() {
+	return std::max<std::size_t>(boost::thread::hardware_concurrency(), 1);
+}
+
 } // namespace internal
 } // namespace retdec
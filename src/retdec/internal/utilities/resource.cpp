@@ -0,0 +1,63 @@
+///
+/// @file      retdec/internal/utilities/resource.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the utilities for resources.
+///
+
+#include "retdec/file.h"
+#include "retdec/internal/utilities/hash.h"
+#include "retdec/internal/utilities/resource.h"
+#include "retdec/resource_arguments.h"
+
+namespace retdec {
+namespace internal {
+
+namespace {
+
+///
+/// Appends the given string to a canonical representation of arguments.
+///
+/// The string is prefixed with its length, so different arguments never have
+/// the same representation.
+///
+void appendCanonical(std::string &canonical, const std::string &str) {
+	canonical += std::to_string(str.size());
+	canonical += ':';
+	canonical += str;
+}
+
+} // anonymous namespace
+
+///
+/// Returns a key identifying a resource with the given arguments.
+///
+/// @param[in] resourcesUrl URL to the resources of the service.
+/// @param[in] args Arguments of the resource.
+///
+/// The key is a hash of the URL, all arguments, and the names and contents of
+/// all files, so resources with the same key produce the same results. The
+/// contents are read in parts, so input files are never stored in memory as a
+/// whole.
+///
+std::string resourceKey(const Connection::Url &resourcesUrl,
+		const ResourceArguments &args) {
+	std::string canonical;
+	appendCanonical(canonical, resourcesUrl);
+	// Arguments and files are sorted by their names, so their order is
+	// canonical.
+	for (auto it = args.argumentsBegin(), e = args.argumentsEnd(); it != e; ++it) {
+		appendCanonical(canonical, it->first);
+		appendCanonical(canonical, it->second);
+	}
+	for (auto it = args.filesBegin(), e = args.filesEnd(); it != e; ++it) {
+		appendCanonical(canonical, it->first);
+		appendCanonical(canonical, it->second->getName());
+		auto content = it->second->openContent();
+		appendCanonical(canonical, sha256(*content));
+	}
+	return sha256(canonical);
+}
+
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,55 @@
+///
+/// @file      retdec/metrics.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the metrics of requests sent to the API and of
+///            resources.
+///
+
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/metrics.h"
+
+using namespace retdec::internal;
+
+namespace retdec {
+
+///
+/// Constructs metrics with no recorded values.
+///
+Metrics::Metrics(): registry_(std::make_shared<MetricsRegistry>()) {}
+
+///
+/// Destructs the metrics.
+///
+Metrics::~Metrics() = default;
+
+///
+/// Returns the metrics in the text-based exposition format of Prometheus.
+///
+std::string Metrics::toPrometheusText() const {
+	return registry_->toPrometheusText();
+}
+
+///
+/// Writes the metrics in the text-based exposition format of Prometheus into
+/// the given file.
+///
+/// @throws FilesystemError When the file cannot be written.
+///
+/// The file is replaced atomically, so it can be periodically rewritten while
+/// it is being read by a collector (e.g. the textfile collector of the node
+/// exporter).
+///
+void Metrics::writePrometheusText(const std::string &filePath) const {
+	writeFile(filePath, toPrometheusText());
+}
+
+///
+/// Returns the registry holding the metrics.
+///
+std::shared_ptr<MetricsRegistry> Metrics::registry() const {
+	return registry_;
+}
+
+} // namespace retdec
@@ -0,0 +1,204 @@
+///
+/// @file      retdec/polling_policy.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the base class and factory for polling
+///            policies.
+///
+
+#include <utility>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/polling_policies/deadline_aware_polling_policy.h"
+#include "retdec/internal/polling_policies/decorrelated_jitter_polling_policy.h"
+#include "retdec/internal/polling_policies/exponential_polling_policy.h"
+#include "retdec/internal/polling_policies/fixed_polling_policy.h"
+#include "retdec/internal/polling_policies/predictive_polling_policy.h"
+#include "retdec/polling_policy.h"
+
+using namespace retdec::internal;
+
+namespace retdec {
+
+///
+/// Constructs an empty view.
+///
+PollingPolicy::CompletionChanges::CompletionChanges() = default;
+
+///
+/// Constructs a view of the given changes.
+///
+/// The changes are not copied, so they have to outlive the view.
+///
+PollingPolicy::CompletionChanges::CompletionChanges(
+		const std::vector<CompletionChange> &changes):
+	first(changes.data()), count(changes.size()) {}
+
+///
+/// Returns a pointer to the first change.
+///
+const PollingPolicy::CompletionChange *
+PollingPolicy::CompletionChanges::begin() const {
+	return first;
+}
+
+///
+/// Returns a pointer past the last change.
+///
+const PollingPolicy::CompletionChange *
+PollingPolicy::CompletionChanges::end() const {
+	return first + count;
+}
+
+///
+/// Returns the number of changes.
+///
+std::size_t PollingPolicy::CompletionChanges::size() const {
+	return count;
+}
+
+///
+/// Are there no changes?
+///
+bool PollingPolicy::CompletionChanges::empty() const {
+	return count == 0;
+}
+
+///
+/// Returns the change with the given index.
+///
+const PollingPolicy::CompletionChange &
+PollingPolicy::CompletionChanges::operator[](std::size_t i) const {
+	return first[i];
+}
+
+///
+/// Returns the first change.
+///
+/// The view must not be empty.
+///
+const PollingPolicy::CompletionChange &
+PollingPolicy::CompletionChanges::front() const {
+	return first[0];
+}
+
+///
+/// Returns the last change.
+///
+/// The view must not be empty.
+///
+const PollingPolicy::CompletionChange &
+PollingPolicy::CompletionChanges::back() const {
+	return first[count - 1];
+}
+
+///
+/// Constructs a policy.
+///
+PollingPolicy::PollingPolicy() = default;
+
+///
+/// Destructs the policy.
+///
+PollingPolicy::~PollingPolicy() = default;
+
+/// @fn PollingPolicy::nextDelay(const Progress &progress)
+///
+/// Returns the delay before the next status update.
+///
+/// It is called from the thread that waits for the resource or from a thread
+/// of the I/O service shared by connections, possibly from several threads at
+/// once.
+///
+
+///
+/// Returns a policy polling statuses with the given fixed delay.
+///
+std::unique_ptr<PollingPolicy> PollingPolicy::fixed(
+		std::chrono::milliseconds delay) {
+	return std::make_unique<FixedPollingPolicy>(delay);
+}
+
+///
+/// Returns a policy polling statuses with an exponentially growing delay.
+///
+/// @param[in] initialDelay Delay after the first status update. It has to be
+///                         positive.
+/// @param[in] maxDelay Maximal delay.
+/// @param[in] factor Factor by which the delay grows. It has to be greater
+///                   than one.
+///
+/// @throws Error When @a initialDelay is not positive or @a factor is not
+///               greater than one (the status would be polled without any
+///               delay or the delay would never grow).
+///
+/// The delay does not grow while the completion of the resource keeps changing.
+///
+std::unique_ptr<PollingPolicy> PollingPolicy::exponential(
+		std::chrono::milliseconds initialDelay,
+		std::chrono::milliseconds maxDelay,
+		double factor) {
+	if (initialDelay <= std::chrono::milliseconds::zero()) {
+		throw Error("the initial delay of an exponential polling policy "
+			"has to be positive");
+	}
+	// Written so that NaN is rejected as well.
+	if (!(factor > 1.0)) {
+		throw Error("the factor of an exponential polling policy has to be "
+			"greater than one");
+	}
+
+	return std::make_unique<ExponentialPollingPolicy>(
+		initialDelay, maxDelay, factor);
+}
+
+///
+/// Returns a policy polling statuses with a randomized delay that grows with
+/// the last delay (so-called decorrelated jitter).
+///
+/// @param[in] baseDelay Minimal delay.
+/// @param[in] maxDelay Maximal delay.
+///
+/// Clients that start many resources at once should prefer this policy so that
+/// the statuses of the resources are not requested at the same moments.
+///
+std::unique_ptr<PollingPolicy> PollingPolicy::decorrelatedJitter(
+		std::chrono::milliseconds baseDelay,
+		std::chrono::milliseconds maxDelay) {
+	return std::make_unique<DecorrelatedJitterPollingPolicy>(
+		baseDelay, maxDelay);
+}
+
+///
+/// Returns a policy polling statuses when resources are predicted to finish.
+///
+/// @param[in] minDelay Minimal delay.
+/// @param[in] maxDelay Maximal delay.
+///
+/// The finish is predicted from the timeline of completion of each resource,
+/// and, until the timeline is long enough, from the rate of completion observed
+/// for other resources with the same mode (e.g. decompilations of binary
+/// files). Long-running resources are thus polled only a few times. The policy
+/// learns from all resources it is used for, so it should be shared.
+///
+std::unique_ptr<PollingPolicy> PollingPolicy::predictive(
+		std::chrono::milliseconds minDelay,
+		std::chrono::milliseconds maxDelay) {
+	return std::make_unique<PredictivePollingPolicy>(minDelay, maxDelay);
+}
+
+///
+/// Returns a policy that uses the delays from the given policy but shortens
+/// them so that a status is polled right at the given deadline.
+///
+/// @param[in] policy Policy deciding the delays.
+/// @param[in] deadline Deadline (measured from the start of the waiting).
+///
+std::unique_ptr<PollingPolicy> PollingPolicy::deadlineAware(
+		std::shared_ptr<const PollingPolicy> policy,
+		std::chrono::milliseconds deadline) {
+	return std::make_unique<DeadlineAwarePollingPolicy>(
+		std::move(policy), deadline);
+}
+
+} // namespace retdec
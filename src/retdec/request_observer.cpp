@@ -0,0 +1,39 @@
+///
+/// @file      retdec/request_observer.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the base class of observers of requests sent
+///            to the API.
+///
+
+#include "retdec/request_observer.h"
+
+namespace retdec {
+
+///
+/// Has the phase with the given time been reached and reported?
+///
+bool RequestObserver::Request::hasTime(TimePoint time) noexcept {
+	return time != TimePoint();
+}
+
+///
+/// Constructs an observer.
+///
+RequestObserver::RequestObserver() = default;
+
+///
+/// Destructs the observer.
+///
+RequestObserver::~RequestObserver() = default;
+
+/// @fn RequestObserver::requestFinished(const Request &request)
+///
+/// Called when a request finishes, either successfully or by failing.
+///
+/// It is called from the thread that sent the request, which may be a thread
+/// of the I/O service shared by connections, possibly from several threads at
+/// once. It should return quickly and it should not throw.
+///
+
+} // namespace retdec
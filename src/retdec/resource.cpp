@@ -124,4 +124,40 @@ std::string Resource::getError() const {
 	return pimpl->error;
 }
 
+///
+/// Returns a future that becomes ready when the resource finishes.
+///
+/// The status of the resource is polled asynchronously, on the threads of the
+/// I/O service shared by connections, so the calling thread is not blocked and
+/// no thread is needed per resource. Once the future is ready, the querying
+/// functions that may access the API return the final status without accessing
+/// it. When the status cannot be obtained (a connection or server error is
+/// retried several times first), the future holds the error.
+///
+/// The resource has to outlive the returned future; the polling stops when the
+/// resource is destructed.
+///
+std::shared_future<void> Resource::finished() {
+	return pimpl->finishedFuture();
+}
+
+///
+/// Calls @a handler when the resource finishes.
+///
+/// This is a callback-based counterpart of finished(), suitable for adapting
+/// the waiting to other asynchronous models (e.g. coroutines). The status is
+/// polled in the same way as in finished(). @a handler is called from a thread
+/// of the I/O service shared by connections, or right away when the resource
+/// is already known to have finished. It should not throw. It may call
+/// synchronous functions of resources (e.g. to obtain outputs), whose requests
+/// are then sent from the calling thread, but it cannot wait for other
+/// resources to finish (see ResourceGroup).
+///
+/// The resource has to outlive the call of @a handler; the polling stops when
+/// the resource is destructed.
+///
+void Resource::whenFinished(const FinishedHandler &handler) {
+	pimpl->whenFinished(handler);
+}
+
 } // namespace retdec
@@ -0,0 +1,183 @@
+///
+/// @file      retdec/resource_group.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the group of resources.
+///
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/resource.h"
+#include "retdec/resource_group.h"
+
+namespace retdec {
+
+namespace {
+
+///
+/// Throws Error when the calling thread cannot wait for resources to finish.
+///
+/// Resources finish in handlers run by worker threads of the I/O service, so a
+/// worker thread waiting for them might wait forever.
+///
+void ensureCanWait() {
+	if (internal::IoService::isWorkerThread()) {
+		throw Error("resources cannot be waited for from a handler run by "
+			"the I/O service (e.g. from a whenFinished() handler)");
+	}
+}
+
+///
+/// State shared between a group and the handlers called when its resources
+/// finish.
+///
+/// The handlers may be called after the group is destructed, so they cannot
+/// refer to the group itself.
+///
+struct FinishedResources {
+	/// Mutex guarding the state.
+	boost::mutex mutex;
+
+	/// Notified whenever a resource finishes.
+	boost::condition_variable resourceFinished;
+
+	/// Finished resources (in the order they finished) together with errors
+	/// that occurred when obtaining their statuses.
+	std::deque<std::pair<Resource *, std::exception_ptr>> resources;
+};
+
+} // anonymous namespace
+
+///
+/// Private implementation of ResourceGroup.
+///
+struct ResourceGroup::Impl {
+	/// Resources in the group.
+	std::vector<Resource *> resources;
+
+	/// Resources that have finished.
+	const std::shared_ptr<FinishedResources> finished =
+		std::make_shared<FinishedResources>();
+};
+
+///
+/// Constructs an empty group.
+///
+ResourceGroup::ResourceGroup():
+	pimpl(std::make_unique<Impl>()) {}
+
+///
+/// Destructs the group.
+///
+ResourceGroup::~ResourceGroup() = default;
+
+///
+/// Adds the given resource into the group.
+///
+/// The polling of its status is started right away. A resource should not be
+/// added into the same group more than once.
+///
+void ResourceGroup::add(Resource &resource) {
+	pimpl->resources.push_back(&resource);
+	auto finished = pimpl->finished;
+	auto resourcePtr = &resource;
+	resource.whenFinished([finished, resourcePtr](std::exception_ptr error) {
+		boost::lock_guard<boost::mutex> lock(finished->mutex);
+		finished->resources.emplace_back(resourcePtr, error);
+		finished->resourceFinished.notify_all();
+	});
+}
+
+///
+/// Returns the number of resources in the group.
+///
+std::size_t ResourceGroup::size() const {
+	return pimpl->resources.size();
+}
+
+///
+/// Is the group empty?
+///
+bool ResourceGroup::empty() const {
+	return pimpl->resources.empty();
+}
+
+///
+/// Waits until all resources in the group finish.
+///
+/// The resources stay in the group. When the status of a resource cannot be
+/// obtained, the first such error is thrown once all resources finish.
+///
+/// @throws Error When some of the resources have not finished yet and it is
+///               called from a handler run by the I/O service (e.g. from a
+///               handler passed to Resource::whenFinished()).
+///
+void ResourceGroup::waitAll() {
+	auto &finished = *pimpl->finished;
+	boost::unique_lock<boost::mutex> lock(finished.mutex);
+	auto allFinished = [&]() {
+		return finished.resources.size() == pimpl->resources.size();
+	};
+	if (!allFinished()) {
+		ensureCanWait();
+	}
+	finished.resourceFinished.wait(lock, allFinished);
+
+	for (const auto &resource : finished.resources) {
+		if (resource.second) {
+			std::rethrow_exception(resource.second);
+		}
+	}
+}
+
+///
+/// Waits until any of the resources in the group finishes, removes it from
+/// the group, and returns it.
+///
+/// Resources are returned in the order in which they finished, so calling
+/// this function repeatedly until the group is empty visits every resource
+/// exactly once.
+///
+/// @throws Error When the group is empty, or when none of the resources has
+///               finished yet and it is called from a handler run by the I/O
+///               service (e.g. from a handler passed to
+///               Resource::whenFinished()).
+///
+/// When the status of the resource cannot be obtained, the error is thrown
+/// (the resource is removed from the group nevertheless).
+///
+Resource &ResourceGroup::waitAny() {
+	if (pimpl->resources.empty()) {
+		throw Error("there are no resources to wait for");
+	}
+
+	auto &finished = *pimpl->finished;
+	boost::unique_lock<boost::mutex> lock(finished.mutex);
+	auto anyFinished = [&]() { return !finished.resources.empty(); };
+	if (!anyFinished()) {
+		ensureCanWait();
+	}
+	finished.resourceFinished.wait(lock, anyFinished);
+	auto resource = finished.resources.front();
+	finished.resources.pop_front();
+	lock.unlock();
+
+	pimpl->resources.erase(std::find(pimpl->resources.begin(),
+		pimpl->resources.end(), resource.first));
+	if (resource.second) {
+		std::rethrow_exception(resource.second);
+	}
+	return *resource.first;
+}
+
+} // namespace retdec
@@ -5,10 +5,15 @@
 /// @brief     Implementation of the library settings.
 ///
 
+#include <chrono>
 #include <utility>
 
 #include "retdec/internal/utilities/os.h"
+#include "retdec/metrics.h"
+#include "retdec/polling_policy.h"
+#include "retdec/request_observer.h"
 #include "retdec/settings.h"
+#include "retdec/tracer.h"
 
 using namespace retdec::internal;
 
@@ -19,7 +24,19 @@ namespace retdec {
 ///
 Settings::Settings():
 	apiUrl_(DefaultApiUrl), apiKey_(DefaultApiKey),
-	userAgent_(DefaultUserAgent) {}
+	userAgent_(DefaultUserAgent),
+	connectionPoolSize_(DefaultConnectionPoolSize),
+	maxConnectionCount_(DefaultMaxConnectionCount),
+	connectionIdleTimeout_(DefaultConnectionIdleTimeout),
+	ioThreadCount_(DefaultIoThreadCount),
+	pollingPolicy_(DefaultPollingPolicy),
+	resultCacheDirectory_(DefaultResultCacheDirectory),
+	resultCacheMaxSize_(DefaultResultCacheMaxSize),
+	deduplicateRuns_(DefaultDeduplicateRuns),
+	journalPath_(DefaultJournalPath),
+	requestObserver_(DefaultRequestObserver),
+	metrics_(DefaultMetrics),
+	tracer_(DefaultTracer) {}
 
 ///
 /// Copy-constructs settings from the given settings.
@@ -124,6 +141,405 @@ std::string Settings::userAgent() const {
 	return userAgent_;
 }
 
+///
+/// Sets a new maximal number of idle connections kept open per API URL.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// A connection that is returned to a pool that already holds this many idle
+/// connections is closed, so the size only limits how many connections are
+/// kept open for later requests. It does not limit how many requests can be
+/// sent at once (see maxConnectionCount()). When it is zero, no connection is
+/// kept open.
+///
+Settings &Settings::connectionPoolSize(std::size_t connectionPoolSize) {
+	connectionPoolSize_ = connectionPoolSize;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new maximal number of idle
+/// connections kept open per API URL.
+///
+Settings Settings::withConnectionPoolSize(std::size_t connectionPoolSize) const {
+	auto copy = *this;
+	copy.connectionPoolSize(connectionPoolSize);
+	return copy;
+}
+
+///
+/// Returns the maximal number of idle connections kept open per API URL.
+///
+std::size_t Settings::connectionPoolSize() const {
+	return connectionPoolSize_;
+}
+
+///
+/// Sets a new maximal number of connections used at once per API URL.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// It limits the number of requests that are sent to the API at once. When
+/// all the connections are in use, further requests wait until one of them
+/// is returned to the pool.
+///
+/// @par Preconditions
+/// - @a maxConnectionCount is greater than zero
+///
+Settings &Settings::maxConnectionCount(std::size_t maxConnectionCount) {
+	maxConnectionCount_ = maxConnectionCount;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new maximal number of connections
+/// used at once per API URL.
+///
+Settings Settings::withMaxConnectionCount(std::size_t maxConnectionCount) const {
+	auto copy = *this;
+	copy.maxConnectionCount(maxConnectionCount);
+	return copy;
+}
+
+///
+/// Returns the maximal number of connections used at once per API URL.
+///
+std::size_t Settings::maxConnectionCount() const {
+	return maxConnectionCount_;
+}
+
+///
+/// Sets a new idle timeout of pooled connections (in milliseconds).
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// A pooled connection that has not been used for at least the given time is
+/// considered to be stale (the server has most likely closed it), so it is
+/// dropped instead of being reused.
+///
+Settings &Settings::connectionIdleTimeout(int connectionIdleTimeout) {
+	connectionIdleTimeout_ = connectionIdleTimeout;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new idle timeout of pooled
+/// connections (in milliseconds).
+///
+Settings Settings::withConnectionIdleTimeout(int connectionIdleTimeout) const {
+	auto copy = *this;
+	copy.connectionIdleTimeout(connectionIdleTimeout);
+	return copy;
+}
+
+///
+/// Returns the idle timeout of pooled connections (in milliseconds).
+///
+int Settings::connectionIdleTimeout() const {
+	return connectionIdleTimeout_;
+}
+
+///
+/// Sets a new number of threads processing I/O of connections.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// All connections with the same number of I/O threads share a single I/O
+/// service, so the number of threads does not depend on the number of
+/// resources that are being processed.
+///
+/// @par Preconditions
+/// - @a ioThreadCount is greater than zero
+///
+Settings &Settings::ioThreadCount(std::size_t ioThreadCount) {
+	ioThreadCount_ = ioThreadCount;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new number of threads processing I/O
+/// of connections.
+///
+Settings Settings::withIoThreadCount(std::size_t ioThreadCount) const {
+	auto copy = *this;
+	copy.ioThreadCount(ioThreadCount);
+	return copy;
+}
+
+///
+/// Returns the number of threads processing I/O of connections.
+///
+std::size_t Settings::ioThreadCount() const {
+	return ioThreadCount_;
+}
+
+///
+/// Sets a new policy deciding how often statuses of resources are polled.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// The policy is used when waiting for resources started by services with
+/// these settings, unless another policy is passed to the waiting member
+/// function.
+///
+/// @par Preconditions
+/// - @a pollingPolicy is non-null
+///
+Settings &Settings::pollingPolicy(
+		std::shared_ptr<const PollingPolicy> pollingPolicy) {
+	pollingPolicy_ = std::move(pollingPolicy);
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new policy deciding how often
+/// statuses of resources are polled.
+///
+Settings Settings::withPollingPolicy(
+		std::shared_ptr<const PollingPolicy> pollingPolicy) const {
+	auto copy = *this;
+	copy.pollingPolicy(std::move(pollingPolicy));
+	return copy;
+}
+
+///
+/// Returns the policy deciding how often statuses of resources are polled.
+///
+std::shared_ptr<const PollingPolicy> Settings::pollingPolicy() const {
+	return pollingPolicy_;
+}
+
+///
+/// Sets a new directory with the cache of results.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// When the directory is set, results of successfully finished resources are
+/// stored into it. When a resource with the same arguments and input files is
+/// run again, it is not sent to the API. Instead, the finished resource is
+/// returned right away and its outputs that have already been obtained are
+/// read from the directory. The directory may be shared by several processes.
+/// When the directory is empty, the cache is disabled.
+///
+Settings &Settings::resultCacheDirectory(
+		const std::string &resultCacheDirectory) {
+	resultCacheDirectory_ = resultCacheDirectory;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new directory with the cache of
+/// results.
+///
+Settings Settings::withResultCacheDirectory(
+		const std::string &resultCacheDirectory) const {
+	auto copy = *this;
+	copy.resultCacheDirectory(resultCacheDirectory);
+	return copy;
+}
+
+///
+/// Returns the directory with the cache of results (empty when the cache is
+/// disabled).
+///
+std::string Settings::resultCacheDirectory() const {
+	return resultCacheDirectory_;
+}
+
+///
+/// Sets a new maximal size of the cache of results (in bytes).
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// When the cache gets larger, the least recently used results are evicted.
+///
+Settings &Settings::resultCacheMaxSize(std::uint64_t resultCacheMaxSize) {
+	resultCacheMaxSize_ = resultCacheMaxSize;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new maximal size of the cache of
+/// results (in bytes).
+///
+Settings Settings::withResultCacheMaxSize(
+		std::uint64_t resultCacheMaxSize) const {
+	auto copy = *this;
+	copy.resultCacheMaxSize(resultCacheMaxSize);
+	return copy;
+}
+
+///
+/// Returns the maximal size of the cache of results (in bytes).
+///
+std::uint64_t Settings::resultCacheMaxSize() const {
+	return resultCacheMaxSize_;
+}
+
+///
+/// Sets whether identical runs that are in progress should share a single
+/// resource.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// When it is enabled and a resource is run while a resource with the same
+/// arguments and input files is being run or has not finished yet, no request
+/// is sent. Instead, the returned resource is a new handle of the resource that
+/// is in progress. The handles share their status updates and downloaded
+/// outputs. Only runs from the same service (e.g. the same Decompiler) are
+/// deduplicated.
+///
+Settings &Settings::deduplicateRuns(bool deduplicateRuns) {
+	deduplicateRuns_ = deduplicateRuns;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new setting of whether identical runs
+/// that are in progress should share a single resource.
+///
+Settings Settings::withDeduplicateRuns(bool deduplicateRuns) const {
+	auto copy = *this;
+	copy.deduplicateRuns(deduplicateRuns);
+	return copy;
+}
+
+///
+/// Should identical runs that are in progress share a single resource?
+///
+bool Settings::deduplicateRuns() const {
+	return deduplicateRuns_;
+}
+
+///
+/// Sets a new path to the journal of started resources.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// When the path is set, a record is appended to the file whenever a
+/// decompilation or analysis is started. After the process is restarted, the
+/// resources can be obtained from the journal without being run again (see
+/// Decompiler::reattach() and Fileinfo::reattach()). The file may be shared by
+/// several processes and it is never truncated. When the path is empty, the
+/// journal is disabled.
+///
+Settings &Settings::journalPath(const std::string &journalPath) {
+	journalPath_ = journalPath;
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new path to the journal of started
+/// resources.
+///
+Settings Settings::withJournalPath(const std::string &journalPath) const {
+	auto copy = *this;
+	copy.journalPath(journalPath);
+	return copy;
+}
+
+///
+/// Returns the path to the journal of started resources (empty when the
+/// journal is disabled).
+///
+std::string Settings::journalPath() const {
+	return journalPath_;
+}
+
+///
+/// Sets a new observer of requests sent to the API.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// The observer is told about every request sent by services with these
+/// settings once the request finishes (see RequestObserver). When it is null,
+/// requests are not measured.
+///
+Settings &Settings::requestObserver(
+		std::shared_ptr<RequestObserver> requestObserver) {
+	requestObserver_ = std::move(requestObserver);
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new observer of requests sent to the
+/// API.
+///
+Settings Settings::withRequestObserver(
+		std::shared_ptr<RequestObserver> requestObserver) const {
+	auto copy = *this;
+	copy.requestObserver(std::move(requestObserver));
+	return copy;
+}
+
+///
+/// Returns the observer of requests sent to the API (null when there is
+/// none).
+///
+std::shared_ptr<RequestObserver> Settings::requestObserver() const {
+	return requestObserver_;
+}
+
+///
+/// Sets new metrics into which requests and resources are recorded.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// When they are null, nothing is recorded.
+///
+Settings &Settings::metrics(std::shared_ptr<Metrics> metrics) {
+	metrics_ = std::move(metrics);
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with new metrics into which requests and
+/// resources are recorded.
+///
+Settings Settings::withMetrics(std::shared_ptr<Metrics> metrics) const {
+	auto copy = *this;
+	copy.metrics(std::move(metrics));
+	return copy;
+}
+
+///
+/// Returns the metrics into which requests and resources are recorded (null
+/// when they are not recorded).
+///
+std::shared_ptr<Metrics> Settings::metrics() const {
+	return metrics_;
+}
+
+///
+/// Sets a new tracer of lifecycles of resources.
+///
+/// @returns Reference to the modified settings (i.e. @c *this).
+///
+/// When it is null, nothing is traced.
+///
+Settings &Settings::tracer(std::shared_ptr<Tracer> tracer) {
+	tracer_ = std::move(tracer);
+	return *this;
+}
+
+///
+/// Returns a copy of the settings with a new tracer of lifecycles of
+/// resources.
+///
+Settings Settings::withTracer(std::shared_ptr<Tracer> tracer) const {
+	auto copy = *this;
+	copy.tracer(std::move(tracer));
+	return copy;
+}
+
+///
+/// Returns the tracer of lifecycles of resources (null when they are not
+/// traced).
+///
+std::shared_ptr<Tracer> Settings::tracer() const {
+	return tracer_;
+}
+
 /// Default URL to the API.
 const std::string Settings::DefaultApiUrl = "https://retdec.com/service/api";
 
@@ -134,4 +550,45 @@ const std::string Settings::DefaultApiKey = "";
 const std::string Settings::DefaultUserAgent = "retdec-cpp/" +
 	operatingSystemName();
 
+/// Default maximal number of idle connections kept open per API URL.
+const std::size_t Settings::DefaultConnectionPoolSize = 4;
+
+/// Default maximal number of connections used at once per API URL.
+const std::size_t Settings::DefaultMaxConnectionCount = 32;
+
+/// Default idle timeout of pooled connections (in milliseconds).
+const int Settings::DefaultConnectionIdleTimeout = 10000;
+
+/// Default number of threads processing I/O of connections (one per processor).
+const std::size_t Settings::DefaultIoThreadCount = processorCount();
+
+/// Default policy deciding how often statuses of resources are polled (a
+/// randomized delay between 250 milliseconds and 10 seconds, which grows while
+/// resources do not make any progress).
+const std::shared_ptr<const PollingPolicy> Settings::DefaultPollingPolicy =
+	PollingPolicy::decorrelatedJitter(
+		std::chrono::milliseconds(250), std::chrono::seconds(10));
+
+/// Default directory with the cache of results (the cache is disabled).
+const std::string Settings::DefaultResultCacheDirectory = "";
+
+/// Default maximal size of the cache of results (1 GB).
+const std::uint64_t Settings::DefaultResultCacheMaxSize = 1024 * 1024 * 1024;
+
+/// By default, identical runs are not deduplicated.
+const bool Settings::DefaultDeduplicateRuns = false;
+
+/// Default path to the journal of started resources (the journal is
+/// disabled).
+const std::string Settings::DefaultJournalPath = "";
+
+/// By default, there is no observer of requests.
+const std::shared_ptr<RequestObserver> Settings::DefaultRequestObserver;
+
+/// By default, no metrics are recorded.
+const std::shared_ptr<Metrics> Settings::DefaultMetrics;
+
+/// By default, resources are not traced.
+const std::shared_ptr<Tracer> Settings::DefaultTracer;
+
 } // namespace retdec
@@ -7,7 +7,7 @@
 
 #include <string>
 
-#include "retdec/internal/connection_managers/real_connection_manager.h"
+#include "retdec/internal/connection_managers/pooled_connection_manager.h"
 #include "retdec/internal/service_impl.h"
 #include "retdec/settings.h"
 #include "retdec/test.h"
@@ -50,7 +50,7 @@ TestImpl::~TestImpl() = default;
 /// Constructs a test with the given settings.
 ///
 Test::Test(const Settings &settings):
-	Test(settings, std::make_shared<RealConnectionManager>()) {}
+	Test(settings, std::make_shared<PooledConnectionManager>()) {}
 
 ///
 /// Constructs a test with the given settings and connection manager.
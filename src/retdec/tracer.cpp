@@ -0,0 +1,56 @@
+///
+/// @file      retdec/tracer.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the tracer of lifecycles of resources.
+///
+
+#include "retdec/internal/trace_buffer.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/tracer.h"
+
+using namespace retdec::internal;
+
+namespace retdec {
+
+///
+/// Constructs a tracer keeping at most @a capacity most recent events.
+///
+Tracer::Tracer(std::size_t capacity):
+	buffer_(std::make_shared<TraceBuffer>(capacity)) {}
+
+///
+/// Destructs the tracer.
+///
+Tracer::~Tracer() = default;
+
+///
+/// Returns the kept events in the JSON format of Chrome trace events.
+///
+/// The result can be opened in @c chrome://tracing or in Perfetto.
+///
+std::string Tracer::toChromeTraceJson() const {
+	return buffer_->toChromeTraceJson();
+}
+
+///
+/// Writes the kept events in the JSON format of Chrome trace events into the
+/// given file.
+///
+/// @throws FilesystemError When the file cannot be written.
+///
+void Tracer::writeChromeTrace(const std::string &filePath) const {
+	writeFile(filePath, toChromeTraceJson());
+}
+
+///
+/// Returns the buffer holding the events.
+///
+std::shared_ptr<TraceBuffer> Tracer::buffer() const {
+	return buffer_;
+}
+
+/// By default, the tracer keeps 64 Ki events.
+const std::size_t Tracer::DefaultCapacity = 64 * 1024;
+
+} // namespace retdec
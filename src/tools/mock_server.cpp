@@ -0,0 +1,800 @@
+///
+/// @file      tools/mock_server.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     A local HTTP server emulating the decompiler, fileinfo, and test
+///            services of the API, for load testing of the library.
+///
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <json/json.h>
+
+namespace {
+
+using boost::asio::ip::tcp;
+
+/// Clock used to measure the processing of resources.
+using Clock = std::chrono::steady_clock;
+
+///
+/// Configuration of the server.
+///
+struct Config {
+	/// Address on which the server listens.
+	std::string address = "127.0.0.1";
+
+	/// Port on which the server listens.
+	unsigned short port = 8000;
+
+	/// Time needed to process a resource.
+	std::chrono::milliseconds processingTime{5000};
+
+	/// Maximal deviation of the processing time of a resource (a fraction of
+	/// the processing time).
+	double processingJitter = 0.0;
+
+	/// Shape of the completion of resources over time (@c linear,
+	/// @c ease-in, @c ease-out, or @c steps).
+	std::string completionCurve = "linear";
+
+	/// Delay of every response.
+	std::chrono::milliseconds latency{0};
+
+	/// Probability that a resource fails.
+	double failureRate = 0.0;
+
+	/// Probability that a request fails with 500 Internal Server Error.
+	double errorRate = 0.0;
+
+	/// Probability that a request is rejected with 429 Too Many Requests.
+	double throttleRate = 0.0;
+
+	/// Maximal number of requests per second, above which requests are
+	/// rejected with 429 Too Many Requests (0 means unlimited).
+	std::size_t maxRequestsPerSecond = 0;
+
+	/// Size of outputs of resources (in bytes).
+	std::uint64_t outputSize = 1024;
+
+	/// Seed of the random number generator.
+	unsigned seed = std::random_device()();
+};
+
+///
+/// HTTP request.
+///
+struct Request {
+	/// Method (e.g. @c GET).
+	std::string method;
+
+	/// Path (without the query).
+	std::string path;
+
+	/// Arguments from the query.
+	std::map<std::string, std::string> args;
+
+	/// Headers (with lower-case names).
+	std::map<std::string, std::string> headers;
+
+	/// Size of the body (in bytes).
+	std::uint64_t bodySize = 0;
+
+	/// Should the connection be kept open after the response?
+	bool keepAlive = true;
+};
+
+///
+/// HTTP response.
+///
+struct Response {
+	/// Status code.
+	int code = 200;
+
+	/// Reason phrase.
+	std::string reason = "OK";
+
+	/// Additional headers.
+	std::vector<std::pair<std::string, std::string>> headers;
+
+	/// Body.
+	std::shared_ptr<const std::string> body;
+};
+
+///
+/// Resource (a decompilation or an analysis) processed by the server.
+///
+struct Resource {
+	/// When the resource was created.
+	Clock::time_point created;
+
+	/// Time needed to process the resource.
+	Clock::duration processingTime;
+
+	/// Does the resource fail?
+	bool fails = false;
+};
+
+///
+/// Returns @a str with all letters converted to lower case.
+///
+std::string toLower(std::string str) {
+	std::transform(str.begin(), str.end(), str.begin(),
+		[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return str;
+}
+
+///
+/// Returns @a str without leading and trailing whitespace.
+///
+std::string trim(const std::string &str) {
+	auto begin = str.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos) {
+		return "";
+	}
+	auto end = str.find_last_not_of(" \t\r\n");
+	return str.substr(begin, end - begin + 1);
+}
+
+///
+/// Returns the given value as a JSON string without any indentation.
+///
+std::shared_ptr<const std::string> toJsonBody(const Json::Value &value) {
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+	return std::make_shared<std::string>(Json::writeString(builder, value));
+}
+
+///
+/// Returns a response with the given status code and JSON body.
+///
+Response jsonResponse(int code, const std::string &reason,
+		const Json::Value &body) {
+	Response response;
+	response.code = code;
+	response.reason = reason;
+	response.headers.emplace_back("Content-Type", "application/json");
+	response.body = toJsonBody(body);
+	return response;
+}
+
+///
+/// Returns a response with the given status code and an error in the format
+/// of the API.
+///
+Response errorResponse(int code, const std::string &reason,
+		const std::string &description) {
+	Json::Value body;
+	body["code"] = code;
+	body["message"] = reason;
+	body["description"] = description;
+	return jsonResponse(code, reason, body);
+}
+
+///
+/// Returns output of the given size resembling decompiled code.
+///
+std::shared_ptr<const std::string> generateOutput(std::uint64_t size) {
+	const std::string Line = "int function_401000(int a1) { return a1 + 1; }\n";
+	auto output = std::make_shared<std::string>();
+	output->reserve(size);
+	while (output->size() < size) {
+		output->append(Line, 0, std::min<std::uint64_t>(
+			Line.size(), size - output->size()));
+	}
+	return output;
+}
+
+///
+/// Emulation of the decompiler, fileinfo, and test services.
+///
+/// It can be used from many threads at once.
+///
+class Service {
+public:
+	explicit Service(const Config &config):
+		config(config),
+		output(generateOutput(config.outputSize)),
+		random(config.seed) {}
+
+	Response handle(const Request &request);
+
+private:
+	Response throttledResponse();
+	bool chance(double probability);
+	bool exceedsMaxRequestsPerSecond();
+
+	Response createResource(const std::string &resourcesPath);
+	Response resourceStatus(const std::string &resourcesPath,
+		const std::string &id);
+	Response resourceOutput(const std::string &resourcesPath,
+		const std::string &id, const std::string &fileName);
+	Response echo(const Request &request);
+
+	bool findResource(const std::string &resourcesPath, const std::string &id,
+		Resource &resource);
+	double progress(const Resource &resource) const;
+	int completion(double progress) const;
+
+private:
+	/// Configuration of the server.
+	const Config config;
+
+	/// Output of resources.
+	const std::shared_ptr<const std::string> output;
+
+	/// Resources by their URLs (e.g. @c /decompiler/decompilations/1).
+	std::unordered_map<std::string, Resource> resources;
+
+	/// Number of created resources.
+	std::uint64_t createdResources = 0;
+
+	/// Random number generator.
+	std::mt19937 random;
+
+	/// Second in which requests are being counted.
+	std::int64_t currentSecond = 0;
+
+	/// Number of requests received in @c currentSecond.
+	std::size_t requestsInCurrentSecond = 0;
+
+	/// Mutex guarding the resources, the random number generator, and the
+	/// numbers of requests.
+	std::mutex mutex;
+};
+
+///
+/// Handles the given request and returns the response.
+///
+/// Paths are matched by their suffixes, so any API URL can be used (e.g.
+/// @c http://127.0.0.1:8000/service/api).
+///
+Response Service::handle(const Request &request) {
+	if (exceedsMaxRequestsPerSecond() || chance(config.throttleRate)) {
+		return throttledResponse();
+	}
+	if (chance(config.errorRate)) {
+		return errorResponse(500, "Internal Server Error",
+			"The error has been injected by the mock server.");
+	}
+
+	const std::vector<std::string> ResourcesPaths{
+		"/decompiler/decompilations",
+		"/fileinfo/analyses"
+	};
+	for (const auto &resourcesPath : ResourcesPaths) {
+		auto pos = request.path.find(resourcesPath);
+		if (pos == std::string::npos) {
+			continue;
+		}
+
+		auto rest = request.path.substr(pos + resourcesPath.size());
+		if (rest.empty() || rest == "/") {
+			if (request.method != "POST") {
+				break;
+			}
+			return createResource(resourcesPath);
+		}
+
+		// /{id}/status, /{id}/outputs/hll, or /{id}/output
+		auto idEnd = rest.find('/', 1);
+		if (idEnd == std::string::npos || request.method != "GET") {
+			break;
+		}
+		auto id = rest.substr(1, idEnd - 1);
+		auto subPath = rest.substr(idEnd);
+		if (subPath == "/status") {
+			return resourceStatus(resourcesPath, id);
+		} else if (subPath == "/outputs/hll" &&
+				resourcesPath == "/decompiler/decompilations") {
+			return resourceOutput(resourcesPath, id, id + ".c");
+		} else if (subPath == "/output" &&
+				resourcesPath == "/fileinfo/analyses") {
+			return resourceOutput(resourcesPath, id, id + ".txt");
+		}
+		break;
+	}
+
+	auto echoPos = request.path.find("/test/echo");
+	if (echoPos != std::string::npos &&
+			echoPos + 10 == request.path.size()) {
+		return echo(request);
+	}
+
+	return errorResponse(404, "Not Found",
+		"The requested URL was not found on the server.");
+}
+
+///
+/// Returns a response rejecting a request because of too many requests.
+///
+Response Service::throttledResponse() {
+	auto response = errorResponse(429, "Too Many Requests",
+		"The request has been throttled by the mock server.");
+	response.headers.emplace_back("Retry-After", "1");
+	return response;
+}
+
+///
+/// Returns @c true with the given probability.
+///
+bool Service::chance(double probability) {
+	if (probability <= 0.0) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	return std::uniform_real_distribution<double>(0.0, 1.0)(random) <
+		probability;
+}
+
+///
+/// Counts a request and checks whether the maximal number of requests per
+/// second has been exceeded.
+///
+bool Service::exceedsMaxRequestsPerSecond() {
+	if (config.maxRequestsPerSecond == 0) {
+		return false;
+	}
+
+	auto second = std::chrono::duration_cast<std::chrono::seconds>(
+		Clock::now().time_since_epoch()).count();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (second != currentSecond) {
+		currentSecond = second;
+		requestsInCurrentSecond = 0;
+	}
+	return ++requestsInCurrentSecond > config.maxRequestsPerSecond;
+}
+
+///
+/// Creates a new resource and returns its ID.
+///
+Response Service::createResource(const std::string &resourcesPath) {
+	std::string id;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::ostringstream idStream;
+		idStream << std::hex << ++createdResources;
+		id = idStream.str();
+
+		Resource resource;
+		resource.created = Clock::now();
+		auto jitter = std::uniform_real_distribution<double>(
+			-config.processingJitter, config.processingJitter)(random);
+		resource.processingTime = std::chrono::duration_cast<Clock::duration>(
+			config.processingTime * std::max(0.0, 1.0 + jitter));
+		resource.fails =
+			std::uniform_real_distribution<double>(0.0, 1.0)(random) <
+				config.failureRate;
+		resources.emplace(resourcesPath + "/" + id, resource);
+	}
+
+	Json::Value body;
+	body["id"] = id;
+	body["links"]["status"] = resourcesPath + "/" + id + "/status";
+	return jsonResponse(200, "OK", body);
+}
+
+///
+/// Returns the status of the given resource.
+///
+Response Service::resourceStatus(const std::string &resourcesPath,
+		const std::string &id) {
+	Resource resource;
+	if (!findResource(resourcesPath, id, resource)) {
+		return errorResponse(404, "Not Found",
+			"There is no resource with ID " + id + ".");
+	}
+
+	auto currentProgress = progress(resource);
+	auto finished = currentProgress >= 1.0;
+	Json::Value body;
+	body["id"] = id;
+	body["finished"] = finished;
+	body["succeeded"] = finished && !resource.fails;
+	body["failed"] = finished && resource.fails;
+	body["error"] = finished && resource.fails ?
+		Json::Value("The failure has been injected by the mock server.") :
+		Json::Value();
+	body["completion"] = completion(currentProgress);
+	return jsonResponse(200, "OK", body);
+}
+
+///
+/// Returns the output of the given resource.
+///
+Response Service::resourceOutput(const std::string &resourcesPath,
+		const std::string &id, const std::string &fileName) {
+	Resource resource;
+	if (!findResource(resourcesPath, id, resource)) {
+		return errorResponse(404, "Not Found",
+			"There is no resource with ID " + id + ".");
+	}
+	if (progress(resource) < 1.0 || resource.fails) {
+		return errorResponse(404, "Not Found",
+			"The output of resource " + id + " is not available.");
+	}
+
+	Response response;
+	response.headers.emplace_back("Content-Type", "text/plain");
+	response.headers.emplace_back("Content-Disposition",
+		"attachment; filename=" + fileName);
+	response.body = output;
+	return response;
+}
+
+///
+/// Returns the arguments of the given request.
+///
+Response Service::echo(const Request &request) {
+	Json::Value body(Json::objectValue);
+	for (const auto &arg : request.args) {
+		body[arg.first] = arg.second;
+	}
+	return jsonResponse(200, "OK", body);
+}
+
+///
+/// Finds the resource with the given ID.
+///
+/// @returns @c true when it was found, @c false otherwise.
+///
+bool Service::findResource(const std::string &resourcesPath,
+		const std::string &id, Resource &resource) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = resources.find(resourcesPath + "/" + id);
+	if (it == resources.end()) {
+		return false;
+	}
+	resource = it->second;
+	return true;
+}
+
+///
+/// Returns the progress of the given resource, from 0 (just created) to 1
+/// (finished).
+///
+double Service::progress(const Resource &resource) const {
+	if (resource.processingTime <= Clock::duration::zero()) {
+		return 1.0;
+	}
+
+	std::chrono::duration<double> elapsed = Clock::now() - resource.created;
+	std::chrono::duration<double> total = resource.processingTime;
+	return std::min(1.0, elapsed / total);
+}
+
+///
+/// Returns the completion (0-100) corresponding to the given progress,
+/// shaped by the configured completion curve.
+///
+int Service::completion(double progress) const {
+	if (progress >= 1.0) {
+		return 100;
+	}
+
+	double shaped = progress;
+	if (config.completionCurve == "ease-in") {
+		shaped = progress * progress;
+	} else if (config.completionCurve == "ease-out") {
+		shaped = 1.0 - (1.0 - progress) * (1.0 - progress);
+	} else if (config.completionCurve == "steps") {
+		shaped = std::floor(progress * 4.0) / 4.0;
+	}
+	// Unfinished resources never report a completion of 100.
+	return std::min(99, static_cast<int>(shaped * 100.0));
+}
+
+///
+/// Parses the query of a URL into @a args.
+///
+void parseQuery(const std::string &query,
+		std::map<std::string, std::string> &args) {
+	std::istringstream queryStream(query);
+	std::string arg;
+	while (std::getline(queryStream, arg, '&')) {
+		auto eq = arg.find('=');
+		if (eq == std::string::npos) {
+			args[arg] = "";
+		} else {
+			args[arg.substr(0, eq)] = arg.substr(eq + 1);
+		}
+	}
+}
+
+///
+/// Reads and discards exactly @a size bytes of a body, starting with the
+/// bytes already in @a buffer.
+///
+void discardBody(tcp::socket &socket, boost::asio::streambuf &buffer,
+		std::uint64_t size) {
+	auto buffered = std::min<std::uint64_t>(size, buffer.size());
+	buffer.consume(buffered);
+	size -= buffered;
+
+	std::array<char, 64 * 1024> chunk;
+	while (size > 0) {
+		auto toRead = std::min<std::uint64_t>(size, chunk.size());
+		size -= socket.read_some(boost::asio::buffer(chunk, toRead));
+	}
+}
+
+///
+/// Reads and discards a body in the chunked transfer encoding.
+///
+/// @returns The size of the decoded body (in bytes).
+///
+std::uint64_t discardChunkedBody(tcp::socket &socket,
+		boost::asio::streambuf &buffer) {
+	std::uint64_t bodySize = 0;
+	for (;;) {
+		boost::asio::read_until(socket, buffer, "\r\n");
+		std::istream stream(&buffer);
+		std::string sizeLine;
+		std::getline(stream, sizeLine);
+		auto chunkSize = std::stoull(trim(sizeLine), nullptr, 16);
+		if (chunkSize == 0) {
+			// Trailing headers (if any) are followed by an empty line.
+			std::string line;
+			do {
+				boost::asio::read_until(socket, buffer, "\r\n");
+				std::getline(stream, line);
+			} while (!trim(line).empty());
+			return bodySize;
+		}
+
+		// The chunk is followed by CRLF.
+		if (buffer.size() < chunkSize + 2) {
+			boost::asio::read(socket, buffer,
+				boost::asio::transfer_exactly(chunkSize + 2 - buffer.size()));
+		}
+		buffer.consume(chunkSize + 2);
+		bodySize += chunkSize;
+	}
+}
+
+///
+/// Reads a request from the given socket.
+///
+/// @returns @c false when the connection has been closed.
+///
+bool readRequest(tcp::socket &socket, boost::asio::streambuf &buffer,
+		Request &request) {
+	boost::system::error_code ec;
+	boost::asio::read_until(socket, buffer, "\r\n\r\n", ec);
+	if (ec) {
+		return false;
+	}
+
+	std::istream stream(&buffer);
+	std::string requestLine;
+	std::getline(stream, requestLine);
+	std::istringstream requestLineStream(requestLine);
+	std::string target;
+	std::string version;
+	requestLineStream >> request.method >> target >> version;
+	auto queryPos = target.find('?');
+	request.path = target.substr(0, queryPos);
+	if (queryPos != std::string::npos) {
+		parseQuery(target.substr(queryPos + 1), request.args);
+	}
+
+	std::string line;
+	while (std::getline(stream, line) && !trim(line).empty()) {
+		auto colon = line.find(':');
+		if (colon != std::string::npos) {
+			request.headers[toLower(trim(line.substr(0, colon)))] =
+				trim(line.substr(colon + 1));
+		}
+	}
+
+	auto connection = toLower(request.headers["connection"]);
+	request.keepAlive = version == "HTTP/1.1" ?
+		connection != "close" : connection == "keep-alive";
+
+	if (toLower(request.headers["transfer-encoding"]) == "chunked") {
+		request.bodySize = discardChunkedBody(socket, buffer);
+	} else if (!request.headers["content-length"].empty()) {
+		request.bodySize = std::stoull(request.headers["content-length"]);
+		discardBody(socket, buffer, request.bodySize);
+	}
+	return true;
+}
+
+///
+/// Writes the whole given data into the given socket.
+///
+void writeAll(tcp::socket &socket, const std::string &data) {
+	std::size_t written = 0;
+	while (written < data.size()) {
+		written += socket.write_some(
+			boost::asio::buffer(data.data() + written, data.size() - written));
+	}
+}
+
+///
+/// Writes the given response into the given socket.
+///
+void writeResponse(tcp::socket &socket, const Response &response,
+		bool keepAlive) {
+	const std::string EmptyBody;
+	const auto &body = response.body ? *response.body : EmptyBody;
+
+	std::ostringstream head;
+	head << "HTTP/1.1 " << response.code << " " << response.reason << "\r\n";
+	for (const auto &header : response.headers) {
+		head << header.first << ": " << header.second << "\r\n";
+	}
+	head << "Content-Length: " << body.size() << "\r\n";
+	head << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+	head << "\r\n";
+	auto headString = head.str();
+
+	writeAll(socket, headString);
+	writeAll(socket, body);
+}
+
+///
+/// Serves requests received over the given connection until it is closed.
+///
+void serveConnection(tcp::socket socket, Service &service,
+		const Config &config) {
+	try {
+		boost::asio::streambuf buffer;
+		for (;;) {
+			Request request;
+			if (!readRequest(socket, buffer, request)) {
+				return;
+			}
+
+			auto response = service.handle(request);
+			if (config.latency.count() > 0) {
+				std::this_thread::sleep_for(config.latency);
+			}
+			writeResponse(socket, response, request.keepAlive);
+			if (!request.keepAlive) {
+				return;
+			}
+		}
+	} catch (const std::exception &) {
+		// The connection has been closed by the client or it is broken, so
+		// there is nobody to respond to.
+	}
+}
+
+///
+/// Prints the usage of the server.
+///
+void printUsage(const std::string &programName) {
+	std::cerr << "usage: " << programName << " [OPTIONS]\n"
+		"\n"
+		"Emulates the decompiler, fileinfo, and test services of the API.\n"
+		"\n"
+		"Options:\n"
+		"  --address ADDRESS         address to listen on (default: 127.0.0.1)\n"
+		"  --port PORT               port to listen on (default: 8000)\n"
+		"  --processing-time MS      processing time of resources (default: 5000)\n"
+		"  --processing-jitter F     maximal deviation of processing times, as a\n"
+		"                            fraction of the processing time (default: 0)\n"
+		"  --completion-curve CURVE  linear, ease-in, ease-out, or steps\n"
+		"                            (default: linear)\n"
+		"  --latency MS              delay of every response (default: 0)\n"
+		"  --failure-rate P          probability that a resource fails\n"
+		"                            (default: 0)\n"
+		"  --error-rate P            probability of 500 Internal Server Error\n"
+		"                            (default: 0)\n"
+		"  --throttle-rate P         probability of 429 Too Many Requests\n"
+		"                            (default: 0)\n"
+		"  --max-requests-per-second N\n"
+		"                            answer requests above N per second with\n"
+		"                            429 Too Many Requests (default: unlimited)\n"
+		"  --output-size BYTES       size of outputs of resources (default: 1024)\n"
+		"  --seed SEED               seed of the random number generator\n";
+}
+
+///
+/// Parses the given command-line arguments into @a config.
+///
+/// @returns @c false when the arguments are invalid.
+///
+bool parseArgs(int argc, char **argv, Config &config) {
+	for (int i = 1; i < argc; ++i) {
+		std::string name(argv[i]);
+		if (i + 1 >= argc) {
+			return false;
+		}
+		std::string value(argv[++i]);
+
+		if (name == "--address") {
+			config.address = value;
+		} else if (name == "--port") {
+			config.port = static_cast<unsigned short>(std::stoul(value));
+		} else if (name == "--processing-time") {
+			config.processingTime = std::chrono::milliseconds(std::stoll(value));
+		} else if (name == "--processing-jitter") {
+			config.processingJitter = std::stod(value);
+		} else if (name == "--completion-curve") {
+			if (value != "linear" && value != "ease-in" &&
+					value != "ease-out" && value != "steps") {
+				return false;
+			}
+			config.completionCurve = value;
+		} else if (name == "--latency") {
+			config.latency = std::chrono::milliseconds(std::stoll(value));
+		} else if (name == "--failure-rate") {
+			config.failureRate = std::stod(value);
+		} else if (name == "--error-rate") {
+			config.errorRate = std::stod(value);
+		} else if (name == "--throttle-rate") {
+			config.throttleRate = std::stod(value);
+		} else if (name == "--max-requests-per-second") {
+			config.maxRequestsPerSecond = std::stoull(value);
+		} else if (name == "--output-size") {
+			config.outputSize = std::stoull(value);
+		} else if (name == "--seed") {
+			config.seed = static_cast<unsigned>(std::stoul(value));
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+	Config config;
+	try {
+		if (!parseArgs(argc, argv, config)) {
+			printUsage(argv[0]);
+			return 1;
+		}
+	} catch (const std::exception &) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	try {
+		Service service(config);
+		boost::asio::io_service ioService;
+		tcp::acceptor acceptor(ioService, tcp::endpoint(
+			boost::asio::ip::address::from_string(config.address), config.port));
+		std::cout << "listening on http://" << config.address << ":"
+			<< acceptor.local_endpoint().port() << "/service/api"
+			<< std::endl;
+
+		// Every connection is served by its own thread. Clients keep their
+		// connections open, so there are only a few of them per client.
+		for (;;) {
+			tcp::socket socket(ioService);
+			acceptor.accept(socket);
+			std::thread(serveConnection, std::move(socket), std::ref(service),
+				std::cref(config)).detach();
+		}
+	} catch (const std::exception &ex) {
+		std::cerr << "error: " << ex.what() << "\n";
+		return 1;
+	}
+}
@@ -5,7 +5,9 @@
 /// @brief     Tests for the analysis.
 ///
 
+#include <cstddef>
 #include <memory>
+#include <string>
 
 #include <gtest/gtest.h>
 #include <json/json.h>
@@ -13,7 +15,10 @@
 #include "retdec/analysis.h"
 #include "retdec/internal/connection_mock.h"
 #include "retdec/internal/utilities/json.h"
+#include "retdec/file.h"
+#include "retdec/internal/utilities/os.h"
 #include "retdec/settings.h"
+#include "retdec/test_utilities/tmp_file.h"
 
 using namespace testing;
 using namespace retdec::internal;
@@ -66,5 +71,80 @@ HasFinishedSendsCorrectRequestWhenNoFinishedInfo) {
 	analysis.hasFinished();
 }
 
+TEST_F(AnalysisTests,
+StreamOutputPassesOutputToHandler) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, body())
+		.WillByDefault(Return("output"));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/fileinfo/analyses/123/output"))
+		.WillOnce(Return(refResponse.release()));
+
+	Analysis analysis("123", conn);
+	std::string output;
+	analysis.streamOutput([&](const char *data, std::size_t size) {
+		output.append(data, size);
+	});
+
+	ASSERT_EQ("output", output);
+}
+
+TEST_F(AnalysisTests,
+DownloadOutputAsFileWritesOutputToFileInGivenDirectory) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, body())
+		.WillByDefault(Return("output"));
+	ON_CALL(*refResponse, attachedFileName())
+		.WillByDefault(Return("test-downloaded-output.txt"));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/fileinfo/analyses/123/output"))
+		.WillOnce(Return(refResponse.release()));
+
+	Analysis analysis("123", conn);
+	auto file = analysis.downloadOutputAsFile(".");
+	RemoveFileOnDestruction remover(joinPaths(".", "test-downloaded-output.txt"));
+
+	ASSERT_EQ("test-downloaded-output.txt", file->getName());
+	ASSERT_EQ("output", readFile(joinPaths(".", "test-downloaded-output.txt")));
+	ASSERT_EQ(file, analysis.getOutputAsFile());
+}
+
+TEST_F(AnalysisTests,
+GetOutputViewReturnsViewOfContentOfOutputFile) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	EXPECT_CALL(*refResponse, bodyAsFileProxy())
+		.WillOnce(Return(
+			File::fromContentWithName("output", "output.txt").release()));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/fileinfo/analyses/123/output"))
+		.WillOnce(Return(refResponse.release()));
+
+	Analysis analysis("123", conn);
+	auto view1 = analysis.getOutputView();
+	auto view2 = analysis.getOutputView();
+
+	ASSERT_EQ("output", view1.toString());
+	ASSERT_EQ(view1.data(), view2.data());
+	ASSERT_EQ(view1.data(), analysis.getOutputAsFile()->getContentView().data());
+}
+
 } // namespace tests
 } // namespace retdec
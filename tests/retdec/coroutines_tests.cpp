@@ -0,0 +1,314 @@
+///
+/// @file      retdec/coroutines_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the coroutine awaitables.
+///
+/// This file is compiled in C++20 mode (when the compiler supports it).
+///
+
+#include "retdec/coroutines.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/analysis.h"
+#include "retdec/analysis_arguments.h"
+#include "retdec/decompilation.h"
+#include "retdec/decompilation_arguments.h"
+#include "retdec/decompiler.h"
+#include "retdec/exceptions.h"
+#include "retdec/file.h"
+#include "retdec/fileinfo.h"
+#include "retdec/internal/connection_manager_mock.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/utilities/json.h"
+#include "retdec/settings.h"
+
+using namespace testing;
+using namespace retdec::internal;
+using namespace retdec::internal::tests;
+
+namespace retdec {
+namespace tests {
+
+namespace {
+
+///
+/// Coroutine that starts right away and can be checked for completion.
+///
+class Task {
+public:
+	struct promise_type {
+		Task get_return_object() {
+			return Task(std::coroutine_handle<promise_type>::from_promise(
+				*this));
+		}
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept {
+			error = std::current_exception();
+		}
+
+		/// Exception that escaped the coroutine (if any).
+		std::exception_ptr error;
+	};
+
+public:
+	explicit Task(std::coroutine_handle<promise_type> handle):
+		handle(handle) {}
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+	~Task() { handle.destroy(); }
+
+	bool isDone() const { return handle.done(); }
+
+	void rethrowError() const {
+		if (handle.promise().error) {
+			std::rethrow_exception(handle.promise().error);
+		}
+	}
+
+private:
+	std::coroutine_handle<promise_type> handle;
+};
+
+///
+/// Returns a mock of a response with the given status code and JSON body.
+///
+ResponseMock *jsonResponse(int statusCode, const std::string &body) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(statusCode));
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(Return(toJson(body)));
+	return response;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for the coroutine awaitables.
+///
+class CoroutinesTests: public Test {
+public:
+	CoroutinesTests();
+
+	/// Connection used by the services and resources.
+	std::shared_ptr<ConnectionMock> conn;
+
+	/// Connection manager returning the connection.
+	std::shared_ptr<ConnectionManagerMock> connectionManager;
+};
+
+///
+/// Sets up a connection manager returning a connection mock.
+///
+CoroutinesTests::CoroutinesTests():
+		conn(std::make_shared<NiceMock<ConnectionMock>>()),
+		connectionManager(std::make_shared<NiceMock<ConnectionManagerMock>>()) {
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	ON_CALL(*connectionManager, newConnection(_))
+		.WillByDefault(Return(conn));
+}
+
+TEST_F(CoroutinesTests,
+AwaitingResumesCoroutineWhenHandlerIsCalledLater) {
+	std::function<void (int)> handler;
+	int result = 0;
+	auto coroutine = [&]() -> Task {
+		result = co_await awaitCompletion<int>([&](auto state) {
+			handler = [state](int value) { state->complete(nullptr, value); };
+		});
+	};
+
+	auto task = coroutine();
+	ASSERT_FALSE(task.isDone());
+
+	handler(42);
+
+	ASSERT_TRUE(task.isDone());
+	ASSERT_EQ(42, result);
+}
+
+TEST_F(CoroutinesTests,
+AwaitingResumesCoroutineWhenHandlerIsCalledFromAnotherThread) {
+	std::thread handlerThread;
+	auto coroutine = [&]() -> Task {
+		co_await awaitCompletion<void>([&](auto state) {
+			handlerThread = std::thread([state]() {
+				state->complete(nullptr);
+			});
+		});
+	};
+
+	auto task = coroutine();
+	handlerThread.join();
+
+	ASSERT_TRUE(task.isDone());
+	task.rethrowError();
+}
+
+TEST_F(CoroutinesTests,
+RunDecompilationReturnsStartedDecompilation) {
+	EXPECT_CALL(*conn, sendPostRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations", _, _))
+		.WillOnce(Return(jsonResponse(201, "{\"id\": \"123\"}")));
+	Decompiler decompiler(Settings(), connectionManager);
+	std::unique_ptr<Decompilation> decompilation;
+	auto coroutine = [&]() -> Task {
+		decompilation = co_await coroutines::runDecompilation(
+			decompiler, DecompilationArguments());
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	task.rethrowError();
+	ASSERT_EQ("123", decompilation->getId());
+}
+
+TEST_F(CoroutinesTests,
+RunDecompilationThrowsErrorWhenRequestFails) {
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.WillOnce(Throw(ConnectionError("connection refused")));
+	Decompiler decompiler(Settings(), connectionManager);
+	auto coroutine = [&]() -> Task {
+		co_await coroutines::runDecompilation(
+			decompiler, DecompilationArguments());
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	ASSERT_THROW(task.rethrowError(), ConnectionError);
+}
+
+TEST_F(CoroutinesTests,
+RunAnalysisReturnsStartedAnalysis) {
+	EXPECT_CALL(*conn, sendPostRequestProxy(
+			"https://retdec.com/service/api/fileinfo/analyses", _, _))
+		.WillOnce(Return(jsonResponse(201, "{\"id\": \"456\"}")));
+	Fileinfo fileinfo(Settings(), connectionManager);
+	std::unique_ptr<Analysis> analysis;
+	auto coroutine = [&]() -> Task {
+		analysis = co_await coroutines::runAnalysis(
+			fileinfo, AnalysisArguments());
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	task.rethrowError();
+	ASSERT_EQ("456", analysis->getId());
+}
+
+TEST_F(CoroutinesTests,
+WaitUntilFinishedFinishesWhenDecompilationFinishes) {
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/status"))
+		.WillOnce(Return(jsonResponse(200,
+			"{\"finished\": true, \"succeeded\": true}")));
+	Decompilation decompilation("123", conn);
+	auto coroutine = [&]() -> Task {
+		co_await coroutines::waitUntilFinished(decompilation);
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	task.rethrowError();
+	ASSERT_TRUE(decompilation.hasSucceeded());
+}
+
+TEST_F(CoroutinesTests,
+WaitUntilFinishedThrowsDecompilationErrorWhenDecompilationFails) {
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Return(jsonResponse(200,
+			"{\"finished\": true, \"failed\": true, \"error\": \"error\"}")));
+	Decompilation decompilation("123", conn);
+	auto coroutine = [&]() -> Task {
+		co_await coroutines::waitUntilFinished(decompilation);
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	ASSERT_THROW(task.rethrowError(), DecompilationError);
+}
+
+TEST_F(CoroutinesTests,
+WaitUntilFinishedDoesNotThrowWhenDecompilationFailsAndOnErrorIsNoThrow) {
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Return(jsonResponse(200,
+			"{\"finished\": true, \"failed\": true, \"error\": \"error\"}")));
+	Decompilation decompilation("123", conn);
+	auto coroutine = [&]() -> Task {
+		co_await coroutines::waitUntilFinished(
+			decompilation, Decompilation::OnError::NoThrow);
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	task.rethrowError();
+	ASSERT_TRUE(decompilation.hasFailed());
+}
+
+TEST_F(CoroutinesTests,
+WaitUntilFinishedThrowsAnalysisErrorWhenAnalysisFails) {
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/fileinfo/analyses/456/status"))
+		.WillOnce(Return(jsonResponse(200,
+			"{\"finished\": true, \"failed\": true, \"error\": \"error\"}")));
+	Analysis analysis("456", conn);
+	auto coroutine = [&]() -> Task {
+		co_await coroutines::waitUntilFinished(analysis);
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	ASSERT_THROW(task.rethrowError(), AnalysisError);
+}
+
+TEST_F(CoroutinesTests,
+GetOutputHllReturnsContentOfOutputHllFile) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(200));
+	EXPECT_CALL(*response, bodyAsFileProxy())
+		.WillOnce(Return(
+			File::fromContentWithName("int main() {}", "test.c").release()));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/outputs/hll"))
+		.WillOnce(Return(response));
+	Decompilation decompilation("123", conn);
+	std::string content;
+	auto coroutine = [&]() -> Task {
+		content = co_await coroutines::getOutputHll(decompilation);
+	};
+
+	auto task = coroutine();
+
+	ASSERT_TRUE(task.isDone());
+	task.rethrowError();
+	ASSERT_EQ("int main() {}", content);
+}
+
+} // namespace tests
+} // namespace retdec
+
+#endif
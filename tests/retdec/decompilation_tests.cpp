@@ -5,15 +5,28 @@
 /// @brief     Tests for the decompilation.
 ///
 
+#include <chrono>
+#include <cstddef>
+#include <exception>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <json/json.h>
 
 #include "retdec/decompilation.h"
+#include "retdec/exceptions.h"
 #include "retdec/internal/connection_mock.h"
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/resource_context.h"
+#include "retdec/internal/trace_buffer.h"
 #include "retdec/internal/utilities/json.h"
+#include "retdec/file.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/polling_policy.h"
 #include "retdec/settings.h"
+#include "retdec/test_utilities/tmp_file.h"
 
 using namespace testing;
 using namespace retdec::internal;
@@ -66,5 +79,354 @@ HasFinishedSendsCorrectRequestWhenNoFinishedInfo) {
 	decompilation.hasFinished();
 }
 
+TEST_F(DecompilationTests,
+WaitUntilFinishedWithPollingPolicyPollsUntilDecompilationFinishes) {
+	auto unfinishedResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*unfinishedResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*unfinishedResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": false, \"completion\": 50}"
+		)));
+	auto finishedResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*finishedResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*finishedResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": true, \"succeeded\": true, \"completion\": 100}"
+		)));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/status"))
+		.WillOnce(Return(unfinishedResponse.release()))
+		.WillOnce(Return(finishedResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	int callbackCalls = 0;
+	decompilation.waitUntilFinished(
+		[&](const Decompilation &) { ++callbackCalls; },
+		*PollingPolicy::fixed(std::chrono::milliseconds(1))
+	);
+
+	ASSERT_TRUE(decompilation.hasFinished());
+	ASSERT_EQ(100, decompilation.getCompletion());
+	ASSERT_EQ(2, callbackCalls);
+}
+
+TEST_F(DecompilationTests,
+WaitUntilFinishedRecordsStatusPollsAndDurationIntoMetrics) {
+	auto unfinishedResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*unfinishedResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*unfinishedResponse, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"finished\": false}")));
+	auto finishedResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*finishedResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*finishedResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": true, \"succeeded\": true}"
+		)));
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Return(unfinishedResponse.release()))
+		.WillOnce(Return(finishedResponse.release()));
+	auto metrics = std::make_shared<MetricsRegistry>();
+	ResourceContext context;
+	context.metrics = metrics;
+
+	Decompilation decompilation("123", conn, context);
+	decompilation.waitUntilFinished(
+		*PollingPolicy::fixed(std::chrono::milliseconds(1)));
+
+	auto text = metrics->toPrometheusText();
+	ASSERT_NE(std::string::npos, text.find(
+		"retdec_status_polls_total{service=\"decompiler\"} 2\n"));
+	ASSERT_NE(std::string::npos, text.find(
+		"retdec_resource_duration_seconds_count"
+		"{service=\"decompiler\",result=\"succeeded\"} 1\n"));
+}
+
+TEST_F(DecompilationTests,
+WaitUntilFinishedTracesStatusUpdatesAndChangesInCompletion) {
+	auto unfinishedResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*unfinishedResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*unfinishedResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": false, \"completion\": 50}"
+		)));
+	auto finishedResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*finishedResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*finishedResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": true, \"succeeded\": true, \"completion\": 100}"
+		)));
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Return(unfinishedResponse.release()))
+		.WillOnce(Return(finishedResponse.release()));
+	auto traceBuffer = std::make_shared<TraceBuffer>(100);
+	ResourceContext context;
+	context.traceBuffer = traceBuffer;
+
+	Decompilation decompilation("123", conn, context);
+	decompilation.waitUntilFinished(
+		*PollingPolicy::fixed(std::chrono::milliseconds(1)));
+
+	std::vector<std::string> names;
+	for (const auto &event : traceBuffer->events()) {
+		ASSERT_EQ("decompilations 123", event.track);
+		names.push_back(event.name);
+	}
+	ASSERT_EQ(std::vector<std::string>({
+		"completion", "updateStatus", "completion", "updateStatus",
+		"waitUntilFinished"
+	}), names);
+}
+
+TEST_F(DecompilationTests,
+StreamOutputHllPassesOutputToHandler) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, body())
+		.WillByDefault(Return("output"));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/outputs/hll"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	std::string output;
+	decompilation.streamOutputHll([&](const char *data, std::size_t size) {
+		output.append(data, size);
+	});
+
+	ASSERT_EQ("output", output);
+}
+
+TEST_F(DecompilationTests,
+DownloadOutputHllFileWritesOutputToFileInGivenDirectory) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, body())
+		.WillByDefault(Return("output"));
+	ON_CALL(*refResponse, attachedFileName())
+		.WillByDefault(Return("test-downloaded-output.c"));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/outputs/hll"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	auto file = decompilation.downloadOutputHllFile(".");
+	RemoveFileOnDestruction remover(joinPaths(".", "test-downloaded-output.c"));
+
+	ASSERT_EQ("test-downloaded-output.c", file->getName());
+	ASSERT_EQ("output", readFile(joinPaths(".", "test-downloaded-output.c")));
+	ASSERT_EQ(file, decompilation.getOutputHllFile());
+}
+
+TEST_F(DecompilationTests,
+FinishedReturnsFutureThatIsReadyWhenDecompilationFinishes) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": true, \"succeeded\": true, \"completion\": 100}"
+		)));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	// The final status obtained while waiting is reused, so the status is
+	// requested only once.
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/status"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	decompilation.finished().get();
+
+	ASSERT_TRUE(decompilation.hasFinished());
+	ASSERT_TRUE(decompilation.hasSucceeded());
+	ASSERT_EQ(100, decompilation.getCompletion());
+}
+
+TEST_F(DecompilationTests,
+FinishedReturnsFutureHoldingErrorWhenStatusCannotBeObtained) {
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Throw(ApiError(404, "Not Found")));
+
+	Decompilation decompilation("123", conn);
+
+	ASSERT_THROW(decompilation.finished().get(), ApiError);
+}
+
+TEST_F(DecompilationTests,
+FinishedRequestsStatusAgainWhenItFailsWithTransientError) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"finished\": true}")));
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Throw(ConnectionError("connection reset")))
+		.WillOnce(Throw(ApiError(503, "Service Unavailable")))
+		.WillOnce(Return(refResponse.release()));
+
+	ResourceContext context;
+	context.pollingPolicy = PollingPolicy::fixed(std::chrono::milliseconds(1));
+
+	Decompilation decompilation("123", conn, context);
+	decompilation.finished().get();
+
+	ASSERT_TRUE(decompilation.hasFinished());
+}
+
+TEST_F(DecompilationTests,
+FinishedReturnsFutureHoldingErrorWhenTransientErrorPersists) {
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillRepeatedly(Throw(ConnectionError("connection refused")));
+
+	ResourceContext context;
+	context.pollingPolicy = PollingPolicy::fixed(std::chrono::milliseconds(1));
+
+	Decompilation decompilation("123", conn, context);
+
+	ASSERT_THROW(decompilation.finished().get(), ConnectionError);
+}
+
+TEST_F(DecompilationTests,
+WhenFinishedCallsHandlerWhenDecompilationFinishes) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"finished\": true}")));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/status"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	bool handlerCalled = false;
+	decompilation.whenFinished([&](std::exception_ptr error) {
+		ASSERT_EQ(nullptr, error);
+		handlerCalled = true;
+	});
+
+	ASSERT_TRUE(handlerCalled);
+	ASSERT_TRUE(decompilation.hasFinished());
+}
+
+TEST_F(DecompilationTests,
+GetOutputHllAsyncPassesOutputToHandler) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	EXPECT_CALL(*refResponse, bodyAsFileProxy())
+		.WillOnce(Return(
+			File::fromContentWithName("int main() {}", "test.c").release()));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/outputs/hll"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	std::string outputHll;
+	decompilation.getOutputHllAsync(
+		[&](std::string output, std::exception_ptr) {
+			outputHll = output;
+		});
+
+	ASSERT_EQ("int main() {}", outputHll);
+}
+
+TEST_F(DecompilationTests,
+GetOutputHllAsyncStoresOutputHllFileSoItIsNotObtainedAgain) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	EXPECT_CALL(*refResponse, bodyAsFileProxy())
+		.WillOnce(Return(
+			File::fromContentWithName("int main() {}", "test.c").release()));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/outputs/hll"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	decompilation.getOutputHllAsync([](std::string, std::exception_ptr) {});
+	std::string outputHll;
+	decompilation.getOutputHllAsync(
+		[&](std::string output, std::exception_ptr) {
+			outputHll = output;
+		});
+
+	ASSERT_EQ("int main() {}", outputHll);
+	ASSERT_EQ("int main() {}", decompilation.getOutputHll());
+}
+
+TEST_F(DecompilationTests,
+GetOutputHllViewReturnsViewOfContentOfOutputHllFile) {
+	auto refResponse = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	EXPECT_CALL(*refResponse, bodyAsFileProxy())
+		.WillOnce(Return(
+			File::fromContentWithName("output", "output.txt").release()));
+
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	EXPECT_CALL(*conn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/123/outputs/hll"))
+		.WillOnce(Return(refResponse.release()));
+
+	Decompilation decompilation("123", conn);
+	auto view1 = decompilation.getOutputHllView();
+	auto view2 = decompilation.getOutputHllView();
+
+	ASSERT_EQ("output", view1.toString());
+	ASSERT_EQ(view1.data(), view2.data());
+	ASSERT_EQ(view1.data(), decompilation.getOutputHllFile()->getContentView().data());
+}
+
 } // namespace tests
 } // namespace retdec
@@ -5,11 +5,33 @@
 /// @brief     Tests for the decompilation service.
 ///
 
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
+#include <json/json.h>
 
+#include "retdec/decompilation.h"
+#include "retdec/decompilation_arguments.h"
 #include "retdec/decompiler.h"
+#include "retdec/exceptions.h"
+#include "retdec/file.h"
 #include "retdec/internal/connection_manager_mock.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/result_cache.h"
+#include "retdec/internal/utilities/json.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/internal/utilities/resource.h"
+#include "retdec/metrics.h"
 #include "retdec/settings.h"
+#include "retdec/test_utilities/http_server.h"
+#include "retdec/test_utilities/tmp_file.h"
 
 using namespace testing;
 using namespace retdec::internal;
@@ -21,7 +43,28 @@ namespace tests {
 ///
 /// Tests for Decompiler.
 ///
-class DecompilerTests: public Test {};
+class DecompilerTests: public Test {
+public:
+	DecompilerTests();
+
+	/// Connection used by the decompiler.
+	std::shared_ptr<ConnectionMock> conn;
+
+	/// Connection manager returning the connection.
+	std::shared_ptr<ConnectionManagerMock> connectionManager;
+};
+
+///
+/// Sets up a connection manager returning a connection mock.
+///
+DecompilerTests::DecompilerTests():
+		conn(std::make_shared<NiceMock<ConnectionMock>>()),
+		connectionManager(std::make_shared<NiceMock<ConnectionManagerMock>>()) {
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	ON_CALL(*connectionManager, newConnection(_))
+		.WillByDefault(Return(conn));
+}
 
 TEST_F(DecompilerTests,
 IsCreatedSuccessfullyWithDefaultConnectionManager) {
@@ -39,5 +82,253 @@ IsCreatedSuccessfullyWithCustomConnectionManager) {
 	);
 }
 
+TEST_F(DecompilerTests,
+RunDecompilationAsyncReturnsFutureOfDecompilationWithCorrectId) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(201)); // HTTP 201 Created
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"id\": \"123\"}")));
+	EXPECT_CALL(*conn, sendPostRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations", _, _))
+		.WillOnce(Return(response));
+	Decompiler decompiler(Settings(), connectionManager);
+
+	auto decompilation = decompiler.runDecompilationAsync(
+		DecompilationArguments()).get();
+
+	ASSERT_EQ("123", decompilation->getId());
+}
+
+TEST_F(DecompilerTests,
+RunDecompilationAsyncReturnsFutureHoldingErrorWhenRequestFails) {
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.WillOnce(Throw(ConnectionError("connection refused")));
+	Decompiler decompiler(Settings(), connectionManager);
+
+	auto decompilation = decompiler.runDecompilationAsync(
+		DecompilationArguments());
+
+	ASSERT_THROW(decompilation.get(), ConnectionError);
+}
+
+TEST_F(DecompilerTests,
+RunDecompilationAsyncWithHandlerPassesDecompilationToHandler) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(201)); // HTTP 201 Created
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"id\": \"123\"}")));
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.WillOnce(Return(response));
+	Decompiler decompiler(Settings(), connectionManager);
+
+	std::unique_ptr<Decompilation> decompilation;
+	decompiler.runDecompilationAsync(DecompilationArguments(),
+		[&](std::unique_ptr<Decompilation> d, std::exception_ptr) {
+			decompilation = std::move(d);
+		});
+
+	ASSERT_EQ("123", decompilation->getId());
+}
+
+TEST_F(DecompilerTests,
+RunDecompilationDoesNotSendAnyRequestWhenResultIsCached) {
+	auto cacheDir = uniqueFilePath(
+		boost::filesystem::temp_directory_path().string());
+	auto args = DecompilationArguments()
+		.withMode("bin")
+		.withInputFile(File::fromContentWithName("content", "file.exe"));
+	ResultCache cache(cacheDir, 1024 * 1024);
+	auto key = resourceKey(
+		"https://retdec.com/service/api/decompiler/decompilations", args);
+	cache.storeResourceId(key, "123");
+	NiceMock<ResponseMock> status;
+	ON_CALL(status, statusCode())
+		.WillByDefault(Return(200));
+	ON_CALL(status, body())
+		.WillByDefault(Return("{\"finished\": true}"));
+	cache.storeResponse(key, ResultCache::StatusResponseName, status);
+	NiceMock<ResponseMock> output;
+	ON_CALL(output, statusCode())
+		.WillByDefault(Return(200));
+	ON_CALL(output, body())
+		.WillByDefault(Return("int main() {}"));
+	cache.storeResponse(key, "outputs-hll", output);
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.Times(0);
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.Times(0);
+	Decompiler decompiler(
+		Settings().withResultCacheDirectory(cacheDir), connectionManager);
+
+	auto decompilation = decompiler.runDecompilation(args);
+	decompilation->waitUntilFinished();
+
+	ASSERT_EQ("123", decompilation->getId());
+	ASSERT_EQ("int main() {}", decompilation->getOutputHll());
+	boost::filesystem::remove_all(cacheDir);
+}
+
+TEST_F(DecompilerTests,
+RunDecompilationReturnsHandleOfInProgressDecompilationWhenRunsAreDeduplicated) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(201)); // HTTP 201 Created
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"id\": \"123\"}")));
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.WillOnce(Return(response));
+	auto args = DecompilationArguments()
+		.withMode("bin")
+		.withInputFile(File::fromContentWithName("content", "file.exe"));
+	Decompiler decompiler(
+		Settings().withDeduplicateRuns(true), connectionManager);
+
+	auto decompilation1 = decompiler.runDecompilation(args);
+	auto decompilation2 = decompiler.runDecompilation(args);
+
+	ASSERT_EQ("123", decompilation1->getId());
+	ASSERT_EQ("123", decompilation2->getId());
+}
+
+TEST_F(DecompilerTests,
+RunDecompilationSendsRequestForEachRunWhenRunsAreNotDeduplicated) {
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.Times(2)
+		.WillRepeatedly(InvokeWithoutArgs([]() {
+			auto response = new NiceMock<ResponseMock>();
+			ON_CALL(*response, statusCode())
+				.WillByDefault(Return(201)); // HTTP 201 Created
+			ON_CALL(*response, bodyAsJson())
+				.WillByDefault(Return(toJson("{\"id\": \"123\"}")));
+			return response;
+		}));
+	auto args = DecompilationArguments()
+		.withMode("bin")
+		.withInputFile(File::fromContentWithName("content", "file.exe"));
+	Decompiler decompiler(Settings(), connectionManager);
+
+	auto decompilation1 = decompiler.runDecompilation(args);
+	auto decompilation2 = decompiler.runDecompilation(args);
+}
+
+TEST_F(DecompilerTests,
+ReattachReturnsJournaledDecompilationWithoutSendingRequest) {
+	auto journalPath = uniqueFilePath(
+		boost::filesystem::temp_directory_path().string());
+	RemoveFileOnDestruction removeJournal(journalPath);
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(201)); // HTTP 201 Created
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"id\": \"123\"}")));
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.WillOnce(Return(response));
+	auto settings = Settings().withJournalPath(journalPath);
+	Decompiler(settings, connectionManager).runDecompilation(
+		DecompilationArguments().withMode("bin"));
+	Decompiler decompiler(settings, connectionManager);
+
+	auto decompilation = decompiler.reattach("123");
+
+	ASSERT_EQ("123", decompilation->getId());
+	ASSERT_EQ(std::vector<std::string>{"123"}, decompiler.journaledIds());
+}
+
+TEST_F(DecompilerTests,
+DurationOfReattachedDecompilationIsNotRecordedIntoMetrics) {
+	auto journalPath = uniqueFilePath(
+		boost::filesystem::temp_directory_path().string());
+	RemoveFileOnDestruction removeJournal(journalPath);
+	auto startResponse = new NiceMock<ResponseMock>();
+	ON_CALL(*startResponse, statusCode())
+		.WillByDefault(Return(201)); // HTTP 201 Created
+	ON_CALL(*startResponse, bodyAsJson())
+		.WillByDefault(Return(toJson("{\"id\": \"123\"}")));
+	EXPECT_CALL(*conn, sendPostRequestProxy(_, _, _))
+		.WillOnce(Return(startResponse));
+	auto statusResponse = new NiceMock<ResponseMock>();
+	ON_CALL(*statusResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*statusResponse, bodyAsJson())
+		.WillByDefault(Return(toJson(
+			"{\"finished\": true, \"succeeded\": true}")));
+	EXPECT_CALL(*conn, sendGetRequestProxy(_))
+		.WillOnce(Return(statusResponse));
+	auto metrics = std::make_shared<Metrics>();
+	auto settings = Settings()
+		.withJournalPath(journalPath)
+		.withMetrics(metrics);
+	Decompiler(settings, connectionManager).runDecompilation(
+		DecompilationArguments());
+	Decompiler decompiler(settings, connectionManager);
+
+	decompiler.reattach("123")->waitUntilFinished();
+
+	ASSERT_EQ(std::string::npos, metrics->toPrometheusText().find(
+		"retdec_resource_duration_seconds_count"));
+}
+
+TEST_F(DecompilerTests,
+ReattachThrowsErrorWhenDecompilationIsNotInJournal) {
+	auto journalPath = uniqueFilePath(
+		boost::filesystem::temp_directory_path().string());
+	RemoveFileOnDestruction removeJournal(journalPath);
+	Decompiler decompiler(
+		Settings().withJournalPath(journalPath), connectionManager);
+
+	ASSERT_THROW(decompiler.reattach("123"), Error);
+}
+
+TEST_F(DecompilerTests,
+ReattachThrowsErrorWhenJournalIsDisabled) {
+	Decompiler decompiler(Settings(), connectionManager);
+
+	ASSERT_THROW(decompiler.reattach("123"), Error);
+}
+
+TEST_F(DecompilerTests,
+OutputCanBeObtainedFromWhenFinishedHandlerWithSingleIoThread) {
+	HttpServer server([](const HttpServer::Request &request) {
+		HttpServer::Response response;
+		if (request.method == "POST") {
+			response.body = R"({"id": "123"})";
+		} else if (request.target ==
+				"/service/api/decompiler/decompilations/123/status") {
+			response.body = R"({"finished": true, "succeeded": true})";
+		} else {
+			response.body = "int main() {}";
+		}
+		return response;
+	});
+	Decompiler decompiler(Settings()
+		.withApiUrl(server.url() + "/service/api")
+		.withIoThreadCount(1)
+		.withMaxConnectionCount(1));
+	auto decompilation = decompiler.runDecompilation(DecompilationArguments());
+
+	// The handler is run by the only I/O thread, so the output has to be
+	// downloaded without waiting for other handlers.
+	std::promise<std::string> output;
+	decompilation->whenFinished([&](std::exception_ptr error) {
+		try {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+			output.set_value(decompilation->getOutputHll());
+		} catch (...) {
+			output.set_exception(std::current_exception());
+		}
+	});
+
+	auto outputFuture = output.get_future();
+	ASSERT_EQ(
+		std::future_status::ready,
+		outputFuture.wait_for(std::chrono::seconds(5))
+	);
+	ASSERT_EQ("int main() {}", outputFuture.get());
+}
+
 } // namespace tests
 } // namespace retdec
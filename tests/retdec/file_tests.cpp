@@ -5,21 +5,78 @@
 /// @brief     Tests for the files.
 ///
 
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
 #include <gtest/gtest.h>
 
 #include "retdec/file.h"
 #include "retdec/internal/utilities/os.h"
+#include "retdec/test_utilities/tmp_file.h"
 
 using namespace testing;
+using namespace retdec::internal;
 
 namespace retdec {
 namespace tests {
 
+///
+/// File that provides only the mandatory member functions.
+///
+class MinimalFile: public File {
+public:
+	virtual std::string getName() const override { return "file.txt"; }
+	virtual std::string getContent() override { return "content"; }
+	virtual void saveCopyTo(const std::string &) override {}
+	virtual void saveCopyTo(const std::string &, const std::string &) override {}
+};
+
 ///
 /// Tests for File.
 ///
 class FileTests: public Test {};
 
+TEST_F(FileTests,
+GetSizeReturnsSizeOfContentByDefault) {
+	MinimalFile file;
+
+	ASSERT_EQ(7u, file.getSize());
+}
+
+TEST_F(FileTests,
+OpenContentReturnsStreamWithContentByDefault) {
+	MinimalFile file;
+
+	auto stream = file.openContent();
+
+	ASSERT_EQ("content", std::string(std::istreambuf_iterator<char>(*stream),
+		std::istreambuf_iterator<char>()));
+}
+
+TEST_F(FileTests,
+GetContentViewReturnsViewOfContentByDefault) {
+	MinimalFile file;
+
+	auto view = file.getContentView();
+
+	ASSERT_EQ(7u, view.size());
+	ASSERT_FALSE(view.empty());
+	ASSERT_EQ("content", std::string(view.data(), view.size()));
+	ASSERT_EQ("content", view.toString());
+}
+
+TEST_F(FileTests,
+ContentViewStaysValidAfterFileIsDestructed) {
+	auto file = std::make_unique<MinimalFile>();
+	auto view = file->getContentView();
+
+	file.reset();
+
+	ASSERT_EQ("content", view.toString());
+}
+
 TEST_F(FileTests,
 FromContentWithNameReturnsFileWithCorrectContentAndName) {
 	auto file = File::fromContentWithName("content", "file.txt");
@@ -28,6 +85,29 @@ FromContentWithNameReturnsFileWithCorrectContentAndName) {
 	ASSERT_EQ("file.txt", file->getName());
 }
 
+TEST_F(FileTests,
+FromContentWithNameMovesGivenContentIntoFile) {
+	std::string content(1000, 'x');
+	const auto contentData = content.data();
+
+	auto file = File::fromContentWithName(std::move(content), "file.txt");
+
+	ASSERT_EQ(contentData, file->getContentView().data());
+	ASSERT_EQ(std::string(1000, 'x'), file->getContent());
+	ASSERT_EQ("file.txt", file->getName());
+}
+
+TEST_F(FileTests,
+FromSharedContentWithNameReturnsFileSharingGivenContent) {
+	auto content = std::make_shared<const std::string>("content");
+
+	auto file = File::fromSharedContentWithName(content, "file.txt");
+
+	ASSERT_EQ(content->data(), file->getContentView().data());
+	ASSERT_EQ("content", file->getContent());
+	ASSERT_EQ("file.txt", file->getName());
+}
+
 TEST_F(FileTests,
 FromFilesystemReturnsFileWithCorrectName) {
 #ifdef RETDEC_OS_WINDOWS
@@ -52,5 +132,15 @@ FromFilesystemWithOtherNameReturnsFileWithCorrectName) {
 	ASSERT_EQ("other.txt", file->getName());
 }
 
+TEST_F(FileTests,
+FromFilesystemMappedReturnsFileWithCorrectNameAndContent) {
+	auto tmpFile = TmpFile::createWithContent("content");
+
+	auto file = File::fromFilesystemMapped(tmpFile->getPath());
+
+	ASSERT_EQ(fileNameFromPath(tmpFile->getPath()), file->getName());
+	ASSERT_EQ("content", file->getContent());
+}
+
 } // namespace tests
 } // namespace retdec
@@ -5,11 +5,22 @@
 /// @brief     Tests for the fileinfo service.
 ///
 
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
+#include <json/json.h>
 
+#include "retdec/analysis.h"
+#include "retdec/exceptions.h"
 #include "retdec/fileinfo.h"
 #include "retdec/internal/connection_manager_mock.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/submission_journal.h"
+#include "retdec/internal/utilities/os.h"
 #include "retdec/settings.h"
+#include "retdec/test_utilities/tmp_file.h"
 
 using namespace testing;
 using namespace retdec::internal;
@@ -39,5 +50,39 @@ IsCreatedSuccessfullyWithCustomConnectionManager) {
 	);
 }
 
+TEST_F(FileinfoTests,
+ReattachReturnsJournaledAnalysis) {
+	auto journalPath = uniqueFilePath(
+		boost::filesystem::temp_directory_path().string());
+	RemoveFileOnDestruction removeJournal(journalPath);
+	SubmissionJournal(journalPath).append(
+		{"https://retdec.com/service/api/fileinfo/analyses", "123", "key", ""});
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	auto connectionManager = std::make_shared<NiceMock<ConnectionManagerMock>>();
+	ON_CALL(*connectionManager, newConnection(_))
+		.WillByDefault(Return(conn));
+	Fileinfo fileinfo(
+		Settings().withJournalPath(journalPath),
+		connectionManager
+	);
+
+	auto analysis = fileinfo.reattach("123");
+
+	ASSERT_EQ("123", analysis->getId());
+	ASSERT_EQ(std::vector<std::string>{"123"}, fileinfo.journaledIds());
+}
+
+TEST_F(FileinfoTests,
+ReattachThrowsErrorWhenJournalIsDisabled) {
+	Fileinfo fileinfo(
+		Settings(),
+		std::make_shared<NiceMock<ConnectionManagerMock>>()
+	);
+
+	ASSERT_THROW(fileinfo.reattach("123"), Error);
+}
+
 } // namespace tests
 } // namespace retdec
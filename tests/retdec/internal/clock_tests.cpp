@@ -0,0 +1,96 @@
+///
+/// @file      retdec/internal/clock_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the clocks.
+///
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/clock.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for Clock.
+///
+class ClockTests: public Test {};
+
+TEST_F(ClockTests,
+SystemReturnsSameClockEveryTime) {
+	ASSERT_EQ(Clock::system(), Clock::system());
+}
+
+TEST_F(ClockTests,
+SystemClockSleepsForGivenDuration) {
+	auto clock = Clock::system();
+	auto start = clock->now();
+
+	clock->sleepFor(5ms);
+
+	ASSERT_GE(clock->now() - start, 5ms);
+}
+
+///
+/// Tests for VirtualClock.
+///
+class VirtualClockTests: public Test {};
+
+TEST_F(VirtualClockTests,
+TimeStartsAtEpoch) {
+	VirtualClock clock;
+
+	ASSERT_EQ(Clock::TimePoint(), clock.now());
+}
+
+TEST_F(VirtualClockTests,
+TimeDoesNotPassByItself) {
+	VirtualClock clock;
+	auto start = clock.now();
+
+	Clock::system()->sleepFor(1ms);
+
+	ASSERT_EQ(start, clock.now());
+}
+
+TEST_F(VirtualClockTests,
+AdvanceMovesTimeForward) {
+	VirtualClock clock;
+
+	clock.advance(2s);
+	clock.advance(500ms);
+
+	ASSERT_EQ(Clock::TimePoint(2500ms), clock.now());
+}
+
+TEST_F(VirtualClockTests,
+AdvanceIgnoresNegativeDuration) {
+	VirtualClock clock;
+	clock.advance(1s);
+
+	clock.advance(-500ms);
+
+	ASSERT_EQ(Clock::TimePoint(1s), clock.now());
+}
+
+TEST_F(VirtualClockTests,
+SleepForMovesTimeForwardWithoutBlocking) {
+	VirtualClock clock;
+	auto realStart = Clock::system()->now();
+
+	clock.sleepFor(std::chrono::hours(24));
+
+	ASSERT_EQ(Clock::TimePoint(std::chrono::hours(24)), clock.now());
+	ASSERT_LT(Clock::system()->now() - realStart, 1s);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
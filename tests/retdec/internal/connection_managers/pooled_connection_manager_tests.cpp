@@ -0,0 +1,454 @@
+///
+/// @file      retdec/internal/connection_managers/pooled_connection_manager_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the manager of pooled connections.
+///
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/connection_manager_mock.h"
+#include "retdec/internal/connection_managers/pooled_connection_manager.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/metrics.h"
+#include "retdec/request_observer_mock.h"
+#include "retdec/settings.h"
+
+using namespace testing;
+using namespace retdec::tests;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for PooledConnectionManager.
+///
+class PooledConnectionManagerTests: public Test {
+public:
+	std::shared_ptr<ConnectionMock> newConnectionMock();
+
+	/// Factory of the pooled connections.
+	std::shared_ptr<ConnectionManagerMock> connectionFactory =
+		std::make_shared<StrictMock<ConnectionManagerMock>>();
+};
+
+///
+/// Returns a connection mock that successfully answers all GET requests.
+///
+std::shared_ptr<ConnectionMock> PooledConnectionManagerTests::newConnectionMock() {
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, sendGetRequestProxy(_))
+		.WillByDefault(InvokeWithoutArgs([]() {
+			return new NiceMock<ResponseMock>();
+		}));
+	return conn;
+}
+
+TEST_F(PooledConnectionManagerTests,
+NewConnectionReturnsConnectionWithApiUrlFromSettings) {
+	PooledConnectionManager cm(connectionFactory);
+
+	auto conn = cm.newConnection(Settings().withApiUrl("http://127.0.0.1/api"));
+
+	ASSERT_EQ("http://127.0.0.1/api", conn->getApiUrl());
+}
+
+TEST_F(PooledConnectionManagerTests,
+NewConnectionDoesNotCreateUnderlyingConnection) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.Times(0);
+
+	cm.newConnection(Settings());
+}
+
+TEST_F(PooledConnectionManagerTests,
+UnderlyingConnectionIsReusedBySubsequentRequests) {
+	PooledConnectionManager cm(connectionFactory);
+	auto underlyingConn = newConnectionMock();
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(underlyingConn));
+	EXPECT_CALL(*underlyingConn, sendGetRequestProxy("http://127.0.0.1/api/1"));
+	EXPECT_CALL(*underlyingConn, sendGetRequestProxy("http://127.0.0.1/api/2"));
+	auto settings = Settings().withApiUrl("http://127.0.0.1/api");
+
+	cm.newConnection(settings)->sendGetRequest("http://127.0.0.1/api/1");
+	cm.newConnection(settings)->sendGetRequest("http://127.0.0.1/api/2");
+}
+
+TEST_F(PooledConnectionManagerTests,
+SeparateUnderlyingConnectionsAreUsedForDifferentApiUrls) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+
+	cm.newConnection(Settings().withApiUrl("http://127.0.0.1/api"))
+		->sendGetRequest("http://127.0.0.1/api");
+	cm.newConnection(Settings().withApiUrl("http://127.0.0.2/api"))
+		->sendGetRequest("http://127.0.0.2/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+SeparateUnderlyingConnectionsAreUsedForDifferentRequestObservers) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+	auto observer = std::make_shared<RequestObserverMock>();
+
+	cm.newConnection(Settings())->sendGetRequest("http://127.0.0.1/api");
+	cm.newConnection(Settings().withRequestObserver(observer))
+		->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+SeparateUnderlyingConnectionsAreUsedForDifferentMetrics) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+
+	cm.newConnection(Settings())->sendGetRequest("http://127.0.0.1/api");
+	cm.newConnection(Settings().withMetrics(std::make_shared<Metrics>()))
+		->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+StaleIdleConnectionIsNotReused) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+	auto conn = cm.newConnection(Settings().withConnectionIdleTimeout(0));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+	conn->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+UnderlyingConnectionIsNotReusedWhenRequestFails) {
+	PooledConnectionManager cm(connectionFactory);
+	auto failingConn = newConnectionMock();
+	EXPECT_CALL(*failingConn, sendGetRequestProxy(_))
+		.WillOnce(Throw(ConnectionError("connection reset")));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(failingConn))
+		.WillOnce(Return(newConnectionMock()));
+	auto conn = cm.newConnection(Settings());
+
+	ASSERT_THROW(conn->sendGetRequest("http://127.0.0.1/api"), ConnectionError);
+	conn->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+NewUnderlyingConnectionIsCreatedWhenAllPooledConnectionsAreBorrowed) {
+	PooledConnectionManager cm(connectionFactory);
+	auto conn = cm.newConnection(Settings().withMaxConnectionCount(2));
+	// The first underlying connection sends a nested request while it is
+	// borrowed, so the nested request has to use another connection.
+	auto outerConn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*outerConn, sendGetRequestProxy(_))
+		.WillByDefault(InvokeWithoutArgs([&]() {
+			conn->sendGetRequest("http://127.0.0.1/api/nested");
+			return new NiceMock<ResponseMock>();
+		}));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(outerConn))
+		.WillOnce(Return(newConnectionMock()));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+UnderlyingConnectionIsReusedAfterAsynchronousRequestCompletes) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()));
+	auto conn = cm.newConnection(Settings());
+
+	std::unique_ptr<Connection::Response> response;
+	conn->sendGetRequestAsync("http://127.0.0.1/api",
+		[&](std::unique_ptr<Connection::Response> r, std::exception_ptr) {
+			response = std::move(r);
+		});
+	conn->sendGetRequest("http://127.0.0.1/api");
+
+	ASSERT_NE(nullptr, response);
+}
+
+TEST_F(PooledConnectionManagerTests,
+UnderlyingConnectionIsNotReusedWhenAsynchronousRequestFails) {
+	PooledConnectionManager cm(connectionFactory);
+	auto failingConn = newConnectionMock();
+	EXPECT_CALL(*failingConn, sendGetRequestProxy(_))
+		.WillOnce(Throw(ConnectionError("connection reset")));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(failingConn))
+		.WillOnce(Return(newConnectionMock()));
+	auto conn = cm.newConnection(Settings());
+
+	std::exception_ptr error;
+	conn->sendGetRequestAsync("http://127.0.0.1/api",
+		[&](std::unique_ptr<Connection::Response>, std::exception_ptr e) {
+			error = e;
+		});
+	conn->sendGetRequest("http://127.0.0.1/api");
+
+	ASSERT_THROW(std::rethrow_exception(error), ConnectionError);
+}
+
+TEST_F(PooledConnectionManagerTests,
+AsynchronousRequestWaitsForConnectionWhenAllPooledConnectionsAreBorrowed) {
+	PooledConnectionManager cm(connectionFactory);
+	auto conn = cm.newConnection(Settings().withMaxConnectionCount(1));
+	// The only underlying connection sends a nested asynchronous request while
+	// it is borrowed, so the nested request has to wait until it is returned.
+	std::promise<void> nestedResponseReceived;
+	auto onlyConn = std::make_shared<NiceMock<ConnectionMock>>();
+	EXPECT_CALL(*onlyConn, sendGetRequestProxy("http://127.0.0.1/api"))
+		.WillOnce(InvokeWithoutArgs([&]() {
+			conn->sendGetRequestAsync("http://127.0.0.1/api/nested",
+				[&](std::unique_ptr<Connection::Response>, std::exception_ptr) {
+					nestedResponseReceived.set_value();
+				});
+			return new NiceMock<ResponseMock>();
+		}));
+	EXPECT_CALL(*onlyConn, sendGetRequestProxy("http://127.0.0.1/api/nested"))
+		.WillOnce(Return(new NiceMock<ResponseMock>()));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(onlyConn));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+
+	ASSERT_EQ(
+		std::future_status::ready,
+		nestedResponseReceived.get_future().wait_for(std::chrono::seconds(5))
+	);
+}
+
+TEST_F(PooledConnectionManagerTests,
+SynchronousRequestFromIoThreadDoesNotWaitWhenAllPooledConnectionsAreBorrowed) {
+	PooledConnectionManager cm(connectionFactory);
+	auto settings = Settings().withMaxConnectionCount(1).withIoThreadCount(1);
+	auto conn = cm.newConnection(settings);
+	// The only underlying connection waits until an I/O thread sends a nested
+	// request, so the nested request cannot wait until it is returned.
+	std::future_status nestedRequestStatus = std::future_status::deferred;
+	auto outerConn = std::make_shared<NiceMock<ConnectionMock>>();
+	EXPECT_CALL(*outerConn, sendGetRequestProxy(_))
+		.WillOnce(InvokeWithoutArgs([&]() {
+			auto nestedRequest = std::make_shared<std::packaged_task<void ()>>(
+				[conn]() {
+					conn->sendGetRequest("http://127.0.0.1/api/nested");
+				});
+			auto nestedRequestSent = nestedRequest->get_future();
+			IoService::shared(settings.ioThreadCount())->asioService()->post(
+				[nestedRequest]() { (*nestedRequest)(); });
+			nestedRequestStatus =
+				nestedRequestSent.wait_for(std::chrono::seconds(5));
+			return new NiceMock<ResponseMock>();
+		}));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(outerConn))
+		.WillOnce(Return(newConnectionMock()));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+
+	ASSERT_EQ(std::future_status::ready, nestedRequestStatus);
+}
+
+TEST_F(PooledConnectionManagerTests,
+WaitingSynchronousRequestIsServedAfterAsynchronousRequestThatWaitedBefore) {
+	PooledConnectionManager cm(connectionFactory);
+	auto conn = cm.newConnection(Settings().withMaxConnectionCount(1));
+	std::vector<std::string> sentUrls;
+	std::thread syncRequestThread;
+	auto onlyConn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*onlyConn, sendGetRequestProxy(_))
+		.WillByDefault(Invoke([&](const Connection::Url &url) {
+			sentUrls.push_back(url);
+			if (url == "http://127.0.0.1/api") {
+				conn->sendGetRequestAsync("http://127.0.0.1/api/async",
+					[](std::unique_ptr<Connection::Response>,
+						std::exception_ptr) {});
+				syncRequestThread = std::thread([&]() {
+					conn->sendGetRequest("http://127.0.0.1/api/sync");
+				});
+			}
+			return new NiceMock<ResponseMock>();
+		}));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(onlyConn));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+	syncRequestThread.join();
+
+	ASSERT_EQ(
+		std::vector<std::string>({
+			"http://127.0.0.1/api",
+			"http://127.0.0.1/api/async",
+			"http://127.0.0.1/api/sync"
+		}),
+		sentUrls
+	);
+}
+
+TEST_F(PooledConnectionManagerTests,
+SeparateUnderlyingConnectionsAreUsedForDifferentPoolSizes) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+
+	cm.newConnection(Settings().withConnectionPoolSize(1))
+		->sendGetRequest("http://127.0.0.1/api");
+	cm.newConnection(Settings().withConnectionPoolSize(2))
+		->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+SeparateUnderlyingConnectionsAreUsedForDifferentMaxConnectionCounts) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+
+	cm.newConnection(Settings().withMaxConnectionCount(1))
+		->sendGetRequest("http://127.0.0.1/api");
+	cm.newConnection(Settings().withMaxConnectionCount(2))
+		->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+PoolSizeDoesNotLimitNumberOfConnectionsUsedAtOnce) {
+	PooledConnectionManager cm(connectionFactory);
+	auto conn = cm.newConnection(Settings().withConnectionPoolSize(1));
+	// The nested request would wait forever if the pool size limited the
+	// number of borrowed connections.
+	auto outerConn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*outerConn, sendGetRequestProxy(_))
+		.WillByDefault(InvokeWithoutArgs([&]() {
+			conn->sendGetRequest("http://127.0.0.1/api/nested");
+			return new NiceMock<ResponseMock>();
+		}));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(outerConn))
+		.WillOnce(Return(newConnectionMock()));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+IdleConnectionsOverPoolSizeAreNotKept) {
+	PooledConnectionManager cm(connectionFactory);
+	auto conn = cm.newConnection(Settings().withConnectionPoolSize(1));
+	auto innerConn = newConnectionMock();
+	EXPECT_CALL(*innerConn, sendGetRequestProxy(_))
+		.Times(1);
+	auto outerConn = newConnectionMock();
+	EXPECT_CALL(*outerConn, sendGetRequestProxy("http://127.0.0.1/api"))
+		.WillOnce(InvokeWithoutArgs([&]() {
+			conn->sendGetRequest("http://127.0.0.1/api/nested");
+			return new NiceMock<ResponseMock>();
+		}));
+	EXPECT_CALL(*outerConn, sendGetRequestProxy("http://127.0.0.1/api/next"))
+		.Times(2);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(outerConn))
+		.WillOnce(Return(innerConn));
+
+	// The nested request returns its connection first, so it is closed when
+	// the outer one is returned to the full pool.
+	conn->sendGetRequest("http://127.0.0.1/api");
+	conn->sendGetRequest("http://127.0.0.1/api/next");
+	conn->sendGetRequest("http://127.0.0.1/api/next");
+}
+
+TEST_F(PooledConnectionManagerTests,
+NoConnectionIsKeptWhenPoolSizeIsZero) {
+	PooledConnectionManager cm(connectionFactory);
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(newConnectionMock()))
+		.WillOnce(Return(newConnectionMock()));
+	auto conn = cm.newConnection(Settings().withConnectionPoolSize(0));
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+	conn->sendGetRequest("http://127.0.0.1/api");
+}
+
+TEST_F(PooledConnectionManagerTests,
+RequestIsSentAgainWhenReusedConnectionFails) {
+	PooledConnectionManager cm(connectionFactory);
+	auto closedConn = newConnectionMock();
+	EXPECT_CALL(*closedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(new NiceMock<ResponseMock>()))
+		.WillOnce(Throw(ConnectionError("connection reset")));
+	auto newConn = newConnectionMock();
+	EXPECT_CALL(*newConn, sendGetRequestProxy("http://127.0.0.1/api/2"));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(closedConn))
+		.WillOnce(Return(newConn));
+	auto conn = cm.newConnection(Settings());
+
+	conn->sendGetRequest("http://127.0.0.1/api/1");
+	conn->sendGetRequest("http://127.0.0.1/api/2");
+}
+
+TEST_F(PooledConnectionManagerTests,
+RequestIsNotSentAgainWhenItFailsForOtherReasonThanConnectionError) {
+	PooledConnectionManager cm(connectionFactory);
+	auto failingConn = newConnectionMock();
+	EXPECT_CALL(*failingConn, sendGetRequestProxy(_))
+		.WillOnce(Return(new NiceMock<ResponseMock>()))
+		.WillOnce(Throw(ApiError(500, "Internal Server Error")));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(failingConn));
+	auto conn = cm.newConnection(Settings());
+
+	conn->sendGetRequest("http://127.0.0.1/api");
+	ASSERT_THROW(conn->sendGetRequest("http://127.0.0.1/api"), ApiError);
+}
+
+TEST_F(PooledConnectionManagerTests,
+AsynchronousRequestIsSentAgainWhenReusedConnectionFails) {
+	PooledConnectionManager cm(connectionFactory);
+	auto closedConn = newConnectionMock();
+	EXPECT_CALL(*closedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(new NiceMock<ResponseMock>()))
+		.WillOnce(Throw(ConnectionError("connection reset")));
+	EXPECT_CALL(*connectionFactory, newConnection(_))
+		.WillOnce(Return(closedConn))
+		.WillOnce(Return(newConnectionMock()));
+	auto conn = cm.newConnection(Settings());
+	conn->sendGetRequest("http://127.0.0.1/api");
+
+	std::exception_ptr error;
+	std::unique_ptr<Connection::Response> response;
+	conn->sendGetRequestAsync("http://127.0.0.1/api",
+		[&](std::unique_ptr<Connection::Response> r, std::exception_ptr e) {
+			response = std::move(r);
+			error = e;
+		});
+
+	ASSERT_EQ(nullptr, error);
+	ASSERT_NE(nullptr, response);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
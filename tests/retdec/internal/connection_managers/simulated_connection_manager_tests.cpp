@@ -0,0 +1,113 @@
+///
+/// @file      retdec/internal/connection_managers/simulated_connection_manager_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the manager of connections to a simulation of the API.
+///
+
+#include <chrono>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "retdec/analysis.h"
+#include "retdec/analysis_arguments.h"
+#include "retdec/decompilation.h"
+#include "retdec/decompilation_arguments.h"
+#include "retdec/decompiler.h"
+#include "retdec/file.h"
+#include "retdec/fileinfo.h"
+#include "retdec/internal/clock.h"
+#include "retdec/internal/connection_managers/simulated_connection_manager.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/internal/simulated_service.h"
+#include "retdec/internal/utilities/smart_ptr.h"
+#include "retdec/polling_policy.h"
+#include "retdec/settings.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for SimulatedConnectionManager.
+///
+class SimulatedConnectionManagerTests: public Test {
+public:
+	SimulatedConnectionManagerTests();
+
+	/// Simulation to which connections are connected.
+	std::shared_ptr<SimulatedService> service;
+
+	/// Tested manager.
+	std::shared_ptr<SimulatedConnectionManager> cm;
+};
+
+///
+/// Sets up a manager of connections to a simulation processing resources for
+/// an hour.
+///
+SimulatedConnectionManagerTests::SimulatedConnectionManagerTests() {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(1h);
+	service = std::make_shared<SimulatedService>(config);
+	cm = std::make_shared<SimulatedConnectionManager>(service);
+}
+
+TEST_F(SimulatedConnectionManagerTests,
+NewConnectionReturnsSimulatedConnectionWithApiUrlFromSettings) {
+	auto conn = cm->newConnection(Settings().apiUrl("http://localhost/api"));
+
+	ASSERT_TRUE(isa<SimulatedConnection>(conn));
+	ASSERT_EQ("http://localhost/api", conn->getApiUrl());
+}
+
+TEST_F(SimulatedConnectionManagerTests,
+ServiceReturnsGivenSimulation) {
+	ASSERT_EQ(service, cm->service());
+}
+
+TEST_F(SimulatedConnectionManagerTests,
+DecompilerWaitsForDecompilationOnVirtualClock) {
+	Decompiler decompiler(
+		Settings().pollingPolicy(PollingPolicy::fixed(1min)),
+		cm
+	);
+
+	auto decompilation = decompiler.runDecompilation(
+		DecompilationArguments()
+			.mode("bin")
+			.inputFile(File::fromContentWithName("content", "input.exe"))
+	);
+	decompilation->waitUntilFinished();
+
+	ASSERT_TRUE(decompilation->hasSucceeded());
+	ASSERT_EQ(Clock::TimePoint(1h), service->clock()->now());
+	ASSERT_EQ(61u, service->statistics().statusRequestCount);
+	ASSERT_EQ(1024u, decompilation->getOutputHll().size());
+}
+
+TEST_F(SimulatedConnectionManagerTests,
+FileinfoWaitsForAnalysisOnVirtualClock) {
+	Fileinfo fileinfo(
+		Settings().pollingPolicy(PollingPolicy::fixed(10min)),
+		cm
+	);
+
+	auto analysis = fileinfo.runAnalysis(
+		AnalysisArguments()
+			.inputFile(File::fromContentWithName("content", "input.exe"))
+	);
+	analysis->waitUntilFinished();
+
+	ASSERT_TRUE(analysis->hasSucceeded());
+	ASSERT_EQ(Clock::TimePoint(1h), service->clock()->now());
+	ASSERT_EQ(1024u, analysis->getOutput().size());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
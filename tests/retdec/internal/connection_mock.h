@@ -29,6 +29,7 @@ public:
 	MOCK_CONST_METHOD0(statusMessage, std::string ());
 	MOCK_CONST_METHOD0(body, std::string ());
 	MOCK_CONST_METHOD0(bodyAsJson, Json::Value ());
+	MOCK_CONST_METHOD0(attachedFileName, std::string ());
 
 	// A workaround is needed due to the lack of support of non-copyable return
 	// types/parameters in Google Mock.
@@ -5,9 +5,17 @@
 /// @brief     Tests for the connection to the API.
 ///
 
+#include <exception>
+#include <memory>
+#include <utility>
+
 #include <gtest/gtest.h>
+#include <json/json.h>
 
+#include "retdec/exceptions.h"
+#include "retdec/internal/clock.h"
 #include "retdec/internal/connection.h"
+#include "retdec/internal/connection_mock.h"
 
 using namespace testing;
 
@@ -20,6 +28,53 @@ namespace tests {
 ///
 class ConnectionTests: public Test {};
 
+TEST_F(ConnectionTests,
+SharedBodyOfResponseReturnsBodyByDefault) {
+	NiceMock<ResponseMock> response;
+	ON_CALL(response, body())
+		.WillByDefault(Return("body"));
+
+	ASSERT_EQ("body", *response.sharedBody());
+}
+
+TEST_F(ConnectionTests,
+SendGetRequestAsyncPassesResponseToHandlerByDefault) {
+	auto refResponse = new NiceMock<ResponseMock>();
+	NiceMock<ConnectionMock> conn;
+	EXPECT_CALL(conn, sendGetRequestProxy("https://retdec.com/service/api"))
+		.WillOnce(Return(refResponse));
+
+	std::unique_ptr<Connection::Response> response;
+	conn.sendGetRequestAsync("https://retdec.com/service/api",
+		[&](std::unique_ptr<Connection::Response> r, std::exception_ptr) {
+			response = std::move(r);
+		});
+
+	ASSERT_EQ(refResponse, response.get());
+}
+
+TEST_F(ConnectionTests,
+SendGetRequestAsyncPassesErrorToHandlerByDefault) {
+	NiceMock<ConnectionMock> conn;
+	EXPECT_CALL(conn, sendGetRequestProxy("https://retdec.com/service/api"))
+		.WillOnce(Throw(ConnectionError("connection refused")));
+
+	std::exception_ptr error;
+	conn.sendGetRequestAsync("https://retdec.com/service/api",
+		[&](std::unique_ptr<Connection::Response>, std::exception_ptr e) {
+			error = e;
+		});
+
+	ASSERT_THROW(std::rethrow_exception(error), ConnectionError);
+}
+
+TEST_F(ConnectionTests,
+ClockReturnsSystemClockByDefault) {
+	NiceMock<ConnectionMock> conn;
+
+	ASSERT_EQ(Clock::system(), conn.clock());
+}
+
 } // namespace tests
 } // namespace internal
 } // namespace retdec
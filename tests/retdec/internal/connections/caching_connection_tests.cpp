@@ -0,0 +1,326 @@
+///
+/// @file      retdec/internal/connections/caching_connection_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the connection wrapper caching responses of a resource
+///            on disk.
+///
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/connections/caching_connection.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/internal/result_cache.h"
+#include "retdec/internal/simulated_service.h"
+#include "retdec/internal/utilities/json.h"
+#include "retdec/internal/utilities/os.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for CachingConnection.
+///
+class CachingConnectionTests: public Test {
+public:
+	CachingConnectionTests();
+	~CachingConnectionTests();
+
+	ResponseMock *responseWith(int statusCode, const std::string &body);
+
+	/// Path to a temporary directory with the cache.
+	const std::string cacheDir;
+
+	/// Cache of responses.
+	std::shared_ptr<ResultCache> cache;
+
+	/// Wrapped connection.
+	std::shared_ptr<ConnectionMock> wrappedConn;
+
+	/// Tested connection.
+	CachingConnection conn;
+};
+
+///
+/// Sets up a caching connection wrapping a connection mock.
+///
+CachingConnectionTests::CachingConnectionTests():
+	cacheDir(uniqueFilePath(
+		boost::filesystem::temp_directory_path().string())),
+	cache(std::make_shared<ResultCache>(cacheDir, 1024 * 1024)),
+	wrappedConn(std::make_shared<StrictMock<ConnectionMock>>()),
+	conn(wrappedConn, cache, "key",
+		"https://retdec.com/service/api/decompiler/decompilations/ID",
+		{"outputs/hll"}) {}
+
+///
+/// Removes the temporary directory with the cache.
+///
+CachingConnectionTests::~CachingConnectionTests() {
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(cacheDir, ec);
+}
+
+///
+/// Returns a new response mock with the given status code and body.
+///
+ResponseMock *CachingConnectionTests::responseWith(int statusCode,
+		const std::string &body) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(statusCode));
+	ON_CALL(*response, body())
+		.WillByDefault(Return(body));
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(InvokeWithoutArgs([body]() { return toJson(body); }));
+	return response;
+}
+
+TEST_F(CachingConnectionTests,
+GetRequestToOutputIsSentOnlyOnce) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	auto response = conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+
+	ASSERT_EQ("int main() {}", response->body());
+}
+
+TEST_F(CachingConnectionTests,
+UnsuccessfulResponseIsNotCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(404, "")))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	auto response = conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+
+	ASSERT_EQ("int main() {}", response->body());
+}
+
+TEST_F(CachingConnectionTests,
+StatusOfUnfinishedResourceIsNotCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": false}")))
+		.WillOnce(Return(responseWith(200, "{\"finished\": true}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+}
+
+TEST_F(CachingConnectionTests,
+StatusOfFailedResourceIsNotCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200,
+			"{\"finished\": true, \"failed\": true}")));
+	cache->storeResourceId("key", "ID");
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_FALSE(cache->finishedResourceId("key", {"outputs/hll"}));
+}
+
+TEST_F(CachingConnectionTests,
+StatusOfSuccessfullyFinishedResourceIsCachedTogetherWithOutputs) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": true}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	cache->storeResourceId("key", "ID");
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_TRUE(cache->finishedResourceId("key", {"outputs/hll"}));
+	auto output = conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	ASSERT_EQ("int main() {}", output->body());
+}
+
+TEST_F(CachingConnectionTests,
+OutputIsNotDownloadedWithStatusWhenItIsAlreadyCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": true}")));
+	cache->storeResourceId("key", "ID");
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_TRUE(cache->finishedResourceId("key", {"outputs/hll"}));
+}
+
+TEST_F(CachingConnectionTests,
+StatusIsNotCachedWhenOutputCannotBeDownloaded) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": true}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(404, "")));
+	cache->storeResourceId("key", "ID");
+
+	auto status = conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_EQ("{\"finished\": true}", status->body());
+	ASSERT_FALSE(cache->finishedResourceId("key", {"outputs/hll"}));
+}
+
+TEST_F(CachingConnectionTests,
+AsyncStatusOfSuccessfullyFinishedResourceIsPassedAfterOutputsAreCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": true}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	cache->storeResourceId("key", "ID");
+	std::promise<bool> outputCachedWhenStatusPassed;
+
+	conn.sendGetRequestAsync(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status",
+		[&](std::unique_ptr<Connection::Response> response,
+				std::exception_ptr error) {
+			EXPECT_EQ(nullptr, error);
+			EXPECT_EQ("{\"finished\": true}", response->body());
+			outputCachedWhenStatusPassed.set_value(
+				cache->hasResponse("key", "outputs-hll"));
+		}
+	);
+
+	ASSERT_TRUE(outputCachedWhenStatusPassed.get_future().get());
+	ASSERT_TRUE(cache->finishedResourceId("key", {"outputs/hll"}));
+}
+
+TEST_F(CachingConnectionTests,
+GetRequestToUrlOutsideResourceIsNotCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/test/echo"))
+		.Times(2)
+		.WillRepeatedly(InvokeWithoutArgs(
+			[this]() { return responseWith(200, "{}"); }));
+
+	conn.sendGetRequest("https://retdec.com/service/api/test/echo");
+	conn.sendGetRequest("https://retdec.com/service/api/test/echo");
+}
+
+TEST_F(CachingConnectionTests,
+StreamingGetRequestToOutputIsServedFromCacheWhenCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	std::string body1;
+	std::string body2;
+
+	conn.sendGetRequestStreamingBody(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll",
+		[&](const char *data, std::size_t size) { body1.append(data, size); }
+	);
+	conn.sendGetRequestStreamingBody(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll",
+		[&](const char *data, std::size_t size) { body2.append(data, size); }
+	);
+
+	ASSERT_EQ("int main() {}", body1);
+	ASSERT_EQ("int main() {}", body2);
+}
+
+TEST_F(CachingConnectionTests,
+StreamingGetRequestToLargeCachedOutputPassesBodyInParts) {
+	std::string output(200 * 1024, 'x');
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200, output)));
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	std::string body;
+	int parts = 0;
+
+	conn.sendGetRequestStreamingBody(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll",
+		[&](const char *data, std::size_t size) {
+			body.append(data, size);
+			++parts;
+		}
+	);
+
+	ASSERT_EQ(output, body);
+	ASSERT_GT(parts, 1);
+}
+
+TEST_F(CachingConnectionTests,
+AsyncGetRequestToOutputIsServedFromCacheWhenCached) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	std::string body;
+
+	conn.sendGetRequestAsync(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll",
+		[&](std::unique_ptr<Connection::Response> response,
+				std::exception_ptr) {
+			body = response->body();
+		}
+	);
+
+	ASSERT_EQ("int main() {}", body);
+}
+
+TEST_F(CachingConnectionTests,
+PostRequestIsPassedToWrappedConnection) {
+	EXPECT_CALL(*wrappedConn, sendPostRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations", _, _))
+		.WillOnce(Return(responseWith(201, "{}")));
+
+	conn.sendPostRequest(
+		"https://retdec.com/service/api/decompiler/decompilations",
+		Connection::RequestArguments(), Connection::RequestFiles());
+}
+
+TEST_F(CachingConnectionTests,
+ClockReturnsClockOfWrappedConnection) {
+	auto service = std::make_shared<SimulatedService>(
+		SimulatedService::Config());
+	CachingConnection conn(std::make_shared<SimulatedConnection>(
+		service, "https://retdec.com/service/api"), cache, "key",
+		"https://retdec.com/service/api/decompiler/decompilations/ID",
+		{"outputs/hll"});
+
+	ASSERT_EQ(service->clock(), conn.clock());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
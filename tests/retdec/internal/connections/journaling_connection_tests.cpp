@@ -0,0 +1,243 @@
+///
+/// @file      retdec/internal/connections/journaling_connection_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the connection wrapper marking a journaled resource as
+///            finished.
+///
+
+#include <exception>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/connections/journaling_connection.h"
+#include "retdec/internal/submission_journal.h"
+#include "retdec/internal/utilities/json.h"
+#include "retdec/internal/utilities/os.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for JournalingConnection.
+///
+class JournalingConnectionTests: public Test {
+public:
+	JournalingConnectionTests();
+	~JournalingConnectionTests();
+
+	ResponseMock *responseWith(int statusCode, const std::string &body);
+	bool isMarkedAsFinished() const;
+
+	/// Path to a temporary journal file.
+	const std::string journalPath;
+
+	/// Journal of started resources.
+	std::shared_ptr<SubmissionJournal> journal;
+
+	/// Wrapped connection.
+	std::shared_ptr<ConnectionMock> wrappedConn;
+
+	/// Tested connection.
+	JournalingConnection conn;
+};
+
+///
+/// Sets up a journaling connection wrapping a connection mock and a journal
+/// with a record of the resource.
+///
+JournalingConnectionTests::JournalingConnectionTests():
+		journalPath(uniqueFilePath(
+			boost::filesystem::temp_directory_path().string())),
+		journal(std::make_shared<SubmissionJournal>(journalPath)),
+		wrappedConn(std::make_shared<StrictMock<ConnectionMock>>()),
+		conn(wrappedConn, journal,
+			"https://retdec.com/service/api/decompiler/decompilations", "ID",
+			{"outputs/hll", "outputs/dsm"}) {
+	journal->append({"https://retdec.com/service/api/decompiler/decompilations",
+		"ID", "key", ""});
+}
+
+///
+/// Removes the temporary journal file and its lock file.
+///
+JournalingConnectionTests::~JournalingConnectionTests() {
+	removeFile(journalPath);
+	removeFile(journalPath + ".lock");
+}
+
+///
+/// Returns a new response mock with the given status code and body.
+///
+ResponseMock *JournalingConnectionTests::responseWith(int statusCode,
+		const std::string &body) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(statusCode));
+	ON_CALL(*response, body())
+		.WillByDefault(Return(body));
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(InvokeWithoutArgs([body]() { return toJson(body); }));
+	return response;
+}
+
+///
+/// Is the resource marked as finished in the journal?
+///
+bool JournalingConnectionTests::isMarkedAsFinished() const {
+	return journal->find(
+		"https://retdec.com/service/api/decompiler/decompilations", "ID"
+	)->finished;
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsMarkedAsFinishedWhenStatusSaysItHasFailed) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200,
+			"{\"finished\": true, \"failed\": true}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_TRUE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsNotMarkedAsFinishedWhenStatusSaysItHasSucceeded) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200,
+			"{\"finished\": true, \"succeeded\": true}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_FALSE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsNotMarkedAsFinishedWhenStatusSaysItHasNotFinished) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200, "{\"finished\": false}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_FALSE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsNotMarkedAsFinishedWhenStatusRequestFails) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(500,
+			"{\"finished\": true, \"failed\": true}")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_FALSE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsMarkedAsFinishedWhenAsyncStatusSaysItHasFailed) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200,
+			"{\"finished\": true, \"failed\": true}")));
+	bool handlerCalled = false;
+
+	conn.sendGetRequestAsync(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status",
+		[&](std::unique_ptr<Connection::Response>, std::exception_ptr error) {
+			ASSERT_EQ(nullptr, error);
+			handlerCalled = true;
+		}
+	);
+
+	ASSERT_TRUE(handlerCalled);
+	ASSERT_TRUE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsMarkedAsFinishedOnlyAfterAllOutputsHaveBeenDownloaded) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/status"))
+		.WillOnce(Return(responseWith(200,
+			"{\"finished\": true, \"succeeded\": true}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/dsm"))
+		.WillOnce(Return(responseWith(200, "main:")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	ASSERT_FALSE(isMarkedAsFinished());
+	conn.sendGetRequestStreamingBody(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/dsm",
+		[](const char *, std::size_t) {});
+
+	ASSERT_TRUE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsNotMarkedAsFinishedWhenOutputRequestFails) {
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(500, "")));
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/dsm"))
+		.WillOnce(Return(responseWith(200, "")));
+
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll");
+	conn.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/dsm");
+
+	ASSERT_FALSE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceIsMarkedAsFinishedWhenAsyncRequestDownloadsLastOutput) {
+	JournalingConnection connWithOneOutput(wrappedConn, journal,
+		"https://retdec.com/service/api/decompiler/decompilations", "ID",
+		{"outputs/hll"});
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+
+	connWithOneOutput.sendGetRequestAsync(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/outputs/hll",
+		[](std::unique_ptr<Connection::Response>, std::exception_ptr) {}
+	);
+
+	ASSERT_TRUE(isMarkedAsFinished());
+}
+
+TEST_F(JournalingConnectionTests,
+ResourceWithoutOutputsIsMarkedAsFinishedWhenStatusSaysItHasSucceeded) {
+	JournalingConnection connWithoutOutputs(wrappedConn, journal,
+		"https://retdec.com/service/api/decompiler/decompilations", "ID", {});
+	EXPECT_CALL(*wrappedConn, sendGetRequestProxy(_))
+		.WillOnce(Return(responseWith(200,
+			"{\"finished\": true, \"succeeded\": true}")));
+
+	connWithoutOutputs.sendGetRequest(
+		"https://retdec.com/service/api/decompiler/decompilations/ID/status");
+
+	ASSERT_TRUE(isMarkedAsFinished());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -16,9 +16,12 @@
 #include <unistd.h>
 
 #include <boost/network/protocol/http/server.hpp>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "retdec/internal/connections/real_connection.h"
+#include "retdec/internal/files/string_file.h"
+#include "retdec/request_observer_mock.h"
 #include "retdec/settings.h"
 
 ///
@@ -28,6 +31,7 @@
 	ASSERT_TRUE(contains(response.get(), text)) << response->body();
 
 using namespace testing;
+using namespace retdec::tests;
 
 namespace retdec {
 namespace internal {
@@ -205,6 +209,74 @@ GetSendsRequestWithUserAgentHeader) {
 	ASSERT_CONTAINS(response, "User-Agent: my user agent");
 }
 
+TEST_F(RealConnectionTests,
+PostSendsRequestWithMultipartContentTypeAndLengthOfStreamedBody) {
+	const auto ApiUrl = HttpServerUrl + "/api";
+	RealConnection conn(Settings().withApiUrl(ApiUrl));
+
+	auto response = conn.sendPostRequest(ApiUrl, Connection::RequestArguments(), {
+		{"input", std::make_shared<StringFile>("content", "file.txt")}
+	});
+
+	// --6eaab101ea8e44848f8d033f5f11088a\r\n                                (36)
+	// Content-Disposition: form-data; name="input"; filename="file.txt"\r\n (67)
+	// \r\n                                                                  (2)
+	// content                                                               (7)
+	// \r\n--6eaab101ea8e44848f8d033f5f11088a--\r\n                          (40)
+	ASSERT_CONTAINS(response, "Content-Type: multipart/form-data; boundary=");
+	ASSERT_CONTAINS(response, "Content-Length: 152");
+}
+
+TEST_F(RealConnectionTests,
+GetIsReportedToRequestObserver) {
+	const auto ApiUrl = HttpServerUrl + "/api";
+	auto observer = std::make_shared<RequestObserverMock>();
+	RealConnection conn(
+		Settings()
+			.withApiUrl(ApiUrl)
+			.withRequestObserver(observer)
+	);
+	RequestObserver::Request request;
+	EXPECT_CALL(*observer, requestFinished(_))
+		.WillOnce(SaveArg<0>(&request));
+
+	auto response = conn.sendGetRequest(ApiUrl + "/test");
+
+	ASSERT_EQ("GET", request.method);
+	ASSERT_EQ(ApiUrl + "/test", request.url);
+	ASSERT_EQ(200, request.statusCode);
+	ASSERT_EQ(response->body().size(), request.bytesReceived);
+	ASSERT_TRUE(RequestObserver::Request::hasTime(request.started));
+	ASSERT_LE(request.started, request.resolved);
+	ASSERT_LE(request.resolved, request.connected);
+	ASSERT_LE(request.connected, request.requestWritten);
+	ASSERT_LE(request.requestWritten, request.finished);
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.tlsHandshakeDone));
+}
+
+TEST_F(RealConnectionTests,
+PostIsReportedToRequestObserverWithSizeOfStreamedBody) {
+	const auto ApiUrl = HttpServerUrl + "/api";
+	auto observer = std::make_shared<RequestObserverMock>();
+	RealConnection conn(
+		Settings()
+			.withApiUrl(ApiUrl)
+			.withRequestObserver(observer)
+	);
+	RequestObserver::Request request;
+	EXPECT_CALL(*observer, requestFinished(_))
+		.WillOnce(SaveArg<0>(&request));
+
+	conn.sendPostRequest(ApiUrl, Connection::RequestArguments(), {
+		{"input", std::make_shared<StringFile>("content", "file.txt")}
+	});
+
+	ASSERT_EQ("POST", request.method);
+	ASSERT_EQ(152u, request.bytesSent);
+	ASSERT_TRUE(RequestObserver::Request::hasTime(request.requestWritten));
+	ASSERT_LE(request.requestWritten, request.finished);
+}
+
 } // namespace tests
 } // namespace internal
 } // namespace retdec
@@ -0,0 +1,222 @@
+///
+/// @file      retdec/internal/connections/sharing_connection_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the connection wrapper sharing responses between
+///            handles of a resource.
+///
+
+#include <exception>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/connections/sharing_connection.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/internal/in_flight_resources.h"
+#include "retdec/internal/simulated_service.h"
+#include "retdec/internal/utilities/json.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for SharingConnection.
+///
+class SharingConnectionTests: public Test {
+public:
+	SharingConnectionTests();
+
+	ResponseMock *responseWith(int statusCode, const std::string &body);
+
+	/// Shared resource.
+	std::shared_ptr<InFlightResource> resource;
+
+	/// Connection wrapped by the first handle.
+	std::shared_ptr<ConnectionMock> wrappedConn1;
+
+	/// Connection wrapped by the second handle.
+	std::shared_ptr<ConnectionMock> wrappedConn2;
+
+	/// Connection of the first handle.
+	SharingConnection conn1;
+
+	/// Connection of the second handle.
+	SharingConnection conn2;
+
+	/// URL of the resource.
+	const std::string resourceUrl =
+		"https://retdec.com/service/api/decompiler/decompilations/ID";
+};
+
+///
+/// Sets up two handles of a resource sharing their responses.
+///
+SharingConnectionTests::SharingConnectionTests():
+	resource(std::make_shared<InFlightResource>()),
+	wrappedConn1(std::make_shared<StrictMock<ConnectionMock>>()),
+	wrappedConn2(std::make_shared<StrictMock<ConnectionMock>>()),
+	conn1(wrappedConn1, resource,
+		"https://retdec.com/service/api/decompiler/decompilations/ID"),
+	conn2(wrappedConn2, resource,
+		"https://retdec.com/service/api/decompiler/decompilations/ID") {}
+
+///
+/// Returns a new response mock with the given status code and body.
+///
+ResponseMock *SharingConnectionTests::responseWith(int statusCode,
+		const std::string &body) {
+	auto response = new NiceMock<ResponseMock>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(statusCode));
+	ON_CALL(*response, body())
+		.WillByDefault(Return(body));
+	ON_CALL(*response, bodyAsJson())
+		.WillByDefault(InvokeWithoutArgs([body]() { return toJson(body); }));
+	return response;
+}
+
+TEST_F(SharingConnectionTests,
+OutputObtainedByOneHandleIsKeptForOtherHandles) {
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+
+	conn1.sendGetRequest(resourceUrl + "/outputs/hll");
+	auto response = conn2.sendGetRequest(resourceUrl + "/outputs/hll");
+
+	ASSERT_EQ("int main() {}", response->body());
+}
+
+TEST_F(SharingConnectionTests,
+UnsuccessfulResponseIsNotKept) {
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/outputs/hll"))
+		.WillOnce(Return(responseWith(404, "")));
+	EXPECT_CALL(*wrappedConn2, sendGetRequestProxy(resourceUrl + "/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+
+	conn1.sendGetRequest(resourceUrl + "/outputs/hll");
+	auto response = conn2.sendGetRequest(resourceUrl + "/outputs/hll");
+
+	ASSERT_EQ("int main() {}", response->body());
+}
+
+TEST_F(SharingConnectionTests,
+StatusOfUnfinishedResourceIsNotKept) {
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": false}")));
+	EXPECT_CALL(*wrappedConn2, sendGetRequestProxy(resourceUrl + "/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": false}")));
+
+	conn1.sendGetRequest(resourceUrl + "/status");
+	conn2.sendGetRequest(resourceUrl + "/status");
+
+	ASSERT_FALSE(resource->hasFinished());
+}
+
+TEST_F(SharingConnectionTests,
+StatusOfFinishedResourceIsKeptAndResourceIsMarkedAsFinished) {
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/status"))
+		.WillOnce(Return(responseWith(200, "{\"finished\": true}")));
+
+	conn1.sendGetRequest(resourceUrl + "/status");
+	auto response = conn2.sendGetRequest(resourceUrl + "/status");
+
+	ASSERT_EQ("{\"finished\": true}", response->body());
+	ASSERT_TRUE(resource->hasFinished());
+}
+
+TEST_F(SharingConnectionTests,
+RequestSentWhileSameRequestIsInProgressGetsItsResponse) {
+	std::string body;
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/status"))
+		.WillOnce(InvokeWithoutArgs([&]() {
+			conn2.sendGetRequestAsync(resourceUrl + "/status",
+				[&](std::unique_ptr<Connection::Response> response,
+						std::exception_ptr) {
+					body = response->body();
+				}
+			);
+			return responseWith(200, "{\"finished\": false}");
+		}));
+
+	conn1.sendGetRequest(resourceUrl + "/status");
+
+	ASSERT_EQ("{\"finished\": false}", body);
+}
+
+TEST_F(SharingConnectionTests,
+ErrorIsPassedToAllHandlesThatHaveJoinedRequest) {
+	std::exception_ptr error;
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/status"))
+		.WillOnce(InvokeWithoutArgs([&]() -> ResponseMock * {
+			conn2.sendGetRequestAsync(resourceUrl + "/status",
+				[&](std::unique_ptr<Connection::Response>,
+						std::exception_ptr e) {
+					error = e;
+				}
+			);
+			throw std::runtime_error("connection refused");
+		}));
+
+	ASSERT_THROW(conn1.sendGetRequest(resourceUrl + "/status"),
+		std::runtime_error);
+	ASSERT_TRUE(error);
+}
+
+TEST_F(SharingConnectionTests,
+StreamingGetRequestIsServedFromKeptResponse) {
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(resourceUrl + "/outputs/hll"))
+		.WillOnce(Return(responseWith(200, "int main() {}")));
+	conn1.sendGetRequest(resourceUrl + "/outputs/hll");
+	std::string body;
+
+	conn2.sendGetRequestStreamingBody(resourceUrl + "/outputs/hll",
+		[&](const char *data, std::size_t size) { body.append(data, size); });
+
+	ASSERT_EQ("int main() {}", body);
+}
+
+TEST_F(SharingConnectionTests,
+GetRequestToUrlOutsideResourceIsNotShared) {
+	EXPECT_CALL(*wrappedConn1, sendGetRequestProxy(
+			"https://retdec.com/service/api/test/echo"))
+		.WillOnce(Return(responseWith(200, "{}")));
+	EXPECT_CALL(*wrappedConn2, sendGetRequestProxy(
+			"https://retdec.com/service/api/test/echo"))
+		.WillOnce(Return(responseWith(200, "{}")));
+
+	conn1.sendGetRequest("https://retdec.com/service/api/test/echo");
+	conn2.sendGetRequest("https://retdec.com/service/api/test/echo");
+}
+
+TEST_F(SharingConnectionTests,
+PostRequestIsPassedToWrappedConnection) {
+	EXPECT_CALL(*wrappedConn1, sendPostRequestProxy(
+			"https://retdec.com/service/api/decompiler/decompilations", _, _))
+		.WillOnce(Return(responseWith(201, "{}")));
+
+	conn1.sendPostRequest(
+		"https://retdec.com/service/api/decompiler/decompilations",
+		Connection::RequestArguments(), Connection::RequestFiles());
+}
+
+TEST_F(SharingConnectionTests,
+ClockReturnsClockOfWrappedConnection) {
+	auto service = std::make_shared<SimulatedService>(
+		SimulatedService::Config());
+	SharingConnection conn(std::make_shared<SimulatedConnection>(
+		service, "https://retdec.com/service/api"), resource, resourceUrl);
+
+	ASSERT_EQ(service->clock(), conn.clock());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,96 @@
+///
+/// @file      retdec/internal/connections/simulated_connection_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the connection to a simulation of the API.
+///
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/internal/simulated_service.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for SimulatedConnection.
+///
+class SimulatedConnectionTests: public Test {
+public:
+	SimulatedConnectionTests();
+
+	/// Simulation to which the connection is connected.
+	std::shared_ptr<SimulatedService> service;
+
+	/// Tested connection.
+	SimulatedConnection conn;
+};
+
+///
+/// Sets up a connection to a simulation with the default configuration.
+///
+SimulatedConnectionTests::SimulatedConnectionTests():
+	service(std::make_shared<SimulatedService>(SimulatedService::Config())),
+	conn(service, "https://retdec.com/service/api") {}
+
+TEST_F(SimulatedConnectionTests,
+GetApiUrlReturnsGivenApiUrl) {
+	ASSERT_EQ("https://retdec.com/service/api", conn.getApiUrl());
+}
+
+TEST_F(SimulatedConnectionTests,
+ClockReturnsClockOfSimulation) {
+	ASSERT_EQ(service->clock(), conn.clock());
+}
+
+TEST_F(SimulatedConnectionTests,
+SendPostRequestCreatesResourceInSimulation) {
+	auto response = conn.sendPostRequest(
+		"https://retdec.com/service/api/decompiler/decompilations",
+		Connection::RequestArguments(), Connection::RequestFiles());
+
+	ASSERT_EQ(201, response->statusCode());
+	ASSERT_EQ(1u, service->statistics().createdResourceCount);
+}
+
+TEST_F(SimulatedConnectionTests,
+SendGetRequestWithoutArgumentsIsHandledBySimulation) {
+	auto response = conn.sendGetRequest(
+		"https://retdec.com/service/api/test/echo");
+
+	ASSERT_EQ(200, response->statusCode());
+	ASSERT_EQ(1u, service->statistics().requestCount);
+}
+
+TEST_F(SimulatedConnectionTests,
+SendGetRequestWithArgumentsPassesArgumentsToSimulation) {
+	auto response = conn.sendGetRequest(
+		"https://retdec.com/service/api/test/echo", {{"a", "b"}});
+
+	ASSERT_EQ("b", response->bodyAsJson()["a"].asString());
+}
+
+TEST_F(SimulatedConnectionTests,
+SendGetRequestAsyncPassesResponseToHandlerBeforeReturning) {
+	int statusCode = 0;
+
+	conn.sendGetRequestAsync("https://retdec.com/service/api/test/echo",
+		[&](std::unique_ptr<Connection::Response> response,
+				std::exception_ptr) {
+			statusCode = response->statusCode();
+		});
+
+	ASSERT_EQ(200, statusCode);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
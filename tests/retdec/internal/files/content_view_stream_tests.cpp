@@ -0,0 +1,70 @@
+///
+/// @file      retdec/internal/files/content_view_stream_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the stream reading a view of the content of a file.
+///
+
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/files/content_view_stream.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Reads the rest of the given stream.
+///
+std::string readRest(std::istream &stream) {
+	return std::string(std::istreambuf_iterator<char>(stream),
+		std::istreambuf_iterator<char>());
+}
+
+} // anonymous namespace
+
+///
+/// Tests for ContentViewStream.
+///
+class ContentViewStreamTests: public Test {};
+
+TEST_F(ContentViewStreamTests,
+StreamReadsViewedBytes) {
+	auto content = std::make_shared<const std::string>("content");
+	ContentViewStream stream(
+		File::ContentView(content, content->data() + 1, 5));
+
+	ASSERT_EQ("onten", readRest(stream));
+}
+
+TEST_F(ContentViewStreamTests,
+StreamOfEmptyViewReadsNothing) {
+	auto content = std::make_shared<const std::string>();
+	ContentViewStream stream(
+		File::ContentView(content, content->data(), content->size()));
+
+	ASSERT_EQ("", readRest(stream));
+}
+
+TEST_F(ContentViewStreamTests,
+StreamKeepsViewedBytesAlive) {
+	auto content = std::make_shared<const std::string>("content");
+	ContentViewStream stream(
+		File::ContentView(content, content->data(), content->size()));
+
+	content.reset();
+
+	ASSERT_EQ("content", readRest(stream));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -5,6 +5,9 @@
 /// @brief     Tests for the file stored in a filesystem.
 ///
 
+#include <iterator>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "retdec/internal/files/filesystem_file.h"
@@ -49,6 +52,25 @@ GetContentReturnsCorrectContent) {
 	ASSERT_EQ("content", file.getContent());
 }
 
+TEST_F(FilesystemFileTests,
+GetSizeReturnsCorrectSize) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	FilesystemFile file(tmpFile->getPath());
+
+	ASSERT_EQ(7u, file.getSize());
+}
+
+TEST_F(FilesystemFileTests,
+OpenContentReturnsStreamWithCorrectContent) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	FilesystemFile file(tmpFile->getPath());
+
+	auto stream = file.openContent();
+
+	ASSERT_EQ("content", std::string(std::istreambuf_iterator<char>(*stream),
+		std::istreambuf_iterator<char>()));
+}
+
 TEST_F(FilesystemFileTests,
 SaveCopyToSavesCopyOfFileToGivenDirectory) {
 	const std::string Content("content");
@@ -0,0 +1,145 @@
+///
+/// @file      retdec/internal/files/mapped_file_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the file stored in a filesystem and mapped into
+///            memory.
+///
+
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/files/mapped_file.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/test_utilities/tmp_file.h"
+
+using namespace testing;
+using namespace retdec::tests;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for MappedFile.
+///
+class MappedFileTests: public Test {
+public:
+	std::string readAll(std::istream &stream) const;
+};
+
+///
+/// Reads the whole content of the given stream.
+///
+std::string MappedFileTests::readAll(std::istream &stream) const {
+	return std::string(std::istreambuf_iterator<char>(stream),
+		std::istreambuf_iterator<char>());
+}
+
+TEST_F(MappedFileTests,
+FileIsMappedWhenItExistsAndIsNonEmpty) {
+	auto tmpFile = TmpFile::createWithContent("content");
+
+	MappedFile file(tmpFile->getPath());
+
+	ASSERT_TRUE(file.isMapped());
+}
+
+TEST_F(MappedFileTests,
+GetNameReturnsCorrectValueWhenCustomNameIsGiven) {
+	auto tmpFile = TmpFile::createWithContent("content");
+
+	MappedFile file(tmpFile->getPath(), "other.txt");
+
+	ASSERT_EQ("other.txt", file.getName());
+}
+
+TEST_F(MappedFileTests,
+GetContentReturnsCorrectContent) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	MappedFile file(tmpFile->getPath());
+
+	ASSERT_EQ("content", file.getContent());
+}
+
+TEST_F(MappedFileTests,
+GetSizeReturnsCorrectSize) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	MappedFile file(tmpFile->getPath());
+
+	ASSERT_EQ(7u, file.getSize());
+}
+
+TEST_F(MappedFileTests,
+GetContentViewReturnsViewOfMappedContent) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	MappedFile file(tmpFile->getPath());
+
+	auto view1 = file.getContentView();
+	auto view2 = file.getContentView();
+
+	ASSERT_EQ("content", view1.toString());
+	ASSERT_EQ(view1.data(), view2.data());
+}
+
+TEST_F(MappedFileTests,
+ContentViewStaysValidAfterFileIsDestructed) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	auto file = std::make_unique<MappedFile>(tmpFile->getPath());
+	auto view = file->getContentView();
+
+	file.reset();
+
+	ASSERT_EQ("content", view.toString());
+}
+
+TEST_F(MappedFileTests,
+OpenContentReturnsStreamWithContent) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	MappedFile file(tmpFile->getPath());
+
+	auto stream = file.openContent();
+
+	ASSERT_EQ("content", readAll(*stream));
+}
+
+TEST_F(MappedFileTests,
+EmptyFileIsNotMappedButHasEmptyContent) {
+	auto tmpFile = TmpFile::createWithContent("");
+
+	MappedFile file(tmpFile->getPath());
+
+	ASSERT_FALSE(file.isMapped());
+	ASSERT_EQ("", file.getContent());
+	ASSERT_EQ(0u, file.getSize());
+	ASSERT_TRUE(file.getContentView().empty());
+	ASSERT_EQ("", readAll(*file.openContent()));
+}
+
+TEST_F(MappedFileTests,
+GetContentThrowsFilesystemErrorWhenFileDoesNotExist) {
+	MappedFile file("/nonexisting/file.txt");
+
+	ASSERT_FALSE(file.isMapped());
+	ASSERT_THROW(file.getContent(), FilesystemError);
+}
+
+TEST_F(MappedFileTests,
+SaveCopyToSavesCopyOfFileToGivenDirectory) {
+	auto tmpFile = TmpFile::createWithContent("content");
+	const std::string Name("retdec-cpp-mapped-file-save-copy-to-test.txt");
+	MappedFile file(tmpFile->getPath(), Name);
+
+	file.saveCopyTo(".");
+
+	RemoveFileOnDestruction remover(Name);
+	ASSERT_EQ("content", readFile(Name));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
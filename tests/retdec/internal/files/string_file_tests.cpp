@@ -5,6 +5,10 @@
 /// @brief     Tests for the file storing its content in a string.
 ///
 
+#include <iterator>
+#include <memory>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "retdec/internal/files/string_file.h"
@@ -30,6 +34,15 @@ FileHasCorrectContentUponCreation) {
 	ASSERT_EQ("content", file.getContent());
 }
 
+TEST_F(StringFileTests,
+FileHasCorrectContentAndNameWhenCreatedFromSharedContent) {
+	auto content = std::make_shared<const std::string>("content");
+	StringFile file(content, "file.txt");
+
+	ASSERT_EQ("content", file.getContent());
+	ASSERT_EQ("file.txt", file.getName());
+}
+
 TEST_F(StringFileTests,
 GetNameReturnsCorrectNameWhenFileHasName) {
 	StringFile file("content", "file.txt");
@@ -44,6 +57,44 @@ GetNameReturnsEmptyStringWhenFileHasNoName) {
 	ASSERT_EQ("", file.getName());
 }
 
+TEST_F(StringFileTests,
+GetSizeReturnsCorrectSize) {
+	StringFile file("content");
+
+	ASSERT_EQ(7u, file.getSize());
+}
+
+TEST_F(StringFileTests,
+GetContentViewReturnsViewOfSharedContentWithoutCopyingIt) {
+	auto content = std::make_shared<const std::string>("content");
+	StringFile file(content, "file.txt");
+
+	auto view = file.getContentView();
+
+	ASSERT_EQ(content->data(), view.data());
+	ASSERT_EQ(7u, view.size());
+}
+
+TEST_F(StringFileTests,
+ContentViewStaysValidAfterFileIsDestructed) {
+	auto file = std::make_unique<StringFile>("content");
+	auto view = file->getContentView();
+
+	file.reset();
+
+	ASSERT_EQ("content", view.toString());
+}
+
+TEST_F(StringFileTests,
+OpenContentReturnsStreamWithContent) {
+	StringFile file("content");
+
+	auto stream = file.openContent();
+
+	ASSERT_EQ("content", std::string(std::istreambuf_iterator<char>(*stream),
+		std::istreambuf_iterator<char>()));
+}
+
 TEST_F(StringFileTests,
 SaveCopyToSavesCopyOfFileToGivenDirectory) {
 	const std::string Content("content");
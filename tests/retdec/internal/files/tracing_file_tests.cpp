@@ -0,0 +1,96 @@
+///
+/// @file      retdec/internal/files/tracing_file_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the file wrapper tracing the saving of copies of the
+///            file.
+///
+
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/files/string_file.h"
+#include "retdec/internal/files/tracing_file.h"
+#include "retdec/internal/trace_buffer.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/test_utilities/tmp_file.h"
+
+using namespace testing;
+using namespace retdec::tests;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for TracingFile.
+///
+class TracingFileTests: public Test {
+protected:
+	TracingFileTests():
+		buffer(std::make_shared<TraceBuffer>(10)),
+		file(std::make_shared<StringFile>("content", "file.c")),
+		tracingFile(file, buffer, "decompilations 123") {}
+
+	std::shared_ptr<TraceBuffer> buffer;
+	std::shared_ptr<File> file;
+	TracingFile tracingFile;
+};
+
+TEST_F(TracingFileTests,
+GetNameReturnsNameOfWrappedFile) {
+	ASSERT_EQ("file.c", tracingFile.getName());
+}
+
+TEST_F(TracingFileTests,
+GetContentReturnsContentOfWrappedFile) {
+	ASSERT_EQ("content", tracingFile.getContent());
+}
+
+TEST_F(TracingFileTests,
+GetContentViewReturnsContentOfWrappedFile) {
+	ASSERT_EQ("content", tracingFile.getContentView().toString());
+}
+
+TEST_F(TracingFileTests,
+GetSizeReturnsSizeOfWrappedFile) {
+	ASSERT_EQ(7u, tracingFile.getSize());
+}
+
+TEST_F(TracingFileTests,
+OpenContentReturnsStreamWithContentOfWrappedFile) {
+	auto stream = tracingFile.openContent();
+
+	ASSERT_EQ("content", std::string(
+		std::istreambuf_iterator<char>(*stream),
+		std::istreambuf_iterator<char>()));
+}
+
+TEST_F(TracingFileTests,
+NothingIsTracedWhenCopyIsNotSaved) {
+	tracingFile.getContent();
+
+	ASSERT_TRUE(buffer->events().empty());
+}
+
+TEST_F(TracingFileTests,
+SaveCopyToSavesCopyOfWrappedFileAndTracesIt) {
+	const std::string Name("retdec-cpp-tracing-file-save-copy-to-test.txt");
+
+	tracingFile.saveCopyTo(".", Name);
+
+	RemoveFileOnDestruction remover(Name);
+	ASSERT_EQ("content", readFile(Name));
+	auto events = buffer->events();
+	ASSERT_EQ(1u, events.size());
+	ASSERT_EQ("saveCopyTo", events[0].name);
+	ASSERT_EQ("decompilations 123", events[0].track);
+	ASSERT_EQ(Name, events[0].args["file"].asString());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
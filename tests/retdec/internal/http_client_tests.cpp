@@ -0,0 +1,319 @@
+///
+/// @file      retdec/internal/http_client_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the HTTP/1.1 client keeping its connections open.
+///
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/http_client.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/test_utilities/http_server.h"
+
+using namespace testing;
+using retdec::tests::HttpServer;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for HttpClient.
+///
+class HttpClientTests: public Test {
+protected:
+	HttpClientTests();
+
+	HttpClient::Request request(const std::string &target = "/") const;
+	std::string send(const HttpClient::Request &request);
+	std::string sendAsync(const HttpClient::Request &request);
+
+	/// Response sent by the server to every request.
+	HttpServer::Response serverResponse;
+
+	/// Last request received by the server.
+	HttpServer::Request lastServerRequest;
+
+	/// Server to which requests are sent.
+	HttpServer server;
+
+	/// Tested client.
+	HttpClient client;
+
+	/// Status and headers of the last response received by the client.
+	HttpClient::Response lastResponse;
+
+	/// Thread that received the body of the last asynchronous response.
+	std::thread::id asyncBodyThreadId;
+};
+
+HttpClientTests::HttpClientTests():
+	server([this](const HttpServer::Request &request) {
+		lastServerRequest = request;
+		return serverResponse;
+	}),
+	client(std::make_shared<IoService>(1)) {}
+
+///
+/// Returns a GET request for the given target on the server.
+///
+HttpClient::Request HttpClientTests::request(const std::string &target) const {
+	HttpClient::Request request;
+	request.method = "GET";
+	request.url = server.url() + target;
+	return request;
+}
+
+///
+/// Sends the given request synchronously and returns the received body.
+///
+std::string HttpClientTests::send(const HttpClient::Request &request) {
+	std::string body;
+	client.send(
+		request,
+		[this](const HttpClient::Response &response) {
+			lastResponse = response;
+		},
+		[&](const char *data, std::size_t size) {
+			body.append(data, size);
+		}
+	);
+	return body;
+}
+
+///
+/// Sends the given request asynchronously, waits for its completion, and
+/// returns the received body.
+///
+/// @throws Error passed to the completion handler.
+///
+std::string HttpClientTests::sendAsync(const HttpClient::Request &request) {
+	auto body = std::make_shared<std::string>();
+	std::promise<void> completed;
+	client.sendAsync(
+		request,
+		[this](const HttpClient::Response &response) {
+			lastResponse = response;
+		},
+		[this, body](const char *data, std::size_t size) {
+			asyncBodyThreadId = std::this_thread::get_id();
+			body->append(data, size);
+		},
+		[&](std::exception_ptr error) {
+			if (error) {
+				completed.set_exception(error);
+			} else {
+				completed.set_value();
+			}
+		}
+	);
+	completed.get_future().get();
+	return *body;
+}
+
+TEST_F(HttpClientTests,
+SendReturnsStatusHeadersAndBodyOfResponse) {
+	serverResponse.code = 404;
+	serverResponse.reason = "Not Found";
+	serverResponse.headers = {{"Content-Type", "text/plain"}};
+	serverResponse.body = "no such file";
+
+	auto body = send(request());
+
+	ASSERT_EQ("no such file", body);
+	ASSERT_EQ(404, lastResponse.statusCode);
+	ASSERT_EQ("Not Found", lastResponse.statusMessage);
+	ASSERT_EQ("text/plain", lastResponse.header("content-type"));
+}
+
+TEST_F(HttpClientTests,
+SendSendsMethodTargetHeadersAndBody) {
+	auto request = this->request("/path?key=value");
+	request.method = "POST";
+	request.headers = {{"User-Agent", "test"}};
+	auto chunks = std::make_shared<int>(0);
+	request.body = [chunks](std::string &chunk) {
+		if (*chunks == 2) {
+			return false;
+		}
+		chunk = *chunks == 0 ? "hello " : "world";
+		++*chunks;
+		return true;
+	};
+	request.bodySize = 11;
+
+	send(request);
+
+	ASSERT_EQ("POST", lastServerRequest.method);
+	ASSERT_EQ("/path?key=value", lastServerRequest.target);
+	ASSERT_EQ("test", lastServerRequest.header("User-Agent"));
+	ASSERT_EQ(server.url().substr(7), lastServerRequest.header("Host"));
+	ASSERT_EQ("11", lastServerRequest.header("Content-Length"));
+	ASSERT_EQ("hello world", lastServerRequest.body);
+}
+
+TEST_F(HttpClientTests,
+ConnectionIsReusedBySubsequentRequests) {
+	serverResponse.body = "body";
+
+	send(request());
+	send(request());
+	sendAsync(request());
+
+	ASSERT_EQ(1u, server.acceptedConnectionCount());
+	ASSERT_EQ(1u, client.idleConnectionCount());
+}
+
+TEST_F(HttpClientTests,
+ChunkedBodyOfResponseIsDecoded) {
+	serverResponse.body = "chunked body";
+	serverResponse.bodyEnd = HttpServer::BodyEnd::Chunked;
+
+	ASSERT_EQ("chunked body", send(request()));
+	ASSERT_EQ("chunked body", send(request()));
+	ASSERT_EQ(1u, server.acceptedConnectionCount());
+}
+
+TEST_F(HttpClientTests,
+BodyOfResponseEndedByClosingConnectionIsReceived) {
+	serverResponse.body = "body until the end";
+	serverResponse.bodyEnd = HttpServer::BodyEnd::ClosedConnection;
+
+	ASSERT_EQ("body until the end", send(request()));
+	ASSERT_EQ(0u, client.idleConnectionCount());
+}
+
+TEST_F(HttpClientTests,
+ConnectionIsNotKeptWhenServerClosesIt) {
+	serverResponse.closeConnection = true;
+
+	send(request());
+	send(request());
+
+	ASSERT_EQ(2u, server.acceptedConnectionCount());
+	ASSERT_EQ(0u, client.idleConnectionCount());
+}
+
+TEST_F(HttpClientTests,
+IdleConnectionClosedByServerIsReplacedByNewOne) {
+	serverResponse.body = "body";
+	send(request());
+
+	server.closeConnections();
+	// Give the client's side of the connection time to notice the closing.
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	ASSERT_EQ("body", send(request()));
+	ASSERT_EQ(2u, server.acceptedConnectionCount());
+}
+
+TEST_F(HttpClientTests,
+PhasesOfEstablishingNewConnectionAndWritingRequestAreReported) {
+	std::vector<HttpClient::Phase> phases;
+	auto request = this->request();
+	request.phaseHandler = [&](HttpClient::Phase phase) {
+		phases.push_back(phase);
+	};
+
+	send(request);
+
+	ASSERT_EQ(
+		std::vector<HttpClient::Phase>({
+			HttpClient::Phase::Resolved,
+			HttpClient::Phase::Connected,
+			HttpClient::Phase::RequestWritten
+		}),
+		phases
+	);
+}
+
+TEST_F(HttpClientTests,
+OnlyWritingOfRequestIsReportedWhenConnectionIsReused) {
+	send(request());
+	std::vector<HttpClient::Phase> phases;
+	auto request = this->request();
+	request.phaseHandler = [&](HttpClient::Phase phase) {
+		phases.push_back(phase);
+	};
+
+	sendAsync(request);
+
+	ASSERT_EQ(
+		std::vector<HttpClient::Phase>({HttpClient::Phase::RequestWritten}),
+		phases
+	);
+}
+
+TEST_F(HttpClientTests,
+SendAsyncReceivesBodyOnIoThread) {
+	serverResponse.body = "body";
+
+	ASSERT_EQ("body", sendAsync(request()));
+	ASSERT_NE(std::this_thread::get_id(), asyncBodyThreadId);
+}
+
+TEST_F(HttpClientTests,
+SendThrowsConnectionErrorForUnsupportedUrl) {
+	auto request = this->request();
+	request.url = "ftp://localhost/";
+
+	ASSERT_THROW(send(request), ConnectionError);
+}
+
+TEST_F(HttpClientTests,
+SendThrowsConnectionErrorWhenServerIsNotRunning) {
+	std::string url;
+	{
+		HttpServer stoppedServer([](const HttpServer::Request &) {
+			return HttpServer::Response();
+		});
+		url = stoppedServer.url();
+	}
+	auto request = this->request();
+	request.url = url + "/";
+
+	ASSERT_THROW(send(request), ConnectionError);
+}
+
+TEST_F(HttpClientTests,
+SendAsyncPassesConnectionErrorWhenServerIsNotRunning) {
+	std::string url;
+	{
+		HttpServer stoppedServer([](const HttpServer::Request &) {
+			return HttpServer::Response();
+		});
+		url = stoppedServer.url();
+	}
+	auto request = this->request();
+	request.url = url + "/";
+
+	ASSERT_THROW(sendAsync(request), ConnectionError);
+}
+
+TEST_F(HttpClientTests,
+SendAsyncPassesExceptionFromBodyGenerator) {
+	auto request = this->request();
+	request.method = "POST";
+	request.body = [](std::string &) -> bool {
+		throw std::runtime_error("generator failed");
+	};
+	request.bodySize = 1;
+
+	ASSERT_THROW(sendAsync(request), std::runtime_error);
+	ASSERT_EQ(0u, client.idleConnectionCount());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
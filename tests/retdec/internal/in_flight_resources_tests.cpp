@@ -0,0 +1,243 @@
+///
+/// @file      retdec/internal/in_flight_resources_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for resources shared by identical runs that are in
+///            progress.
+///
+
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/in_flight_resources.h"
+#include "retdec/internal/stored_response.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a successful response with the given body.
+///
+std::unique_ptr<Connection::Response> responseWith(const std::string &body) {
+	return std::make_unique<StoredResponse>(200, "OK",
+		std::make_shared<const std::string>(body), "");
+}
+
+} // anonymous namespace
+
+///
+/// Tests for InFlightResource.
+///
+class InFlightResourceTests: public Test {
+public:
+	/// Tested resource.
+	InFlightResource resource;
+};
+
+TEST_F(InFlightResourceTests,
+WhenStartedCallsHandlerWithIdOnceResourceIsStarted) {
+	std::string id;
+	resource.whenStarted([&](const std::string &startedId, std::exception_ptr) {
+		id = startedId;
+	});
+
+	resource.started("ID");
+
+	ASSERT_EQ("ID", id);
+}
+
+TEST_F(InFlightResourceTests,
+WhenStartedCallsHandlerRightAwayWhenResourceHasBeenStarted) {
+	resource.started("ID");
+	std::string id;
+
+	resource.whenStarted([&](const std::string &startedId, std::exception_ptr) {
+		id = startedId;
+	});
+
+	ASSERT_EQ("ID", id);
+}
+
+TEST_F(InFlightResourceTests,
+WaitUntilStartedReturnsIdWhenResourceHasBeenStarted) {
+	resource.started("ID");
+
+	ASSERT_EQ("ID", resource.waitUntilStarted());
+}
+
+TEST_F(InFlightResourceTests,
+WaitUntilStartedThrowsErrorWhenResourceHasFailedToStart) {
+	resource.failedToStart(
+		std::make_exception_ptr(std::runtime_error("error")));
+
+	ASSERT_THROW(resource.waitUntilStarted(), std::runtime_error);
+	ASSERT_TRUE(resource.hasFailedToStart());
+}
+
+TEST_F(InFlightResourceTests,
+FailedToStartIsIgnoredWhenResourceHasBeenStarted) {
+	resource.started("ID");
+
+	resource.failedToStart(
+		std::make_exception_ptr(std::runtime_error("error")));
+
+	ASSERT_FALSE(resource.hasFailedToStart());
+	ASSERT_EQ("ID", resource.waitUntilStarted());
+}
+
+TEST_F(InFlightResourceTests,
+FirstJoinOfRequestHasToSendRequest) {
+	ASSERT_FALSE(resource.joinRequest("URL",
+		[](std::unique_ptr<Connection::Response>, std::exception_ptr) {}));
+}
+
+TEST_F(InFlightResourceTests,
+JoinsOfRequestInProgressGetSameResponse) {
+	std::string body1;
+	std::string body2;
+	resource.joinRequest("URL",
+		[&](std::unique_ptr<Connection::Response> response, std::exception_ptr) {
+			body1 = response->body();
+		});
+	auto shared = resource.joinRequest("URL",
+		[&](std::unique_ptr<Connection::Response> response, std::exception_ptr) {
+			body2 = response->body();
+		});
+
+	resource.completeRequest("URL", responseWith("body"), nullptr, false);
+
+	ASSERT_TRUE(shared);
+	ASSERT_EQ("body", body1);
+	ASSERT_EQ("body", body2);
+}
+
+TEST_F(InFlightResourceTests,
+JoinsOfRequestInProgressGetSameError) {
+	std::exception_ptr error1;
+	std::exception_ptr error2;
+	resource.joinRequest("URL",
+		[&](std::unique_ptr<Connection::Response>, std::exception_ptr error) {
+			error1 = error;
+		});
+	resource.joinRequest("URL",
+		[&](std::unique_ptr<Connection::Response>, std::exception_ptr error) {
+			error2 = error;
+		});
+
+	resource.completeRequest("URL", nullptr,
+		std::make_exception_ptr(std::runtime_error("error")), false);
+
+	ASSERT_TRUE(error1);
+	ASSERT_TRUE(error2);
+}
+
+TEST_F(InFlightResourceTests,
+RequestHasToBeSentAgainWhenResponseIsNotKept) {
+	resource.joinRequest("URL",
+		[](std::unique_ptr<Connection::Response>, std::exception_ptr) {});
+	resource.completeRequest("URL", responseWith("body"), nullptr, false);
+
+	ASSERT_FALSE(resource.joinRequest("URL",
+		[](std::unique_ptr<Connection::Response>, std::exception_ptr) {}));
+	ASSERT_EQ(nullptr, resource.keptResponse("URL"));
+}
+
+TEST_F(InFlightResourceTests,
+KeptResponseIsPassedRightAway) {
+	resource.joinRequest("URL",
+		[](std::unique_ptr<Connection::Response>, std::exception_ptr) {});
+	resource.completeRequest("URL", responseWith("body"), nullptr, true);
+	std::string body;
+
+	auto shared = resource.joinRequest("URL",
+		[&](std::unique_ptr<Connection::Response> response, std::exception_ptr) {
+			body = response->body();
+		});
+
+	ASSERT_TRUE(shared);
+	ASSERT_EQ("body", body);
+	ASSERT_EQ("body", resource.keptResponse("URL")->body());
+}
+
+///
+/// Tests for InFlightResources.
+///
+class InFlightResourcesTests: public Test {
+public:
+	/// Tested resources.
+	InFlightResources resources;
+};
+
+TEST_F(InFlightResourcesTests,
+FirstJoinHasToStartResource) {
+	auto joined = resources.join("key");
+
+	ASSERT_NE(nullptr, joined.first);
+	ASSERT_TRUE(joined.second);
+}
+
+TEST_F(InFlightResourcesTests,
+SecondJoinWithSameKeyGetsSameResource) {
+	auto joined1 = resources.join("key");
+
+	auto joined2 = resources.join("key");
+
+	ASSERT_EQ(joined1.first, joined2.first);
+	ASSERT_FALSE(joined2.second);
+}
+
+TEST_F(InFlightResourcesTests,
+JoinWithDifferentKeyGetsDifferentResource) {
+	auto joined1 = resources.join("key1");
+
+	auto joined2 = resources.join("key2");
+
+	ASSERT_NE(joined1.first, joined2.first);
+	ASSERT_TRUE(joined2.second);
+}
+
+TEST_F(InFlightResourcesTests,
+FinishedResourceIsNotShared) {
+	auto joined1 = resources.join("key");
+	joined1.first->finished();
+
+	auto joined2 = resources.join("key");
+
+	ASSERT_NE(joined1.first, joined2.first);
+	ASSERT_TRUE(joined2.second);
+}
+
+TEST_F(InFlightResourcesTests,
+ResourceThatFailedToStartIsNotShared) {
+	auto joined1 = resources.join("key");
+	joined1.first->failedToStart(
+		std::make_exception_ptr(std::runtime_error("error")));
+
+	auto joined2 = resources.join("key");
+
+	ASSERT_NE(joined1.first, joined2.first);
+	ASSERT_TRUE(joined2.second);
+}
+
+TEST_F(InFlightResourcesTests,
+ResourceIsForgottenWhenItIsNotHeld) {
+	resources.join("key");
+
+	auto joined = resources.join("key");
+
+	ASSERT_TRUE(joined.second);
+	ASSERT_EQ(1u, resources.size());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,108 @@
+///
+/// @file      retdec/internal/io_service_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the I/O service shared by connections.
+///
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/utilities/os.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for IoService.
+///
+class IoServiceTests: public Test {};
+
+TEST_F(IoServiceTests,
+HasGivenNumberOfThreads) {
+	IoService service(3);
+
+	ASSERT_EQ(3u, service.threadCount());
+}
+
+TEST_F(IoServiceTests,
+HasAtLeastOneThread) {
+	IoService service(0);
+
+	ASSERT_EQ(1u, service.threadCount());
+}
+
+TEST_F(IoServiceTests,
+PostedHandlerIsRunByWorkerThread) {
+	IoService service(1);
+	std::atomic<bool> handlerRun(false);
+
+	service.asioService()->post([&]() { handlerRun = true; });
+
+	for (int i = 0; i < 100 && !handlerRun; ++i) {
+		sleep(10);
+	}
+	ASSERT_TRUE(handlerRun);
+}
+
+TEST_F(IoServiceTests,
+IsWorkerThreadReturnsTrueOnlyOnWorkerThread) {
+	IoService service(1);
+	std::atomic<bool> handlerRun(false);
+	std::atomic<bool> runOnWorkerThread(false);
+
+	service.asioService()->post([&]() {
+		runOnWorkerThread = IoService::isWorkerThread();
+		handlerRun = true;
+	});
+
+	for (int i = 0; i < 100 && !handlerRun; ++i) {
+		sleep(10);
+	}
+	ASSERT_TRUE(runOnWorkerThread);
+	ASSERT_FALSE(IoService::isWorkerThread());
+}
+
+TEST_F(IoServiceTests,
+PostedHandlersAreRunBeforeServiceIsDestructed) {
+	std::atomic<int> handlersRun(0);
+	{
+		IoService service(1);
+		auto asioService = service.asioService();
+		asioService->post([&, asioService]() {
+			sleep(10);
+			++handlersRun;
+			// Work posted by a running handler is run as well.
+			asioService->post([&]() { ++handlersRun; });
+		});
+	}
+
+	ASSERT_EQ(2, handlersRun);
+}
+
+TEST_F(IoServiceTests,
+SharedReturnsSameServiceForSameNumberOfThreadsWhileItIsUsed) {
+	auto service1 = IoService::shared(2);
+	auto service2 = IoService::shared(2);
+
+	ASSERT_EQ(service1, service2);
+}
+
+TEST_F(IoServiceTests,
+SharedReturnsDifferentServicesForDifferentNumbersOfThreads) {
+	auto service1 = IoService::shared(1);
+	auto service2 = IoService::shared(2);
+
+	ASSERT_NE(service1, service2);
+	ASSERT_EQ(1u, service1->threadCount());
+	ASSERT_EQ(2u, service2->threadCount());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,373 @@
+///
+/// @file      retdec/internal/metrics_registry_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the registry of metrics of requests and resources.
+///
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/resource_status.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for Counter.
+///
+class CounterTests: public Test {};
+
+TEST_F(CounterTests,
+ValueIsZeroByDefault) {
+	Counter counter;
+
+	ASSERT_EQ(0u, counter.value());
+}
+
+TEST_F(CounterTests,
+IncrementIncreasesValue) {
+	Counter counter;
+
+	counter.increment();
+	counter.increment(5);
+
+	ASSERT_EQ(6u, counter.value());
+}
+
+TEST_F(CounterTests,
+IncrementsFromManyThreadsAreAllCounted) {
+	Counter counter;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 8; ++i) {
+		threads.emplace_back([&]() {
+			for (int j = 0; j < 1000; ++j) {
+				counter.increment();
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	ASSERT_EQ(8000u, counter.value());
+}
+
+///
+/// Tests for Histogram.
+///
+class HistogramTests: public Test {};
+
+TEST_F(HistogramTests,
+IsEmptyByDefault) {
+	Histogram histogram;
+
+	ASSERT_EQ(0u, histogram.count());
+	ASSERT_EQ(0u, histogram.sumInMicroseconds());
+}
+
+TEST_F(HistogramTests,
+RecordIncreasesCountAndSum) {
+	Histogram histogram;
+
+	histogram.record(std::chrono::microseconds(100));
+	histogram.record(std::chrono::microseconds(250));
+
+	ASSERT_EQ(2u, histogram.count());
+	ASSERT_EQ(350u, histogram.sumInMicroseconds());
+}
+
+TEST_F(HistogramTests,
+RecordPutsDurationIntoItsBucket) {
+	Histogram histogram;
+
+	histogram.record(std::chrono::microseconds(100));
+
+	ASSERT_EQ(1u, histogram.bucketCount(Histogram::bucketIndex(100)));
+}
+
+TEST_F(HistogramTests,
+NegativeDurationIsRecordedAsZero) {
+	Histogram histogram;
+
+	histogram.record(std::chrono::microseconds(-5));
+
+	ASSERT_EQ(1u, histogram.bucketCount(0));
+	ASSERT_EQ(0u, histogram.sumInMicroseconds());
+}
+
+TEST_F(HistogramTests,
+SmallDurationsHaveTheirOwnBuckets) {
+	for (std::uint64_t i = 0; i < Histogram::SubBucketCount; ++i) {
+		ASSERT_EQ(i, Histogram::bucketIndex(i));
+		ASSERT_EQ(i, Histogram::bucketLowerBound(i));
+	}
+}
+
+TEST_F(HistogramTests,
+PowersOfTwoAreSplitIntoSubBuckets) {
+	// 1024 = 2^10 is split into buckets starting at 1024, 1280, 1536, 1792.
+	ASSERT_EQ(Histogram::bucketIndex(1024), Histogram::bucketIndex(1279));
+	ASSERT_EQ(Histogram::bucketIndex(1024) + 1, Histogram::bucketIndex(1280));
+	ASSERT_EQ(Histogram::bucketIndex(1792) + 1, Histogram::bucketIndex(2048));
+	ASSERT_EQ(1280u, Histogram::bucketLowerBound(
+		Histogram::bucketIndex(1280)));
+}
+
+TEST_F(HistogramTests,
+EveryDurationIsWithinBoundsOfItsBucket) {
+	for (std::uint64_t v = 0; v < 100000; v += 7) {
+		auto index = Histogram::bucketIndex(v);
+		ASSERT_LE(Histogram::bucketLowerBound(index), v);
+		ASSERT_GT(Histogram::bucketLowerBound(index + 1), v);
+	}
+}
+
+TEST_F(HistogramTests,
+HugeDurationIsRecordedIntoLastBucket) {
+	ASSERT_EQ(Histogram::BucketCount - 1,
+		Histogram::bucketIndex(UINT64_MAX));
+}
+
+///
+/// Tests for MetricsRegistry.
+///
+class MetricsRegistryTests: public Test {
+public:
+	bool exported(const std::string &line);
+
+	/// Tested registry.
+	MetricsRegistry registry;
+};
+
+///
+/// Has the given line been exported?
+///
+bool MetricsRegistryTests::exported(const std::string &line) {
+	return registry.toPrometheusText().find(line + "\n") != std::string::npos;
+}
+
+TEST_F(MetricsRegistryTests,
+ServiceFromNameReturnsCorrectService) {
+	ASSERT_EQ(MetricsRegistry::Service::Decompiler,
+		MetricsRegistry::serviceFromName("decompiler"));
+	ASSERT_EQ(MetricsRegistry::Service::Fileinfo,
+		MetricsRegistry::serviceFromName("fileinfo"));
+	ASSERT_EQ(MetricsRegistry::Service::Test,
+		MetricsRegistry::serviceFromName("test"));
+	ASSERT_EQ(MetricsRegistry::Service::Other,
+		MetricsRegistry::serviceFromName("xxx"));
+}
+
+TEST_F(MetricsRegistryTests,
+ServiceFromUrlReturnsServiceFromFirstPartOfPathAfterApiUrl) {
+	ASSERT_EQ(MetricsRegistry::Service::Decompiler,
+		MetricsRegistry::serviceFromUrl("https://retdec.com/service/api",
+			"https://retdec.com/service/api/decompiler/decompilations"));
+	ASSERT_EQ(MetricsRegistry::Service::Test,
+		MetricsRegistry::serviceFromUrl("https://retdec.com/service/api",
+			"https://retdec.com/service/api/test?a=b"));
+	ASSERT_EQ(MetricsRegistry::Service::Fileinfo,
+		MetricsRegistry::serviceFromUrl("https://retdec.com/service/api",
+			"https://retdec.com/service/api/fileinfo"));
+}
+
+TEST_F(MetricsRegistryTests,
+ServiceFromUrlReturnsOtherForUrlOutsideOfApi) {
+	ASSERT_EQ(MetricsRegistry::Service::Other,
+		MetricsRegistry::serviceFromUrl("https://retdec.com/service/api",
+			"https://example.com/decompiler"));
+	ASSERT_EQ(MetricsRegistry::Service::Other,
+		MetricsRegistry::serviceFromUrl("https://retdec.com/service/api",
+			"https://retdec.com/service/apidecompiler"));
+}
+
+TEST_F(MetricsRegistryTests,
+EmptyRegistryExportsOnlyHeaders) {
+	auto text = registry.toPrometheusText();
+
+	ASSERT_NE(std::string::npos,
+		text.find("# TYPE retdec_requests_total counter\n"));
+	ASSERT_NE(std::string::npos,
+		text.find("# TYPE retdec_request_duration_seconds histogram\n"));
+	ASSERT_EQ(std::string::npos, text.find("service="));
+}
+
+TEST_F(MetricsRegistryTests,
+FinishedRequestsAreExportedByServiceAndStatusCode) {
+	registry.requestFinished(MetricsRegistry::Service::Decompiler, 200,
+		std::chrono::milliseconds(1));
+	registry.requestFinished(MetricsRegistry::Service::Decompiler, 200,
+		std::chrono::milliseconds(1));
+	registry.requestFinished(MetricsRegistry::Service::Fileinfo, 404,
+		std::chrono::milliseconds(1));
+
+	ASSERT_TRUE(exported(
+		"retdec_requests_total{service=\"decompiler\",code=\"200\"} 2"));
+	ASSERT_TRUE(exported(
+		"retdec_requests_total{service=\"fileinfo\",code=\"404\"} 1"));
+}
+
+TEST_F(MetricsRegistryTests,
+DurationsOfRequestsAreExportedAsCumulativeHistogramInSeconds) {
+	registry.requestFinished(MetricsRegistry::Service::Test, 200,
+		std::chrono::microseconds(1024));
+	registry.requestFinished(MetricsRegistry::Service::Test, 200,
+		std::chrono::microseconds(1300));
+
+	ASSERT_TRUE(exported("retdec_request_duration_seconds_bucket"
+		"{service=\"test\",code=\"200\",le=\"0.00128\"} 1"));
+	ASSERT_TRUE(exported("retdec_request_duration_seconds_bucket"
+		"{service=\"test\",code=\"200\",le=\"0.001536\"} 2"));
+	ASSERT_TRUE(exported("retdec_request_duration_seconds_bucket"
+		"{service=\"test\",code=\"200\",le=\"+Inf\"} 2"));
+	ASSERT_TRUE(exported("retdec_request_duration_seconds_sum"
+		"{service=\"test\",code=\"200\"} 0.002324"));
+	ASSERT_TRUE(exported("retdec_request_duration_seconds_count"
+		"{service=\"test\",code=\"200\"} 2"));
+}
+
+TEST_F(MetricsRegistryTests,
+UnusualStatusCodesAreExportedAsOther) {
+	registry.requestFinished(MetricsRegistry::Service::Test, 1000,
+		std::chrono::milliseconds(1));
+
+	ASSERT_TRUE(exported(
+		"retdec_requests_total{service=\"test\",code=\"other\"} 1"));
+}
+
+TEST_F(MetricsRegistryTests,
+FailedRequestsAreExported) {
+	registry.requestFailed(MetricsRegistry::Service::Decompiler);
+
+	ASSERT_TRUE(exported(
+		"retdec_failed_requests_total{service=\"decompiler\"} 1"));
+}
+
+TEST_F(MetricsRegistryTests,
+StatusPollsAreExported) {
+	registry.statusPolled(MetricsRegistry::Service::Fileinfo);
+	registry.statusPolled(MetricsRegistry::Service::Fileinfo);
+
+	ASSERT_TRUE(exported(
+		"retdec_status_polls_total{service=\"fileinfo\"} 2"));
+}
+
+TEST_F(MetricsRegistryTests,
+FinishedResourcesAreExportedByResult) {
+	registry.resourceFinished(MetricsRegistry::Service::Decompiler, true,
+		std::chrono::seconds(2));
+	registry.resourceFinished(MetricsRegistry::Service::Decompiler, false,
+		std::chrono::seconds(3));
+
+	ASSERT_TRUE(exported("retdec_resource_duration_seconds_sum"
+		"{service=\"decompiler\",result=\"succeeded\"} 2"));
+	ASSERT_TRUE(exported("retdec_resource_duration_seconds_sum"
+		"{service=\"decompiler\",result=\"failed\"} 3"));
+}
+
+TEST_F(MetricsRegistryTests,
+RequestsFinishedFromManyThreadsAreAllCounted) {
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 8; ++i) {
+		threads.emplace_back([&]() {
+			for (int j = 0; j < 1000; ++j) {
+				registry.requestFinished(MetricsRegistry::Service::Test,
+					200 + j % 2, std::chrono::microseconds(j));
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	ASSERT_TRUE(exported(
+		"retdec_requests_total{service=\"test\",code=\"200\"} 4000"));
+	ASSERT_TRUE(exported(
+		"retdec_requests_total{service=\"test\",code=\"201\"} 4000"));
+}
+
+///
+/// Tests for ResourceMetrics.
+///
+class ResourceMetricsTests: public Test {
+public:
+	static ResourceStatus status(bool finished, bool succeeded = false);
+
+	/// Registry into which the metrics are recorded.
+	std::shared_ptr<MetricsRegistry> registry =
+		std::make_shared<MetricsRegistry>();
+};
+
+///
+/// Returns a status with the given values.
+///
+ResourceStatus ResourceMetricsTests::status(bool finished, bool succeeded) {
+	ResourceStatus status;
+	status.finished = finished;
+	status.succeeded = succeeded;
+	status.failed = finished && !succeeded;
+	return status;
+}
+
+TEST_F(ResourceMetricsTests,
+StatusPolledIsRecordedForServiceOfResource) {
+	ResourceMetrics metrics(registry, MetricsRegistry::Service::Fileinfo);
+
+	metrics.statusPolled();
+
+	ASSERT_NE(std::string::npos, registry->toPrometheusText().find(
+		"retdec_status_polls_total{service=\"fileinfo\"} 1\n"));
+}
+
+TEST_F(ResourceMetricsTests,
+DurationIsRecordedOnceWhenResourceFinishes) {
+	ResourceMetrics metrics(registry, MetricsRegistry::Service::Decompiler);
+
+	metrics.statusReceived(status(false));
+	metrics.statusReceived(status(true, true));
+	metrics.statusReceived(status(true, true));
+
+	ASSERT_NE(std::string::npos, registry->toPrometheusText().find(
+		"retdec_resource_duration_seconds_count"
+		"{service=\"decompiler\",result=\"succeeded\"} 1\n"));
+}
+
+TEST_F(ResourceMetricsTests,
+DurationIsRecordedWhenResourceFinishesBeforeFirstStatusUpdate) {
+	ResourceMetrics metrics(registry, MetricsRegistry::Service::Decompiler);
+
+	metrics.statusReceived(status(true, true));
+
+	ASSERT_NE(std::string::npos, registry->toPrometheusText().find(
+		"retdec_resource_duration_seconds_count"
+		"{service=\"decompiler\",result=\"succeeded\"} 1\n"));
+}
+
+TEST_F(ResourceMetricsTests,
+DurationIsNotRecordedWhenItShouldNotBeMeasured) {
+	ResourceMetrics metrics(registry, MetricsRegistry::Service::Decompiler,
+		false);
+
+	metrics.statusReceived(status(false));
+	metrics.statusReceived(status(true, true));
+
+	ASSERT_EQ(std::string::npos, registry->toPrometheusText().find(
+		"retdec_resource_duration_seconds_count"));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
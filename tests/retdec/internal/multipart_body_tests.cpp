@@ -0,0 +1,170 @@
+///
+/// @file      retdec/internal/multipart_body_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the body of a multipart/form-data request.
+///
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/files/string_file.h"
+#include "retdec/internal/multipart_body.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Generates the whole body by calling @a body until it generates nothing.
+///
+std::string generateWholeBody(MultipartBody &body) {
+	std::string wholeBody;
+	std::string chunk;
+	while (body(chunk)) {
+		wholeBody += chunk;
+		chunk.clear();
+	}
+	return wholeBody;
+}
+
+///
+/// File whose size reported before it is read differs from the size of its
+/// content, as if the file changed in the meantime.
+///
+class FileChangingSize: public StringFile {
+public:
+	FileChangingSize(const std::string &content, std::uint64_t size):
+		StringFile(content, "file.exe"), size(size) {}
+
+	virtual std::uint64_t getSize() override {
+		return size;
+	}
+
+private:
+	/// Reported size.
+	const std::uint64_t size;
+};
+
+} // anonymous namespace
+
+///
+/// Tests for MultipartBody.
+///
+class MultipartBodyTests: public Test {};
+
+TEST_F(MultipartBodyTests,
+GeneratesNothingWhenThereAreNoFiles) {
+	MultipartBody body({}, "boundary");
+
+	ASSERT_EQ("", generateWholeBody(body));
+	ASSERT_EQ(0u, body.size());
+}
+
+TEST_F(MultipartBodyTests,
+GeneratesPartWithContentOfSingleFile) {
+	MultipartBody body({
+		{"input", std::make_shared<StringFile>("content", "file.exe")}
+	}, "boundary");
+
+	ASSERT_EQ(
+		"--boundary\r\n"
+		"Content-Disposition: form-data; name=\"input\"; filename=\"file.exe\"\r\n"
+		"\r\n"
+		"content"
+		"\r\n--boundary--\r\n",
+		generateWholeBody(body)
+	);
+}
+
+TEST_F(MultipartBodyTests,
+GeneratesPartsOfAllFilesSeparatedByBoundary) {
+	MultipartBody body({
+		{"input", std::make_shared<StringFile>("content1", "file.exe")},
+		{"pdb", std::make_shared<StringFile>("content2", "file.pdb")}
+	}, "boundary");
+
+	ASSERT_EQ(
+		"--boundary\r\n"
+		"Content-Disposition: form-data; name=\"input\"; filename=\"file.exe\"\r\n"
+		"\r\n"
+		"content1"
+		"\r\n--boundary\r\n"
+		"Content-Disposition: form-data; name=\"pdb\"; filename=\"file.pdb\"\r\n"
+		"\r\n"
+		"content2"
+		"\r\n--boundary--\r\n",
+		generateWholeBody(body)
+	);
+}
+
+TEST_F(MultipartBodyTests,
+SizeReturnsSizeOfGeneratedBody) {
+	MultipartBody body({
+		{"input", std::make_shared<StringFile>("content", "file.exe")}
+	}, "boundary");
+
+	auto size = body.size();
+
+	ASSERT_EQ(generateWholeBody(body).size(), size);
+}
+
+TEST_F(MultipartBodyTests,
+GeneratesContentOfLargeFileInChunksOfLimitedSize) {
+	std::string content(3 * MultipartBody::ChunkSize + 1, 'x');
+	MultipartBody body({
+		{"input", std::make_shared<StringFile>(content, "file.exe")}
+	}, "boundary");
+
+	std::string wholeBody;
+	std::string chunk;
+	while (body(chunk)) {
+		ASSERT_LE(chunk.size(), MultipartBody::ChunkSize);
+		wholeBody += chunk;
+		chunk.clear();
+	}
+
+	ASSERT_EQ(body.size(), wholeBody.size());
+	ASSERT_NE(std::string::npos, wholeBody.find(content));
+}
+
+TEST_F(MultipartBodyTests,
+ThrowsFilesystemErrorWhenFileIsLargerThanWhenBodyWasCreated) {
+	MultipartBody body({
+		{"input", std::make_shared<FileChangingSize>("content", 3)}
+	}, "boundary");
+
+	ASSERT_THROW(generateWholeBody(body), FilesystemError);
+}
+
+TEST_F(MultipartBodyTests,
+ThrowsFilesystemErrorWhenFileIsSmallerThanWhenBodyWasCreated) {
+	MultipartBody body({
+		{"input", std::make_shared<FileChangingSize>("content", 100)}
+	}, "boundary");
+
+	ASSERT_THROW(generateWholeBody(body), FilesystemError);
+}
+
+TEST_F(MultipartBodyTests,
+ThrowsFilesystemErrorWhenLargeFileGrowsBeyondItsSize) {
+	std::string content(2 * MultipartBody::ChunkSize, 'x');
+	MultipartBody body({
+		{"input", std::make_shared<FileChangingSize>(content,
+			MultipartBody::ChunkSize)}
+	}, "boundary");
+
+	ASSERT_THROW(generateWholeBody(body), FilesystemError);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,73 @@
+///
+/// @file      retdec/internal/polling_policies/deadline_aware_polling_policy_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the policy making sure that a status is polled right
+///            at a deadline.
+///
+
+#include <chrono>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/polling_policies/deadline_aware_polling_policy.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a progress with the given last delay and completion change.
+///
+PollingPolicy::Progress progress(std::chrono::milliseconds lastDelay,
+		int completionDelta = 0,
+		std::chrono::milliseconds elapsedTime = 0ms) {
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = elapsedTime;
+	progress.lastDelay = lastDelay;
+	progress.completionDelta = completionDelta;
+	progress.statusUpdateCount = 1;
+	progress.completion = 0;
+	return progress;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for DeadlineAwarePollingPolicy.
+///
+class DeadlineAwarePollingPolicyTests: public Test {};
+
+TEST_F(DeadlineAwarePollingPolicyTests,
+NextDelayReturnsDelayFromPolicyWhenItEndsBeforeDeadline) {
+	DeadlineAwarePollingPolicy policy(
+		PollingPolicy::fixed(500ms), 2000ms);
+
+	ASSERT_EQ(500ms, policy.nextDelay(progress(500ms, 0, 1000ms)));
+}
+
+TEST_F(DeadlineAwarePollingPolicyTests,
+NextDelayIsShortenedToEndAtDeadline) {
+	DeadlineAwarePollingPolicy policy(
+		PollingPolicy::fixed(500ms), 2000ms);
+
+	ASSERT_EQ(200ms, policy.nextDelay(progress(500ms, 0, 1800ms)));
+}
+
+TEST_F(DeadlineAwarePollingPolicyTests,
+NextDelayReturnsDelayFromPolicyAfterDeadline) {
+	DeadlineAwarePollingPolicy policy(
+		PollingPolicy::fixed(500ms), 2000ms);
+
+	ASSERT_EQ(500ms, policy.nextDelay(progress(500ms, 0, 2500ms)));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,79 @@
+///
+/// @file      retdec/internal/polling_policies/decorrelated_jitter_polling_policy_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the policy polling statuses with a randomized,
+///            decorrelated delay.
+///
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/polling_policies/decorrelated_jitter_polling_policy.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a progress with the given last delay and completion change.
+///
+PollingPolicy::Progress progress(std::chrono::milliseconds lastDelay,
+		int completionDelta = 0,
+		std::chrono::milliseconds elapsedTime = 0ms) {
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = elapsedTime;
+	progress.lastDelay = lastDelay;
+	progress.completionDelta = completionDelta;
+	progress.statusUpdateCount = 1;
+	progress.completion = 0;
+	return progress;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for DecorrelatedJitterPollingPolicy.
+///
+class DecorrelatedJitterPollingPolicyTests: public Test {};
+
+TEST_F(DecorrelatedJitterPollingPolicyTests,
+NextDelayIsBetweenBaseDelayAndThreeTimesLastDelay) {
+	DecorrelatedJitterPollingPolicy policy(100ms, 10000ms);
+
+	for (int i = 0; i < 100; ++i) {
+		auto delay = policy.nextDelay(progress(200ms));
+		ASSERT_GE(delay, 100ms);
+		ASSERT_LE(delay, 600ms);
+	}
+}
+
+TEST_F(DecorrelatedJitterPollingPolicyTests,
+NextDelayIsAtMostLastDelayWhenCompletionChanged) {
+	DecorrelatedJitterPollingPolicy policy(100ms, 10000ms);
+
+	for (int i = 0; i < 100; ++i) {
+		auto delay = policy.nextDelay(progress(200ms, 5));
+		ASSERT_GE(delay, 100ms);
+		ASSERT_LE(delay, 200ms);
+	}
+}
+
+TEST_F(DecorrelatedJitterPollingPolicyTests,
+NextDelayDoesNotExceedMaxDelay) {
+	DecorrelatedJitterPollingPolicy policy(100ms, 300ms);
+
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_LE(policy.nextDelay(progress(1000ms)), 300ms);
+	}
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,91 @@
+///
+/// @file      retdec/internal/polling_policies/exponential_polling_policy_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the policy polling statuses with an exponentially
+///            growing delay.
+///
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/polling_policies/exponential_polling_policy.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a progress with the given last delay and completion change.
+///
+PollingPolicy::Progress progress(std::chrono::milliseconds lastDelay,
+		int completionDelta = 0,
+		std::chrono::milliseconds elapsedTime = 0ms) {
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = elapsedTime;
+	progress.lastDelay = lastDelay;
+	progress.completionDelta = completionDelta;
+	progress.statusUpdateCount = 1;
+	progress.completion = 0;
+	return progress;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for ExponentialPollingPolicy.
+///
+class ExponentialPollingPolicyTests: public Test {};
+
+TEST_F(ExponentialPollingPolicyTests,
+NextDelayReturnsInitialDelayAfterFirstStatusUpdate) {
+	ExponentialPollingPolicy policy(100ms, 1000ms, 2.0);
+
+	ASSERT_EQ(100ms, policy.nextDelay(progress(0ms)));
+}
+
+TEST_F(ExponentialPollingPolicyTests,
+NextDelayGrowsByFactorWhenThereIsNoProgress) {
+	ExponentialPollingPolicy policy(100ms, 1000ms, 2.0);
+
+	ASSERT_EQ(200ms, policy.nextDelay(progress(100ms)));
+}
+
+TEST_F(ExponentialPollingPolicyTests,
+NextDelayIsRoundedUp) {
+	ExponentialPollingPolicy policy(3ms, 1000ms, 1.5);
+
+	ASSERT_EQ(5ms, policy.nextDelay(progress(3ms)));
+}
+
+TEST_F(ExponentialPollingPolicyTests,
+ShortDelayGrowsByAtLeastOneMillisecond) {
+	ExponentialPollingPolicy policy(1ms, 1000ms, 1.1);
+
+	ASSERT_EQ(2ms, policy.nextDelay(progress(1ms)));
+	ASSERT_EQ(3ms, policy.nextDelay(progress(2ms)));
+}
+
+TEST_F(ExponentialPollingPolicyTests,
+NextDelayDoesNotGrowWhenCompletionChanged) {
+	ExponentialPollingPolicy policy(100ms, 1000ms, 2.0);
+
+	ASSERT_EQ(400ms, policy.nextDelay(progress(400ms, 5)));
+}
+
+TEST_F(ExponentialPollingPolicyTests,
+NextDelayDoesNotExceedMaxDelay) {
+	ExponentialPollingPolicy policy(100ms, 1000ms, 2.0);
+
+	ASSERT_EQ(1000ms, policy.nextDelay(progress(800ms)));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,55 @@
+///
+/// @file      retdec/internal/polling_policies/fixed_polling_policy_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the policy polling statuses with a fixed delay.
+///
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/polling_policies/fixed_polling_policy.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a progress with the given last delay and completion change.
+///
+PollingPolicy::Progress progress(std::chrono::milliseconds lastDelay,
+		int completionDelta = 0,
+		std::chrono::milliseconds elapsedTime = 0ms) {
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = elapsedTime;
+	progress.lastDelay = lastDelay;
+	progress.completionDelta = completionDelta;
+	progress.statusUpdateCount = 1;
+	progress.completion = 0;
+	return progress;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for FixedPollingPolicy.
+///
+class FixedPollingPolicyTests: public Test {};
+
+TEST_F(FixedPollingPolicyTests,
+NextDelayReturnsGivenDelayRegardlessOfProgress) {
+	FixedPollingPolicy policy(500ms);
+
+	ASSERT_EQ(500ms, policy.nextDelay(progress(0ms)));
+	ASSERT_EQ(500ms, policy.nextDelay(progress(500ms, 10, 1000ms)));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
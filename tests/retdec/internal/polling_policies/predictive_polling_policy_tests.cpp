@@ -0,0 +1,122 @@
+///
+/// @file      retdec/internal/polling_policies/predictive_polling_policy_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the policy polling statuses when resources are
+///            predicted to finish.
+///
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/polling_policies/predictive_polling_policy.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a progress with the given completion timeline.
+///
+PollingPolicy::Progress progress(std::chrono::milliseconds elapsedTime,
+		const std::vector<PollingPolicy::CompletionChange> &completionChanges,
+		const std::string &mode = "bin") {
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = elapsedTime;
+	progress.lastDelay = 0ms;
+	progress.completionDelta = completionChanges.size() > 1 ?
+		completionChanges.back().completion -
+			completionChanges[completionChanges.size() - 2].completion : 0;
+	progress.statusUpdateCount = completionChanges.size();
+	progress.completion = completionChanges.back().completion;
+	progress.completionChanges = completionChanges;
+	progress.mode = mode;
+	return progress;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for PredictivePollingPolicy.
+///
+class PredictivePollingPolicyTests: public Test {};
+
+TEST_F(PredictivePollingPolicyTests,
+NextDelayReturnsMinDelayWhenThereIsNothingToPredictFrom) {
+	PredictivePollingPolicy policy(100ms, 60000ms);
+
+	ASSERT_EQ(100ms, policy.nextDelay(progress(0ms, {{0ms, 0}})));
+}
+
+TEST_F(PredictivePollingPolicyTests,
+NextDelayAimsAtPredictedFinishWhenTimelineIsLongEnough) {
+	PredictivePollingPolicy policy(100ms, 60000ms);
+
+	// 10 % per second, so the remaining 80 % take 8 seconds.
+	auto delay = policy.nextDelay(progress(2000ms,
+		{{0ms, 0}, {1000ms, 10}, {2000ms, 20}}));
+
+	ASSERT_EQ(8000ms, delay);
+}
+
+TEST_F(PredictivePollingPolicyTests,
+NextDelayAimsAtNextExpectedCompletionChangeWhenTimelineIsShort) {
+	PredictivePollingPolicy policy(100ms, 60000ms);
+
+	auto delay = policy.nextDelay(progress(1000ms, {{0ms, 0}, {1000ms, 10}}));
+
+	ASSERT_EQ(1000ms, delay);
+}
+
+TEST_F(PredictivePollingPolicyTests,
+NextDelayUsesRateObservedForOtherResourcesWithSameMode) {
+	PredictivePollingPolicy policy(100ms, 60000ms);
+	policy.nextDelay(progress(1000ms, {{0ms, 0}, {1000ms, 10}}, "bin"));
+
+	auto delay = policy.nextDelay(progress(0ms, {{0ms, 0}}, "bin"));
+
+	ASSERT_EQ(10000ms, delay);
+}
+
+TEST_F(PredictivePollingPolicyTests,
+RatesAreNotSharedBetweenModes) {
+	PredictivePollingPolicy policy(100ms, 60000ms);
+
+	policy.nextDelay(progress(1000ms, {{0ms, 0}, {1000ms, 10}}, "bin"));
+
+	ASSERT_DOUBLE_EQ(0.01, policy.rateForMode("bin"));
+	ASSERT_DOUBLE_EQ(0.0, policy.rateForMode("c"));
+}
+
+TEST_F(PredictivePollingPolicyTests,
+NextDelayGrowsWithElapsedTimeWhenResourceIsOverdue) {
+	PredictivePollingPolicy policy(100ms, 60000ms);
+
+	// Predicted to finish after 10 seconds.
+	auto delay = policy.nextDelay(progress(50000ms,
+		{{0ms, 0}, {1000ms, 10}, {2000ms, 20}}));
+
+	ASSERT_EQ(5000ms, delay);
+}
+
+TEST_F(PredictivePollingPolicyTests,
+NextDelayDoesNotExceedMaxDelay) {
+	PredictivePollingPolicy policy(100ms, 1000ms);
+
+	auto delay = policy.nextDelay(progress(2000ms,
+		{{0ms, 0}, {1000ms, 10}, {2000ms, 20}}));
+
+	ASSERT_EQ(1000ms, delay);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,150 @@
+///
+/// @file      retdec/internal/polling_progress_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the progress of polling the status of a resource.
+///
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/polling_progress.h"
+#include "retdec/internal/resource_status.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Policy that records the progresses it is asked about and returns a fixed
+/// delay.
+///
+class RecordingPollingPolicy: public PollingPolicy {
+public:
+	virtual std::chrono::milliseconds nextDelay(
+			const Progress &progress) const override {
+		progresses.push_back(progress);
+		// The view of the timeline is valid only during the call.
+		completionChanges.emplace_back(progress.completionChanges.begin(),
+			progress.completionChanges.end());
+		return 100ms;
+	}
+
+	/// Progresses the policy has been asked about.
+	mutable std::vector<Progress> progresses;
+
+	/// Copies of the timelines from the progresses.
+	mutable std::vector<std::vector<CompletionChange>> completionChanges;
+};
+
+///
+/// Returns the status from the given body of a status response.
+///
+ResourceStatus status(const std::string &body) {
+	return ResourceStatus::fromBody(body.data(), body.data() + body.size());
+}
+
+} // anonymous namespace
+
+///
+/// Tests for PollingProgress.
+///
+class PollingProgressTests: public Test {};
+
+TEST_F(PollingProgressTests,
+NextDelayReturnsDelayFromPolicy) {
+	RecordingPollingPolicy policy;
+	PollingProgress progress(policy);
+
+	ASSERT_EQ(100ms, progress.nextDelay(status("{}")));
+}
+
+TEST_F(PollingProgressTests,
+FirstProgressHasNoLastDelayAndNoCompletionChange) {
+	RecordingPollingPolicy policy;
+	PollingProgress progress(policy);
+
+	progress.nextDelay(status("{\"completion\": 20}"));
+
+	ASSERT_EQ(1u, policy.progresses.size());
+	ASSERT_EQ(0ms, policy.progresses[0].lastDelay);
+	ASSERT_EQ(0, policy.progresses[0].completionDelta);
+	ASSERT_EQ(1u, policy.progresses[0].statusUpdateCount);
+}
+
+TEST_F(PollingProgressTests,
+NextProgressHasLastDelayAndCompletionChange) {
+	RecordingPollingPolicy policy;
+	PollingProgress progress(policy);
+
+	progress.nextDelay(status("{\"completion\": 20}"));
+	progress.nextDelay(status("{\"completion\": 35}"));
+
+	ASSERT_EQ(2u, policy.progresses.size());
+	ASSERT_EQ(100ms, policy.progresses[1].lastDelay);
+	ASSERT_EQ(15, policy.progresses[1].completionDelta);
+	ASSERT_EQ(2u, policy.progresses[1].statusUpdateCount);
+}
+
+TEST_F(PollingProgressTests,
+CompletionDoesNotChangeWhenStatusDoesNotContainIt) {
+	RecordingPollingPolicy policy;
+	PollingProgress progress(policy);
+
+	progress.nextDelay(status("{\"completion\": 20}"));
+	progress.nextDelay(status("{}"));
+
+	ASSERT_EQ(0, policy.progresses[1].completionDelta);
+}
+
+TEST_F(PollingProgressTests,
+ProgressContainsTimelineOfCompletionChanges) {
+	RecordingPollingPolicy policy;
+	PollingProgress progress(policy);
+
+	progress.nextDelay(status("{\"completion\": 20}"));
+	progress.nextDelay(status("{\"completion\": 20}"));
+	progress.nextDelay(status("{\"completion\": 35}"));
+
+	const auto &changes = policy.completionChanges[2];
+	ASSERT_EQ(2u, changes.size());
+	ASSERT_EQ(20, changes[0].completion);
+	ASSERT_EQ(35, changes[1].completion);
+	ASSERT_EQ(35, policy.progresses[2].completion);
+}
+
+TEST_F(PollingProgressTests,
+ProgressContainsGivenMode) {
+	RecordingPollingPolicy policy;
+	PollingProgress progress(policy, "bin");
+
+	progress.nextDelay(status("{}"));
+
+	ASSERT_EQ("bin", policy.progresses[0].mode);
+}
+
+TEST_F(PollingProgressTests,
+ElapsedTimeIsMeasuredByGivenClock) {
+	RecordingPollingPolicy policy;
+	auto clock = std::make_shared<VirtualClock>();
+	PollingProgress progress(policy, "", clock);
+
+	clock->advance(1500ms);
+	progress.nextDelay(status("{}"));
+
+	ASSERT_EQ(1500ms, policy.progresses.at(0).elapsedTime);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,156 @@
+///
+/// @file      retdec/internal/resource_status_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the status of a resource.
+///
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/utilities/json.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns the status from the given body of a status response.
+///
+ResourceStatus fromBody(const std::string &body) {
+	return ResourceStatus::fromBody(body.data(), body.data() + body.size());
+}
+
+} // anonymous namespace
+
+///
+/// Tests for ResourceStatus.
+///
+class ResourceStatusTests: public Test {};
+
+TEST_F(ResourceStatusTests,
+StatusHasCorrectValuesByDefault) {
+	ResourceStatus status;
+
+	ASSERT_FALSE(status.finished);
+	ASSERT_FALSE(status.succeeded);
+	ASSERT_FALSE(status.failed);
+	ASSERT_EQ("", status.error);
+	ASSERT_FALSE(status.completion);
+}
+
+TEST_F(ResourceStatusTests,
+FromJsonReturnsCorrectStatus) {
+	auto status = ResourceStatus::fromJson(toJson(R"({
+		"finished": true,
+		"succeeded": false,
+		"failed": true,
+		"error": "Error message.",
+		"completion": 100
+	})"));
+
+	ASSERT_TRUE(status.finished);
+	ASSERT_FALSE(status.succeeded);
+	ASSERT_TRUE(status.failed);
+	ASSERT_EQ("Error message.", status.error);
+	ASSERT_TRUE(status.completion);
+	ASSERT_EQ(100, *status.completion);
+}
+
+TEST_F(ResourceStatusTests,
+FromJsonReturnsDefaultValuesForMissingMembers) {
+	auto status = ResourceStatus::fromJson(toJson("{}"));
+
+	ASSERT_FALSE(status.finished);
+	ASSERT_FALSE(status.succeeded);
+	ASSERT_FALSE(status.failed);
+	ASSERT_EQ("", status.error);
+	ASSERT_FALSE(status.completion);
+}
+
+TEST_F(ResourceStatusTests,
+FromBodyReturnsCorrectStatusOfUsualShape) {
+	auto status = fromBody(R"({
+		"id": "abc",
+		"finished": true,
+		"succeeded": true,
+		"failed": false,
+		"error": null,
+		"completion": 100,
+		"phases": [
+			{"name": "Initialization", "completion": 5, "warnings": []},
+			{"name": "Done", "completion": 100, "warnings": ["x \"y\""]}
+		],
+		"cg_generation": {"generated": true, "failed": false, "error": null},
+		"size": -1.5e+3
+	})");
+
+	ASSERT_TRUE(status.finished);
+	ASSERT_TRUE(status.succeeded);
+	ASSERT_FALSE(status.failed);
+	ASSERT_EQ("", status.error);
+	ASSERT_TRUE(status.completion);
+	ASSERT_EQ(100, *status.completion);
+}
+
+TEST_F(ResourceStatusTests,
+FromBodyReturnsCorrectErrorMessage) {
+	auto status = fromBody(R"({"failed": true, "error": "Error message."})");
+
+	ASSERT_TRUE(status.failed);
+	ASSERT_EQ("Error message.", status.error);
+}
+
+TEST_F(ResourceStatusTests,
+FromBodyDecodesEscapeSequencesInErrorMessage) {
+	auto status = fromBody(R"({"error": "Error:\n\"x\" A"})");
+
+	ASSERT_EQ("Error:\n\"x\" A", status.error);
+}
+
+TEST_F(ResourceStatusTests,
+FromBodyReturnsStatusWithoutCompletionWhenThereIsNoCompletion) {
+	auto status = fromBody(R"({"finished": false})");
+
+	ASSERT_FALSE(status.completion);
+}
+
+TEST_F(ResourceStatusTests,
+FromBodyReturnsSameStatusAsFromJsonForUnusualShapes) {
+	for (const auto &body : {
+			R"({"finished": 1, "succeeded": 0, "error": 5})",
+			R"({"completion": 45.5})",
+			R"({"completion": null})",
+			R"({"finished": true} // comment)",
+			R"({"finished": true, "finished": false})"}) {
+		auto status = fromBody(body);
+		auto refStatus = ResourceStatus::fromJson(toJson(body));
+
+		ASSERT_EQ(refStatus.finished, status.finished) << body;
+		ASSERT_EQ(refStatus.succeeded, status.succeeded) << body;
+		ASSERT_EQ(refStatus.failed, status.failed) << body;
+		ASSERT_EQ(refStatus.error, status.error) << body;
+		ASSERT_TRUE(refStatus.completion == status.completion) << body;
+	}
+}
+
+TEST_F(ResourceStatusTests,
+FromBodyThrowsJsonDecodingErrorWhenBodyIsNotValidJson) {
+	ASSERT_THROW(fromBody(""), JsonDecodingError);
+	ASSERT_THROW(fromBody(R"({"finished": true)"), JsonDecodingError);
+	ASSERT_THROW(fromBody(R"({"finished": true, "x": [1 2]})"),
+		JsonDecodingError);
+	ASSERT_THROW(fromBody(R"({"finished": true, "x": --1})"),
+		JsonDecodingError);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,263 @@
+///
+/// @file      retdec/internal/result_cache_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the on-disk cache of results of resources.
+///
+
+#include <future>
+#include <memory>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/result_cache.h"
+#include "retdec/internal/utilities/os.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for ResultCache.
+///
+class ResultCacheTests: public Test {
+public:
+	ResultCacheTests();
+	~ResultCacheTests();
+
+	/// Path to a temporary directory with the cache.
+	const std::string cacheDir;
+};
+
+///
+/// Sets up a path to a temporary directory with the cache.
+///
+ResultCacheTests::ResultCacheTests():
+	cacheDir(uniqueFilePath(
+		boost::filesystem::temp_directory_path().string())) {}
+
+///
+/// Removes the temporary directory with the cache.
+///
+ResultCacheTests::~ResultCacheTests() {
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(cacheDir, ec);
+}
+
+namespace {
+
+///
+/// Returns a response mock with the given body and attached file name.
+///
+std::unique_ptr<ResponseMock> responseWith(const std::string &body,
+		const std::string &attachedFileName = "") {
+	auto response = std::make_unique<NiceMock<ResponseMock>>();
+	ON_CALL(*response, statusCode())
+		.WillByDefault(Return(200));
+	ON_CALL(*response, body())
+		.WillByDefault(Return(body));
+	ON_CALL(*response, attachedFileName())
+		.WillByDefault(Return(attachedFileName));
+	return response;
+}
+
+} // anonymous namespace
+
+TEST_F(ResultCacheTests,
+FinishedResourceIdReturnsNothingWhenThereIsNoEntry) {
+	ResultCache cache(cacheDir, 1024);
+
+	ASSERT_FALSE(cache.finishedResourceId("key", {}));
+}
+
+TEST_F(ResultCacheTests,
+FinishedResourceIdReturnsNothingWhenStatusIsNotStored) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResourceId("key", "ID");
+
+	ASSERT_FALSE(cache.finishedResourceId("key", {}));
+}
+
+TEST_F(ResultCacheTests,
+FinishedResourceIdReturnsStoredIdWhenStatusIsStored) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResourceId("key", "ID");
+	cache.storeResponse("key", ResultCache::StatusResponseName,
+		*responseWith("{\"finished\": true}"));
+
+	auto id = cache.finishedResourceId("key", {});
+
+	ASSERT_TRUE(id);
+	ASSERT_EQ("ID", *id);
+}
+
+TEST_F(ResultCacheTests,
+FinishedResourceIdReturnsNothingWhenOutputIsNotStored) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResourceId("key", "ID");
+	cache.storeResponse("key", ResultCache::StatusResponseName,
+		*responseWith("{\"finished\": true}"));
+
+	ASSERT_FALSE(cache.finishedResourceId("key", {"outputs/hll"}));
+}
+
+TEST_F(ResultCacheTests,
+FinishedResourceIdReturnsStoredIdWhenStatusAndOutputsAreStored) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResourceId("key", "ID");
+	cache.storeResponse("key", "outputs-hll", *responseWith("int main() {}"));
+	cache.storeResponse("key", ResultCache::StatusResponseName,
+		*responseWith("{\"finished\": true}"));
+
+	auto id = cache.finishedResourceId("key", {"outputs/hll"});
+
+	ASSERT_TRUE(id);
+	ASSERT_EQ("ID", *id);
+}
+
+TEST_F(ResultCacheTests,
+HasResponseReturnsWhetherResponseIsStored) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResponse("key", "outputs-hll", *responseWith("int main() {}"));
+
+	ASSERT_TRUE(cache.hasResponse("key", "outputs-hll"));
+	ASSERT_FALSE(cache.hasResponse("key", "output"));
+}
+
+TEST_F(ResultCacheTests,
+ResponseNameReplacesSlashesInPath) {
+	ASSERT_EQ("outputs-hll", ResultCache::responseName("outputs/hll"));
+}
+
+TEST_F(ResultCacheTests,
+ResponseReturnsNullWhenResponseIsNotStored) {
+	ResultCache cache(cacheDir, 1024);
+
+	ASSERT_EQ(nullptr, cache.response("key", "outputs-hll"));
+}
+
+TEST_F(ResultCacheTests,
+ResponseReturnsStoredResponse) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResponse("key", "outputs-hll",
+		*responseWith("int main() {}", "file.c"));
+
+	auto response = cache.response("key", "outputs-hll");
+
+	ASSERT_NE(nullptr, response);
+	ASSERT_EQ(200, response->statusCode());
+	ASSERT_EQ("int main() {}", response->body());
+	ASSERT_EQ("file.c", response->attachedFileName());
+	ASSERT_EQ("file.c", response->bodyAsFile()->getName());
+	ASSERT_EQ("int main() {}", response->bodyAsFile()->getContent());
+}
+
+TEST_F(ResultCacheTests,
+StoreResponseFileMovesFileIntoEntry) {
+	ResultCache cache(cacheDir, 1024);
+	auto tmpFilePath = cache.newTmpFilePath();
+	writeFile(tmpFilePath, "int main() {}");
+
+	cache.storeResponseFile("key", "outputs-hll", tmpFilePath, "file.c");
+
+	auto response = cache.response("key", "outputs-hll");
+	ASSERT_NE(nullptr, response);
+	ASSERT_EQ("int main() {}", response->body());
+	ASSERT_EQ("file.c", response->attachedFileName());
+	ASSERT_FALSE(boost::filesystem::exists(tmpFilePath));
+}
+
+TEST_F(ResultCacheTests,
+EvictsLeastRecentlyUsedEntriesWhenMaxSizeIsExceeded) {
+	ResultCache cache(cacheDir, 15);
+	cache.storeResponse("key1", "outputs-hll", *responseWith("0123456789"));
+	boost::filesystem::last_write_time(joinPaths(cacheDir, "key1"), 1);
+
+	cache.storeResponse("key2", "outputs-hll", *responseWith("0123456789"));
+
+	ASSERT_EQ(nullptr, cache.response("key1", "outputs-hll"));
+	ASSERT_NE(nullptr, cache.response("key2", "outputs-hll"));
+}
+
+TEST_F(ResultCacheTests,
+EvictsLeastRecentlyUsedEntriesWhenRunningSizeExceedsMaxSize) {
+	ResultCache cache(cacheDir, 25);
+	cache.storeResponse("key1", "outputs-hll", *responseWith("0123456789"));
+	boost::filesystem::last_write_time(joinPaths(cacheDir, "key1"), 1);
+	cache.storeResponse("key2", "outputs-hll", *responseWith("0123456789"));
+	boost::filesystem::last_write_time(joinPaths(cacheDir, "key2"), 2);
+
+	cache.storeResponse("key3", "outputs-hll", *responseWith("0123456789"));
+
+	ASSERT_EQ(nullptr, cache.response("key1", "outputs-hll"));
+	ASSERT_NE(nullptr, cache.response("key2", "outputs-hll"));
+	ASSERT_NE(nullptr, cache.response("key3", "outputs-hll"));
+}
+
+TEST_F(ResultCacheTests,
+EvictsEntriesStoredByOtherCachesWhenMaxSizeIsExceeded) {
+	ResultCache otherCache(cacheDir, 15);
+	otherCache.storeResponse("key1", "outputs-hll", *responseWith("0123456789"));
+	boost::filesystem::last_write_time(joinPaths(cacheDir, "key1"), 1);
+	ResultCache cache(cacheDir, 15);
+
+	cache.storeResponse("key2", "outputs-hll", *responseWith("0123456789"));
+
+	ASSERT_EQ(nullptr, cache.response("key1", "outputs-hll"));
+	ASSERT_NE(nullptr, cache.response("key2", "outputs-hll"));
+}
+
+TEST_F(ResultCacheTests,
+StreamResponsePassesBodyOfStoredResponseAndReturnsResponse) {
+	ResultCache cache(cacheDir, 1024);
+	cache.storeResponse("key", "outputs-hll",
+		*responseWith("int main() {}", "file.c"));
+	std::string body;
+
+	auto response = cache.streamResponse("key", "outputs-hll",
+		[&](const char *data, std::size_t size) { body.append(data, size); });
+
+	ASSERT_NE(nullptr, response);
+	ASSERT_EQ("int main() {}", body);
+	ASSERT_EQ(200, response->statusCode());
+	ASSERT_EQ("file.c", response->attachedFileName());
+}
+
+TEST_F(ResultCacheTests,
+StreamResponseReturnsNullWithoutPassingBodyWhenResponseIsNotStored) {
+	ResultCache cache(cacheDir, 1024);
+	bool bodyPassed = false;
+
+	auto response = cache.streamResponse("key", "outputs-hll",
+		[&](const char *, std::size_t) { bodyPassed = true; });
+
+	ASSERT_EQ(nullptr, response);
+	ASSERT_FALSE(bodyPassed);
+}
+
+TEST_F(ResultCacheTests,
+StoreResponseAsyncStoresResponseAndThenCallsHandler) {
+	auto cache = std::make_shared<ResultCache>(cacheDir, 1024);
+	std::promise<bool> storedWhenHandlerCalled;
+
+	cache->storeResponseAsync("key", "outputs-hll",
+		*responseWith("int main() {}"),
+		[&]() {
+			storedWhenHandlerCalled.set_value(
+				cache->hasResponse("key", "outputs-hll"));
+		}
+	);
+
+	ASSERT_TRUE(storedWhenHandlerCalled.get_future().get());
+	ASSERT_EQ("int main() {}", cache->response("key", "outputs-hll")->body());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
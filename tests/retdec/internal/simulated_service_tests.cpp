@@ -0,0 +1,368 @@
+///
+/// @file      retdec/internal/simulated_service_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the simulation of the services of the API.
+///
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/clock.h"
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/simulated_service.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+/// URL to the API of the simulation.
+const std::string ApiUrl = "https://retdec.com/service/api";
+
+/// URL to decompilations.
+const std::string DecompilationsUrl = ApiUrl + "/decompiler/decompilations";
+
+/// URL to analyses.
+const std::string AnalysesUrl = ApiUrl + "/fileinfo/analyses";
+
+} // anonymous namespace
+
+///
+/// Tests for SimulatedService.
+///
+class SimulatedServiceTests: public Test {
+public:
+	std::string createDecompilation(SimulatedService &service);
+	ResourceStatus decompilationStatus(SimulatedService &service,
+		const std::string &id);
+};
+
+///
+/// Creates a decompilation and returns its ID.
+///
+std::string SimulatedServiceTests::createDecompilation(
+		SimulatedService &service) {
+	auto response = service.sendPostRequest(DecompilationsUrl,
+		Connection::RequestArguments(), Connection::RequestFiles());
+	return response->bodyAsJson()["id"].asString();
+}
+
+///
+/// Returns the status of the decompilation with the given ID.
+///
+ResourceStatus SimulatedServiceTests::decompilationStatus(
+		SimulatedService &service, const std::string &id) {
+	auto response = service.sendGetRequest(
+		DecompilationsUrl + "/" + id + "/status",
+		Connection::RequestArguments());
+	return response->bodyAsStatus();
+}
+
+TEST_F(SimulatedServiceTests,
+CreatingResourceReturnsItsId) {
+	SimulatedService service{SimulatedService::Config()};
+
+	auto response = service.sendPostRequest(DecompilationsUrl,
+		Connection::RequestArguments(), Connection::RequestFiles());
+
+	ASSERT_EQ(201, response->statusCode());
+	ASSERT_EQ("1", response->bodyAsJson()["id"].asString());
+}
+
+TEST_F(SimulatedServiceTests,
+ResourceCompletesLinearlyOverProcessingTimeAndThenSucceeds) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(100s);
+	SimulatedService service(config);
+	auto id = createDecompilation(service);
+
+	auto status = decompilationStatus(service, id);
+	ASSERT_FALSE(status.finished);
+	ASSERT_EQ(0, *status.completion);
+
+	service.clock()->advance(40s);
+	status = decompilationStatus(service, id);
+	ASSERT_FALSE(status.finished);
+	ASSERT_EQ(40, *status.completion);
+
+	service.clock()->advance(60s);
+	status = decompilationStatus(service, id);
+	ASSERT_TRUE(status.finished);
+	ASSERT_TRUE(status.succeeded);
+	ASSERT_EQ(100, *status.completion);
+}
+
+TEST_F(SimulatedServiceTests,
+UnfinishedResourceNeverReportsCompletionOf100) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(100s);
+	SimulatedService service(config);
+	auto id = createDecompilation(service);
+
+	service.clock()->advance(99999ms);
+
+	ASSERT_EQ(99, *decompilationStatus(service, id).completion);
+}
+
+TEST_F(SimulatedServiceTests,
+ResourceWaitsInQueueUntilWorkerIsFree) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(10s);
+	config.workerCount = 1;
+	SimulatedService service(config);
+	auto id1 = createDecompilation(service);
+	auto id2 = createDecompilation(service);
+
+	service.clock()->advance(5s);
+	ASSERT_EQ(0, *decompilationStatus(service, id2).completion);
+
+	service.clock()->advance(10s);
+	ASSERT_TRUE(decompilationStatus(service, id1).finished);
+	ASSERT_EQ(50, *decompilationStatus(service, id2).completion);
+
+	service.clock()->advance(5s);
+	ASSERT_TRUE(decompilationStatus(service, id2).finished);
+	ASSERT_EQ(1u, service.statistics().maxQueueLength);
+}
+
+TEST_F(SimulatedServiceTests,
+ResourcesStartInOrderOfTheirCreationWhenWorkersFreeUp) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(10s);
+	config.workerCount = 2;
+	SimulatedService service(config);
+	std::vector<std::string> ids;
+	for (int i = 0; i < 5; ++i) {
+		ids.push_back(createDecompilation(service));
+	}
+
+	// Without any request in between, the simulation has to catch up on
+	// two rounds of workers finishing.
+	service.clock()->advance(25s);
+
+	ASSERT_TRUE(decompilationStatus(service, ids[3]).finished);
+	ASSERT_EQ(50, *decompilationStatus(service, ids[4]).completion);
+	ASSERT_EQ(4u, service.statistics().finishedResourceCount);
+}
+
+TEST_F(SimulatedServiceTests,
+ResourceFailsWithFailureRateOfOne) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(1s);
+	config.failureRate = 1.0;
+	SimulatedService service(config);
+	auto id = createDecompilation(service);
+	service.clock()->advance(1s);
+
+	auto status = decompilationStatus(service, id);
+
+	ASSERT_TRUE(status.finished);
+	ASSERT_TRUE(status.failed);
+	ASSERT_FALSE(status.succeeded);
+	ASSERT_FALSE(status.error.empty());
+}
+
+TEST_F(SimulatedServiceTests,
+OutputOfSucceededDecompilationHasConfiguredSize) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(1s);
+	config.outputSize = 100;
+	SimulatedService service(config);
+	auto id = createDecompilation(service);
+	service.clock()->advance(1s);
+
+	auto response = service.sendGetRequest(
+		DecompilationsUrl + "/" + id + "/outputs/hll",
+		Connection::RequestArguments());
+
+	ASSERT_EQ(200, response->statusCode());
+	ASSERT_EQ(100u, response->body().size());
+	ASSERT_EQ(id + ".c", response->attachedFileName());
+}
+
+TEST_F(SimulatedServiceTests,
+OutputOfUnfinishedResourceIsNotAvailable) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(1s);
+	SimulatedService service(config);
+	auto id = createDecompilation(service);
+
+	auto response = service.sendGetRequest(
+		DecompilationsUrl + "/" + id + "/outputs/hll",
+		Connection::RequestArguments());
+
+	ASSERT_EQ(404, response->statusCode());
+}
+
+TEST_F(SimulatedServiceTests,
+AnalysesHaveTheirOwnStatusAndOutput) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::fixed(1s);
+	SimulatedService service(config);
+	auto id = service.sendPostRequest(AnalysesUrl,
+		Connection::RequestArguments(), Connection::RequestFiles()
+	)->bodyAsJson()["id"].asString();
+	service.clock()->advance(1s);
+
+	auto status = service.sendGetRequest(AnalysesUrl + "/" + id + "/status",
+		Connection::RequestArguments())->bodyAsStatus();
+	auto output = service.sendGetRequest(AnalysesUrl + "/" + id + "/output",
+		Connection::RequestArguments());
+
+	ASSERT_TRUE(status.succeeded);
+	ASSERT_EQ(200, output->statusCode());
+	ASSERT_EQ(id + ".txt", output->attachedFileName());
+}
+
+TEST_F(SimulatedServiceTests,
+StatusOfNonexistingResourceIsNotFound) {
+	SimulatedService service{SimulatedService::Config()};
+
+	auto response = service.sendGetRequest(DecompilationsUrl + "/X/status",
+		Connection::RequestArguments());
+
+	ASSERT_EQ(404, response->statusCode());
+}
+
+TEST_F(SimulatedServiceTests,
+EchoReturnsArgumentsOfRequest) {
+	SimulatedService service{SimulatedService::Config()};
+
+	auto response = service.sendGetRequest(ApiUrl + "/test/echo",
+		{{"a", "1"}, {"b", "2"}});
+
+	ASSERT_EQ(200, response->statusCode());
+	ASSERT_EQ("1", response->bodyAsJson()["a"].asString());
+	ASSERT_EQ("2", response->bodyAsJson()["b"].asString());
+}
+
+TEST_F(SimulatedServiceTests,
+RequestsFailWithErrorRateOfOne) {
+	SimulatedService::Config config;
+	config.errorRate = 1.0;
+	SimulatedService service(config);
+
+	auto response = service.sendPostRequest(DecompilationsUrl,
+		Connection::RequestArguments(), Connection::RequestFiles());
+
+	ASSERT_EQ(500, response->statusCode());
+	ASSERT_EQ(0u, service.statistics().createdResourceCount);
+	ASSERT_EQ(1u, service.statistics().failedRequestCount);
+}
+
+TEST_F(SimulatedServiceTests,
+EveryRequestMovesClockForwardByItsLatency) {
+	SimulatedService::Config config;
+	config.requestLatency = SimulatedService::fixed(30ms);
+	SimulatedService service(config);
+
+	auto id = createDecompilation(service);
+	decompilationStatus(service, id);
+
+	ASSERT_EQ(Clock::TimePoint(60ms), service.clock()->now());
+}
+
+TEST_F(SimulatedServiceTests,
+StatisticsCountRequests) {
+	SimulatedService service{SimulatedService::Config()};
+	auto id = createDecompilation(service);
+	decompilationStatus(service, id);
+	decompilationStatus(service, id);
+
+	auto statistics = service.statistics();
+
+	ASSERT_EQ(3u, statistics.requestCount);
+	ASSERT_EQ(2u, statistics.statusRequestCount);
+	ASSERT_EQ(1u, statistics.createdResourceCount);
+}
+
+TEST_F(SimulatedServiceTests,
+SimulationsWithSameSeedBehaveTheSame) {
+	SimulatedService::Config config;
+	config.processingTime = SimulatedService::logNormal(10s, 1.0);
+	config.seed = 42;
+	SimulatedService service1(config);
+	SimulatedService service2(config);
+	auto id1 = createDecompilation(service1);
+	auto id2 = createDecompilation(service2);
+
+	service1.clock()->advance(5s);
+	service2.clock()->advance(5s);
+
+	ASSERT_EQ(*decompilationStatus(service1, id1).completion,
+		*decompilationStatus(service2, id2).completion);
+}
+
+///
+/// Tests for distributions of SimulatedService.
+///
+class SimulatedServiceDistributionTests: public Test {
+public:
+	/// Random number generator.
+	std::mt19937_64 random;
+};
+
+TEST_F(SimulatedServiceDistributionTests,
+FixedReturnsGivenDuration) {
+	auto distribution = SimulatedService::fixed(5ms);
+
+	ASSERT_EQ(5ms, distribution(random));
+}
+
+TEST_F(SimulatedServiceDistributionTests,
+UniformReturnsDurationsBetweenMinAndMax) {
+	auto distribution = SimulatedService::uniform(10ms, 20ms);
+
+	for (int i = 0; i < 100; ++i) {
+		auto duration = distribution(random);
+		ASSERT_GE(duration, 10ms);
+		ASSERT_LE(duration, 20ms);
+	}
+}
+
+TEST_F(SimulatedServiceDistributionTests,
+ExponentialReturnsDurationsWithGivenMean) {
+	auto distribution = SimulatedService::exponential(100ms);
+
+	std::chrono::milliseconds sum(0);
+	for (int i = 0; i < 10000; ++i) {
+		sum += distribution(random);
+	}
+
+	ASSERT_NEAR(100, sum.count() / 10000, 10);
+}
+
+TEST_F(SimulatedServiceDistributionTests,
+LogNormalReturnsDurationsWithGivenMedian) {
+	auto distribution = SimulatedService::logNormal(100ms, 0.5);
+
+	int belowMedian = 0;
+	for (int i = 0; i < 10000; ++i) {
+		if (distribution(random) < 100ms) {
+			++belowMedian;
+		}
+	}
+
+	ASSERT_NEAR(5000, belowMedian, 300);
+}
+
+TEST_F(SimulatedServiceDistributionTests,
+DistributionsWithZeroMeanOrMedianReturnZero) {
+	ASSERT_EQ(0ms, SimulatedService::exponential(0ms)(random));
+	ASSERT_EQ(0ms, SimulatedService::logNormal(0ms, 1.0)(random));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
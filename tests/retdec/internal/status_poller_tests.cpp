@@ -0,0 +1,77 @@
+///
+/// @file      retdec/internal/status_poller_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the poller of statuses of resources.
+///
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/status_poller.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for StatusPoller.
+///
+class StatusPollerTests: public Test {};
+
+TEST_F(StatusPollerTests,
+ScheduledUpdateIsRunAfterGivenDelay) {
+	auto poller = std::make_shared<StatusPoller>(std::make_shared<IoService>(1));
+	std::promise<void> updateRun;
+
+	poller->schedule(std::chrono::milliseconds(1),
+		[&]() { updateRun.set_value(); });
+
+	ASSERT_EQ(
+		std::future_status::ready,
+		updateRun.get_future().wait_for(std::chrono::seconds(5))
+	);
+	ASSERT_EQ(0u, poller->scheduledCount());
+}
+
+TEST_F(StatusPollerTests,
+UpdatesAreRunInOrderOfTheirDueTimes) {
+	// A single thread runs the updates, so they are run one after another.
+	auto poller = std::make_shared<StatusPoller>(std::make_shared<IoService>(1));
+	std::vector<int> runUpdates;
+	std::promise<void> allUpdatesRun;
+
+	poller->schedule(std::chrono::milliseconds(40), [&]() {
+		runUpdates.push_back(2);
+		allUpdatesRun.set_value();
+	});
+	poller->schedule(std::chrono::milliseconds(1),
+		[&]() { runUpdates.push_back(1); });
+
+	ASSERT_EQ(
+		std::future_status::ready,
+		allUpdatesRun.get_future().wait_for(std::chrono::seconds(5))
+	);
+	ASSERT_EQ(std::vector<int>({1, 2}), runUpdates);
+}
+
+TEST_F(StatusPollerTests,
+SharedReturnsSamePollerForSameIoServiceWhileItIsUsed) {
+	auto ioService = std::make_shared<IoService>(1);
+
+	auto poller1 = StatusPoller::shared(ioService);
+	auto poller2 = StatusPoller::shared(ioService);
+
+	ASSERT_EQ(poller1, poller2);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
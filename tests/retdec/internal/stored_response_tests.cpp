@@ -0,0 +1,75 @@
+///
+/// @file      retdec/internal/stored_response_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the response stored in memory.
+///
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/file.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/stored_response.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for StoredResponse.
+///
+class StoredResponseTests: public Test {};
+
+TEST_F(StoredResponseTests,
+ReturnsCorrectValuesWhenConstructedFromValues) {
+	StoredResponse response(404, "Not Found",
+		std::make_shared<const std::string>("{\"error\": \"x\"}"), "file.txt");
+
+	ASSERT_EQ(404, response.statusCode());
+	ASSERT_EQ("Not Found", response.statusMessage());
+	ASSERT_EQ("{\"error\": \"x\"}", response.body());
+	ASSERT_EQ("x", response.bodyAsJson()["error"].asString());
+	ASSERT_EQ("file.txt", response.attachedFileName());
+	ASSERT_EQ("file.txt", response.bodyAsFile()->getName());
+	ASSERT_EQ("{\"error\": \"x\"}", response.bodyAsFile()->getContent());
+}
+
+TEST_F(StoredResponseTests,
+CopiesValuesOfGivenResponse) {
+	NiceMock<ResponseMock> original;
+	ON_CALL(original, statusCode())
+		.WillByDefault(Return(200));
+	ON_CALL(original, statusMessage())
+		.WillByDefault(Return("OK"));
+	ON_CALL(original, body())
+		.WillByDefault(Return("content"));
+	ON_CALL(original, attachedFileName())
+		.WillByDefault(Return("file.c"));
+
+	StoredResponse response(original);
+
+	ASSERT_EQ(200, response.statusCode());
+	ASSERT_EQ("OK", response.statusMessage());
+	ASSERT_EQ("content", response.body());
+	ASSERT_EQ("file.c", response.attachedFileName());
+}
+
+TEST_F(StoredResponseTests,
+CopiesShareBody) {
+	StoredResponse response(200, "OK",
+		std::make_shared<const std::string>("content"), "");
+
+	StoredResponse copy(response);
+
+	ASSERT_EQ(response.sharedBody(), copy.sharedBody());
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
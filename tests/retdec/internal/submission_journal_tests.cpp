@@ -0,0 +1,211 @@
+///
+/// @file      retdec/internal/submission_journal_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the persistent journal of started resources.
+///
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/internal/submission_journal.h"
+#include "retdec/internal/utilities/os.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for SubmissionJournal.
+///
+class SubmissionJournalTests: public Test {
+public:
+	SubmissionJournalTests();
+	~SubmissionJournalTests();
+
+	/// Path to a temporary journal file.
+	const std::string journalPath;
+};
+
+///
+/// Sets up a path to a temporary journal file.
+///
+SubmissionJournalTests::SubmissionJournalTests():
+	journalPath(uniqueFilePath(
+		boost::filesystem::temp_directory_path().string())) {}
+
+///
+/// Removes the temporary journal file and its lock file.
+///
+SubmissionJournalTests::~SubmissionJournalTests() {
+	removeFile(journalPath);
+	removeFile(journalPath + ".lock");
+}
+
+TEST_F(SubmissionJournalTests,
+CreatesJournalFileWhenItDoesNotExist) {
+	SubmissionJournal journal(journalPath);
+
+	ASSERT_TRUE(boost::filesystem::exists(journalPath));
+}
+
+TEST_F(SubmissionJournalTests,
+ThrowsFilesystemErrorWhenJournalFileCannotBeOpened) {
+	ASSERT_THROW(
+		SubmissionJournal(joinPaths(journalPath, "journal")),
+		FilesystemError
+	);
+}
+
+TEST_F(SubmissionJournalTests,
+FindReturnsAppendedRecord) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"decompilations", "ID", "key", "bin"});
+
+	auto record = journal.find("decompilations", "ID");
+
+	ASSERT_TRUE(record);
+	ASSERT_EQ("decompilations", record->service);
+	ASSERT_EQ("ID", record->id);
+	ASSERT_EQ("key", record->key);
+	ASSERT_EQ("bin", record->mode);
+}
+
+TEST_F(SubmissionJournalTests,
+FindReturnsNothingWhenRecordIsFromOtherService) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"analyses", "ID", "key", ""});
+
+	ASSERT_FALSE(journal.find("decompilations", "ID"));
+}
+
+TEST_F(SubmissionJournalTests,
+RecordsAreKeptAfterJournalIsReopened) {
+	SubmissionJournal(journalPath).append({"decompilations", "ID", "key", ""});
+
+	SubmissionJournal journal(journalPath);
+
+	ASSERT_TRUE(journal.find("decompilations", "ID"));
+}
+
+TEST_F(SubmissionJournalTests,
+RecordsReturnsRecordsOfServiceInOrderInWhichTheyWereAppended) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"decompilations", "ID1", "key1", ""});
+	journal.append({"analyses", "ID2", "key2", ""});
+	journal.append({"decompilations", "ID3", "key3", ""});
+
+	auto records = journal.records("decompilations");
+
+	ASSERT_EQ(2, records.size());
+	ASSERT_EQ("ID1", records[0].id);
+	ASSERT_EQ("ID3", records[1].id);
+}
+
+TEST_F(SubmissionJournalTests,
+IncompleteRecordWrittenDuringCrashIsSkippedAndDoesNotCorruptNextRecord) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"decompilations", "ID1", "key1", ""});
+	std::ofstream(journalPath, std::ios::app) << "{\"service\": \"decomp";
+
+	journal.append({"decompilations", "ID2", "key2", ""});
+
+	auto records = journal.records("decompilations");
+	ASSERT_EQ(2, records.size());
+	ASSERT_EQ("ID1", records[0].id);
+	ASSERT_EQ("ID2", records[1].id);
+}
+
+TEST_F(SubmissionJournalTests,
+RecordsAppendedByOtherJournalAreFoundAfterJournalIsIndexed) {
+	SubmissionJournal journal(journalPath);
+	SubmissionJournal otherJournal(journalPath);
+	journal.append({"decompilations", "ID1", "key1", ""});
+	ASSERT_TRUE(journal.find("decompilations", "ID1"));
+
+	otherJournal.append({"decompilations", "ID2", "key2", ""});
+
+	ASSERT_TRUE(journal.find("decompilations", "ID2"));
+}
+
+TEST_F(SubmissionJournalTests,
+AppendedRecordIsFoundWithoutJournalFileBeingReadAgain) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"decompilations", "ID1", "key1", ""});
+	ASSERT_TRUE(journal.find("decompilations", "ID1"));
+	journal.append({"decompilations", "ID2", "key2", ""});
+	// Replace the content without changing the version of the file, so the
+	// records cannot be found when the file is read again.
+	auto lastWriteTime = boost::filesystem::last_write_time(journalPath);
+	writeFile(journalPath, std::string(fileSize(journalPath), ' '));
+	boost::filesystem::last_write_time(journalPath, lastWriteTime);
+
+	ASSERT_TRUE(journal.find("decompilations", "ID2"));
+}
+
+TEST_F(SubmissionJournalTests,
+EveryRecordIsWrittenAsSingleLine) {
+	SubmissionJournal journal(journalPath);
+
+	journal.append({"decompilations", "ID", "key", "bin"});
+
+	auto content = readFile(journalPath);
+	ASSERT_EQ('\n', content.back());
+	ASSERT_EQ(content.size() - 1,
+		content.find('\n', content.find_first_not_of('\n')));
+}
+
+TEST_F(SubmissionJournalTests,
+MarkFinishedMarksRecordAsFinished) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"decompilations", "ID1", "key1", ""});
+	journal.append({"decompilations", "ID2", "key2", ""});
+
+	journal.markFinished("decompilations", "ID1");
+
+	auto records = SubmissionJournal(journalPath).records("decompilations");
+	ASSERT_EQ(2, records.size());
+	ASSERT_TRUE(records[0].finished);
+	ASSERT_FALSE(records[1].finished);
+}
+
+TEST_F(SubmissionJournalTests,
+MarkFinishedDoesNothingWhenThereIsNoSuchRecord) {
+	SubmissionJournal journal(journalPath);
+	journal.append({"decompilations", "ID", "key", ""});
+	auto content = readFile(journalPath);
+
+	journal.markFinished("analyses", "ID");
+
+	ASSERT_EQ(content, readFile(journalPath));
+}
+
+TEST_F(SubmissionJournalTests,
+JournalIsCompactedWhenMostRecordsAreOfFinishedResources) {
+	SubmissionJournal journal(journalPath);
+	auto count = SubmissionJournal::MinFinishedRecordsToCompact;
+	for (std::size_t i = 0; i < count; ++i) {
+		journal.append({"decompilations", std::to_string(i), "key", ""});
+	}
+	journal.append({"decompilations", "unfinished", "key", ""});
+	for (std::size_t i = 0; i < count; ++i) {
+		journal.markFinished("decompilations", std::to_string(i));
+	}
+
+	SubmissionJournal reopenedJournal(journalPath);
+	auto records = reopenedJournal.records("decompilations");
+	ASSERT_EQ(1, records.size());
+	ASSERT_EQ("unfinished", records[0].id);
+	ASSERT_FALSE(reopenedJournal.find("decompilations", "0"));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
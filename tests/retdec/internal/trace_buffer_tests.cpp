@@ -0,0 +1,269 @@
+///
+/// @file      retdec/internal/trace_buffer_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the ring buffer of trace events and spans recording
+///            them.
+///
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/internal/resource_status.h"
+#include "retdec/internal/trace_buffer.h"
+#include "retdec/internal/utilities/json.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+namespace {
+
+///
+/// Returns an event with the given name.
+///
+TraceBuffer::Event eventNamed(const std::string &name) {
+	TraceBuffer::Event event;
+	event.name = name;
+	event.start = TraceBuffer::Clock::now();
+	return event;
+}
+
+///
+/// Returns the names of the events in the given buffer.
+///
+std::vector<std::string> eventNames(const TraceBuffer &buffer) {
+	std::vector<std::string> names;
+	for (const auto &event : buffer.events()) {
+		names.push_back(event.name);
+	}
+	return names;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for TraceBuffer.
+///
+class TraceBufferTests: public Test {};
+
+TEST_F(TraceBufferTests,
+IsEmptyByDefault) {
+	TraceBuffer buffer(10);
+
+	ASSERT_TRUE(buffer.events().empty());
+}
+
+TEST_F(TraceBufferTests,
+EventsReturnsRecordedEventsFromOldest) {
+	TraceBuffer buffer(10);
+
+	buffer.record(eventNamed("a"));
+	buffer.record(eventNamed("b"));
+
+	ASSERT_EQ(std::vector<std::string>({"a", "b"}), eventNames(buffer));
+}
+
+TEST_F(TraceBufferTests,
+RecordOverwritesOldestEventsWhenFull) {
+	TraceBuffer buffer(2);
+
+	buffer.record(eventNamed("a"));
+	buffer.record(eventNamed("b"));
+	buffer.record(eventNamed("c"));
+
+	ASSERT_EQ(std::vector<std::string>({"b", "c"}), eventNames(buffer));
+}
+
+TEST_F(TraceBufferTests,
+RecordSpanRecordsSpanOnGivenTrack) {
+	TraceBuffer buffer(10);
+
+	buffer.recordSpan("run", "decompilations 123",
+		TraceBuffer::Clock::now());
+
+	auto events = buffer.events();
+	ASSERT_EQ(1u, events.size());
+	ASSERT_EQ("run", events[0].name);
+	ASSERT_EQ("decompilations 123", events[0].track);
+	ASSERT_FALSE(events[0].instant);
+}
+
+TEST_F(TraceBufferTests,
+RecordInstantRecordsInstantEventWithArguments) {
+	TraceBuffer buffer(10);
+	Json::Value args;
+	args["completion"] = 50;
+
+	buffer.recordInstant("completion", "decompilations 123", args);
+
+	auto events = buffer.events();
+	ASSERT_EQ(1u, events.size());
+	ASSERT_TRUE(events[0].instant);
+	ASSERT_EQ(50, events[0].args["completion"].asInt());
+}
+
+TEST_F(TraceBufferTests,
+EventsRecordedFromManyThreadsAreAllKept) {
+	TraceBuffer buffer(1000);
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([&]() {
+			for (int j = 0; j < 100; ++j) {
+				buffer.recordInstant("event", "");
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	ASSERT_EQ(400u, buffer.events().size());
+}
+
+TEST_F(TraceBufferTests,
+ToChromeTraceJsonReturnsEventsWithNamedTracks) {
+	TraceBuffer buffer(10);
+	buffer.recordSpan("run", "decompilations 123", TraceBuffer::Clock::now());
+	buffer.recordInstant("completion", "decompilations 123");
+
+	auto trace = toJson(buffer.toChromeTraceJson());
+
+	ASSERT_EQ("ms", trace["displayTimeUnit"].asString());
+	auto events = trace["traceEvents"];
+	ASSERT_EQ(3u, events.size());
+	ASSERT_EQ("M", events[0]["ph"].asString());
+	ASSERT_EQ("thread_name", events[0]["name"].asString());
+	ASSERT_EQ("decompilations 123", events[0]["args"]["name"].asString());
+	ASSERT_EQ("X", events[1]["ph"].asString());
+	ASSERT_EQ("run", events[1]["name"].asString());
+	ASSERT_TRUE(events[1].isMember("dur"));
+	ASSERT_EQ(events[0]["tid"], events[1]["tid"]);
+	ASSERT_EQ("i", events[2]["ph"].asString());
+	ASSERT_EQ("completion", events[2]["name"].asString());
+	ASSERT_EQ(events[0]["tid"], events[2]["tid"]);
+}
+
+TEST_F(TraceBufferTests,
+ToChromeTraceJsonShowsEventsWithoutTrackOnTrackOfThread) {
+	TraceBuffer buffer(10);
+	buffer.recordInstant("event", "");
+
+	auto trace = toJson(buffer.toChromeTraceJson());
+
+	ASSERT_EQ("thread " + std::to_string(TraceBuffer::currentThread()),
+		trace["traceEvents"][0]["args"]["name"].asString());
+}
+
+TEST_F(TraceBufferTests,
+ResourceTrackReturnsNameOfResourcesAndId) {
+	ASSERT_EQ("decompilations 123",
+		TraceBuffer::resourceTrack("decompilations", "123"));
+}
+
+///
+/// Tests for ResourceTrace.
+///
+class ResourceTraceTests: public Test {};
+
+TEST_F(ResourceTraceTests,
+StatusReceivedRecordsOnlyChangesInCompletion) {
+	auto buffer = std::make_shared<TraceBuffer>(10);
+	ResourceTrace trace(buffer, "decompilations 123");
+	ResourceStatus status;
+	status.completion = 10;
+
+	trace.statusReceived(status);
+	trace.statusReceived(status);
+	status.completion = 20;
+	trace.statusReceived(status);
+
+	auto events = buffer->events();
+	ASSERT_EQ(2u, events.size());
+	ASSERT_EQ("completion", events[0].name);
+	ASSERT_EQ("decompilations 123", events[0].track);
+	ASSERT_EQ(10, events[0].args["completion"].asInt());
+	ASSERT_EQ(20, events[1].args["completion"].asInt());
+}
+
+TEST_F(ResourceTraceTests,
+StatusReceivedRecordsNothingWhenStatusHasNoCompletion) {
+	auto buffer = std::make_shared<TraceBuffer>(10);
+	ResourceTrace trace(buffer, "analyses 123");
+
+	trace.statusReceived(ResourceStatus());
+
+	ASSERT_TRUE(buffer->events().empty());
+}
+
+///
+/// Tests for TraceSpan.
+///
+class TraceSpanTests: public Test {};
+
+TEST_F(TraceSpanTests,
+RecordsSpanUponDestruction) {
+	auto buffer = std::make_shared<TraceBuffer>(10);
+
+	{
+		TraceSpan span(buffer, "updateStatus", "decompilations 123");
+		ASSERT_TRUE(buffer->events().empty());
+	}
+
+	auto events = buffer->events();
+	ASSERT_EQ(1u, events.size());
+	ASSERT_EQ("updateStatus", events[0].name);
+	ASSERT_EQ("decompilations 123", events[0].track);
+	ASSERT_EQ(TraceBuffer::currentThread(), events[0].thread);
+}
+
+TEST_F(TraceSpanTests,
+SetTrackAndSetArgChangeRecordedSpan) {
+	auto buffer = std::make_shared<TraceBuffer>(10);
+
+	{
+		TraceSpan span(buffer, "run");
+		span.setTrack("decompilations 123");
+		span.setArg("cached", true);
+	}
+
+	auto events = buffer->events();
+	ASSERT_EQ("decompilations 123", events[0].track);
+	ASSERT_TRUE(events[0].args["cached"].asBool());
+}
+
+TEST_F(TraceSpanTests,
+RecordsSpanOnTrackOfResourceWhenCreatedFromResourceTrace) {
+	auto buffer = std::make_shared<TraceBuffer>(10);
+	auto trace = std::make_shared<ResourceTrace>(buffer, "analyses 123");
+
+	{
+		TraceSpan span(trace, "getOutput");
+	}
+
+	ASSERT_EQ("analyses 123", buffer->events()[0].track);
+}
+
+TEST_F(TraceSpanTests,
+DoesNothingWithoutBuffer) {
+	TraceSpan span(std::shared_ptr<TraceBuffer>(), "run");
+	span.setTrack("decompilations 123");
+	span.setArg("cached", true);
+}
+
+TEST_F(TraceSpanTests,
+DoesNothingWithoutResourceTrace) {
+	TraceSpan span(std::shared_ptr<ResourceTrace>(), "run");
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
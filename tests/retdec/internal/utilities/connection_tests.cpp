@@ -5,13 +5,20 @@
 /// @brief     Tests for connection utilities.
 ///
 
+#include <cstddef>
+#include <exception>
 #include <memory>
+#include <string>
+#include <utility>
 
 #include <gtest/gtest.h>
 #include <json/json.h>
 
 #include "retdec/exceptions.h"
+#include "retdec/internal/clock.h"
 #include "retdec/internal/connection_mock.h"
+#include "retdec/internal/connections/simulated_connection.h"
+#include "retdec/internal/simulated_service.h"
 #include "retdec/internal/utilities/connection.h"
 #include "retdec/internal/utilities/json.h"
 
@@ -21,6 +28,27 @@ namespace retdec {
 namespace internal {
 namespace tests {
 
+///
+/// Tests for createQuery().
+///
+class CreateQueryTests: public Test {};
+
+TEST_F(CreateQueryTests,
+ReturnsEmptyStringWhenThereAreNoArguments) {
+	ASSERT_EQ("", createQuery({}));
+}
+
+TEST_F(CreateQueryTests,
+ReturnsQueryWithSingleArgument) {
+	ASSERT_EQ("?mode=bin", createQuery({{"mode", "bin"}}));
+}
+
+TEST_F(CreateQueryTests,
+ReturnsQueryWithArgumentsSeparatedByAmpersandsInGivenOrder) {
+	ASSERT_EQ("?mode=bin&target_language=c",
+		createQuery({{"mode", "bin"}, {"target_language", "c"}}));
+}
+
 ///
 /// Tests for requestSucceeded().
 ///
@@ -178,6 +206,16 @@ GetApiUrlReturnsApiUrlFromWrappedConnection) {
 	ASSERT_EQ("https://retdec.com/service/api", rvconn.getApiUrl());
 }
 
+TEST_F(ResponseVerifyingConnectionTests,
+ClockReturnsClockOfWrappedConnection) {
+	auto service = std::make_shared<SimulatedService>(
+		SimulatedService::Config());
+	ResponseVerifyingConnection rvconn(std::make_shared<SimulatedConnection>(
+		service, "https://retdec.com/service/api"));
+
+	ASSERT_EQ(service->clock(), rvconn.clock());
+}
+
 TEST_F(ResponseVerifyingConnectionTests,
 SendGetRequestWithUrlCallsSendGetRequestOnWrappedConnectionAndReturnsResponseWhenSucceeded) {
 	auto refResponse = new NiceMock<ResponseMock>();
@@ -268,6 +306,89 @@ SendPostRequestCallsSendGetRequestOnWrappedConnectionAndThrowsApiErrorWhenFailed
 	ASSERT_THROW(rvconn.sendPostRequest(url, args, files), ApiError);
 }
 
+TEST_F(ResponseVerifyingConnectionTests,
+SendGetRequestStreamingBodyPassesBodyToHandlerAndReturnsResponseWhenSucceeded) {
+	auto refResponse = new NiceMock<ResponseMock>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	ON_CALL(*refResponse, body())
+		.WillByDefault(Return("body"));
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	Connection::Url url("https://retdec.com/service/api");
+	EXPECT_CALL(*conn, sendGetRequestProxy(url))
+		.WillOnce(Return(refResponse));
+	ResponseVerifyingConnection rvconn(conn);
+
+	std::string body;
+	auto response = rvconn.sendGetRequestStreamingBody(url,
+		[&](const char *data, std::size_t size) { body.append(data, size); });
+
+	ASSERT_EQ(refResponse, response.get());
+	ASSERT_EQ("body", body);
+}
+
+TEST_F(ResponseVerifyingConnectionTests,
+SendGetRequestStreamingBodyDoesNotPassBodyToHandlerAndThrowsApiErrorWhenFailed) {
+	auto response = responseForFailedRequest();
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	Connection::Url url("https://retdec.com/service/api");
+	EXPECT_CALL(*conn, sendGetRequestProxy(url))
+		.WillOnce(Return(response.release()));
+	ResponseVerifyingConnection rvconn(conn);
+
+	bool handlerCalled = false;
+	ASSERT_THROW(
+		rvconn.sendGetRequestStreamingBody(url,
+			[&](const char *, std::size_t) { handlerCalled = true; }),
+		ApiError
+	);
+	ASSERT_FALSE(handlerCalled);
+}
+
+TEST_F(ResponseVerifyingConnectionTests,
+SendGetRequestAsyncPassesResponseToHandlerWhenSucceeded) {
+	auto refResponse = new NiceMock<ResponseMock>();
+	ON_CALL(*refResponse, statusCode())
+		.WillByDefault(Return(200)); // HTTP 200 OK
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	Connection::Url url("https://retdec.com/service/api");
+	EXPECT_CALL(*conn, sendGetRequestProxy(url))
+		.WillOnce(Return(refResponse));
+	ResponseVerifyingConnection rvconn(conn);
+
+	std::unique_ptr<Connection::Response> response;
+	std::exception_ptr error;
+	rvconn.sendGetRequestAsync(url,
+		[&](std::unique_ptr<Connection::Response> r, std::exception_ptr e) {
+			response = std::move(r);
+			error = e;
+		});
+
+	ASSERT_EQ(refResponse, response.get());
+	ASSERT_EQ(nullptr, error);
+}
+
+TEST_F(ResponseVerifyingConnectionTests,
+SendPostRequestAsyncPassesApiErrorToHandlerWhenFailed) {
+	auto response = responseForFailedRequest();
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	Connection::Url url("https://retdec.com/service/api");
+	Connection::RequestArguments args;
+	Connection::RequestFiles files;
+	EXPECT_CALL(*conn, sendPostRequestProxy(url, args, files))
+		.WillOnce(Return(response.release()));
+	ResponseVerifyingConnection rvconn(conn);
+
+	std::exception_ptr error;
+	rvconn.sendPostRequestAsync(url, args, files,
+		[&](std::unique_ptr<Connection::Response> r, std::exception_ptr e) {
+			ASSERT_EQ(nullptr, r);
+			error = e;
+		});
+
+	ASSERT_THROW(std::rethrow_exception(error), ApiError);
+}
+
 } // namespace tests
 } // namespace internal
 } // namespace retdec
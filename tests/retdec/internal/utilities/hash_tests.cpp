@@ -0,0 +1,52 @@
+///
+/// @file      retdec/internal/utilities/hash_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for hashing utilities.
+///
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/utilities/hash.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for sha256().
+///
+class Sha256Tests: public Test {};
+
+TEST_F(Sha256Tests,
+ReturnsCorrectHashOfEmptyString) {
+	ASSERT_EQ(
+		"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+		sha256("")
+	);
+}
+
+TEST_F(Sha256Tests,
+ReturnsCorrectHashOfString) {
+	ASSERT_EQ(
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+		sha256("abc")
+	);
+}
+
+TEST_F(Sha256Tests,
+ReturnsSameHashForStreamAsForStringWithSameContent) {
+	std::string content(100000, 'x');
+	std::istringstream stream(content);
+
+	ASSERT_EQ(sha256(content), sha256(stream));
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
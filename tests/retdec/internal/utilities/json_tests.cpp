@@ -5,6 +5,11 @@
 /// @brief     Tests for string utilities.
 ///
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "retdec/exceptions.h"
@@ -55,6 +60,73 @@ ThrowsJsonDecodingErrorWhenStringIsInvalid) {
 	ASSERT_THROW(toJson("{xxx}"), JsonDecodingError);
 }
 
+TEST_F(ToJsonTests,
+ThrowsJsonDecodingErrorWhenStringIsEmpty) {
+	ASSERT_THROW(toJson(""), JsonDecodingError);
+}
+
+TEST_F(ToJsonTests,
+ThrowsJsonDecodingErrorWhenObjectHasTrailingComma) {
+	ASSERT_THROW(toJson("{\"id\": 1,}"), JsonDecodingError);
+}
+
+TEST_F(ToJsonTests,
+CharactersInGivenRangeAreParsedCorrectly) {
+	const std::string Str("[{\"id\": 1}]");
+
+	auto asJson = toJson(Str.data() + 1, Str.data() + Str.size() - 1);
+
+	ASSERT_EQ(1, asJson.get("id", 0).asInt());
+}
+
+TEST_F(ToJsonTests,
+ParserCanBeReusedAfterInvalidString) {
+	ASSERT_THROW(toJson("{xxx}"), JsonDecodingError);
+
+	auto asJson = toJson("{\"id\": 1}");
+
+	ASSERT_EQ(1, asJson.get("id", 0).asInt());
+}
+
+TEST_F(ToJsonTests,
+StringsAreParsedCorrectlyInManyThreads) {
+	std::vector<std::thread> threads;
+	std::atomic<int> parsed(0);
+	for (int i = 0; i < 4; ++i) {
+		threads.emplace_back([&parsed, i]() {
+			for (int j = 0; j < 100; ++j) {
+				auto value = i * 100 + j;
+				if (toJson("{\"id\": " + std::to_string(value) + "}")
+						.get("id", -1).asInt() == value) {
+					++parsed;
+				}
+			}
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	ASSERT_EQ(400, parsed);
+}
+
+///
+/// Tests for toJsonString().
+///
+class ToJsonStringTests: public Test {};
+
+TEST_F(ToJsonStringTests,
+ObjectIsEncodedOnSingleLine) {
+	Json::Value value;
+	value["id"] = "x\ny";
+	value["count"] = 1;
+
+	auto str = toJsonString(value);
+
+	ASSERT_EQ(std::string::npos, str.find('\n'));
+	ASSERT_EQ(value, toJson(str));
+}
+
 } // namespace tests
 } // namespace internal
 } // namespace retdec
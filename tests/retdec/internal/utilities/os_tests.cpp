@@ -5,6 +5,11 @@
 /// @brief     Tests for operating-system-related utilities.
 ///
 
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+#include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
 
 #include "retdec/exceptions.h"
@@ -18,6 +23,39 @@ namespace retdec {
 namespace internal {
 namespace tests {
 
+namespace {
+
+///
+/// Base class of tests working with files in a temporary directory.
+///
+class TmpDirectoryTests: public Test {
+public:
+	TmpDirectoryTests():
+			dir(uniqueFilePath(
+				boost::filesystem::temp_directory_path().string())) {
+		boost::filesystem::create_directory(dir);
+	}
+
+	~TmpDirectoryTests() {
+		boost::system::error_code ec;
+		boost::filesystem::remove_all(dir, ec);
+	}
+
+	///
+	/// Returns the number of files in the temporary directory.
+	///
+	std::size_t fileCount() const {
+		return static_cast<std::size_t>(std::distance(
+			boost::filesystem::directory_iterator(dir),
+			boost::filesystem::directory_iterator()));
+	}
+
+	/// Path to the temporary directory.
+	const std::string dir;
+};
+
+} // anonymous namespace
+
 ///
 /// Tests for fileNameFromPath().
 ///
@@ -63,10 +101,47 @@ ThrowsFilesystemErrorWhenFileDoesNotExist) {
 	ASSERT_THROW(readFile("nonexisting-file"), FilesystemError);
 }
 
+///
+/// Tests for openFile().
+///
+class OpenFileTests: public Test {};
+
+TEST_F(OpenFileTests,
+ReturnsStreamWithCorrectContentWhenFileExists) {
+	auto tmpFile = TmpFile::createWithContent("content");
+
+	auto stream = openFile(tmpFile->getPath());
+
+	ASSERT_EQ("content", std::string(std::istreambuf_iterator<char>(*stream),
+		std::istreambuf_iterator<char>()));
+}
+
+TEST_F(OpenFileTests,
+ThrowsFilesystemErrorWhenFileDoesNotExist) {
+	ASSERT_THROW(openFile("nonexisting-file"), FilesystemError);
+}
+
+///
+/// Tests for fileSize().
+///
+class FileSizeTests: public Test {};
+
+TEST_F(FileSizeTests,
+ReturnsCorrectSizeWhenFileExists) {
+	auto tmpFile = TmpFile::createWithContent("content");
+
+	ASSERT_EQ(7u, fileSize(tmpFile->getPath()));
+}
+
+TEST_F(FileSizeTests,
+ThrowsFilesystemErrorWhenFileDoesNotExist) {
+	ASSERT_THROW(fileSize("nonexisting-file"), FilesystemError);
+}
+
 ///
 /// Tests for writeFile().
 ///
-class WriteFileTests: public Test {};
+class WriteFileTests: public TmpDirectoryTests {};
 
 TEST_F(WriteFileTests,
 WritesCorrectContentToFile) {
@@ -83,10 +158,121 @@ ThrowsIoErrorWhenFileCannotBeOpenedForWriting) {
 	ASSERT_THROW(writeFile("/", "content"), IoError);
 }
 
+TEST_F(WriteFileTests,
+ReplacesExistingFileWithoutLeavingTemporaryFileBehind) {
+	auto path = joinPaths(dir, "file.txt");
+	writeFile(path, "old content");
+
+	writeFile(path, "content");
+
+	ASSERT_EQ("content", readFile(path));
+	ASSERT_EQ(1u, fileCount());
+}
+
+TEST_F(WriteFileTests,
+WritesFileGivenByPathWithoutDirectory) {
+	auto cwd = boost::filesystem::current_path();
+	boost::filesystem::current_path(dir);
+
+	writeFile("file.txt", "content");
+
+	boost::filesystem::current_path(cwd);
+	ASSERT_EQ("content", readFile(joinPaths(dir, "file.txt")));
+	ASSERT_EQ(1u, fileCount());
+}
+
+TEST_F(WriteFileTests,
+ThrowsFilesystemErrorAndLeavesNoTemporaryFileWhenFileCannotBeReplaced) {
+	auto path = joinPaths(dir, "subdir");
+	boost::filesystem::create_directory(path);
+	writeFile(joinPaths(path, "file.txt"), "content");
+
+	ASSERT_THROW(writeFile(path, "content"), FilesystemError);
+	ASSERT_EQ(1u, fileCount());
+}
+
+#ifndef RETDEC_OS_WINDOWS
+TEST_F(WriteFileTests,
+PreservesPermissionsOfReplacedFile) {
+	auto path = joinPaths(dir, "file.sh");
+	writeFile(path, "old content");
+	boost::filesystem::permissions(path, boost::filesystem::owner_read |
+		boost::filesystem::owner_write | boost::filesystem::owner_exe);
+
+	writeFile(path, "content");
+
+	ASSERT_EQ(boost::filesystem::owner_read | boost::filesystem::owner_write |
+		boost::filesystem::owner_exe,
+		boost::filesystem::status(path).permissions());
+}
+
+TEST_F(WriteFileTests,
+ReplacesTargetOfSymbolicLinkAndKeepsLink) {
+	auto targetPath = joinPaths(dir, "target.txt");
+	auto linkPath = joinPaths(dir, "link.txt");
+	writeFile(targetPath, "old content");
+	boost::filesystem::create_symlink(targetPath, linkPath);
+
+	writeFile(linkPath, "content");
+
+	ASSERT_TRUE(boost::filesystem::is_symlink(linkPath));
+	ASSERT_EQ("content", readFile(targetPath));
+	ASSERT_EQ(2u, fileCount());
+}
+#endif
+
+///
+/// Tests for appendToFile().
+///
+class AppendToFileTests: public TmpDirectoryTests {};
+
+TEST_F(AppendToFileTests,
+CreatesFileWhenItDoesNotExist) {
+	auto path = joinPaths(dir, "file.txt");
+
+	appendToFile(path, "content");
+
+	ASSERT_EQ("content", readFile(path));
+}
+
+TEST_F(AppendToFileTests,
+AppendsContentToEndOfExistingFile) {
+	auto path = joinPaths(dir, "file.txt");
+	writeFile(path, "old ");
+
+	appendToFile(path, "content");
+
+	ASSERT_EQ("old content", readFile(path));
+}
+
+TEST_F(AppendToFileTests,
+ThrowsFilesystemErrorWhenFileCannotBeOpened) {
+	ASSERT_THROW(appendToFile(dir, "content"), FilesystemError);
+}
+
+///
+/// Tests for openFileForWriting().
+///
+class OpenFileForWritingTests: public Test {};
+
+TEST_F(OpenFileForWritingTests,
+ReturnsStreamWritingToFile) {
+	auto tmpFile = TmpFile::createWithContent("old content");
+
+	*openFileForWriting(tmpFile->getPath()) << "content";
+
+	ASSERT_EQ("content", readFile(tmpFile->getPath()));
+}
+
+TEST_F(OpenFileForWritingTests,
+ThrowsFilesystemErrorWhenFileCannotBeOpened) {
+	ASSERT_THROW(openFileForWriting("/"), FilesystemError);
+}
+
 ///
 /// Tests for copyFile().
 ///
-class CopyFileTests: public Test {};
+class CopyFileTests: public TmpDirectoryTests {};
 
 TEST_F(CopyFileTests,
 WritesCorrectContentToFile) {
@@ -99,11 +285,200 @@ WritesCorrectContentToFile) {
 	ASSERT_EQ(Content, readFile(tmpOutFile->getPath()));
 }
 
+TEST_F(CopyFileTests,
+CopiesLargeFileCorrectly) {
+	std::string content;
+	for (std::size_t i = 0; i < 3 * 1024 * 1024; ++i) {
+		content += static_cast<char>(i % 251);
+	}
+	auto srcPath = joinPaths(dir, "src");
+	auto dstPath = joinPaths(dir, "dst");
+	writeFile(srcPath, content);
+
+	copyFile(srcPath, dstPath);
+
+	ASSERT_EQ(content, readFile(dstPath));
+}
+
+TEST_F(CopyFileTests,
+CopiesEmptyFileCorrectly) {
+	auto srcPath = joinPaths(dir, "src");
+	auto dstPath = joinPaths(dir, "dst");
+	writeFile(srcPath, "");
+
+	copyFile(srcPath, dstPath);
+
+	ASSERT_EQ("", readFile(dstPath));
+}
+
+TEST_F(CopyFileTests,
+ReplacesExistingFileWithoutLeavingTemporaryFileBehind) {
+	auto srcPath = joinPaths(dir, "src");
+	auto dstPath = joinPaths(dir, "dst");
+	writeFile(srcPath, "content");
+	writeFile(dstPath, "old content");
+
+	copyFile(srcPath, dstPath);
+
+	ASSERT_EQ("content", readFile(dstPath));
+	ASSERT_EQ(2u, fileCount());
+}
+
+#ifndef RETDEC_OS_WINDOWS
+TEST_F(CopyFileTests,
+PreservesPermissionsOfSourceFile) {
+	auto srcPath = joinPaths(dir, "src");
+	auto dstPath = joinPaths(dir, "dst");
+	writeFile(srcPath, "content");
+	boost::filesystem::permissions(srcPath, boost::filesystem::owner_read |
+		boost::filesystem::owner_write | boost::filesystem::owner_exe);
+
+	copyFile(srcPath, dstPath);
+
+	ASSERT_EQ(boost::filesystem::status(srcPath).permissions(),
+		boost::filesystem::status(dstPath).permissions());
+}
+#endif
+
+TEST_F(CopyFileTests,
+CopiesFileToPathWithoutDirectory) {
+	auto srcPath = joinPaths(dir, "src");
+	writeFile(srcPath, "content");
+	auto cwd = boost::filesystem::current_path();
+	boost::filesystem::current_path(dir);
+
+	copyFile(srcPath, "dst");
+
+	boost::filesystem::current_path(cwd);
+	ASSERT_EQ("content", readFile(joinPaths(dir, "dst")));
+	ASSERT_EQ(2u, fileCount());
+}
+
 TEST_F(CopyFileTests,
 ThrowsFilesystemErrorWhenSourceFileDoesNotExist) {
 	ASSERT_THROW(copyFile("nonexisting-file", "any-file"), FilesystemError);
 }
 
+TEST_F(CopyFileTests,
+ThrowsFilesystemErrorAndLeavesNoTemporaryFileWhenFileCannotBeReplaced) {
+	auto srcPath = joinPaths(dir, "src");
+	auto dstPath = joinPaths(dir, "subdir");
+	writeFile(srcPath, "content");
+	boost::filesystem::create_directory(dstPath);
+	writeFile(joinPaths(dstPath, "file.txt"), "content");
+
+	ASSERT_THROW(copyFile(srcPath, dstPath), FilesystemError);
+	ASSERT_EQ(2u, fileCount());
+}
+
+///
+/// Tests for copyFileBy().
+///
+class CopyFileByTests: public TmpDirectoryTests {};
+
+TEST_F(CopyFileByTests,
+PortableMethodCopiesFile) {
+	auto srcPath = joinPaths(dir, "src");
+	auto dstPath = joinPaths(dir, "dst");
+	writeFile(srcPath, "content");
+
+	ASSERT_TRUE(copyFileBy(FileCopyMethod::Portable, srcPath, dstPath));
+	ASSERT_EQ("content", readFile(dstPath));
+}
+
+TEST_F(CopyFileByTests,
+EveryMethodEitherCopiesFileOrReportsThatItIsNotSupported) {
+	std::string content(3 * 1024 * 1024, 'x');
+	auto srcPath = joinPaths(dir, "src");
+	writeFile(srcPath, content);
+
+	for (auto method : {FileCopyMethod::Clone, FileCopyMethod::CopyFileRange,
+			FileCopyMethod::Sendfile, FileCopyMethod::Portable}) {
+		auto dstPath = joinPaths(dir, "dst");
+		if (copyFileBy(method, srcPath, dstPath)) {
+			ASSERT_EQ(content, readFile(dstPath));
+		}
+		removeFile(dstPath);
+	}
+}
+
+TEST_F(CopyFileByTests,
+ThrowsFilesystemErrorWhenSourceFileDoesNotExist) {
+	ASSERT_THROW(
+		copyFileBy(FileCopyMethod::Portable, "nonexisting-file", "any-file"),
+		FilesystemError
+	);
+}
+
+///
+/// Tests for renameFile().
+///
+class RenameFileTests: public Test {};
+
+TEST_F(RenameFileTests,
+MovesFileToNewPath) {
+	const std::string NewPath("retdec-cpp-rename-file-test.txt");
+	writeFile(NewPath + ".orig", "content");
+
+	renameFile(NewPath + ".orig", NewPath);
+
+	RemoveFileOnDestruction remover(NewPath);
+	ASSERT_EQ("content", readFile(NewPath));
+	ASSERT_THROW(readFile(NewPath + ".orig"), FilesystemError);
+}
+
+TEST_F(RenameFileTests,
+ThrowsFilesystemErrorWhenSourceFileDoesNotExist) {
+	ASSERT_THROW(renameFile("nonexisting-file", "any-file"), FilesystemError);
+}
+
+///
+/// Tests for removeFile().
+///
+class RemoveFileTests: public Test {};
+
+TEST_F(RemoveFileTests,
+RemovesExistingFile) {
+	const std::string Path("retdec-cpp-remove-file-test.txt");
+	writeFile(Path, "content");
+
+	removeFile(Path);
+
+	ASSERT_THROW(readFile(Path), FilesystemError);
+}
+
+TEST_F(RemoveFileTests,
+DoesNothingWhenFileDoesNotExist) {
+	removeFile("nonexisting-file");
+}
+
+///
+/// Tests for uniqueFilePath().
+///
+class UniqueFilePathTests: public Test {};
+
+TEST_F(UniqueFilePathTests,
+ReturnsPathInGivenDirectory) {
+	auto path = uniqueFilePath("dir");
+
+	ASSERT_EQ(0u, path.find(joinPaths("dir", "")));
+}
+
+TEST_F(UniqueFilePathTests,
+ReturnsDifferentPathsOnSubsequentCalls) {
+	ASSERT_NE(uniqueFilePath("."), uniqueFilePath("."));
+}
+
+///
+/// Tests for processorCount().
+///
+class ProcessorCountTests: public Test {};
+
+TEST_F(ProcessorCountTests,
+ReturnsAtLeastOne) {
+	ASSERT_GE(processorCount(), 1u);
+}
+
 } // namespace tests
 } // namespace internal
 } // namespace retdec
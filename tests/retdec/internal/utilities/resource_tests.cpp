@@ -0,0 +1,85 @@
+///
+/// @file      retdec/internal/utilities/resource_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the utilities for resources.
+///
+
+#include <gtest/gtest.h>
+
+#include "retdec/file.h"
+#include "retdec/internal/utilities/resource.h"
+#include "retdec/resource_arguments.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace internal {
+namespace tests {
+
+///
+/// Tests for resourceKey().
+///
+class ResourceKeyTests: public Test {
+public:
+	ResourceArguments argsWithFile(const std::string &content) const;
+
+	/// URL to resources.
+	const std::string resourcesUrl =
+		"https://retdec.com/service/api/decompiler/decompilations";
+};
+
+///
+/// Returns arguments with a file of the given content.
+///
+ResourceArguments ResourceKeyTests::argsWithFile(
+		const std::string &content) const {
+	return ResourceArguments()
+		.withArgument("mode", "bin")
+		.withFile("input", File::fromContentWithName(content, "file.exe"));
+}
+
+TEST_F(ResourceKeyTests,
+KeyIsSameForSameArguments) {
+	ASSERT_EQ(
+		resourceKey(resourcesUrl, argsWithFile("content")),
+		resourceKey(resourcesUrl, argsWithFile("content"))
+	);
+}
+
+TEST_F(ResourceKeyTests,
+KeyDiffersForDifferentContentsOfFiles) {
+	ASSERT_NE(
+		resourceKey(resourcesUrl, argsWithFile("content1")),
+		resourceKey(resourcesUrl, argsWithFile("content2"))
+	);
+}
+
+TEST_F(ResourceKeyTests,
+KeyDiffersForDifferentArguments) {
+	ASSERT_NE(
+		resourceKey(resourcesUrl, argsWithFile("content")),
+		resourceKey(resourcesUrl,
+			argsWithFile("content").withArgument("mode", "c"))
+	);
+}
+
+TEST_F(ResourceKeyTests,
+KeyDiffersForDifferentResourcesUrls) {
+	ASSERT_NE(
+		resourceKey(resourcesUrl, argsWithFile("content")),
+		resourceKey(resourcesUrl + "2", argsWithFile("content"))
+	);
+}
+
+TEST_F(ResourceKeyTests,
+KeyDiffersWhenArgumentsDifferOnlyInSplittingOfValues) {
+	ASSERT_NE(
+		resourceKey(resourcesUrl, ResourceArguments().withArgument("a", "bc")),
+		resourceKey(resourcesUrl, ResourceArguments().withArgument("ab", "c"))
+	);
+}
+
+} // namespace tests
+} // namespace internal
+} // namespace retdec
@@ -0,0 +1,51 @@
+///
+/// @file      retdec/metrics_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the metrics of requests sent to the API and of
+///            resources.
+///
+
+#include <chrono>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/metrics_registry.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/metrics.h"
+#include "retdec/test_utilities/tmp_file.h"
+
+using namespace testing;
+using namespace retdec::internal;
+
+namespace retdec {
+namespace tests {
+
+///
+/// Tests for Metrics.
+///
+class MetricsTests: public Test {};
+
+TEST_F(MetricsTests,
+ToPrometheusTextReturnsMetricsFromRegistry) {
+	Metrics metrics;
+	metrics.registry()->statusPolled(MetricsRegistry::Service::Decompiler);
+
+	ASSERT_EQ(metrics.registry()->toPrometheusText(),
+		metrics.toPrometheusText());
+}
+
+TEST_F(MetricsTests,
+WritePrometheusTextWritesMetricsIntoFile) {
+	Metrics metrics;
+	metrics.registry()->statusPolled(MetricsRegistry::Service::Decompiler);
+	auto tmpFile = TmpFile::createWithContent("");
+
+	metrics.writePrometheusText(tmpFile->getPath());
+
+	ASSERT_EQ(metrics.toPrometheusText(), readFile(tmpFile->getPath()));
+}
+
+} // namespace tests
+} // namespace retdec
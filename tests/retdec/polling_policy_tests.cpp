@@ -0,0 +1,91 @@
+///
+/// @file      retdec/polling_policy_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the polling policies.
+///
+
+#include <chrono>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "retdec/exceptions.h"
+#include "retdec/polling_policy.h"
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace retdec {
+namespace tests {
+
+namespace {
+
+///
+/// Returns a progress after the first status update.
+///
+PollingPolicy::Progress firstProgress() {
+	PollingPolicy::Progress progress;
+	progress.elapsedTime = 0ms;
+	progress.lastDelay = 0ms;
+	progress.completionDelta = 0;
+	progress.statusUpdateCount = 1;
+	progress.completion = 0;
+	return progress;
+}
+
+} // anonymous namespace
+
+///
+/// Tests for PollingPolicy.
+///
+class PollingPolicyTests: public Test {};
+
+TEST_F(PollingPolicyTests,
+FixedReturnsPolicyWithGivenDelay) {
+	auto policy = PollingPolicy::fixed(300ms);
+
+	ASSERT_EQ(300ms, policy->nextDelay(firstProgress()));
+}
+
+TEST_F(PollingPolicyTests,
+ExponentialReturnsPolicyStartingWithInitialDelay) {
+	auto policy = PollingPolicy::exponential(100ms, 1000ms);
+
+	ASSERT_EQ(100ms, policy->nextDelay(firstProgress()));
+}
+
+TEST_F(PollingPolicyTests,
+ExponentialThrowsErrorWhenInitialDelayIsNotPositive) {
+	ASSERT_THROW(PollingPolicy::exponential(0ms, 1000ms), Error);
+	ASSERT_THROW(PollingPolicy::exponential(-1ms, 1000ms), Error);
+}
+
+TEST_F(PollingPolicyTests,
+ExponentialThrowsErrorWhenFactorIsNotGreaterThanOne) {
+	ASSERT_THROW(PollingPolicy::exponential(100ms, 1000ms, 1.0), Error);
+	ASSERT_THROW(PollingPolicy::exponential(100ms, 1000ms, 0.5), Error);
+	ASSERT_THROW(PollingPolicy::exponential(100ms, 1000ms, std::nan("")),
+		Error);
+}
+
+TEST_F(PollingPolicyTests,
+DecorrelatedJitterReturnsPolicyWithDelaysWithinBounds) {
+	auto policy = PollingPolicy::decorrelatedJitter(100ms, 200ms);
+
+	auto delay = policy->nextDelay(firstProgress());
+
+	ASSERT_GE(delay, 100ms);
+	ASSERT_LE(delay, 200ms);
+}
+
+TEST_F(PollingPolicyTests,
+DeadlineAwareReturnsPolicyShorteningDelaysToDeadline) {
+	auto policy = PollingPolicy::deadlineAware(
+		PollingPolicy::fixed(500ms), 200ms);
+
+	ASSERT_EQ(200ms, policy->nextDelay(firstProgress()));
+}
+
+} // namespace tests
+} // namespace retdec
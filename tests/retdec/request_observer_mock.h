@@ -0,0 +1,32 @@
+///
+/// @file      retdec/request_observer_mock.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Mock for RequestObserver.
+///
+
+#ifndef RETDEC_REQUEST_OBSERVER_MOCK_H
+#define RETDEC_REQUEST_OBSERVER_MOCK_H
+
+#include <gmock/gmock.h>
+
+#include "retdec/request_observer.h"
+
+namespace retdec {
+namespace tests {
+
+///
+/// Mock for RequestObserver.
+///
+class RequestObserverMock: public RequestObserver {
+public:
+	RequestObserverMock() = default;
+	virtual ~RequestObserverMock() override = default;
+
+	MOCK_METHOD1(requestFinished, void (const Request &));
+};
+
+} // namespace tests
+} // namespace retdec
+
+#endif
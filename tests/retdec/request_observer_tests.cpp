@@ -0,0 +1,52 @@
+///
+/// @file      retdec/request_observer_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the base class of observers of requests sent to the
+///            API.
+///
+
+#include <gtest/gtest.h>
+
+#include "retdec/request_observer.h"
+
+using namespace testing;
+
+namespace retdec {
+namespace tests {
+
+///
+/// Tests for RequestObserver::Request.
+///
+class RequestObserverRequestTests: public Test {};
+
+TEST_F(RequestObserverRequestTests,
+PhasesHaveNoTimeByDefault) {
+	RequestObserver::Request request;
+
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.started));
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.resolved));
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.connected));
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.tlsHandshakeDone));
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.requestWritten));
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.firstByteReceived));
+	ASSERT_FALSE(RequestObserver::Request::hasTime(request.finished));
+}
+
+TEST_F(RequestObserverRequestTests,
+HasTimeReturnsTrueForMeasuredPhase) {
+	ASSERT_TRUE(RequestObserver::Request::hasTime(
+		RequestObserver::Clock::now()));
+}
+
+TEST_F(RequestObserverRequestTests,
+CountsAndStatusCodeAreZeroByDefault) {
+	RequestObserver::Request request;
+
+	ASSERT_EQ(0u, request.bytesSent);
+	ASSERT_EQ(0u, request.bytesReceived);
+	ASSERT_EQ(0, request.statusCode);
+}
+
+} // namespace tests
+} // namespace retdec
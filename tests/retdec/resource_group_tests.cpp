@@ -0,0 +1,172 @@
+///
+/// @file      retdec/resource_group_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the group of resources.
+///
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <json/json.h>
+
+#include "retdec/decompilation.h"
+#include "retdec/exceptions.h"
+#include "retdec/internal/connection_mock.h"
+#include "retdec/internal/io_service.h"
+#include "retdec/internal/resource_context.h"
+#include "retdec/internal/utilities/json.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/polling_policy.h"
+#include "retdec/resource_group.h"
+
+using namespace testing;
+using namespace retdec::internal;
+using namespace retdec::internal::tests;
+
+namespace retdec {
+namespace tests {
+
+///
+/// Tests for ResourceGroup.
+///
+class ResourceGroupTests: public Test {
+protected:
+	std::shared_ptr<ConnectionMock> connReturningStatus(
+		const std::string &status);
+};
+
+///
+/// Returns a connection that returns the given status whenever it is asked
+/// for it.
+///
+std::shared_ptr<ConnectionMock> ResourceGroupTests::connReturningStatus(
+		const std::string &status) {
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	ON_CALL(*conn, sendGetRequestProxy(_))
+		.WillByDefault(InvokeWithoutArgs([status]() {
+			auto response = new NiceMock<ResponseMock>();
+			ON_CALL(*response, statusCode())
+				.WillByDefault(Return(200)); // HTTP 200 OK
+			ON_CALL(*response, bodyAsJson())
+				.WillByDefault(Return(toJson(status)));
+			return response;
+		}));
+	return conn;
+}
+
+TEST_F(ResourceGroupTests,
+GroupIsEmptyAfterCreation) {
+	ResourceGroup group;
+
+	ASSERT_TRUE(group.empty());
+	ASSERT_EQ(0u, group.size());
+}
+
+TEST_F(ResourceGroupTests,
+SizeReturnsNumberOfAddedResources) {
+	auto conn = connReturningStatus("{\"finished\": true}");
+	Decompilation decompilation1("1", conn);
+	Decompilation decompilation2("2", conn);
+	ResourceGroup group;
+
+	group.add(decompilation1);
+	group.add(decompilation2);
+
+	ASSERT_FALSE(group.empty());
+	ASSERT_EQ(2u, group.size());
+}
+
+TEST_F(ResourceGroupTests,
+WaitAllWaitsUntilAllResourcesFinish) {
+	auto conn = connReturningStatus("{\"finished\": true}");
+	Decompilation decompilation1("1", conn);
+	Decompilation decompilation2("2", conn);
+	ResourceGroup group;
+	group.add(decompilation1);
+	group.add(decompilation2);
+
+	group.waitAll();
+
+	ASSERT_TRUE(decompilation1.hasFinished());
+	ASSERT_TRUE(decompilation2.hasFinished());
+	ASSERT_EQ(2u, group.size());
+}
+
+TEST_F(ResourceGroupTests,
+WaitAnyReturnsFinishedResourceAndRemovesItFromGroup) {
+	auto conn = connReturningStatus("{\"finished\": true}");
+	Decompilation decompilation("1", conn);
+	ResourceGroup group;
+	group.add(decompilation);
+
+	auto &resource = group.waitAny();
+
+	ASSERT_EQ(&decompilation, &resource);
+	ASSERT_TRUE(resource.hasFinished());
+	ASSERT_TRUE(group.empty());
+}
+
+TEST_F(ResourceGroupTests,
+WaitAnyThrowsErrorWhenGroupIsEmpty) {
+	ResourceGroup group;
+
+	ASSERT_THROW(group.waitAny(), Error);
+}
+
+TEST_F(ResourceGroupTests,
+WaitAllThrowsErrorWhenCalledFromIoThreadBeforeResourcesFinish) {
+	auto conn = connReturningStatus("{\"finished\": false}");
+	auto ioService = std::make_shared<IoService>(1);
+	ResourceContext context;
+	context.ioService = ioService;
+	context.pollingPolicy = PollingPolicy::fixed(std::chrono::milliseconds(1));
+	std::promise<void> waited;
+	auto waitedFuture = waited.get_future();
+	{
+		Decompilation decompilation("1", conn, context);
+		ResourceGroup group;
+		group.add(decompilation);
+
+		ioService->asioService()->post([&]() {
+			try {
+				group.waitAll();
+				waited.set_value();
+			} catch (...) {
+				waited.set_exception(std::current_exception());
+			}
+		});
+		waitedFuture.wait();
+	}
+
+	// The stopped polling releases the connection when it is due.
+	for (int i = 0; i < 100 && conn.use_count() > 1; ++i) {
+		sleep(10);
+	}
+	ASSERT_THROW(waitedFuture.get(), Error);
+}
+
+TEST_F(ResourceGroupTests,
+WaitAllThrowsErrorWhenStatusOfResourceCannotBeObtained) {
+	auto conn = std::make_shared<NiceMock<ConnectionMock>>();
+	ON_CALL(*conn, getApiUrl())
+		.WillByDefault(Return("https://retdec.com/service/api"));
+	ON_CALL(*conn, sendGetRequestProxy(_))
+		.WillByDefault(Throw(ConnectionError("connection refused")));
+	ResourceContext context;
+	context.pollingPolicy = PollingPolicy::fixed(std::chrono::milliseconds(1));
+	Decompilation decompilation("1", conn, context);
+	ResourceGroup group;
+	group.add(decompilation);
+
+	ASSERT_THROW(group.waitAll(), ConnectionError);
+}
+
+} // namespace tests
+} // namespace retdec
@@ -5,10 +5,17 @@
 /// @brief     Tests for the settings.
 ///
 
+#include <chrono>
+#include <memory>
+
 #include <gtest/gtest.h>
 
 #include "retdec/internal/utilities/os.h"
+#include "retdec/metrics.h"
+#include "retdec/polling_policy.h"
+#include "retdec/request_observer_mock.h"
 #include "retdec/settings.h"
+#include "retdec/tracer.h"
 
 using namespace testing;
 using namespace retdec::internal;
@@ -36,6 +43,22 @@ DefaultUserAgentHasCorrectValue) {
 	ASSERT_EQ("retdec-cpp/" + operatingSystemName(), Settings::DefaultUserAgent);
 }
 
+TEST_F(SettingsTests,
+DefaultConnectionPoolSizeIsPositive) {
+	ASSERT_GT(Settings::DefaultConnectionPoolSize, 0u);
+}
+
+TEST_F(SettingsTests,
+DefaultMaxConnectionCountIsGreaterThanDefaultConnectionPoolSize) {
+	ASSERT_GT(Settings::DefaultMaxConnectionCount,
+		Settings::DefaultConnectionPoolSize);
+}
+
+TEST_F(SettingsTests,
+DefaultIoThreadCountHasCorrectValue) {
+	ASSERT_EQ(processorCount(), Settings::DefaultIoThreadCount);
+}
+
 TEST_F(SettingsTests,
 HasDefaultValuesWhenCreatedWithDefaultConstructor) {
 	Settings settings;
@@ -43,6 +66,18 @@ HasDefaultValuesWhenCreatedWithDefaultConstructor) {
 	ASSERT_EQ(Settings::DefaultApiKey, settings.apiKey());
 	ASSERT_EQ(Settings::DefaultApiUrl, settings.apiUrl());
 	ASSERT_EQ(Settings::DefaultUserAgent, settings.userAgent());
+	ASSERT_EQ(Settings::DefaultConnectionPoolSize, settings.connectionPoolSize());
+	ASSERT_EQ(Settings::DefaultMaxConnectionCount, settings.maxConnectionCount());
+	ASSERT_EQ(Settings::DefaultConnectionIdleTimeout, settings.connectionIdleTimeout());
+	ASSERT_EQ(Settings::DefaultIoThreadCount, settings.ioThreadCount());
+	ASSERT_EQ(Settings::DefaultPollingPolicy, settings.pollingPolicy());
+	ASSERT_EQ(Settings::DefaultResultCacheDirectory, settings.resultCacheDirectory());
+	ASSERT_EQ(Settings::DefaultResultCacheMaxSize, settings.resultCacheMaxSize());
+	ASSERT_EQ(Settings::DefaultDeduplicateRuns, settings.deduplicateRuns());
+	ASSERT_EQ(Settings::DefaultJournalPath, settings.journalPath());
+	ASSERT_EQ(Settings::DefaultRequestObserver, settings.requestObserver());
+	ASSERT_EQ(Settings::DefaultMetrics, settings.metrics());
+	ASSERT_EQ(Settings::DefaultTracer, settings.tracer());
 }
 
 TEST_F(SettingsTests,
@@ -99,6 +134,247 @@ WithUserAgentReturnsSettingsWithNewUserAgent) {
 	ASSERT_EQ("my user agent", newSettings.userAgent());
 }
 
+TEST_F(SettingsTests,
+ConnectionPoolSizeChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.connectionPoolSize(16);
+
+	ASSERT_EQ(16u, settings.connectionPoolSize());
+}
+
+TEST_F(SettingsTests,
+WithConnectionPoolSizeReturnsSettingsWithNewConnectionPoolSize) {
+	Settings settings;
+
+	auto newSettings = settings.withConnectionPoolSize(16);
+
+	ASSERT_EQ(16u, newSettings.connectionPoolSize());
+}
+
+TEST_F(SettingsTests,
+MaxConnectionCountChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.maxConnectionCount(64);
+
+	ASSERT_EQ(64u, settings.maxConnectionCount());
+}
+
+TEST_F(SettingsTests,
+WithMaxConnectionCountReturnsSettingsWithNewMaxConnectionCount) {
+	Settings settings;
+
+	auto newSettings = settings.withMaxConnectionCount(64);
+
+	ASSERT_EQ(64u, newSettings.maxConnectionCount());
+}
+
+TEST_F(SettingsTests,
+ConnectionIdleTimeoutChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.connectionIdleTimeout(3000);
+
+	ASSERT_EQ(3000, settings.connectionIdleTimeout());
+}
+
+TEST_F(SettingsTests,
+WithConnectionIdleTimeoutReturnsSettingsWithNewConnectionIdleTimeout) {
+	Settings settings;
+
+	auto newSettings = settings.withConnectionIdleTimeout(3000);
+
+	ASSERT_EQ(3000, newSettings.connectionIdleTimeout());
+}
+
+TEST_F(SettingsTests,
+IoThreadCountChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.ioThreadCount(2);
+
+	ASSERT_EQ(2u, settings.ioThreadCount());
+}
+
+TEST_F(SettingsTests,
+WithIoThreadCountReturnsSettingsWithNewIoThreadCount) {
+	Settings settings;
+
+	auto newSettings = settings.withIoThreadCount(2);
+
+	ASSERT_EQ(2u, newSettings.ioThreadCount());
+}
+
+TEST_F(SettingsTests,
+PollingPolicyChangesSettingsInPlace) {
+	Settings settings;
+	std::shared_ptr<const PollingPolicy> pollingPolicy =
+		PollingPolicy::fixed(std::chrono::milliseconds(100));
+
+	settings.pollingPolicy(pollingPolicy);
+
+	ASSERT_EQ(pollingPolicy, settings.pollingPolicy());
+}
+
+TEST_F(SettingsTests,
+WithPollingPolicyReturnsSettingsWithNewPollingPolicy) {
+	Settings settings;
+	std::shared_ptr<const PollingPolicy> pollingPolicy =
+		PollingPolicy::fixed(std::chrono::milliseconds(100));
+
+	auto newSettings = settings.withPollingPolicy(pollingPolicy);
+
+	ASSERT_EQ(pollingPolicy, newSettings.pollingPolicy());
+}
+
+TEST_F(SettingsTests,
+ResultCacheDirectoryChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.resultCacheDirectory("/tmp/cache");
+
+	ASSERT_EQ("/tmp/cache", settings.resultCacheDirectory());
+}
+
+TEST_F(SettingsTests,
+WithResultCacheDirectoryReturnsSettingsWithNewResultCacheDirectory) {
+	Settings settings;
+
+	auto newSettings = settings.withResultCacheDirectory("/tmp/cache");
+
+	ASSERT_EQ("/tmp/cache", newSettings.resultCacheDirectory());
+}
+
+TEST_F(SettingsTests,
+ResultCacheMaxSizeChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.resultCacheMaxSize(1024);
+
+	ASSERT_EQ(1024u, settings.resultCacheMaxSize());
+}
+
+TEST_F(SettingsTests,
+WithResultCacheMaxSizeReturnsSettingsWithNewResultCacheMaxSize) {
+	Settings settings;
+
+	auto newSettings = settings.withResultCacheMaxSize(1024);
+
+	ASSERT_EQ(1024u, newSettings.resultCacheMaxSize());
+}
+
+TEST_F(SettingsTests,
+DeduplicateRunsChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.deduplicateRuns(true);
+
+	ASSERT_TRUE(settings.deduplicateRuns());
+}
+
+TEST_F(SettingsTests,
+WithDeduplicateRunsReturnsSettingsWithNewDeduplicateRuns) {
+	Settings settings;
+
+	auto newSettings = settings.withDeduplicateRuns(true);
+
+	ASSERT_TRUE(newSettings.deduplicateRuns());
+}
+
+TEST_F(SettingsTests,
+JournalPathChangesSettingsInPlace) {
+	Settings settings;
+
+	settings.journalPath("/tmp/journal");
+
+	ASSERT_EQ("/tmp/journal", settings.journalPath());
+}
+
+TEST_F(SettingsTests,
+WithJournalPathReturnsSettingsWithNewJournalPath) {
+	Settings settings;
+
+	auto newSettings = settings.withJournalPath("/tmp/journal");
+
+	ASSERT_EQ("/tmp/journal", newSettings.journalPath());
+}
+
+TEST_F(SettingsTests,
+DefaultRequestObserverIsNull) {
+	ASSERT_EQ(nullptr, Settings::DefaultRequestObserver);
+}
+
+TEST_F(SettingsTests,
+RequestObserverChangesSettingsInPlace) {
+	Settings settings;
+	auto requestObserver = std::make_shared<RequestObserverMock>();
+
+	settings.requestObserver(requestObserver);
+
+	ASSERT_EQ(requestObserver, settings.requestObserver());
+}
+
+TEST_F(SettingsTests,
+WithRequestObserverReturnsSettingsWithNewRequestObserver) {
+	Settings settings;
+	auto requestObserver = std::make_shared<RequestObserverMock>();
+
+	auto newSettings = settings.withRequestObserver(requestObserver);
+
+	ASSERT_EQ(requestObserver, newSettings.requestObserver());
+}
+
+TEST_F(SettingsTests,
+DefaultMetricsAreNull) {
+	ASSERT_EQ(nullptr, Settings::DefaultMetrics);
+}
+
+TEST_F(SettingsTests,
+MetricsChangesSettingsInPlace) {
+	Settings settings;
+	auto metrics = std::make_shared<Metrics>();
+
+	settings.metrics(metrics);
+
+	ASSERT_EQ(metrics, settings.metrics());
+}
+
+TEST_F(SettingsTests,
+WithMetricsReturnsSettingsWithNewMetrics) {
+	Settings settings;
+	auto metrics = std::make_shared<Metrics>();
+
+	auto newSettings = settings.withMetrics(metrics);
+
+	ASSERT_EQ(metrics, newSettings.metrics());
+}
+
+TEST_F(SettingsTests,
+DefaultTracerIsNull) {
+	ASSERT_EQ(nullptr, Settings::DefaultTracer);
+}
+
+TEST_F(SettingsTests,
+TracerChangesSettingsInPlace) {
+	Settings settings;
+	auto tracer = std::make_shared<Tracer>();
+
+	settings.tracer(tracer);
+
+	ASSERT_EQ(tracer, settings.tracer());
+}
+
+TEST_F(SettingsTests,
+WithTracerReturnsSettingsWithNewTracer) {
+	Settings settings;
+	auto tracer = std::make_shared<Tracer>();
+
+	auto newSettings = settings.withTracer(tracer);
+
+	ASSERT_EQ(tracer, newSettings.tracer());
+}
+
 TEST_F(SettingsTests,
 NotModifyingSettersAllowChaining) {
 	auto settings = Settings()
@@ -0,0 +1,325 @@
+///
+/// @file      retdec/test_utilities/http_server.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Implementation of the local HTTP server for tests.
+///
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <sys/socket.h>
+
+#include "retdec/test_utilities/http_server.h"
+
+using boost::asio::ip::tcp;
+
+namespace retdec {
+namespace tests {
+
+namespace {
+
+///
+/// Returns @a str with all letters converted to lower case.
+///
+std::string toLower(std::string str) {
+	std::transform(str.begin(), str.end(), str.begin(),
+		[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return str;
+}
+
+///
+/// Returns @a str without the trailing carriage return (if any).
+///
+std::string withoutCr(std::string str) {
+	if (!str.empty() && str.back() == '\r') {
+		str.pop_back();
+	}
+	return str;
+}
+
+///
+/// Reads a request from the given socket.
+///
+/// @returns @c false when the connection has been closed.
+///
+bool readRequest(tcp::socket &socket, boost::asio::streambuf &buffer,
+		HttpServer::Request &request) {
+	boost::system::error_code ec;
+	boost::asio::read_until(socket, buffer, "\r\n\r\n", ec);
+	if (ec) {
+		return false;
+	}
+
+	std::istream stream(&buffer);
+	std::string line;
+	std::getline(stream, line);
+	std::istringstream requestLine(withoutCr(line));
+	requestLine >> request.method >> request.target;
+	while (std::getline(stream, line) && !withoutCr(line).empty()) {
+		line = withoutCr(line);
+		auto colonPos = line.find(':');
+		request.headers.emplace_back(line.substr(0, colonPos),
+			line.substr(line.find_first_not_of(' ', colonPos + 1)));
+	}
+
+	auto contentLength = request.header("Content-Length");
+	auto bodySize = contentLength.empty() ? 0 : std::stoul(contentLength);
+	if (buffer.size() < bodySize) {
+		boost::asio::read(socket, buffer,
+			boost::asio::transfer_exactly(bodySize - buffer.size()), ec);
+		if (ec) {
+			return false;
+		}
+	}
+	request.body.resize(bodySize);
+	stream.read(&request.body[0], static_cast<std::streamsize>(bodySize));
+	return true;
+}
+
+///
+/// Writes all the given data into the given socket.
+///
+/// @returns @c false when the data could not be written.
+///
+bool writeAll(tcp::socket &socket, const std::string &data) {
+	std::size_t written = 0;
+	while (written < data.size()) {
+		boost::system::error_code ec;
+		written += socket.write_some(boost::asio::buffer(
+			data.data() + written, data.size() - written), ec);
+		if (ec) {
+			return false;
+		}
+	}
+	return true;
+}
+
+///
+/// Returns the given response in its wire format.
+///
+std::string formatResponse(const HttpServer::Response &response) {
+	std::ostringstream formatted;
+	formatted << "HTTP/1.1 " << response.code << " " << response.reason <<
+		"\r\n";
+	for (const auto &header : response.headers) {
+		formatted << header.first << ": " << header.second << "\r\n";
+	}
+	if (response.closeConnection) {
+		formatted << "Connection: close\r\n";
+	}
+	switch (response.bodyEnd) {
+		case HttpServer::BodyEnd::ContentLength:
+			formatted << "Content-Length: " << response.body.size() <<
+				"\r\n\r\n" << response.body;
+			break;
+
+		case HttpServer::BodyEnd::Chunked: {
+			formatted << "Transfer-Encoding: chunked\r\n\r\n";
+			// Split the body into two chunks.
+			auto half = response.body.size() / 2;
+			for (const auto &chunk : {response.body.substr(0, half),
+					response.body.substr(half)}) {
+				if (!chunk.empty()) {
+					formatted << std::hex << chunk.size() << std::dec <<
+						"\r\n" << chunk << "\r\n";
+				}
+			}
+			formatted << "0\r\n\r\n";
+			break;
+		}
+
+		case HttpServer::BodyEnd::ClosedConnection:
+		default:
+			formatted << "\r\n" << response.body;
+			break;
+	}
+	return formatted.str();
+}
+
+} // anonymous namespace
+
+///
+/// Returns the value of the first header with the given name (ignoring case).
+///
+std::string HttpServer::Request::header(const std::string &name) const {
+	for (const auto &header : headers) {
+		if (toLower(header.first) == toLower(name)) {
+			return header.second;
+		}
+	}
+	return "";
+}
+
+///
+/// Private implementation of HttpServer.
+///
+struct HttpServer::Impl {
+	Impl(const Handler &handler);
+	~Impl();
+
+	void acceptConnections();
+	void serveConnection(std::shared_ptr<tcp::socket> socket);
+
+	/// Function returning responses to requests.
+	const Handler handler;
+
+	/// Service of the sockets.
+	boost::asio::io_service service;
+
+	/// Acceptor of connections.
+	tcp::acceptor acceptor;
+
+	/// Thread accepting connections.
+	std::thread acceptingThread;
+
+	/// Threads serving connections.
+	std::vector<std::thread> servingThreads;
+
+	/// Open connections.
+	std::vector<std::shared_ptr<tcp::socket>> connections;
+
+	/// Number of accepted connections.
+	std::atomic<std::size_t> acceptedConnections{0};
+
+	/// Is the server being stopped?
+	std::atomic<bool> stopping{false};
+
+	/// Mutex guarding the threads and connections.
+	boost::mutex mutex;
+};
+
+///
+/// Starts a server on a free port of the loopback interface.
+///
+HttpServer::Impl::Impl(const Handler &handler):
+	handler(handler),
+	acceptor(service, tcp::endpoint(
+		boost::asio::ip::address_v4::loopback(), 0)) {
+	acceptingThread = std::thread([this]() { acceptConnections(); });
+}
+
+///
+/// Stops the server.
+///
+HttpServer::Impl::~Impl() {
+	stopping = true;
+	{
+		// Wake up the accepting thread.
+		tcp::socket socket(service);
+		boost::system::error_code ignored;
+		socket.connect(acceptor.local_endpoint(), ignored);
+		acceptingThread.join();
+	}
+
+	std::vector<std::thread> threads;
+	{
+		boost::lock_guard<boost::mutex> lock(mutex);
+		for (const auto &socket : connections) {
+			::shutdown(socket->native_handle(), SHUT_RDWR);
+		}
+		threads.swap(servingThreads);
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+}
+
+///
+/// Accepts connections until the server is stopped.
+///
+void HttpServer::Impl::acceptConnections() {
+	for (;;) {
+		auto socket = std::make_shared<tcp::socket>(service);
+		boost::system::error_code ec;
+		acceptor.accept(*socket, ec);
+		if (stopping) {
+			return;
+		}
+		if (ec) {
+			continue;
+		}
+
+		++acceptedConnections;
+		boost::lock_guard<boost::mutex> lock(mutex);
+		connections.push_back(socket);
+		servingThreads.emplace_back([this, socket]() {
+			serveConnection(socket);
+		});
+	}
+}
+
+///
+/// Serves requests received over the given connection until it is closed.
+///
+void HttpServer::Impl::serveConnection(std::shared_ptr<tcp::socket> socket) {
+	boost::asio::streambuf buffer;
+	for (;;) {
+		Request request;
+		if (!readRequest(*socket, buffer, request)) {
+			break;
+		}
+
+		auto response = handler(request);
+		if (!writeAll(*socket, formatResponse(response)) ||
+				response.closeConnection ||
+				response.bodyEnd == BodyEnd::ClosedConnection) {
+			break;
+		}
+	}
+
+	::shutdown(socket->native_handle(), SHUT_RDWR);
+	boost::lock_guard<boost::mutex> lock(mutex);
+	connections.erase(
+		std::remove(connections.begin(), connections.end(), socket),
+		connections.end());
+}
+
+///
+/// Starts a server passing received requests to the given handler.
+///
+HttpServer::HttpServer(const Handler &handler):
+	impl(std::make_unique<Impl>(handler)) {}
+
+///
+/// Stops the server.
+///
+HttpServer::~HttpServer() = default;
+
+///
+/// Returns the URL of the server (e.g. @c http://127.0.0.1:39521).
+///
+std::string HttpServer::url() const {
+	return "http://127.0.0.1:" +
+		std::to_string(impl->acceptor.local_endpoint().port());
+}
+
+///
+/// Returns the number of connections accepted so far.
+///
+std::size_t HttpServer::acceptedConnectionCount() const {
+	return impl->acceptedConnections;
+}
+
+///
+/// Closes all open connections, like servers do with connections that have
+/// been idle for too long.
+///
+void HttpServer::closeConnections() {
+	boost::lock_guard<boost::mutex> lock(impl->mutex);
+	for (const auto &socket : impl->connections) {
+		::shutdown(socket->native_handle(), SHUT_RDWR);
+	}
+}
+
+} // namespace tests
+} // namespace retdec
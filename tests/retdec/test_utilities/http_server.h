@@ -0,0 +1,108 @@
+///
+/// @file      retdec/test_utilities/http_server.h
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Local HTTP server for tests.
+///
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace retdec {
+namespace tests {
+
+///
+/// Local HTTP server answering requests from background threads.
+///
+/// Every connection is served by its own thread and it is kept open between
+/// requests unless a response says otherwise, so tests can check whether
+/// clients reuse their connections.
+///
+class HttpServer {
+public:
+	/// Headers (names and values).
+	using Headers = std::vector<std::pair<std::string, std::string>>;
+
+	///
+	/// Received request.
+	///
+	struct Request {
+		std::string header(const std::string &name) const;
+
+		/// Method (e.g. @c GET).
+		std::string method;
+
+		/// Target (the path and the query).
+		std::string target;
+
+		/// Headers.
+		Headers headers;
+
+		/// Body.
+		std::string body;
+	};
+
+	///
+	/// How the end of the body of a response is signaled.
+	///
+	enum class BodyEnd {
+		ContentLength, ///< By the @c Content-Length header.
+		Chunked,       ///< By the last chunk of the chunked encoding.
+		ClosedConnection ///< By closing the connection.
+	};
+
+	///
+	/// Response to be sent.
+	///
+	struct Response {
+		/// Status code.
+		int code = 200;
+
+		/// Reason phrase.
+		std::string reason = "OK";
+
+		/// Additional headers.
+		Headers headers;
+
+		/// Body.
+		std::string body;
+
+		/// How the end of the body is signaled.
+		BodyEnd bodyEnd = BodyEnd::ContentLength;
+
+		/// Should the connection be closed after the response?
+		bool closeConnection = false;
+	};
+
+	/// Function returning the response to the given request. It is called
+	/// from threads serving the connections.
+	using Handler = std::function<Response (const Request &request)>;
+
+public:
+	explicit HttpServer(const Handler &handler);
+	~HttpServer();
+
+	std::string url() const;
+	std::size_t acceptedConnectionCount() const;
+	void closeConnections();
+
+	/// @name Disabled
+	/// @{
+	HttpServer(const HttpServer &) = delete;
+	HttpServer(HttpServer &&) = delete;
+	HttpServer &operator=(const HttpServer &) = delete;
+	HttpServer &operator=(HttpServer &&) = delete;
+	/// @}
+
+private:
+	struct Impl;
+	/// Private implementation.
+	std::unique_ptr<Impl> impl;
+};
+
+} // namespace tests
+} // namespace retdec
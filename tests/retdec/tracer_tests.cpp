@@ -0,0 +1,59 @@
+///
+/// @file      retdec/tracer_tests.cpp
+/// @copyright (c) 2015 by Petr Zemek (s3rvac@gmail.com) and contributors
+/// @license   MIT, see the @c LICENSE file for more details
+/// @brief     Tests for the tracer of lifecycles of resources.
+///
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "retdec/internal/trace_buffer.h"
+#include "retdec/internal/utilities/os.h"
+#include "retdec/test_utilities/tmp_file.h"
+#include "retdec/tracer.h"
+
+using namespace testing;
+using namespace retdec::internal;
+
+namespace retdec {
+namespace tests {
+
+///
+/// Tests for Tracer.
+///
+class TracerTests: public Test {};
+
+TEST_F(TracerTests,
+ToChromeTraceJsonReturnsEventsFromBuffer) {
+	Tracer tracer;
+	tracer.buffer()->recordInstant("completion", "decompilations 123");
+
+	ASSERT_EQ(tracer.buffer()->toChromeTraceJson(),
+		tracer.toChromeTraceJson());
+}
+
+TEST_F(TracerTests,
+KeepsAtMostGivenNumberOfEvents) {
+	Tracer tracer(1);
+
+	tracer.buffer()->recordInstant("a", "");
+	tracer.buffer()->recordInstant("b", "");
+
+	ASSERT_EQ(1u, tracer.buffer()->events().size());
+}
+
+TEST_F(TracerTests,
+WriteChromeTraceWritesEventsIntoFile) {
+	Tracer tracer;
+	tracer.buffer()->recordInstant("completion", "decompilations 123");
+	auto tmpFile = TmpFile::createWithContent("");
+
+	tracer.writeChromeTrace(tmpFile->getPath());
+
+	ASSERT_EQ(tracer.toChromeTraceJson(), readFile(tmpFile->getPath()));
+}
+
+} // namespace tests
+} // namespace retdec